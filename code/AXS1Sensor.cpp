@@ -17,6 +17,7 @@ bool AXS1Sensor::begin(Driver* driver, uint8_t sensor_id){
 
     this->driver = driver;
     this->id    = sensor_id;
+    driver->setProtocol(id, 1.0f);                                  // The AX-S1 speaks Protocol 1.0 whatever the servos use
 
     if (!setObstacleCompare(AXS1_OBSTACLE_DETECTED)) return false;  // Set default obstacle detection threshold
     if (!setLightCompare(AXS1_LIGHT_DETECTED)) return false;        // Set default light detection threshold
@@ -90,6 +91,24 @@ bool AXS1Sensor::getStatusReturnLevel(uint8_t* status_return) {
     return true;
 }
 
+// Read the distance, light, detection and sound registers in three transfers of up to four bytes
+// instead of one transfer per register. data receives AXS1_SENSOR_BLOCK bytes starting at
+// AXS1_Left_Distance_Data.
+bool AXS1Sensor::readSensors(uint8_t* data) {
+    for (uint8_t offset = 0; offset < AXS1_SENSOR_BLOCK; offset += 4) {
+        uint8_t  length = min(4, AXS1_SENSOR_BLOCK - offset);
+        uint32_t value  = 0;
+        if (!driver->readRegister(id, AXS1_Left_Distance_Data + offset, length, &value)) {
+            LOG_ERR("Failed to read sensor data for ID: " + String(id));
+            return false;
+        }
+        for (uint8_t i = 0; i < length; i++) {
+            data[offset + i] = (uint8_t)(value >> (8 * i));
+        }
+    }
+    return true;
+}
+
 // Get the distance data from the IR left side sensor
 bool AXS1Sensor::getDistanceLeft(uint8_t* value) {
     if (!driver->readRegister(id, AXS1_Left_Distance_Data, 1, (uint32_t*)value)) {
@@ -480,304 +499,297 @@ bool AXS1Sensor::printStatus() {
     return true;
 }
 
-// Process console commands for sensor control
-bool AXS1Sensor::runConsoleCommands(const String& cmd, const String& args) {
-    if (cmd == "ap") {
-        bool result = ping();
-        PRINTLN("Sensor ping: " + String(result ? "SUCCESS" : "FAILED"));
-        return true;
-
-    } else if (cmd == "as") {
-        printStatus();
-        return true;
-
-    } else if (cmd == "ad") {
-        uint8_t distance_left = 0 , distance_center = 0 , distance_right = 0;
-        if (!getDistanceLeft(&distance_left) || !getDistanceCenter(&distance_center) || !getDistanceRight(&distance_right)) {
-            LOG_ERR("Failed to read distance data");
-        } else {
-            PRINTLN("Distance - Left: " + String(distance_left) + 
-                   ", Center: " + String(distance_center) + 
-                   ", Right: " + String(distance_right));
-        }
-        return true;
+// Print the state of the left, center and right bits of a detection byte
+static void printDetected(const char* what, uint8_t bits) {
+    PRINTLN(String(what) + " Detected - Left: " + String((bits & 1) ? "On" : "Off") +
+            ", Center: " + String((bits & 2) ? "On" : "Off") +
+            ", Right: " + String((bits & 4) ? "On" : "Off"));
+}
 
-    } else if (cmd == "air") {
-        uint8_t light_left = 0 , light_center = 0 , light_right = 0;
-        if (!getIRLeft(&light_left) || !getIRCenter(&light_center) || !getIRRight(&light_right)) {
-            LOG_ERR("Failed to read IR light data");
-        } else {
-            PRINTLN("IR light - Left: " + String(light_left) + 
-                   ", Center: " + String(light_center) + 
-                   ", Right: " + String(light_right));
-        }
-        return true;
+// Print a byte register read, or the error when the read failed
+static bool printRead(bool ok, const char* what, uint16_t value) {
+    if (!ok) {
+        LOG_ERR("Failed to read " + String(what) + " data");
+        return false;
+    }
+    PRINTLN(String(what) + " Data: " + String(value));
+    return true;
+}
 
-    } else if (cmd == "asoc") {
-        uint8_t value = 0;
-        if (args.length() > 0) {
-            value = args.toInt();
-        }
-        if (!setObstacleCompare(value)) {
-            LOG_ERR("Failed to set Obstacle Compare value to " + String(value));
-        } else {
-            PRINTLN("Obstacle Compare value set to " + String(value));
-        }
-        return true;
+// ap: Ping the sensor
+static bool pingSensor(void* sensor, const CommandArgs&) {
+    bool found = static_cast<AXS1Sensor*>(sensor)->ping();
+    PRINTLN("Sensor ping: " + String(found ? "SUCCESS" : "FAILED"));
+    return found;
+}
 
-    } else if (cmd == "agoc") {
-        uint8_t obstacle_compare = 0;
-        if (!getObstacleCompare(&obstacle_compare)) {
-            LOG_ERR("Failed to get Obstacle Compare value");
-        } else {
-            PRINTLN("Obstacle Compare value: " + String(obstacle_compare));
-        }
-        return true;
+// as: Print the sensor status
+static bool showSensor(void* sensor, const CommandArgs&) {
+    return static_cast<AXS1Sensor*>(sensor)->printStatus();
+}
 
-    } else if (cmd == "aslc") {
-        uint8_t value = 0;
-        if (args.length() > 0) {
-            value = args.toInt();
-        }
-        if (!setLightCompare(value)) {
-            LOG_ERR("Failed to set Light Compare value to " + String(value));
-        } else {
-            PRINTLN("Light Compare value set to " + String(value));
-        }
-        return true;
+// ad: Read the distance sensors
+static bool showDistance(void* module, const CommandArgs&) {
+    AXS1Sensor* sensor = static_cast<AXS1Sensor*>(module);
+    uint8_t left = 0, center = 0, right = 0;
+    if (!sensor->getDistanceLeft(&left) || !sensor->getDistanceCenter(&center) || !sensor->getDistanceRight(&right)) {
+        LOG_ERR("Failed to read distance data");
+        return false;
+    }
+    PRINTLN("Distance - Left: " + String(left) + ", Center: " + String(center) + ", Right: " + String(right));
+    return true;
+}
 
-    } else if (cmd == "aglc") {
-        uint8_t compareValue = 0;
-        if (!getLightCompare(&compareValue)) {
-            LOG_ERR("Failed to get Light Compare value");
-        } else {
-            PRINTLN("Light Compare value: " + String(compareValue));
-        }
-        return true;
+// air: Read the IR light sensors
+static bool showIR(void* module, const CommandArgs&) {
+    AXS1Sensor* sensor = static_cast<AXS1Sensor*>(module);
+    uint8_t left = 0, center = 0, right = 0;
+    if (!sensor->getIRLeft(&left) || !sensor->getIRCenter(&center) || !sensor->getIRRight(&right)) {
+        LOG_ERR("Failed to read IR light data");
+        return false;
+    }
+    PRINTLN("IR light - Left: " + String(left) + ", Center: " + String(center) + ", Right: " + String(right));
+    return true;
+}
 
-    } else if (cmd == "aod") {
-        uint8_t od = 0;
-        if (!ObstacleDetected(&od)) {
-            LOG_ERR("Failed to read Obstacle Detected data");
-        } else {
-            PRINTLN("Obstacle Detected - Left: " + String((od & 1) == 1 ? "On" : "Off") + 
-                    ", Center: " + String((od & 2) == 2 ? "On" : "Off") +
-                    ", Right: " + String((od & 4) == 4 ? "On" : "Off"));
-        }
-        return true;
+// asoc [value]: Set the obstacle compare value
+static bool setObstacleCompare(void* sensor, const CommandArgs& args) {
+    uint8_t value = (uint8_t)args.toInt(0, 0);
+    if (!static_cast<AXS1Sensor*>(sensor)->setObstacleCompare(value)) {
+        LOG_ERR("Failed to set Obstacle Compare value to " + String(value));
+        return false;
+    }
+    PRINTLN("Obstacle Compare value set to " + String(value));
+    return true;
+}
 
-    } else if (cmd == "ald") {
-        uint8_t ld = 0;
-        if (!LightDetected(&ld)) {
-            LOG_ERR("Failed to read Light Detected data");
-        } else {
-            PRINTLN("Light Detected - Left: " + String((ld & 1) == 1 ? "On" : "Off") + 
-                    ", Center: " + String((ld & 2) == 2 ? "On" : "Off") +
-                    ", Right: " + String((ld & 4) == 4 ? "On" : "Off"));
-        }
-        return true;
+// agoc: Read the obstacle compare value
+static bool showObstacleCompare(void* sensor, const CommandArgs&) {
+    uint8_t value = 0;
+    if (!static_cast<AXS1Sensor*>(sensor)->getObstacleCompare(&value)) {
+        LOG_ERR("Failed to get Obstacle Compare value");
+        return false;
+    }
+    PRINTLN("Obstacle Compare value: " + String(value));
+    return true;
+}
 
-    } else if (cmd == "agsd") {
-        uint8_t sound_data = 0;
-        if (!getSoundData(&sound_data)) {
-            LOG_ERR("Failed to read Sound Detected data");
-        } else {
-            PRINTLN("Sound Detected Data: " + String(sound_data));
-        }
-        return true;
+// aslc [value]: Set the light compare value
+static bool setLightCompare(void* sensor, const CommandArgs& args) {
+    uint8_t value = (uint8_t)args.toInt(0, 0);
+    if (!static_cast<AXS1Sensor*>(sensor)->setLightCompare(value)) {
+        LOG_ERR("Failed to set Light Compare value to " + String(value));
+        return false;
+    }
+    PRINTLN("Light Compare value set to " + String(value));
+    return true;
+}
 
-    } else if (cmd == "agsdmh") {
-        uint8_t sound_data_max_hold = 0;
-        if (!getSoundDataMaxHold(&sound_data_max_hold)) {
-            LOG_ERR("Failed to read Sound Data Max Hold data");
-        } else {
-            PRINTLN("Sound Data Max Hold Data: " + String(sound_data_max_hold));
-        }
-        return true;
+// aglc: Read the light compare value
+static bool showLightCompare(void* sensor, const CommandArgs&) {
+    uint8_t value = 0;
+    if (!static_cast<AXS1Sensor*>(sensor)->getLightCompare(&value)) {
+        LOG_ERR("Failed to get Light Compare value");
+        return false;
+    }
+    PRINTLN("Light Compare value: " + String(value));
+    return true;
+}
 
-    } else if (cmd == "agsdc") {
-        uint8_t sound_detected_count = 0;
-        if (!getSoundDetectedCount(&sound_detected_count)) {
-            LOG_ERR("Failed to read Sound Detected Count data");
-        } else {
-            PRINTLN("Sound Detected Count Data: " + String(sound_detected_count));
-        }
-        return true;
+// aod: Read the obstacle detection
+static bool showObstacleDetected(void* sensor, const CommandArgs&) {
+    uint8_t bits = 0;
+    if (!static_cast<AXS1Sensor*>(sensor)->ObstacleDetected(&bits)) {
+        LOG_ERR("Failed to read Obstacle Detected data");
+        return false;
+    }
+    printDetected("Obstacle", bits);
+    return true;
+}
 
-    } else if (cmd == "agsdt") {
-        uint8_t sound_detected_time = 0;
-        if (!getSoundDetectedTime(&sound_detected_time)) {
-            LOG_ERR("Failed to read Sound Detected Time data");
-        } else {
-            PRINTLN("Sound Detected Time Data: " + String(sound_detected_time));
-        }
-        return true;
+// ald: Read the light detection
+static bool showLightDetected(void* sensor, const CommandArgs&) {
+    uint8_t bits = 0;
+    if (!static_cast<AXS1Sensor*>(sensor)->LightDetected(&bits)) {
+        LOG_ERR("Failed to read Light Detected data");
+        return false;
+    }
+    printDetected("Light", bits);
+    return true;
+}
 
-    } else if (cmd == "arsdmh") {
-        if (!resetSoundDataMaxHold()) {
-            LOG_ERR("Failed to reset Sound Data Max Hold");
-        } else {
-            PRINTLN("Sound Data Max Hold reset successfully");
-        }
-        return true;
+// agsd: Read the sound data
+static bool showSoundData(void* sensor, const CommandArgs&) {
+    uint8_t value = 0;
+    return printRead(static_cast<AXS1Sensor*>(sensor)->getSoundData(&value), "Sound Detected", value);
+}
 
-    } else if (cmd == "arsdc") {
-        if (!resetSoundDetectedCount()) {
-            LOG_ERR("Failed to reset Sound Detected Count");
-        } else {
-            PRINTLN("Sound Detected Count reset successfully");
-        }
-        return true;
+// agsdmh: Read the sound data max hold
+static bool showSoundDataMaxHold(void* sensor, const CommandArgs&) {
+    uint8_t value = 0;
+    return printRead(static_cast<AXS1Sensor*>(sensor)->getSoundDataMaxHold(&value), "Sound Data Max Hold", value);
+}
 
-    } else if (cmd == "arsdt") {
-        if (!resetSoundDetectedTime()) {
-            LOG_ERR("Failed to reset Sound Detected Time");
-        } else {
-            PRINTLN("Sound Detected Time reset successfully");
-        }
-        return true;
+// agsdc: Read the sound detected count
+static bool showSoundDetectedCount(void* sensor, const CommandArgs&) {
+    uint8_t value = 0;
+    return printRead(static_cast<AXS1Sensor*>(sensor)->getSoundDetectedCount(&value), "Sound Detected Count", value);
+}
 
-    } else if (cmd == "apt") {
-        uint8_t note = 0;
-        uint8_t duration = 0;
-        
-        if (args.length() > 0) {
-            int spaceIndex = args.indexOf(' ');
-            if (spaceIndex != -1) {
-                note = args.substring(0, spaceIndex).toInt();
-                duration = args.substring(spaceIndex + 1).toInt();
-            } else {
-                note = args.toInt();
-            }
-        }
+// agsdt: Read the sound detected time
+static bool showSoundDetectedTime(void* sensor, const CommandArgs&) {
+    uint8_t value = 0;
+    return printRead(static_cast<AXS1Sensor*>(sensor)->getSoundDetectedTime(&value), "Sound Detected Time", value);
+}
 
-        if (!playTone(note, duration)) {
-            LOG_ERR("Failed to play tone " + String(note) + " for duration " + String(duration));
-        } else {
-            PRINTLN("Playing tone " + String(note) + " for duration " + String(duration));
-        }
-        return true;
+// arsdmh: Reset the sound data max hold
+static bool resetSoundDataMaxHold(void* sensor, const CommandArgs&) {
+    if (!static_cast<AXS1Sensor*>(sensor)->resetSoundDataMaxHold()) {
+        LOG_ERR("Failed to reset Sound Data Max Hold");
+        return false;
+    }
+    PRINTLN("Sound Data Max Hold reset successfully");
+    return true;
+}
 
-    } else if (cmd == "apm") {
+// arsdc: Reset the sound detected count
+static bool resetSoundDetectedCount(void* sensor, const CommandArgs&) {
+    if (!static_cast<AXS1Sensor*>(sensor)->resetSoundDetectedCount()) {
+        LOG_ERR("Failed to reset Sound Detected Count");
+        return false;
+    }
+    PRINTLN("Sound Detected Count reset successfully");
+    return true;
+}
 
-        uint8_t note = 0;
+// arsdt: Reset the sound detected time
+static bool resetSoundDetectedTime(void* sensor, const CommandArgs&) {
+    if (!static_cast<AXS1Sensor*>(sensor)->resetSoundDetectedTime()) {
+        LOG_ERR("Failed to reset Sound Detected Time");
+        return false;
+    }
+    PRINTLN("Sound Detected Time reset successfully");
+    return true;
+}
 
-        if (args.length() > 0) {
-            note = args.toInt();
-        }
-        
-        if (!playMelody(note)) {
-            LOG_ERR("Failed to play melody " + String(note));
-        } else {
-            PRINTLN("Playing melody " + String(note));
-        }
-        return true;
-    
-    } else if (cmd == "apn") {
-        
-        uint8_t melody = 0;
-
-        if (args.length() > 0) {
-            if (args == "stop") {
-                if (!stopTone()) {
-                    LOG_ERR("Failed to stop continuous tone.");
-                } else {
-                    PRINTLN("Continuous tone stopped successfully.");
-                }
-                return true;
-            }
-
-            melody = args.toInt();
-        }
+// apt [note] [dur]: Play a tone
+static bool playTone(void* sensor, const CommandArgs& args) {
+    uint8_t note     = (uint8_t)args.toInt(0, 0);
+    uint8_t duration = (uint8_t)args.toInt(1, 0);
+    if (!static_cast<AXS1Sensor*>(sensor)->playTone(note, duration)) {
+        LOG_ERR("Failed to play tone " + String(note) + " for duration " + String(duration));
+        return false;
+    }
+    PRINTLN("Playing tone " + String(note) + " for duration " + String(duration));
+    return true;
+}
 
-        if (!startTone(melody)) {
-            LOG_ERR("Failed to play melody " + String(melody));
-        } else {
-            PRINTLN("Playing melody " + String(melody));
-        }
-        return true;
+// apm [melody]: Play a melody
+static bool playMelody(void* sensor, const CommandArgs& args) {
+    uint8_t melody = (uint8_t)args.toInt(0, 0);
+    if (!static_cast<AXS1Sensor*>(sensor)->playMelody(melody)) {
+        LOG_ERR("Failed to play melody " + String(melody));
+        return false;
+    }
+    PRINTLN("Playing melody " + String(melody));
+    return true;
+}
 
-    } else if (cmd == "agrx") {
-        uint16_t remoconRX = 0;
-        if (!getRemoconRX(&remoconRX)) {
-            LOG_ERR("Failed to read Remote Control RX data");
-        } else {
-            PRINTLN("Remote Control RX Data: " + String(remoconRX));
+// apn [note|stop]: Start or stop a continuous tone
+static bool continuousTone(void* module, const CommandArgs& args) {
+    AXS1Sensor* sensor = static_cast<AXS1Sensor*>(module);
+    if (strcmp(args.get(0), "stop") == 0) {
+        if (!sensor->stopTone()) {
+            LOG_ERR("Failed to stop continuous tone.");
+            return false;
         }
+        PRINTLN("Continuous tone stopped successfully.");
         return true;
+    }
+    uint8_t melody = (uint8_t)args.toInt(0, 0);
+    if (!sensor->startTone(melody)) {
+        LOG_ERR("Failed to play melody " + String(melody));
+        return false;
+    }
+    PRINTLN("Playing melody " + String(melody));
+    return true;
+}
 
-    } else if (cmd == "agtx") {
-        uint16_t remoconTX = 0;
-        if (!getRemoconTX(&remoconTX)) {
-            LOG_ERR("Failed to read Remote Control TX data");
-        } else {
-            PRINTLN("Remote Control TX Data: " + String(remoconTX));
-        }
-        return true;
+// agrx: Read the remote control RX data
+static bool showRemoconRX(void* sensor, const CommandArgs&) {
+    uint16_t value = 0;
+    return printRead(static_cast<AXS1Sensor*>(sensor)->getRemoconRX(&value), "Remote Control RX", value);
+}
 
-    } else if (cmd == "arxa") {
-        bool arrived = RemoconArrived();
-        PRINTLN("Remote Control Data Arrived: " + String(arrived ? "Yes" : "No"));
-        return true;    
+// agtx: Read the remote control TX data
+static bool showRemoconTX(void* sensor, const CommandArgs&) {
+    uint16_t value = 0;
+    return printRead(static_cast<AXS1Sensor*>(sensor)->getRemoconTX(&value), "Remote Control TX", value);
+}
 
-    } else if (cmd == "astx") {
-        uint16_t value = 0;
-        if (args.length() > 0) {
-            value = args.toInt();
-        }
-        if (!setRemoconTX(value)) {
-            LOG_ERR("Failed to set Remote Control TX value to " + String(value));
-        } else {
-            PRINTLN("Remote Control TX value set to " + String(value));
-        }
-        return true;
+// arxa: Check whether remote control data arrived
+static bool showRemoconArrived(void* sensor, const CommandArgs&) {
+    PRINTLN("Remote Control Data Arrived: " + String(static_cast<AXS1Sensor*>(sensor)->RemoconArrived() ? "Yes" : "No"));
+    return true;
+}
 
-    } else if (cmd == "a?") {
-        if (!printConsoleHelp()) {  
-            LOG_ERR("Failed to print console help");
-        }
-        return true;
-    
+// astx [value]: Set the remote control TX data
+static bool setRemoconTX(void* sensor, const CommandArgs& args) {
+    uint16_t value = (uint16_t)args.toInt(0, 0);
+    if (!static_cast<AXS1Sensor*>(sensor)->setRemoconTX(value)) {
+        LOG_ERR("Failed to set Remote Control TX value to " + String(value));
+        return false;
     }
+    PRINTLN("Remote Control TX value set to " + String(value));
+    return true;
+}
+
+// a?: Print the sensor help
+static bool showSensorHelp(void* sensor, const CommandArgs&) {
+    if (static_cast<AXS1Sensor*>(sensor)->printConsoleHelp()) return true;
+    LOG_ERR("Failed to print console help");
     return false;
 }
 
+// Console commands, the help is printed from this table
+static const ConsoleCommand axs1Commands[] = {
+    { "ap",     "",             "Ping sensor (connectivity test)",                  pingSensor },
+    { "as",     "",             "Print Sensor status",                              showSensor },
+    { nullptr,  "",             "",                                                 nullptr },
+    { "ad",     "",             "Read Distance sensors (left, center, right)",      showDistance },
+    { "air",    "",             "Read IR light sensors (left, center, right)",      showIR },
+    { nullptr,  "",             "",                                                 nullptr },
+    { "asoc",   "[value]",      "Set Obstacle Detection Compare value (0-255)",     setObstacleCompare },
+    { "agoc",   "",             "Read Obstacle Detection Compare value",            showObstacleCompare },
+    { "aslc",   "[value]",      "Set Light Detection Compare value (0-255)",        setLightCompare },
+    { "aglc",   "",             "Read Light Detection Compare value",               showLightCompare },
+    { nullptr,  "",             "",                                                 nullptr },
+    { "aod",    "",             "Read Obstacle Detection (left, center, right)",    showObstacleDetected },
+    { "ald",    "",             "Read Light Detection (left, center, right)",       showLightDetected },
+    { nullptr,  "",             "",                                                 nullptr },
+    { "agsd",   "",             "Read Sound Data",                                  showSoundData },
+    { "agsdmh", "",             "Read Sound Data Max Hold",                         showSoundDataMaxHold },
+    { "agsdc",  "",             "Read Sound Detected Count",                        showSoundDetectedCount },
+    { "agsdt",  "",             "Read Sound Detected Time",                         showSoundDetectedTime },
+    { "arsdmh", "",             "Reset Sound Data Max Hold",                        resetSoundDataMaxHold },
+    { "arsdc",  "",             "Reset Sound Detected Count",                       resetSoundDetectedCount },
+    { "arsdt",  "",             "Reset Sound Detected Time",                        resetSoundDetectedTime },
+    { nullptr,  "",             "",                                                 nullptr },
+    { "apt",    "[note] [dur]", "Play Tone (note 0-51, duration 0-50",              playTone },
+    { "apm",    "[melody]",     "Play Melody (0-26)",                               playMelody },
+    { "apn",    "[note]",       "Start continuous tone (note 0-51)",                continuousTone },
+    { "apn",    "stop",         "Stop continuous tone",                             nullptr },
+    { nullptr,  "",             "",                                                 nullptr },
+    { "agrx",   "",             "Read Remote Control RX data",                      showRemoconRX },
+    { "agtx",   "",             "Read Remote Control TX data",                      showRemoconTX },
+    { "arxa",   "",             "Check if Remote Control data has arrived",         showRemoconArrived },
+    { "astx",   "[value]",      "Set Remote Control TX data (0-65535)",             setRemoconTX },
+    { nullptr,  "",             "",                                                 nullptr },
+    { "a?",     "",             "Show this help message",                           showSensorHelp },
+};
+const ConsoleCommandTable AXS1Sensor::commandTable = { "Sensor Commands (AXS1):", axs1Commands, sizeof(axs1Commands) / sizeof(axs1Commands[0]) };
+
 // Print sensor-specific help information
 bool AXS1Sensor::printConsoleHelp() {
-    PRINTLN("Sensor Commands (AXS1):\n\r");
-    PRINTLN("  ap               - Ping sensor (connectivity test)");
-    PRINTLN("  as               - Print Sensor status");
-    PRINTLN("");
-    PRINTLN("  ad               - Read Distance sensors (left, center, right)");
-    PRINTLN("  air              - Read IR light sensors (left, center, right)");
-    PRINTLN("");
-    PRINTLN("  asoc [value]     - Set Obstacle Detection Compare value (0-255)");
-    PRINTLN("  agoc             - Read Obstacle Detection Compare value");
-    PRINTLN("  aslc [value]     - Set Light Detection Compare value (0-255)");
-    PRINTLN("  aglc             - Read Light Detection Compare value");
-    PRINTLN("");
-    PRINTLN("  aod              - Read Obstacle Detection (left, center, right)");
-    PRINTLN("  ald              - Read Light Detection (left, center, right)");
-    PRINTLN("");
-    PRINTLN("  agsd             - Read Sound Data");
-    PRINTLN("  agsdmh           - Read Sound Data Max Hold");
-    PRINTLN("  agsdc            - Read Sound Detected Count");
-    PRINTLN("  agsdt            - Read Sound Detected Time");
-    PRINTLN("  arsdmh           - Reset Sound Data Max Hold");
-    PRINTLN("  arsdc            - Reset Sound Detected Count");
-    PRINTLN("  arsdt            - Reset Sound Detected Time");
-    PRINTLN("");
-    PRINTLN("  apt [note] [dur] - Play Tone (note 0-51, duration 0-50");
-    PRINTLN("  apm [melody]     - Play Melody (0-26)");
-    PRINTLN("  apn [note]       - Start continuous tone (note 0-51)");
-    PRINTLN("  apn stop         - Stop continuous tone");
-    PRINTLN("");
-    PRINTLN("  agrx             - Read Remote Control RX data");
-    PRINTLN("  agtx             - Read Remote Control TX data");
-    PRINTLN("  arxa             - Check if Remote Control data has arrived");
-    PRINTLN("  astx [value]     - Set Remote Control TX data (0-65535)");
-    PRINTLN("");
-    PRINTLN("  a?               - Show this help message");
-    PRINTLN("");
-    return true;
-}
\ No newline at end of file
+    return CommandRegistry::printHelp(commandTable);
+}
@@ -5,6 +5,7 @@
     #define AXS1_SENSOR_ID                      100
     #define AXS1_OBSTACLE_DETECTED              8  // Obstacle detected threshold
     #define AXS1_LIGHT_DETECTED                 8  // Light detected threshold
+    #define AXS1_SENSOR_BLOCK                   10 // Registers from Left_Distance_Data to Sound_Data read by readSensors
 
     // EEPROM Area (Section 4.6 https://emanual.robotis.com/docs/en/parts/sensor/ax-s1/)
     #define AXS1_Model_Number_L                 0   // access=R  , initial value=13(0x0D)
@@ -42,6 +43,7 @@
     #define AXS1_Light_Detect_Compare           53  // access=RW
 
     #include "Driver.h"
+    #include "CommandRegistry.h"
 
     class AXS1Sensor {
     public:
@@ -61,6 +63,7 @@
         bool getStatusReturnLevel(uint8_t* status_return);
 
         // IR Sensors Distance
+        bool readSensors(uint8_t* data);        // Read registers 26 to 35 (distance, light, detection, sound) into data
         bool getDistanceLeft(uint8_t* value);
         bool getDistanceCenter(uint8_t* value);
         bool getDistanceRight(uint8_t* value);
@@ -104,8 +107,8 @@
 
         // Status and Helper Functions
         bool printStatus();
-        bool runConsoleCommands(const String& cmd, const String& args);  // Process console commands for sensor control
         bool printConsoleHelp();                                                // Print sensor-specific help information
+        static const ConsoleCommandTable commandTable;                          // Console commands and their help
 
     private:
         Driver*     driver;                    // Pointer to Driver instance
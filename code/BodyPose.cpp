@@ -83,57 +83,66 @@ bool BodyPose::printStatus() {
     return true;
 }
 
+// bs: Print the body pose
+static bool showPose(void* pose, const CommandArgs&) {
+    return static_cast<BodyPose*>(pose)->printStatus();
+}
 
-bool BodyPose::runConsoleCommands(const String& cmd, const String& args) {
-    if (cmd == "bs") {
-        printStatus();
-        return true;
-
-    } else if (cmd == "bsp") {
-        float x, y, z, roll, pitch, yaw;
-        if (sscanf(args.c_str(), "%f %f %f %f %f %f", &x, &y, &z, &roll, &pitch, &yaw) == 6) {
-            setPose(x, y, z, roll, pitch, yaw);
-        } else {
-            LOG_ERR("Invalid arguments. Usage: bsp [x y z roll pitch yaw]");
-        }   
-
-    } else if (cmd == "brp") {
-        resetPose();
-        return true;
-    } else if (cmd == "bspos") {
-        float x, y, z;
-        if (sscanf(args.c_str(), "%f %f %f", &x, &y, &z) == 3) {
-            setPosition(x, y, z);
-        } else {
-            LOG_ERR("Invalid arguments. Usage: bspos [x y z]");
-        }
-        return true;
-        
-    } else if (cmd == "bso") {
-        float roll, pitch, yaw;
-        if (sscanf(args.c_str(), "%f %f %f", &roll, &pitch, &yaw) == 3) {
-            setOrientation(roll, pitch, yaw);
-        } else {
-            LOG_ERR("Invalid arguments. Usage: bso [roll pitch yaw]");
-        }
-        return true;
-
-    } else if (cmd == "b?") {
-        printConsoleHelp();
-        return true;
+// bsp x y z roll pitch yaw: Set the body pose
+static bool setBodyPose(void* pose, const CommandArgs& args) {
+    float x, y, z, roll, pitch, yaw;
+    if (sscanf(args.rest(), "%f %f %f %f %f %f", &x, &y, &z, &roll, &pitch, &yaw) != 6) {
+        LOG_ERR("Invalid arguments. Usage: bsp [x y z roll pitch yaw]");
+        return false;
+    }
+    static_cast<BodyPose*>(pose)->setPose(x, y, z, roll, pitch, yaw);
+    return true;
+}
 
+// brp: Reset the body pose
+static bool resetBodyPose(void* pose, const CommandArgs&) {
+    static_cast<BodyPose*>(pose)->resetPose();
+    return true;
+}
+
+// bspos x y z: Set the body position
+static bool setBodyPosition(void* pose, const CommandArgs& args) {
+    float x, y, z;
+    if (sscanf(args.rest(), "%f %f %f", &x, &y, &z) != 3) {
+        LOG_ERR("Invalid arguments. Usage: bspos [x y z]");
+        return false;
     }
-    return false;
+    static_cast<BodyPose*>(pose)->setPosition(x, y, z);
+    return true;
 }
 
-bool BodyPose::printConsoleHelp() const {
-    PRINTLN("BodyPose Console Commands:\n\r");
-    PRINTLN("  bs                           - Print body pose status");
-    PRINTLN("  bsp [x y z roll pitch yaw]   - Set the body pose");
-    PRINTLN("  brp                          - Reset the body pose");
-    PRINTLN("  bspos [x y z]                - Set the body position");
-    PRINTLN("  bso [roll pitch yaw]         - Set the body orientation");
-    PRINTLN("  b?                           - Show this help");
-    PRINTLN("");
+// bso roll pitch yaw: Set the body orientation
+static bool setBodyOrientation(void* pose, const CommandArgs& args) {
+    float roll, pitch, yaw;
+    if (sscanf(args.rest(), "%f %f %f", &roll, &pitch, &yaw) != 3) {
+        LOG_ERR("Invalid arguments. Usage: bso [roll pitch yaw]");
+        return false;
+    }
+    static_cast<BodyPose*>(pose)->setOrientation(roll, pitch, yaw);
     return true;
-}
\ No newline at end of file
+}
+
+// b?: Print the body pose help
+static bool showPoseHelp(void* pose, const CommandArgs&) {
+    return static_cast<BodyPose*>(pose)->printConsoleHelp();
+}
+
+// Console commands, the help is printed from this table
+static const ConsoleCommand bodyPoseCommands[] = {
+    { "bs",     "",                       "Print body pose status",   showPose },
+    { "bsp",    "[x y z roll pitch yaw]", "Set the body pose",        setBodyPose },
+    { "brp",    "",                       "Reset the body pose",      resetBodyPose },
+    { "bspos",  "[x y z]",                "Set the body position",    setBodyPosition },
+    { "bso",    "[roll pitch yaw]",       "Set the body orientation", setBodyOrientation },
+    { "b?",     "",                       "Show this help",           showPoseHelp },
+};
+const ConsoleCommandTable BodyPose::commandTable = { "BodyPose Console Commands:", bodyPoseCommands, sizeof(bodyPoseCommands) / sizeof(bodyPoseCommands[0]) };
+
+bool BodyPose::printConsoleHelp() const {
+    return CommandRegistry::printHelp(commandTable);
+}
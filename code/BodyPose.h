@@ -2,6 +2,7 @@
 #define BODYPPOSE_H
 
 #include "Arduino.h"
+#include "CommandRegistry.h"
 
 #define ROLL_MIN   -1.57f   // -90 degrees in radians
 #define ROLL_MAX    1.57f   //  90 degrees in radians
@@ -30,8 +31,8 @@ public:
     void resetPose();
 
     bool printStatus();
-    bool runConsoleCommands(const String& cmd, const String& args);
     bool printConsoleHelp() const;
+    static const ConsoleCommandTable commandTable;
 
     // Members
     float x;      // Position in mm (forward/back)
@@ -1,86 +1,93 @@
 #include "CommandHistory.h"
 
 // Constructor
-CommandHistory::CommandHistory(size_t maxSize) 
-    : currentIndex(-1), maxHistorySize(maxSize) {
-    history.reserve(maxHistorySize);
+CommandHistory::CommandHistory()
+    : oldest(0), count(0), currentIndex(-1) {
+    memset(entries, 0, sizeof(entries));
 }
 
-// Add a command to history
-void CommandHistory::addCommand(const String& command) {
+// Add a command to history, overwriting the oldest when all slots are used
+void CommandHistory::addCommand(const char* command) {
     // Don't add empty commands or duplicates of the last command
-    if (command.length() == 0 || (!history.empty() && history.back() == command)) {
+    if (command[0] == 0 || (count > 0 && strcmp(entry(count - 1), command) == 0)) {
         resetToEnd();
         return;
     }
-    
-    history.push_back(command);
-    trimHistory();
+
+    uint8_t slot;
+    if (count < COMMAND_HISTORY_SIZE) {
+        slot = (oldest + count) % COMMAND_HISTORY_SIZE;
+        count++;
+    } else {
+        slot   = oldest;
+        oldest = (oldest + 1) % COMMAND_HISTORY_SIZE;
+    }
+    strncpy(entries[slot], command, COMMAND_LINE_MAX - 1);
+    entries[slot][COMMAND_LINE_MAX - 1] = 0;
     resetToEnd();
 }
 
 // Get previous command in history
-String CommandHistory::getPrevious() {
-    if (history.empty()) {
+const char* CommandHistory::getPrevious() {
+    if (count == 0) {
         return "";
     }
-    
+
     if (currentIndex <= 0) {
         currentIndex = 0;
     } else {
         currentIndex--;
     }
-    
-    return history[currentIndex];
+
+    return entry(currentIndex);
 }
 
 // Get next command in history
-String CommandHistory::getNext() {
-    if (history.empty()) {
+const char* CommandHistory::getNext() {
+    if (count == 0) {
         return "";
     }
-    
-    if (currentIndex >= (int)history.size() - 1) {
-        currentIndex = history.size();
+
+    if (currentIndex >= (int)count - 1) {
+        currentIndex = count;
         return ""; // Return empty string when at end
     } else {
         currentIndex++;
-        return history[currentIndex];
+        return entry(currentIndex);
     }
 }
 
 // Get current command at cursor
-String CommandHistory::getCurrent() const {
-    if (history.empty() || currentIndex < 0 || currentIndex >= (int)history.size()) {
+const char* CommandHistory::getCurrent() const {
+    if (count == 0 || currentIndex < 0 || currentIndex >= (int)count) {
         return "";
     }
-    return history[currentIndex];
+    return entry(currentIndex);
 }
 
 // Reset to end of history (after last command)
 void CommandHistory::resetToEnd() {
-    currentIndex = history.size();
+    currentIndex = count;
 }
 
 // Check if history is empty
 bool CommandHistory::isEmpty() const {
-    return history.empty();
+    return count == 0;
 }
 
 // Get history size
 size_t CommandHistory::size() const {
-    return history.size();
+    return count;
 }
 
 // Clear all history
 void CommandHistory::clear() {
-    history.clear();
+    oldest       = 0;
+    count        = 0;
     currentIndex = -1;
 }
 
-// Trim history to maximum size
-void CommandHistory::trimHistory() {
-    while (history.size() > maxHistorySize) {
-        history.erase(history.begin());
-    }
+// Command index, counted from the oldest
+const char* CommandHistory::entry(uint8_t index) const {
+    return entries[(oldest + index) % COMMAND_HISTORY_SIZE];
 }
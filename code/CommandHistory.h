@@ -2,28 +2,32 @@
 #define COMMANDHISTORY_H
 
 #include <Arduino.h>
-#include <vector>
+#include "CommandRegistry.h"                    // COMMAND_LINE_MAX
 
+#define COMMAND_HISTORY_SIZE    uint8_t(10)     // Commands kept, the oldest is overwritten
+
+// Command history in a ring of fixed slots, so a long session never touches the heap
 class CommandHistory {
 
 public:
-    CommandHistory(size_t maxSize = 10);
+    CommandHistory();
 
-    void    addCommand(const String& command);  // Add a command to history
-    String  getPrevious();                      // Navigate history: previous
-    String  getNext();                          // Navigate history: next
-    String  getCurrent() const;                 // Get current command at cursor
-    void    resetToEnd();                       // Reset to end of history
-    bool    isEmpty() const;                    // Check if history is empty
-    size_t  size() const;                       // Get history size
-    void    clear();                            // Clear all history
+    void        addCommand(const char* command);    // Add a command to history
+    const char* getPrevious();                      // Navigate history: previous, "" if empty
+    const char* getNext();                          // Navigate history: next, "" past the newest
+    const char* getCurrent() const;                 // Get current command at cursor
+    void        resetToEnd();                       // Reset to end of history
+    bool        isEmpty() const;                    // Check if history is empty
+    size_t      size() const;                       // Get history size
+    void        clear();                            // Clear all history
 
 private:
-    std::vector<String> history;                // Command history storage
-    int                 currentIndex;           // Current position in history
-    size_t              maxHistorySize;         // Maximum number of commands to store
+    char        entries[COMMAND_HISTORY_SIZE][COMMAND_LINE_MAX];   // Command slots
+    uint8_t     oldest;                             // Slot of the oldest command
+    uint8_t     count;                              // Commands stored
+    int         currentIndex;                       // Current position, 0 is the oldest and count is past the newest
 
-    void                trimHistory();          // Helper method to trim history
+    const char* entry(uint8_t index) const;         // Command index, counted from the oldest
 };
 
 #endif
@@ -0,0 +1,238 @@
+#include "CommandRegistry.h"
+#include "Debug.h"
+
+// Constructor for CommandArgs class
+CommandArgs::CommandArgs() {
+    text[0]     = 0;
+    tokens[0]   = 0;
+    args        = text;
+    argc        = 0;
+}
+
+// Lowercase and trim the line, split off the command and tokenize the arguments at spaces
+bool CommandArgs::parse(const char* line) {
+    argc    = 0;
+    text[0] = 0;
+    args    = text;
+    while (*line == ' ' || *line == '\t') line++;
+    size_t length = strlen(line);
+    while (length > 0 && isspace((unsigned char)line[length - 1])) length--;
+    if (length == 0 || length >= COMMAND_LINE_MAX) return false;
+
+    for (size_t i = 0; i < length; i++) {
+        text[i] = (char)tolower((unsigned char)line[i]);
+    }
+    text[length] = 0;
+
+    char* space = strchr(text, ' ');
+    if (space == nullptr) {
+        args = text + length;
+    } else {
+        *space = 0;
+        args   = space + 1;
+        while (*args == ' ') args++;
+    }
+
+    strcpy(tokens, args);
+    char* p = tokens;
+    while (*p != 0 && argc < COMMAND_ARGS_MAX) {
+        while (*p == ' ') *p++ = 0;
+        if (*p == 0) break;
+        argv[argc++] = p;
+        while (*p != 0 && *p != ' ') p++;
+    }
+    if (*p == ' ') *p = 0;                                                          // End the last token kept
+    return true;
+}
+
+// The command
+const char* CommandArgs::command() const {
+    return text;
+}
+
+// Number of arguments tokenized
+uint8_t CommandArgs::count() const {
+    return argc;
+}
+
+// Argument index, "" if missing
+const char* CommandArgs::get(uint8_t index) const {
+    return (index < argc) ? argv[index] : "";
+}
+
+// Argument index as a number, fallback if missing
+long CommandArgs::toInt(uint8_t index, long fallback) const {
+    return (index < argc) ? atol(argv[index]) : fallback;
+}
+
+// All argument text after the command
+const char* CommandArgs::rest() const {
+    return args;
+}
+
+//-----------------------------------------------------------------------------
+
+// Constructor for CommandRegistry class
+CommandRegistry::CommandRegistry() {
+    memset(slots, 0, sizeof(slots));
+    memset(modules, 0, sizeof(modules));
+    moduleCount     = 0;
+    commandCount    = 0;
+    maxProbe        = 0;
+}
+
+// Register a table. Every name and alternative is hashed now; a duplicate is reported and left out,
+// so the first table registered keeps the command. Help-only lines are not hashed.
+bool CommandRegistry::add(const ConsoleCommandTable& table, void* module) {
+    if (module == nullptr) return false;
+    if (moduleCount >= COMMAND_MODULES) {
+        LOG_ERR("No room to register " + String(table.title));
+        return false;
+    }
+    uint8_t index       = moduleCount++;
+    modules[index]      = { &table, module };
+
+    bool success = true;
+    for (uint8_t i = 0; i < table.count; i++) {
+        const ConsoleCommand* command = &table.commands[i];
+        const char* name = (command->handler != nullptr) ? command->name : nullptr;
+        while (name != nullptr && *name != 0) {
+            const char* end = strstr(name, " / ");
+            uint8_t length  = (uint8_t)(end != nullptr ? end - name : strlen(name));
+            success        &= insert(name, length, command, index);
+            name            = (end != nullptr) ? end + 3 : nullptr;
+        }
+    }
+    return success;
+}
+
+// Run a command's handler on its module. A handler reports its own errors, so a command that failed
+// is still a known one.
+bool CommandRegistry::dispatch(const CommandArgs& args) const {
+    const Slot* slot = find(args.command());
+    if (slot == nullptr) return false;
+    slot->command->handler(modules[slot->module].context, args);
+    return true;
+}
+
+// Print the help command and title of every table that has one, the console's own excepted
+bool CommandRegistry::printIndex() const {
+    char line[96];
+    for (uint8_t m = 0; m < moduleCount; m++) {
+        const ConsoleCommandTable* table = modules[m].table;
+        for (uint8_t i = 0; i < table->count; i++) {
+            const char* name = table->commands[i].name;
+            if (name == nullptr || name[0] == '?') continue;
+            size_t length = strlen(name);
+            if (name[length - 1] != '?') continue;
+
+            size_t title = strlen(table->title);
+            if (title > 0 && table->title[title - 1] == ':') title--;               // Titles end with a colon
+            snprintf(line, sizeof(line), "  %-17s- Show %.*s", name, (int)title, table->title);
+            PRINTLN(line);
+            break;
+        }
+    }
+    return true;
+}
+
+// Print every table in registration order
+bool CommandRegistry::printAll() const {
+    for (uint8_t m = 0; m < moduleCount; m++) {
+        printHelp(*modules[m].table);
+    }
+    PRINTLN(String(commandCount) + " commands in " + String(moduleCount) + " tables, longest lookup " + String(maxProbe) + " probes");
+    return true;
+}
+
+// Number of command names registered
+uint16_t CommandRegistry::getCommandCount() const {
+    return commandCount;
+}
+
+// Longest probe sequence
+uint16_t CommandRegistry::getMaxProbe() const {
+    return maxProbe;
+}
+
+// Print a table: the title, then one line per command with the help text lined up past the longest
+// command and its arguments
+bool CommandRegistry::printHelp(const ConsoleCommandTable& table) {
+    int width = 16;
+    for (uint8_t i = 0; i < table.count; i++) {
+        const ConsoleCommand& c = table.commands[i];
+        if (c.name == nullptr) continue;
+        int length = (int)(strlen(c.name) + (c.usage[0] != 0 ? 1 + strlen(c.usage) : 0));
+        if (length > width) width = length;
+    }
+
+    PRINTLN(String(table.title) + "\n\r");
+    char left[64];
+    char line[200];
+    for (uint8_t i = 0; i < table.count; i++) {
+        const ConsoleCommand& c = table.commands[i];
+        if (c.name == nullptr) {
+            PRINTLN("");
+            continue;
+        }
+        snprintf(left, sizeof(left), "%s%s%s", c.name, c.usage[0] != 0 ? " " : "", c.usage);
+        snprintf(line, sizeof(line), "  %-*s - %s", width, left, c.help);
+        PRINTLN(line);
+    }
+    PRINTLN("");
+    return true;
+}
+
+// FNV-1a of the name, folded to the slot range
+uint16_t CommandRegistry::hash(const char* name, uint8_t length) {
+    uint32_t h = 2166136261UL;
+    for (uint8_t i = 0; i < length; i++) {
+        h ^= (uint8_t)name[i];
+        h *= 16777619UL;
+    }
+    return (uint16_t)((h ^ (h >> 16)) & (COMMAND_HASH_SIZE - 1));
+}
+
+// Hash one name into the first free slot after its home slot
+bool CommandRegistry::insert(const char* name, uint8_t length, const ConsoleCommand* command, uint8_t module) {
+    if (commandCount >= COMMAND_HASH_SIZE / 2) {
+        LOG_ERR("Command registry is full, raise COMMAND_HASH_SIZE");
+        return false;
+    }
+    uint16_t index = hash(name, length);
+    for (uint16_t probe = 1; ; probe++) {
+        Slot& slot = slots[index];
+        if (slot.name == nullptr) {
+            slot.name       = name;
+            slot.command    = command;
+            slot.length     = length;
+            slot.module     = module;
+            commandCount++;
+            if (probe > maxProbe) maxProbe = probe;
+            return true;
+        }
+        if (slot.length == length && strncmp(slot.name, name, length) == 0) {
+            if (slot.module == module) return true;                                 // Another usage line, the first entry runs it
+            LOG_ERR("Console command " + String(name).substring(0, length) + " of " + String(modules[module].table->title)
+                    + " is already registered by " + String(modules[slot.module].table->title));
+            return false;
+        }
+        index = (index + 1) & (COMMAND_HASH_SIZE - 1);
+    }
+}
+
+// Slot of a name, nullptr if unknown
+const CommandRegistry::Slot* CommandRegistry::find(const char* name) const {
+    size_t length = strlen(name);
+    if (length == 0 || length > 255) return nullptr;
+    uint16_t index = hash(name, (uint8_t)length);
+    for (uint16_t probe = 0; probe < COMMAND_HASH_SIZE; probe++) {
+        const Slot& slot = slots[index];
+        if (slot.name == nullptr) return nullptr;
+        if (slot.length == length && strncmp(slot.name, name, length) == 0) return &slot;
+        index = (index + 1) & (COMMAND_HASH_SIZE - 1);
+    }
+    return nullptr;
+}
+
+// end of CommandRegistry.cpp
@@ -0,0 +1,94 @@
+#ifndef COMMANDREGISTRY_H
+#define COMMANDREGISTRY_H
+
+    #include <Arduino.h>
+
+    #define COMMAND_MODULES         uint8_t(24)         // Command tables that can be registered
+    #define COMMAND_HASH_SIZE       uint16_t(512)       // Hash slots, a power of two over twice the number of commands
+    #define COMMAND_LINE_MAX        uint8_t(128)        // Longest command line
+    #define COMMAND_ARGS_MAX        uint8_t(8)          // Arguments tokenized per line, the rest stays in rest()
+
+    class CommandArgs;
+    typedef bool (*CommandHandler)(void* module, const CommandArgs& args);          // Runs one command on its module instance, false if it failed
+
+    // One console command. The help output is generated from these, so a command that is not in its
+    // module's table can not be reached either. A name may repeat in its table for another usage line,
+    // the first entry of a name runs it.
+    struct ConsoleCommand {
+        const char*     name;                           // Command, alternatives separated by " / ", nullptr for a blank help line
+        const char*     usage;                          // Arguments shown in the help, "" if none
+        const char*     help;                           // Help text
+        CommandHandler  handler;                        // Runs the command, nullptr on help-only lines
+    };
+
+    // A module's commands, in help order
+    struct ConsoleCommandTable {
+        const char*             title;                  // Help title
+        const ConsoleCommand*   commands;               // Commands and blank lines
+        uint8_t                 count;                  // Entries in commands
+    };
+
+    // A command line split in place: lowercased, the command and up to COMMAND_ARGS_MAX arguments
+    // as separate strings, and the whole argument text for handlers that scan it themselves.
+    class CommandArgs {
+        public:
+            CommandArgs();                                                          // Constructor
+            bool            parse(const char* line);                                // Split a line, false if empty or too long
+
+            const char*     command() const;                                        // The command
+            uint8_t         count() const;                                          // Number of arguments tokenized
+            const char*     get(uint8_t index) const;                               // Argument index, "" if missing
+            long            toInt(uint8_t index, long fallback) const;              // Argument index as a number, fallback if missing
+            const char*     rest() const;                                           // All argument text, trimmed
+
+        private:
+            char            text[COMMAND_LINE_MAX];                                 // Command, then the argument text
+            char            tokens[COMMAND_LINE_MAX];                               // Copy of the argument text split at spaces
+            const char*     args;                                                   // Start of the argument text in text
+            const char*     argv[COMMAND_ARGS_MAX];                                 // Arguments in tokens
+            uint8_t         argc;                                                   // Number of arguments
+    };
+
+    // Finds the handler of a command with one hash lookup instead of asking every module in turn. Tables
+    // are hashed when registered (FNV-1a, linear probing) and every name keeps its own entry, so dispatch
+    // costs one hash of the name, usually one string compare and a call of the command's handler with
+    // the module instance and the tokenized arguments.
+    class CommandRegistry {
+        public:
+            CommandRegistry();                                                      // Constructor
+
+            bool            add(const ConsoleCommandTable& table, void* module);    // Register a module's table, a nullptr module is skipped
+
+            bool            dispatch(const CommandArgs& args) const;                // Run a command, false only if unknown
+            bool            printIndex() const;                                     // Print the help command of every table
+            bool            printAll() const;                                       // Print every table
+            uint16_t        getCommandCount() const;                                // Number of command names registered
+            uint16_t        getMaxProbe() const;                                    // Longest probe sequence, 1 means no collisions
+
+            static bool     printHelp(const ConsoleCommandTable& table);            // Print a table as help
+
+        private:
+            struct Slot {
+                const char*             name;                                       // Start of the name in its table, nullptr if free
+                const ConsoleCommand*   command;                                    // Entry the name runs
+                uint8_t                 length;                                     // Name length, alternatives are separate slots
+                uint8_t                 module;                                     // Index into modules
+            };
+
+            struct Module {
+                const ConsoleCommandTable*  table;                                  // Commands and help
+                void*                       context;                                // Module instance passed to the handlers
+            };
+
+            Slot            slots[COMMAND_HASH_SIZE];                               // Open addressing hash of command names
+            Module          modules[COMMAND_MODULES];                               // Registered tables
+            uint8_t         moduleCount;                                            // Used entries in modules
+            uint16_t        commandCount;                                           // Used slots
+            uint16_t        maxProbe;                                               // Longest probe sequence so far
+
+            static uint16_t hash(const char* name, uint8_t length);                 // FNV-1a folded to the slot range
+            bool            insert(const char* name, uint8_t length, const ConsoleCommand* command, uint8_t module);  // Hash one name, false on a duplicate or when full
+            const Slot*     find(const char* name) const;                           // Slot of a name, nullptr if unknown
+    };
+
+#endif // COMMANDREGISTRY_H
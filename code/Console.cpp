@@ -12,7 +12,14 @@ Console::Console(   Stream* stream,
                     Turret* turret,
                     AXS1Sensor* sensor,
                     GaitController* gc,
-                    Remotecontroller* rc
+                    Remotecontroller* rc,
+                    Scheduler* scheduler,
+                    MotionPlayer* motion,
+                    Recorder* recorder,
+                    FootContact* contact,
+                    ServoEstimator* estimator,
+                    StateStage* stateStage,
+                    Telemetry* telemetry
                     ){
 
     log::setLogStream(stream);                // Set the log stream to the same stream
@@ -31,8 +38,17 @@ Console::Console(   Stream* stream,
     this->sensor    = sensor;           // Store the AXS1Sensor instance
     this->gc        = gc;               // Store the GaitController instance
     this->rc        = rc;               // Store the RemoteController instance
+    this->scheduler = scheduler;        // Store the Scheduler instance
+    this->motion    = motion;           // Store the MotionPlayer instance
+    this->recorder  = recorder;         // Store the Recorder instance
+    this->contact   = contact;          // Store the FootContact instance
+    this->estimator = estimator;        // Store the ServoEstimator instance
+    this->stateStage = stateStage;      // Store the StateStage instance
+    this->telemetry = telemetry;        // Store the Telemetry instance
 
     shell           = "$";              // Default shell prompt
+    inputBuffer[0]  = 0;                // Empty input line
+    inputLength     = 0;
     cursorPos       = 0;                // Start cursor at position 0
     insertMode      = true;             // Default to insert mode
 }
@@ -49,6 +65,27 @@ bool Console::begin() {
         while (!Serial);                            // Wait for Serial if using USB
     }
 
+    // Hash every command once; the console is registered first so it keeps its names. Help is
+    // printed in this order too.
+    registry.add(commandTable, this);
+    registry.add(Microcontroller::commandTable, mc);
+    registry.add(Driver::commandTable, driver);
+    registry.add(Servo::commandTable, servo);
+    registry.add(Hexapod::commandTable, hexapod);
+    registry.add(Leg::commandTable, hexapod);                   // Leg commands select their leg of the hexapod
+    registry.add(Turret::commandTable, turret);
+    registry.add(AXS1Sensor::commandTable, sensor);
+    registry.add(BodyPose::commandTable, bodyPose);
+    registry.add(GaitController::commandTable, gc);
+    registry.add(Remotecontroller::commandTable, rc);
+    registry.add(Scheduler::commandTable, scheduler);
+    registry.add(MotionPlayer::commandTable, motion);
+    registry.add(Recorder::commandTable, recorder);
+    registry.add(FootContact::commandTable, contact);
+    registry.add(ServoEstimator::commandTable, estimator);
+    registry.add(StateStage::commandTable, stateStage);
+    registry.add(Telemetry::commandTable, telemetry);
+
     PRINT("\033[2J\033[H");                         // ANSI escape code: clear screen and move cursor to top-left
     PRINTLN("SpiderBot Firmware v1.0 (c) 2025");
     LOG_INF("Console initialized successfully.");   // Log initialization message
@@ -61,6 +98,7 @@ bool Console::startShell() {
     PRINTLN("Type '?' for help.");      // Print help message
     commandHistory.resetToEnd();        // Reset command history to end
     PRINT(shell);                       // Print the shell prompt
+    log::setBuffered(true);             // From here on output is queued and sent by update
     return true;
 }
 
@@ -75,71 +113,49 @@ bool Console::update() {
             handleInputControl(c);      // Control characters and special sequences
         }
     }
+    log::drain();                       // Print deferred log records in idle time
+    log::transmit();                    // Send a budget of queued output, never waiting for the link
     return true;
 }
 
 // Process the command entered by the user
-void Console::processInput(const String& input) {
-    
-    String cmd = input;
-    String mainCmd, args;
-
-    cmd.trim();                                     // Remove leading/trailing whitespace
-    cmd.toLowerCase();                              // Convert to lowercase for consistent handling
-    if (cmd.length() == 0) return;                  // Skip empty commands
+void Console::processInput(const char* input) {
+    if (!commandArgs.parse(input)) return;          // Skip empty commands
     commandHistory.addCommand(input);               // Add original command to history
-    int spaceIndex = cmd.indexOf(' ');              // Find the first space character
-    if (spaceIndex != -1) {                         // If a space is found
-        mainCmd = cmd.substring(0, spaceIndex);     // Extract main command
-        args = cmd.substring(spaceIndex + 1);       // Extract arguments
-        args.trim();                                // Remove leading/trailing whitespace
 
-    } else {
-        mainCmd = cmd;
+    // One hash lookup finds the module that owns the command
+    if (!registry.dispatch(commandArgs)) {
+        char message[COMMAND_LINE_MAX + 24];
+        snprintf(message, sizeof(message), "Unknown command: %s", input);
+        LOG_ERR(message);                           // Unknown command
+        PRINTLN("Type '?' for help.");
     }
-
-    // Execute command using organized command handlers
-    if (!runConsoleCommands(mainCmd, args) &&
-        !mc->runConsoleCommands(mainCmd, args) &&
-        !driver->runConsoleCommands(mainCmd, args) &&
-        !servo->runConsoleCommands(mainCmd, args) &&
-        !hexapod->runConsoleCommands(mainCmd, args) &&
-        !runLegCommand(mainCmd, args) &&                    
-        !turret->runConsoleCommands(mainCmd, args) &&
-        !bodyPose->runConsoleCommands(mainCmd, args) &&
-        !sensor->runConsoleCommands(mainCmd, args) &&
-        !gc->runConsoleCommands(mainCmd, args) &&
-        !rc->runConsoleCommands(mainCmd, args)) {
-            LOG_ERR("Unknown command: " + input);   // Unknown command
-            PRINTLN("Type '?' for help.");
-        }
 }
 
-// Handle printable character input and display
+// Handle printable character input and display. The line is edited in place: an insert shifts the
+// rest of the line right by one, and a full line rings the bell instead of growing.
 void Console::handlePrintableChar(char c) {
-    if (insertMode) {
-        if (cursorPos < (int)inputBuffer.length()) {            // Insert mode: insert character at cursor position
-            String before = inputBuffer.substring(0, cursorPos);    // Insert character in the middle of the string
-            String after = inputBuffer.substring(cursorPos);
-            inputBuffer = before + c + after;
+    if (insertMode || cursorPos >= inputLength) {
+        if (inputLength >= COMMAND_LINE_MAX - 1) {
+            PRINT('\a');                                        // Line is full
+            return;
+        }
+        memmove(inputBuffer + cursorPos + 1, inputBuffer + cursorPos, inputLength - cursorPos + 1);  // Open a gap, terminator included
+        inputBuffer[cursorPos] = c;
+        inputLength++;
+
+        if (cursorPos < inputLength - 1) {                      // Insert mode: insert character at cursor position
             PRINT("\033[K");                                // Clear from cursor to end and reprint
-            String remaining = inputBuffer.substring(cursorPos);
-            PRINT(remaining);
-            for (int i = remaining.length() - 1; i > 0; i--) {  // Move cursor back to position after inserted character
+            PRINT(inputBuffer + cursorPos);
+            for (int i = inputLength - cursorPos - 1; i > 0; i--) {  // Move cursor back to position after inserted character
                 PRINT("\033[D");
             }
         } else {
-            inputBuffer += c;                                   // At end of string, just append and echo
-            stream->write(c);
+            PRINT(c);                                           // At end of line, just echo
         }
     } else {
-        if (cursorPos < (int)inputBuffer.length()) {            // Overwrite mode: replace character at cursor position
-            inputBuffer.setCharAt(cursorPos, c);                // Replace character at cursor position
-            stream->write(c);                                       // Echo the character
-        } else {
-            inputBuffer += c;                                   // At end of string, append new character
-            stream->write(c);                                       // Echo the character
-        }
+        inputBuffer[cursorPos] = c;                             // Overwrite mode: replace character at cursor position
+        PRINT(c);                                               // Echo the character
     }
     cursorPos++;
 }
@@ -300,19 +316,19 @@ void Console::handleExtendedKey(char keyCode) {
 
 // Arrow key handlers
 void Console::handleArrowUp() {
-    String prevCommand = commandHistory.getPrevious();
-    if (prevCommand.length() > 0) {
+    const char* prevCommand = commandHistory.getPrevious();
+    if (prevCommand[0] != 0) {
         clearAndRedrawLine(prevCommand);
     }
 }
 
 void Console::handleArrowDown() {
-    String nextCommand = commandHistory.getNext();
+    const char* nextCommand = commandHistory.getNext();
     clearAndRedrawLine(nextCommand);
 }
 
 void Console::handleArrowRight() {
-    if (cursorPos < (int)inputBuffer.length()) {
+    if (cursorPos < inputLength) {
     PRINT("\033[C");
         cursorPos++;
     }
@@ -334,7 +350,7 @@ void Console::handleHome() {
 }
 
 void Console::handleEnd() {
-    while (cursorPos < (int)inputBuffer.length()) {
+    while (cursorPos < inputLength) {
     PRINT("\033[C");
         cursorPos++;
     }
@@ -348,8 +364,9 @@ void Console::handleInsertKey() {
 }
 
 void Console::handleDeleteKey() {
-    if (cursorPos < (int)inputBuffer.length()) {
-        inputBuffer.remove(cursorPos, 1);
+    if (cursorPos < inputLength) {
+        memmove(inputBuffer + cursorPos, inputBuffer + cursorPos + 1, inputLength - cursorPos);  // Close the gap, terminator included
+        inputLength--;
         refreshLineFromCursor();
     }
 }
@@ -357,7 +374,8 @@ void Console::handleDeleteKey() {
 void Console::handleBackspace() {
     if (cursorPos > 0) {
         cursorPos--;
-        inputBuffer.remove(cursorPos, 1);
+        memmove(inputBuffer + cursorPos, inputBuffer + cursorPos + 1, inputLength - cursorPos);
+        inputLength--;
     PRINT("\b");
         refreshLineFromCursor();
     }
@@ -365,13 +383,14 @@ void Console::handleBackspace() {
 
 void Console::handleClearScreen() {
     PRINT("\033[2J\033[H");                                 // Clear screen and move cursor to home
-    inputBuffer = "";
+    inputBuffer[0] = 0;
+    inputLength = 0;
     cursorPos = 0;
     PRINT(shell);
 }
 
 void Console::handleNewline() {
-    if (inputBuffer.length() > 0) {
+    if (inputLength > 0) {
         PRINT("\n\r");
         processInput(inputBuffer);
         resetInputState();
@@ -383,7 +402,7 @@ void Console::handleNewline() {
 }
 
 // Clear current input line and redraw with new content
-void Console::clearAndRedrawLine(const String& newContent) {
+void Console::clearAndRedrawLine(const char* newContent) {
     // Move cursor to beginning of input
     while (cursorPos > 0) {
     PRINT("\b");
@@ -394,26 +413,28 @@ void Console::clearAndRedrawLine(const String& newContent) {
     PRINT("\033[K");                                        // Clear from cursor to end of line
     
     // Set new content and redraw
-    inputBuffer = newContent;
+    strncpy(inputBuffer, newContent, COMMAND_LINE_MAX - 1);
+    inputBuffer[COMMAND_LINE_MAX - 1] = 0;
+    inputLength = strlen(inputBuffer);
     PRINT(inputBuffer);
-    cursorPos = inputBuffer.length();
+    cursorPos = inputLength;
 }
 
 // Refresh line after cursor position changes
 void Console::refreshLineFromCursor() {
     PRINT("\033[K");                                        // Clear from cursor to end
-    String remaining = inputBuffer.substring(cursorPos);
-    PRINT(remaining);
+    PRINT(inputBuffer + cursorPos);
 
     // Move cursor back to correct position
-    for (int i = 0; i < (int)remaining.length(); i++) {
+    for (int i = 0; i < inputLength - cursorPos; i++) {
     PRINT("\033[D");
     }
 }
 
 // Helper to reset input state after command processing
 void Console::resetInputState() {
-    inputBuffer = "";
+    inputBuffer[0] = 0;
+    inputLength = 0;
     cursorPos = 0;
     commandHistory.resetToEnd();
     insertMode = true;
@@ -422,75 +443,77 @@ void Console::resetInputState() {
 
 //--------------------------------------------------------------------------------------------------------------------------------
 
-// System commands (help, cls, status)
-bool Console::runConsoleCommands(const String& cmd, const String& args) {
-    if (cmd == "?" || cmd == "h") {
-        printConsoleHelp();
-        return true;
-    
-    } else if (cmd == "??") {
-        printAllHelp();
-        return true;
+// ? / h: Print the console help and the help command of every module
+bool Console::showHelp(void* console, const CommandArgs&) {
+    return static_cast<Console*>(console)->printConsoleHelp();
+}
 
-    } else if (cmd == "cls" || cmd == "clear") {
-        PRINT("\033[2J\033[H");                     // ANSI escape code to clear screen and move cursor to home
-        PRINT(shell);
-        return true;
+// ??: Print every command
+bool Console::showAllHelp(void* console, const CommandArgs&) {
+    return static_cast<Console*>(console)->printAllHelp();
+}
 
-    } else if (cmd == "debug") {
-        // Set debug level: debug 0-4
-        if (args.length() > 0) {
-            int level = args.toInt();
-            if (level >= DEBUG_NON && level <= DEBUG_DBG) {
-                log::setDebugLevel((DebugLevel)level);
-                LOG_INF("Debug level set to: " + String(level));
-            } else {
-                LOG_ERR("Invalid debug level. Use 0-4 (0=NON, 1=ERR, 2=WRN, 3=INF, 4=DBG)");
-            }
+// cls / clear: Clear the terminal screen
+bool Console::clearScreen(void* console, const CommandArgs&) {
+    PRINT("\033[2J\033[H");                     // ANSI escape code to clear screen and move cursor to home
+    PRINT(static_cast<Console*>(console)->shell);
+    return true;
+}
 
-        } else {
-            PRINTLN("Current debug level: " + String(log::getDebugLevel()));
-        }
+// debug [0-4]: Set the debug level, print it without argument
+bool Console::setDebugLevel(void*, const CommandArgs& args) {
+    if (args.count() == 0) {
+        PRINTLN("Current debug level: " + String(log::getDebugLevel()));
         return true;
+    }
+    long level = args.toInt(0, -1);
+    if (level < DEBUG_NON || level > DEBUG_DBG) {
+        LOG_ERR("Invalid debug level. Use 0-4 (0=NON, 1=ERR, 2=WRN, 3=INF, 4=DBG)");
+        return false;
+    }
+    log::setDebugLevel((DebugLevel)level);
+    LOG_INF("Debug level set to: " + String(level));
+    return true;
+}
 
-    } else if (cmd == "color") {
-        // Toggle color output: color on/off
-        if (args == "on" || args == "1" || args == "true") {
-            log::setColorEnabled(true);
-        } else if (args == "off" || args == "0" || args == "false") {
-            log::setColorEnabled(false);
-        } else {
-            PRINTLN("Current color setting: " + String(log::getColorEnabled() ? "enabled" : "disabled"));
-        }
-        return true;
+// color [on/off]: Enable or disable color output, print the setting otherwise
+bool Console::setColor(void*, const CommandArgs& args) {
+    const char* arg = args.get(0);
+    if (strcmp(arg, "on") == 0 || strcmp(arg, "1") == 0 || strcmp(arg, "true") == 0) {
+        log::setColorEnabled(true);
+    } else if (strcmp(arg, "off") == 0 || strcmp(arg, "0") == 0 || strcmp(arg, "false") == 0) {
+        log::setColorEnabled(false);
+    } else {
+        PRINTLN("Current color setting: " + String(log::getColorEnabled() ? "enabled" : "disabled"));
+    }
+    return true;
+}
+
+// logs [flush]: Print the deferred log and console output rings, flush sends them now
+bool Console::showLogs(void*, const CommandArgs& args) {
+    if (strcmp(args.get(0), "flush") == 0) {
+        while (log::drain() > 0) {}
+        log::flush();
+    }
+    PRINTLN("Deferred log     : " + String(log::getPending()) + " / " + String(LOG_RING_SIZE) + " pending | "
+            + String(log::getDropped()) + " dropped | compiled up to level " + String(LOG_LEVEL));
+    PRINTLN("Console output   : " + String(log::getTxPending()) + " / " + String(LOG_TX_SIZE) + " bytes queued | peak "
+            + String(log::getTxPeak()) + " | " + String(log::getTxDropped()) + " bytes dropped | "
+            + String(log::getTxDroppedErrors()) + " error lines dropped | " + (log::isBuffered() ? "buffered" : "direct"));
+    return true;
+}
 
-    } else if (cmd == "test") {
-        // Test all log levels
+// test: Print a message of every log level
+bool Console::testLogs(void*, const CommandArgs&) {
     PRINTLN("This is a normal message");
     LOG_ERR("This is an error message");
     LOG_WRN("This is a warning message");
     LOG_INF("This is an info message");
     LOG_DBG("This is a debug message");
+    LOGF_INF("This is a deferred info message, %d of %d", 1, 1);
     PRINTLN("Current debug level: " + String(log::getDebugLevel()));
     PRINTLN("Color output is " + String(log::getColorEnabled() ? "enabled" : "disabled"));
-        return true;
-
-    } 
-    return false;
-}
-
-// Leg control commands (operates on leg 0 by default, could be extended for specific legs)
-bool Console::runLegCommand(const String& cmd, const String& args) {
-    int legIndex = 0; // Default to leg 0
-    if (args.length() > 0) {
-        legIndex = args.toInt();
-        if (legIndex < 0 || legIndex >= HEXAPOD_LEGS) {
-            legIndex = 0;
-        }
-    }
-    
-    // Call the specific leg's runConsoleCommands method
-    return hexapod->legs[legIndex].runConsoleCommands(cmd, args, legIndex);
+    return true;
 }
 
 //Print comprehensive help information
@@ -499,18 +522,9 @@ bool Console::printAllHelp() {
     PRINTLN("SpiderBot Console - Available Commands:");
     PRINTLN("");
     
-    // Print help for each component
-    if (!this->printConsoleHelp()) return false;
-    if (!mc->printConsoleHelp()) return false;
-    if (!driver->printConsoleHelp()) return false;
-    if (!servo->printConsoleHelp()) return false;
-    if (!hexapod->printConsoleHelp()) return false;
-    if (!hexapod->legs[0].printConsoleHelp()) return false;
-    if (!turret->printConsoleHelp()) return false;
-    if (!sensor->printConsoleHelp()) return false;
-    if (!bodyPose->printConsoleHelp()) return false;
-    if (!gc->printConsoleHelp()) return false;
-    if (!rc->printConsoleHelp()) return false;
+    // Print help for each component, from the registered tables
+    if (!registry.printAll()) return false;
+    PRINTLN("");
 
     // Show examples for common commands
     PRINTLN("Examples: 'lpu 2' moves leg 2 point up, 'sbu 72 200' plays note, 'mlon 3' turns on user LED 3");
@@ -518,26 +532,23 @@ bool Console::printAllHelp() {
     return true;
 }
 
-// Print console-specific help information
+// Console commands, the help is printed from this table
+static const ConsoleCommand consoleCommands[] = {
+    { "? / h",       "",         "Show this help message",                                     Console::showHelp },
+    { "??",          "",         "Show all available commands",                                Console::showAllHelp },
+    { nullptr,       "",         "",                                                           nullptr },
+    { "cls / clear", "",         "Clear the terminal screen",                                  Console::clearScreen },
+    { "debug",       "[0-4]",    "Set debug level (0=NONE, 1=ERROR, 2=WARN, 3=INFO, 4=ALL)",   Console::setDebugLevel },
+    { "color",       "[on/off]", "Enable/disable color output",                                Console::setColor },
+    { "logs",        "[flush]",  "Show the log and output rings, flush sends them now",        Console::showLogs },
+    { "test",        "",         "Test all log message types",                                 Console::testLogs },
+};
+const ConsoleCommandTable Console::commandTable = { "Console Commands:", consoleCommands, sizeof(consoleCommands) / sizeof(consoleCommands[0]) };
+
+// Print console-specific help information, then the help command of every module
 bool Console::printConsoleHelp() {
-    PRINTLN("Console Commands:\n\r");
-    PRINTLN("  ? / h            - Show this help message");
-    PRINTLN("  ??               - Show all available commands");
-    PRINTLN("");
-    PRINTLN("  d?               - Show driver commands");
-    PRINTLN("  s?               - Show servo commands");
-    PRINTLN("  h?               - Show hexapod commands");
-    PRINTLN("  l?               - Show leg commands");
-    PRINTLN("  a?               - Show AX-S1 Sensor commands");
-    PRINTLN("  t?               - Show turret commands");
-    PRINTLN("  b?               - Show body pose commands");
-    PRINTLN("  g?               - Show gait controller commands");
-    PRINTLN("  r?               - Show remote controller commands");
-    PRINTLN("");
-    PRINTLN("  cls / clear      - Clear the terminal screen");
-    PRINTLN("  debug [0-4]      - Set debug level (0=NONE, 1=ERROR, 2=WARN, 3=INFO, 4=ALL)");
-    PRINTLN("  color [on/off]   - Enable/disable color output");
-    PRINTLN("  test             - Test all log message types");
+    if (!CommandRegistry::printHelp(commandTable)) return false;
+    if (!registry.printIndex()) return false;
     PRINTLN("");
     return true;
 }
@@ -14,6 +14,14 @@
     #include "AXS1Sensor.h"         // Include AXS1Sensor class for sensor management
     #include "GaitController.h"     // Include GaitController for movement control
     #include "Remotecontroller.h"   // Include RemoteController class for remote control input
+    #include "Scheduler.h"          // Include Scheduler class for main loop task scheduling
+    #include "MotionPlayer.h"       // Include MotionPlayer class for RoboPlus motion playback
+    #include "Recorder.h"           // Include Recorder class for teach-and-replay recording
+    #include "FootContact.h"        // Include FootContact class for foot contact estimation
+    #include "ServoEstimator.h"     // Include ServoEstimator class for servo position estimation
+    #include "StateStage.h"         // Include StateStage class for the robot state snapshot
+    #include "Telemetry.h"          // Include Telemetry class for the binary telemetry stream
+    #include "CommandRegistry.h"    // Include CommandRegistry class for command dispatch and help
 
     class Console {
         public:
@@ -27,20 +35,39 @@
                         Turret*             turret  = nullptr,      // Pointer to Turret instance
                         AXS1Sensor*         sensor  = nullptr,      // Pointer to AXS1Sensor instance
                         GaitController*     gc      = nullptr,      // Pointer to GaitController instance
-                        Remotecontroller*   rc      = nullptr       // Pointer to RemoteController instance
+                        Remotecontroller*   rc      = nullptr,      // Pointer to RemoteController instance
+                        Scheduler*          scheduler = nullptr,    // Pointer to Scheduler instance
+                        MotionPlayer*       motion  = nullptr,      // Pointer to MotionPlayer instance
+                        Recorder*           recorder = nullptr,     // Pointer to Recorder instance
+                        FootContact*        contact = nullptr,      // Pointer to FootContact instance
+                        ServoEstimator*     estimator = nullptr,    // Pointer to ServoEstimator instance
+                        StateStage*         stateStage = nullptr,   // Pointer to StateStage instance
+                        Telemetry*          telemetry = nullptr     // Pointer to Telemetry instance
             );
 
             bool begin();                                           // Initialize the console
             bool startShell();                                      // Start the shell
             bool update();                                          // Call in loop()
 
+            // Handlers of the console's own commands, members as they print the help and the prompt
+            static bool showHelp(void* console, const CommandArgs& args);       // ? / h
+            static bool showAllHelp(void* console, const CommandArgs& args);    // ??
+            static bool clearScreen(void* console, const CommandArgs& args);    // cls / clear
+            static bool setDebugLevel(void* console, const CommandArgs& args);  // debug [0-4]
+            static bool setColor(void* console, const CommandArgs& args);       // color [on/off]
+            static bool showLogs(void* console, const CommandArgs& args);       // logs [flush]
+            static bool testLogs(void* console, const CommandArgs& args);       // test
+
         private:
             Stream*             stream;                             // Pointer to the stream for input/output
-            String              inputBuffer     = "";               // Buffer to store the input command
+            char                inputBuffer[COMMAND_LINE_MAX];      // Input line being edited, always terminated
+            uint8_t             inputLength     = 0;                // Characters in inputBuffer
             String              shell           = "$";              // Shell prompt string
             int                 cursorPos       = 0;                // Current cursor position in input buffer
             bool                insertMode      = true;             // Insert mode flag (true=insert, false=overwrite)
             CommandHistory      commandHistory;                     // Command history management
+            CommandRegistry     registry;                           // Command names hashed to their modules
+            CommandArgs         commandArgs;                        // The command line being run, tokenized
             
             // Pointers to instances
             Microcontroller*    mc;                                 // Pointer to Microcontroller instance
@@ -52,9 +79,16 @@
             AXS1Sensor*         sensor;                             // Pointer to AXS1Sensor instance (can be nullptr)
             GaitController*     gc;                                 // Pointer to GaitController instance
             Remotecontroller*   rc;                                 // Pointer to RemoteController instance
+            Scheduler*          scheduler;                          // Pointer to Scheduler instance
+            MotionPlayer*       motion;                             // Pointer to MotionPlayer instance
+            Recorder*           recorder;                           // Pointer to Recorder instance
+            FootContact*        contact;                            // Pointer to FootContact instance
+            ServoEstimator*     estimator;                          // Pointer to ServoEstimator instance
+            StateStage*         stateStage;                         // Pointer to StateStage instance
+            Telemetry*          telemetry;                          // Pointer to Telemetry instance
 
             // Input processing methods
-            void processInput(const String& input);                 // Process the input entered by the user
+            void processInput(const char* input);                   // Process the input entered by the user
             void handlePrintableChar(char c);                       // Handle printable character input and display
             void handleInputControl(char c);                        // Handle all input control operations
             
@@ -84,15 +118,14 @@
             void handleNewline();                                   // Enter - process command
             
             // Input helper methods
-            void clearAndRedrawLine(const String& newContent);     // Clear line and redraw with new content
+            void clearAndRedrawLine(const char* newContent);        // Clear line and redraw with new content
             void refreshLineFromCursor();                           // Refresh display from cursor position
             void resetInputState();                                 // Reset input state after command
 
             // Console Command Execution and Help
-            bool runConsoleCommands(const String& cmd, const String& args);     // System commands (help, cls, status)
-            bool runLegCommand(const String& cmd, const String& args);          // Leg control commands
             bool printAllHelp();                                       // Print comprehensive help information
             bool printConsoleHelp();                                // Print console-specific help information
+            static const ConsoleCommandTable commandTable;          // Console commands and their help
         
 
     };
@@ -0,0 +1,102 @@
+#include "ControlTick.h"
+#include "Console.h"
+#include "Debug.h"
+
+ControlTick* ControlTick::instance = nullptr;
+
+// Constructor for ControlTick
+ControlTick::ControlTick() : timer(CONTROL_TICK_TIMER) {
+    stage       = nullptr;
+    period      = CONTROL_TICK_PERIOD;
+    tickCount   = 0;
+    maxTickTime = 0;
+    overruns    = 0;
+}
+
+// Attach the control stage and start the hardware timer
+bool ControlTick::begin(uint32_t period, TickFunction stage) {
+    if (stage == nullptr || period == 0) {
+        LOG_ERR("Invalid control tick stage or period.");
+        return false;
+    }
+    if (instance != nullptr && instance != this) {
+        LOG_ERR("Control tick timer is already in use.");
+        return false;
+    }
+
+    this->stage  = stage;
+    this->period = period;
+    resetStats();
+    instance     = this;
+
+    timer.stop();
+    timer.setPeriod(period);
+    timer.attachInterrupt(isr);
+    timer.refresh();
+    timer.start();
+
+    LOG_INF("Control tick started. (" + String(1000000UL / period) + " Hz)");
+    return true;
+}
+
+// Stop the hardware timer
+bool ControlTick::stop() {
+    timer.stop();
+    timer.detachInterrupt();
+    instance = nullptr;
+    return true;
+}
+
+// Get the tick period in us
+uint32_t ControlTick::getPeriod() const {
+    return period;
+}
+
+// Get the number of ticks since begin()
+uint32_t ControlTick::getTickCount() const {
+    return tickCount;
+}
+
+// Get the longest stage execution time in us
+uint32_t ControlTick::getMaxTickTime() const {
+    return maxTickTime;
+}
+
+// Get the number of ticks whose stage took longer than the period
+uint32_t ControlTick::getOverruns() const {
+    return overruns;
+}
+
+// Clear tick statistics
+void ControlTick::resetStats() {
+    noInterrupts();
+    tickCount   = 0;
+    maxTickTime = 0;
+    overruns    = 0;
+    interrupts();
+}
+
+// Timer interrupt handler, runs the control stage and times it
+void ControlTick::isr() {
+    ControlTick* self = instance;
+    if (self == nullptr || self->stage == nullptr) return;
+
+    uint32_t start = micros();
+    self->stage();
+    uint32_t elapsed = micros() - start;
+
+    self->tickCount = self->tickCount + 1;
+    if (elapsed > self->maxTickTime) self->maxTickTime = elapsed;
+    if (elapsed > self->period)      self->overruns    = self->overruns + 1;
+}
+
+// Print tick statistics
+bool ControlTick::printStatus() {
+    PRINTLN("Control Tick     : " + String(1000000UL / period) + " Hz"
+            + " | Ticks " + String(getTickCount())
+            + " | Max " + String(getMaxTickTime()) + " us"
+            + " | Overruns " + String(getOverruns()));
+    return true;
+}
+
+// end of ControlTick.cpp
@@ -0,0 +1,39 @@
+#ifndef CONTROL_TICK_H
+#define CONTROL_TICK_H
+
+    #include <Arduino.h>
+
+    #define CONTROL_TICK_TIMER      TIMER_CH1           // OpenCR hardware timer channel used for the control tick
+    #define CONTROL_TICK_PERIOD     uint32_t(10000)     // Default control tick period in us (100 Hz)
+
+    typedef void (*TickFunction)();                     // Control stage, called from the timer interrupt
+
+    // Hardware-timer-driven control tick. The tick stage runs in interrupt context,
+    // so it must only compute setpoints and must never touch the Dynamixel bus or the console.
+    class ControlTick {
+        public:
+            ControlTick();                                                  // Constructor
+            bool            begin(uint32_t period, TickFunction stage);     // Attach the stage and start the timer
+            bool            stop();                                         // Stop the timer
+
+            uint32_t        getPeriod() const;                              // Get the tick period in us
+            uint32_t        getTickCount() const;                           // Get the number of ticks since begin()
+            uint32_t        getMaxTickTime() const;                         // Get the longest stage execution time in us
+            uint32_t        getOverruns() const;                            // Get the number of ticks that took longer than the period
+            void            resetStats();                                   // Clear tick statistics
+
+            bool            printStatus();                                  // Print tick statistics
+
+        private:
+            static void     isr();                                          // Timer interrupt handler
+            static ControlTick* instance;                                   // Instance served by the interrupt handler
+
+            HardwareTimer       timer;                                      // OpenCR hardware timer
+            TickFunction        stage;                                      // Control stage called every tick
+            uint32_t            period;                                     // Tick period in us
+            volatile uint32_t   tickCount;                                  // Number of ticks since begin()
+            volatile uint32_t   maxTickTime;                                // Longest stage execution time in us
+            volatile uint32_t   overruns;                                   // Ticks that took longer than the period
+    };
+
+#endif // CONTROL_TICK_H
@@ -15,6 +15,25 @@ Stream*     log::logStream       = &Serial;      // Default to Serial for loggin
 DebugLevel  log::debugLevel      = DEBUG_INF;    // Default debug level
 bool        log::colorEnabled    = true;         // Default color enabled
 
+LogRecord               log::ring[LOG_RING_SIZE];
+std::atomic<uint16_t>   log::head(0);
+std::atomic<uint16_t>   log::tail(0);
+std::atomic<uint32_t>   log::dropped(0);
+uint32_t                log::droppedReported = 0;
+
+char                    log::tx[LOG_TX_SIZE];
+volatile uint16_t       log::txHead             = 0;
+volatile uint16_t       log::txTail             = 0;
+bool                    log::buffered           = false;
+uint16_t                log::txPeak             = 0;
+uint32_t                log::txDropped          = 0;
+uint32_t                log::txDroppedErrors    = 0;
+uint32_t                log::txDroppedReported  = 0;
+
+// Header and color of each DebugLevel
+static const char* const levelPrefix[] = { "", LOG_HEADER_ERROR, LOG_HEADER_WARNING, LOG_HEADER_INFO, LOG_HEADER_DEBUG };
+static const char* const levelColor[]  = { "", COLOR_RED, COLOR_YELLOW, COLOR_WHITE, COLOR_CYAN };
+
 // Static method to set debug level
 void log::setDebugLevel(DebugLevel level) {
     debugLevel = level;
@@ -35,7 +54,8 @@ void log::print(const String& message) {
     }
     
     // Print message directly without debug level check, timestamp, or color formatting
-    logStream->print(message);
+    const char* parts[] = { message.c_str() };
+    output(DEBUG_INF, parts, 1);
 }
 
 // Static method to print normal messages (always printed, no debug level filtering)
@@ -46,76 +66,317 @@ void log::println(const String& message) {
     }
     
     // Print message directly without debug level check, timestamp, or color formatting
-    logStream->println(message);
+    const char* parts[] = { message.c_str(), "\r\n" };
+    output(DEBUG_INF, parts, 2);
 }
 
 // Print float value
 void log::print(float value) {
-    if (logStream) {
-        logStream->print(value);
-    }
+    String text(value);
+    const char* parts[] = { text.c_str() };
+    output(DEBUG_INF, parts, 1);
 }
 
 // Print float value with newline
 void log::println(float value) {
-    if (logStream) {
-        logStream->println(value);
-    }
+    String text(value);
+    const char* parts[] = { text.c_str(), "\r\n" };
+    output(DEBUG_INF, parts, 2);
 }
 
 // Print int value
 void log::print(int value) {
-    if (logStream) {
-        logStream->print(value);
-    }
+    char text[12];
+    snprintf(text, sizeof(text), "%d", value);
+    const char* parts[] = { text };
+    output(DEBUG_INF, parts, 1);
 }
 
 // Print int value with newline
 void log::println(int value) {
-    if (logStream) {
-        logStream->println(value);
-    }
+    char text[12];
+    snprintf(text, sizeof(text), "%d", value);
+    const char* parts[] = { text, "\r\n" };
+    output(DEBUG_INF, parts, 2);
+}
+
+// Print a single character
+void log::print(char c) {
+    char text[2] = { c, 0 };
+    const char* parts[] = { text };
+    output(DEBUG_INF, parts, 1);
+}
+
+// Print a literal or char buffer
+void log::print(const char* message) {
+    const char* parts[] = { message };
+    output(DEBUG_INF, parts, 1);
+}
+
+// Print a literal or char buffer with newline
+void log::println(const char* message) {
+    const char* parts[] = { message, "\r\n" };
+    output(DEBUG_INF, parts, 2);
 }
 
 // Static method to print error messages
 void log::printError(const String& message) {
-    printLog(DEBUG_ERR, LOG_HEADER_ERROR, COLOR_RED, message);
+    printLog(DEBUG_ERR, millis(), message.c_str());
 }
 
 // Static method to print warning messages
 void log::printWarning(const String& message) {
-    printLog(DEBUG_WRN, LOG_HEADER_WARNING, COLOR_YELLOW, message);
+    printLog(DEBUG_WRN, millis(), message.c_str());
 }
 
 // Static method to print info messages
 void log::printInfo(const String& message) {
-    printLog(DEBUG_INF, LOG_HEADER_INFO, COLOR_WHITE, message);
+    printLog(DEBUG_INF, millis(), message.c_str());
 }
 
 // Static method to print debug messages
 void log::printDebug(const String& message) {
-    printLog(DEBUG_DBG, LOG_HEADER_DEBUG, COLOR_CYAN, message);
+    printLog(DEBUG_DBG, millis(), message.c_str());
+}
+
+// Print error literal
+void log::printError(const char* message) {
+    printLog(DEBUG_ERR, millis(), message);
+}
+
+// Print warning literal
+void log::printWarning(const char* message) {
+    printLog(DEBUG_WRN, millis(), message);
+}
+
+// Print info literal
+void log::printInfo(const char* message) {
+    printLog(DEBUG_INF, millis(), message);
+}
+
+// Print debug literal
+void log::printDebug(const char* message) {
+    printLog(DEBUG_DBG, millis(), message);
+}
+
+// Take a ticket and fill its record. Any context may log, including an interrupt that preempts
+// another producer halfway: the compare-exchange hands each producer its own slot, and drain stops at
+// a slot whose sequence is not published yet. A full ring drops the record and counts it.
+void log::push(DebugLevel level, const char* format, const char* text, const int32_t* args) {
+    uint16_t ticket = head.load(std::memory_order_relaxed);
+    do {
+        if ((uint16_t)(ticket - tail.load(std::memory_order_acquire)) >= LOG_RING_SIZE) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    } while (!head.compare_exchange_weak(ticket, (uint16_t)(ticket + 1), std::memory_order_acquire, std::memory_order_relaxed));
+
+    LogRecord& r = ring[ticket & (LOG_RING_SIZE - 1)];
+    r.level     = (uint8_t)level;
+    r.time      = millis();
+    r.format    = format;
+    r.text      = text;
+    for (uint8_t i = 0; i < LOG_ARGS; i++) {
+        r.args[i] = args[i];
+    }
+    r.sequence.store((uint16_t)(ticket + 1), std::memory_order_release);
+}
+
+// Format and print up to max deferred records in ticket order. Called from the console, so the
+// formatting cost lands in idle time.
+uint16_t log::drain(uint16_t max) {
+    uint32_t lost = dropped.load(std::memory_order_relaxed);
+    if (lost != droppedReported) {
+        char line[48];
+        snprintf(line, sizeof(line), "%lu deferred log records dropped", (unsigned long)(lost - droppedReported));
+        droppedReported = lost;
+        printLog(DEBUG_WRN, millis(), line);
+    }
+
+    uint16_t count = 0;
+    while (count < max) {
+        uint16_t ticket = tail.load(std::memory_order_relaxed);
+        if (ticket == head.load(std::memory_order_acquire)) break;
+        LogRecord& r = ring[ticket & (LOG_RING_SIZE - 1)];
+        if (r.sequence.load(std::memory_order_acquire) != (uint16_t)(ticket + 1)) break;   // Still being written
+
+        char            line[LOG_LINE_MAX];
+        const int32_t*  a = r.args;
+        if (r.text != nullptr) {
+            snprintf(line, sizeof(line), r.format, r.text, (int)a[0], (int)a[1], (int)a[2], (int)a[3]);
+        } else {
+            snprintf(line, sizeof(line), r.format, (int)a[0], (int)a[1], (int)a[2], (int)a[3]);
+        }
+        DebugLevel level = (DebugLevel)r.level;
+        uint32_t   time  = r.time;
+        tail.store((uint16_t)(ticket + 1), std::memory_order_release);             // Copied out, the slot is free
+
+        printLog(level, time, line);
+        count++;
+    }
+    return count;
+}
+
+// Deferred records not printed yet
+uint16_t log::getPending() {
+    return (uint16_t)(head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire));
+}
+
+// Deferred records lost to a full ring
+uint32_t log::getDropped() {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+// Start or stop queueing output. Setup logs straight to the stream, the shell turns the ring on
+// once the console task runs to empty it.
+void log::setBuffered(bool enabled) {
+    if (!enabled) flush();
+    buffered = enabled;
+}
+
+// Hand up to budget queued bytes to the stream in at most two contiguous writes per pass, each no more
+// than the stream has room for, so a slow link leaves the bytes in the ring instead of stalling the
+// loop in write. Warns once the ring has room again after lines were dropped.
+uint16_t log::transmit(uint16_t budget) {
+    if (logStream == nullptr) return 0;
+
+    uint16_t sent = 0;
+    while (sent < budget) {
+        uint16_t tail  = txTail;
+        uint16_t used  = (uint16_t)(txHead - tail);
+        if (used == 0) break;
+        int      room  = logStream->availableForWrite();
+        if (room <= 0) break;                                                       // Link busy, the rest waits for the next update
+        uint16_t index = tail & (LOG_TX_SIZE - 1);
+        uint16_t count = min((uint16_t)(LOG_TX_SIZE - index), min(used, (uint16_t)(budget - sent)));
+        if (room < count) count = (uint16_t)room;
+        count  = (uint16_t)logStream->write((const uint8_t*)&tx[index], count);
+        txTail = (uint16_t)(tail + count);
+        sent  += count;
+        if (count == 0) break;
+    }
+
+    if (txDropped != txDroppedReported && getTxPending() < LOG_TX_SIZE / 2) {
+        char line[48];
+        snprintf(line, sizeof(line), "Console output dropped %lu bytes", (unsigned long)(txDropped - txDroppedReported));
+        txDroppedReported = txDropped;
+        printLog(DEBUG_WRN, millis(), line);
+    }
+    return sent;
+}
+
+// Send everything queued, waiting for the link to take it. Only for output that must be complete and
+// in order, such as a binary dump.
+void log::flush() {
+    if (logStream == nullptr) return;
+    while (getTxPending() > 0) {
+        transmit(LOG_TX_SIZE);
+    }
+}
+
+// Queue binary data, such as a telemetry frame, under the same policy as an info line. Dropped data
+// is left to the caller to count, so it does not raise the dropped output warning.
+bool log::write(const uint8_t* data, uint16_t length) {
+    if (logStream == nullptr) return false;
+    if (!buffered) {
+        logStream->write(data, length);
+        return true;
+    }
+
+    noInterrupts();
+    uint16_t head = txHead;
+    uint16_t used = (uint16_t)(head - txTail);
+    if (used + length > LOG_TX_SIZE - LOG_TX_RESERVE) {
+        interrupts();
+        return false;
+    }
+    for (uint16_t i = 0; i < length; i++) {
+        tx[head++ & (LOG_TX_SIZE - 1)] = (char)data[i];
+    }
+    txHead = head;
+    used  += length;
+    if (used > txPeak) txPeak = used;
+    interrupts();
+    return true;
 }
 
-// Private helper method for formatted logging
-void log::printLog(DebugLevel level, const String& prefix, const String& color, const String& message) {
+// Bytes queued
+uint16_t log::getTxPending() {
+    return (uint16_t)(txHead - txTail);
+}
+
+// Most bytes ever queued
+uint16_t log::getTxPeak() {
+    return txPeak;
+}
+
+// Bytes dropped
+uint32_t log::getTxDropped() {
+    return txDropped;
+}
+
+// Error and warning lines dropped
+uint32_t log::getTxDroppedErrors() {
+    return txDroppedErrors;
+}
+
+// Private helper method for formatted logging, passed on in pieces so no String is built
+void log::printLog(DebugLevel level, uint32_t time, const char* message) {
     // Check if we should print this message based on debug level
     if (debugLevel < level || logStream == nullptr) {
         return;
     }
 
-    // Build the formatted message
-    String timestamp = String(millis());
-    String formattedMessage = "";
+    char timestamp[12];
+    snprintf(timestamp, sizeof(timestamp), "%lu", (unsigned long)time);
 
     if (colorEnabled) {
-        formattedMessage = color + COLOR_BOLD + prefix + COLOR_RESET + timestamp + "ms " + color + message + COLOR_RESET;
+        const char* parts[] = { levelColor[level], COLOR_BOLD, levelPrefix[level], COLOR_RESET, timestamp, "ms ",
+                                levelColor[level], message, COLOR_RESET, "\r\n" };
+        output(level, parts, 10);
     } else {
-        formattedMessage = prefix + timestamp + "ms " + message;
+        const char* parts[] = { levelPrefix[level], timestamp, "ms ", message, "\r\n" };
+        output(level, parts, 5);
     }
+}
 
-    // Print the message
-    logStream->println(formattedMessage);
+// Write the parts straight to the stream, or queue them as one unit. Interrupts stay off while
+// copying, so a line logged from the control tick never lands inside another.
+void log::output(DebugLevel level, const char* const* parts, uint8_t count) {
+    if (logStream == nullptr) return;
+    if (!buffered) {
+        for (uint8_t i = 0; i < count; i++) {
+            logStream->print(parts[i]);
+        }
+        return;
+    }
+
+    size_t total = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        total += strlen(parts[i]);
+    }
+    size_t limit = LOG_TX_SIZE;                                                     // Errors and warnings may fill the ring
+    if (level == DEBUG_DBG)      limit -= 2 * LOG_TX_RESERVE;                       // Debug is dropped first
+    else if (level > DEBUG_WRN)  limit -= LOG_TX_RESERVE;                           // Then info and console replies
+
+    noInterrupts();
+    uint16_t head = txHead;
+    uint16_t used = (uint16_t)(head - txTail);
+    if (used + total > limit) {
+        txDropped += total;
+        if (level <= DEBUG_WRN) txDroppedErrors++;
+        interrupts();
+        return;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        for (const char* c = parts[i]; *c != 0; c++) {
+            tx[head++ & (LOG_TX_SIZE - 1)] = *c;
+        }
+    }
+    txHead = head;
+    used  += total;
+    if (used > txPeak) txPeak = used;
+    interrupts();
 }
 
 // end of Logger.cpp
\ No newline at end of file
@@ -2,6 +2,22 @@
 #define DEBUG_H
 
     #include <Arduino.h>
+    #include <atomic>
+
+    // Highest level compiled in, 0-4 as DebugLevel. LOG_ and LOGF_ statements above it expand to an
+    // empty statement, arguments included, so a build can drop debug logging with e.g. -DLOG_LEVEL=2.
+    #ifndef LOG_LEVEL
+        #define LOG_LEVEL       4
+    #endif
+
+    #define LOG_RING_SIZE       64              // Deferred records held until the console drains them, a power of two
+    #define LOG_ARGS            4               // Integer arguments per deferred record
+    #define LOG_DRAIN_MAX       8               // Records formatted per drain call
+    #define LOG_LINE_MAX        120             // Longest formatted deferred message
+
+    #define LOG_TX_SIZE         16384           // Console output ring once buffered, a power of two, holds the whole ?? help
+    #define LOG_TX_RESERVE      1024            // Ring bytes only errors and warnings may use
+    #define LOG_TX_BUDGET       256             // Bytes handed to the stream per console update
 
     // ANSI color codes for terminal output
     #define COLOR_RESET     "\033[0m"       // Reset color
@@ -20,10 +36,42 @@
     #define PRINT(msg)      log::print(msg)             // Normal print without debug level or color
     #define PRINTLN(msg)    log::println(msg)           // Print with newline
 
-    #define LOG_ERR(msg)    log::printError(msg)        // Error logging with red color
-    #define LOG_WRN(msg)    log::printWarning(msg)      // Warning logging with yellow color
-    #define LOG_INF(msg)    log::printInfo(msg)         // Info logging with green color
-    #define LOG_DBG(msg)    log::printDebug(msg)        // Debug logging with cyan color
+    // Run a log call only when its level is enabled at run time, so a filtered message is never built
+    #define LOG_AT(level, call)     do { if (log::getDebugLevel() >= (level)) call; } while (0)
+    #define LOG_OFF                 do { } while (0)    // A level not compiled in
+
+    // Deferred logging for hot paths: LOGF_ERR("id: %d address: %d", id, address) stores the format
+    // literal and up to LOG_ARGS integers in a ring and returns, without building a String. A first
+    // argument of type const char* must point to a string literal and goes to a leading %s. The
+    // console formats and prints the records when it is idle.
+    #if LOG_LEVEL >= 1
+        #define LOG_ERR(msg)    LOG_AT(DEBUG_ERR, log::printError(msg))     // Error logging with red color
+        #define LOGF_ERR(...)   LOG_AT(DEBUG_ERR, log::defer(DEBUG_ERR, __VA_ARGS__))
+    #else
+        #define LOG_ERR(msg)    LOG_OFF
+        #define LOGF_ERR(...)   LOG_OFF
+    #endif
+    #if LOG_LEVEL >= 2
+        #define LOG_WRN(msg)    LOG_AT(DEBUG_WRN, log::printWarning(msg))   // Warning logging with yellow color
+        #define LOGF_WRN(...)   LOG_AT(DEBUG_WRN, log::defer(DEBUG_WRN, __VA_ARGS__))
+    #else
+        #define LOG_WRN(msg)    LOG_OFF
+        #define LOGF_WRN(...)   LOG_OFF
+    #endif
+    #if LOG_LEVEL >= 3
+        #define LOG_INF(msg)    LOG_AT(DEBUG_INF, log::printInfo(msg))      // Info logging with green color
+        #define LOGF_INF(...)   LOG_AT(DEBUG_INF, log::defer(DEBUG_INF, __VA_ARGS__))
+    #else
+        #define LOG_INF(msg)    LOG_OFF
+        #define LOGF_INF(...)   LOG_OFF
+    #endif
+    #if LOG_LEVEL >= 4
+        #define LOG_DBG(msg)    LOG_AT(DEBUG_DBG, log::printDebug(msg))     // Debug logging with cyan color
+        #define LOGF_DBG(...)   LOG_AT(DEBUG_DBG, log::defer(DEBUG_DBG, __VA_ARGS__))
+    #else
+        #define LOG_DBG(msg)    LOG_OFF
+        #define LOGF_DBG(...)   LOG_OFF
+    #endif
 
     // Debug levels for logging system
     enum DebugLevel {
@@ -34,6 +82,16 @@
         DEBUG_DBG = 4      // Debug, Info, Warnings, and Errors
     };
 
+    // A deferred log message: the format literal is its ID, the arguments stay raw until drained
+    struct LogRecord {
+        std::atomic<uint16_t>   sequence;                   // Ticket + 1 once the record is complete
+        uint8_t                 level;                      // DebugLevel
+        uint32_t                time;                       // millis() when logged
+        const char*             format;                     // printf format literal
+        const char*             text;                       // Literal for a leading %s, nullptr if none
+        int32_t                 args[LOG_ARGS];             // Integer arguments
+    };
+
     class log {
         public:
             // Static methods for managing console state
@@ -53,11 +111,49 @@
             static void println(float value);                       // Print float value with newline
             static void print(int value);                           // Print int value  
             static void println(int value);                         // Print int value with newline
+            static void print(char c);                              // Print a single character
+            static void print(const char* message);                // Same for literals and char buffers, without a String
+            static void println(const char* message);
             
             static void printError(const String& message);          // Print error message (red)
             static void printWarning(const String& message);        // Print warning message (yellow)
             static void printInfo(const String& message);           // Print info message (green)
             static void printDebug(const String& message);          // Print debug message (cyan)
+            static void printError(const char* message);            // Same for literals, without a String
+            static void printWarning(const char* message);
+            static void printInfo(const char* message);
+            static void printDebug(const char* message);
+
+            // Deferred logging, see LOGF_ERR. Safe from the control tick interrupt.
+            template <typename... Args>
+            static void defer(DebugLevel level, const char* format, Args... args) {
+                static_assert(sizeof...(Args) <= LOG_ARGS, "Too many deferred log arguments");
+                const int32_t values[LOG_ARGS] = { (int32_t)args... };
+                push(level, format, nullptr, values);
+            }
+            template <typename... Args>
+            static void defer(DebugLevel level, const char* format, const char* text, Args... args) {
+                static_assert(sizeof...(Args) <= LOG_ARGS, "Too many deferred log arguments");
+                const int32_t values[LOG_ARGS] = { (int32_t)args... };
+                push(level, format, text, values);
+            }
+            static uint16_t drain(uint16_t max = LOG_DRAIN_MAX);    // Print up to max deferred records, returns the count
+            static uint16_t getPending();                           // Deferred records not printed yet
+            static uint32_t getDropped();                           // Deferred records lost to a full ring
+
+            // Console output ring. Once buffered, everything printed is queued and sent by transmit
+            // within a byte budget, so printing never waits for the link. When the ring fills, debug
+            // lines go first, then info and console replies; errors and warnings may use the last
+            // LOG_TX_RESERVE bytes. A line that does not fit is dropped whole and counted.
+            static void     setBuffered(bool enabled);              // Queue output instead of writing it, false flushes first
+            static bool     isBuffered() { return buffered; }
+            static uint16_t transmit(uint16_t budget = LOG_TX_BUDGET);  // Send up to budget queued bytes the stream has room for, returns the count
+            static void     flush();                                // Send everything queued, waiting for the link
+            static bool     write(const uint8_t* data, uint16_t length);    // Queue binary data as one unit at info priority, false if dropped
+            static uint16_t getTxPending();                         // Bytes queued
+            static uint16_t getTxPeak();                            // Most bytes ever queued
+            static uint32_t getTxDropped();                         // Bytes dropped
+            static uint32_t getTxDroppedErrors();                   // Error and warning lines dropped
 
         private:
             // Static members for global logging
@@ -65,8 +161,25 @@
             static DebugLevel   debugLevel;                         // Current debug level
             static bool         colorEnabled;                       // Color output enabled flag
 
-            // Private logging helper
-            static void printLog(DebugLevel level, const String& prefix, const String& color, const String& message);
+            static LogRecord                ring[LOG_RING_SIZE];    // Deferred records
+            static std::atomic<uint16_t>    head;                   // Next ticket to hand out, shared by producers
+            static std::atomic<uint16_t>    tail;                   // Next ticket to print, owned by drain
+            static std::atomic<uint32_t>    dropped;                // Records lost to a full ring
+            static uint32_t                 droppedReported;        // dropped when drain last warned about it
+
+            static char                     tx[LOG_TX_SIZE];        // Console output ring
+            static volatile uint16_t        txHead;                 // Free running write index, written with interrupts off
+            static volatile uint16_t        txTail;                 // Free running read index, owned by transmit
+            static bool                     buffered;               // Output goes to the ring
+            static uint16_t                 txPeak;                 // Most bytes ever queued
+            static uint32_t                 txDropped;              // Bytes dropped
+            static uint32_t                 txDroppedErrors;        // Error and warning lines dropped
+            static uint32_t                 txDroppedReported;      // txDropped when transmit last warned about it
+
+            // Private logging helpers
+            static void push(DebugLevel level, const char* format, const char* text, const int32_t* args);
+            static void printLog(DebugLevel level, uint32_t time, const char* message);
+            static void output(DebugLevel level, const char* const* parts, uint8_t count);  // Queue or write parts as one unit
 
     };
 
@@ -1,9 +1,24 @@
 #include "Driver.h"
-#include "Console.h"
+#include "ServoEstimator.h"
 #include "Debug.h"
 
-// Constructor for Servo
-Driver::Driver(){}
+// Constructor for Driver
+Driver::Driver() {
+    clearHealth(0xFF);
+    memset(protocolOf, 0, sizeof(protocolOf));
+    memset(portOf, 0, sizeof(portOf));
+    for (uint8_t p = 0; p < DRIVER_PORTS; p++) {
+        ports[p] = nullptr;
+    }
+    for (uint16_t i = 0; i < DRIVER_HEALTH_IDS; i++) {
+        statusLevel[i] = 2;                                                         // AX default: reply to every instruction
+    }
+    for (uint8_t i = 0; i < DRIVER_SYNC_HANDLERS; i++) {
+        syncLength[i]  = DRIVER_ITEM_LENGTH;
+        syncAddress[i] = 0xFFFF;
+    }
+    clearBusStats();
+}
 
 //initialize the Dynamixel driver instance
 bool Driver::begin(const char* device_name, uint32_t baudrate, float protocol_version) {
@@ -14,8 +29,11 @@ bool Driver::begin(const char* device_name, uint32_t baudrate, float protocol_ve
     return true;
 }
 
-// Set the port handler with the device name
+// Set the port handler with the device name. The codec's handle on the same UART is created first:
+// on OpenCR creating a handle switches the Dynamixel power off, and opening the workbench's port
+// afterwards switches it back on.
 bool Driver::setPortHandler(const char *device_name) {
+    ports[0] = dynamixel::PortHandler::getPortHandler(device_name);
     if (!dxl.setPortHandler(device_name, &log))
     {        
         LOG_ERR(log);
@@ -31,6 +49,10 @@ bool Driver::setBaudrate(uint32_t baud_rate) {
     {        
         LOG_ERR(log);
     }
+    if (ports[0] != nullptr && !ports[0]->setBaudRate((int)baud_rate)) {
+        LOG_WRN("Codec port failed to open, register transfers use the workbench");
+        ports[0] = nullptr;
+    }
     LOG_INF("Baudrate set to: "+ String(baud_rate));
     return true;
 }
@@ -42,10 +64,45 @@ bool Driver::setPacketHandler(float protocol_version) {
     {        
         LOG_ERR(log);
     }
+    busProtocol = (protocol_version >= 2.0f) ? 2 : 1;
     LOG_INF("Packet handler set with protocol version: " + String(protocol_version));
     return true;
 }
 
+// Open another bus for the codecs. Call it before any servo on it is used: on OpenCR creating a port
+// handle switches the Dynamixel power off until the handle is opened.
+bool Driver::addPort(const char *device_name, uint32_t baud_rate) {
+    if (portCount >= DRIVER_PORTS) {
+        LOG_ERR("No free port for " + String(device_name) + ", at most " + String(DRIVER_PORTS));
+        return false;
+    }
+    dynamixel::PortHandler* handle = dynamixel::PortHandler::getPortHandler(device_name);
+    if (handle == nullptr || !handle->openPort() || !handle->setBaudRate((int)baud_rate)) {
+        LOG_ERR("Failed to open port " + String(device_name));
+        return false;
+    }
+    ports[portCount++] = handle;
+    LOG_INF("Port " + String(portCount - 1) + " opened on: " + String(device_name) + " at " + String(baud_rate));
+    return true;
+}
+
+// Route an ID to a port
+void Driver::setPort(uint8_t id, uint8_t port) {
+    if (id >= DRIVER_HEALTH_IDS || port >= DRIVER_PORTS) return;
+    portOf[id] = port;
+}
+
+// Port an ID is routed to, broadcast goes to port 0
+uint8_t Driver::getPort(uint8_t id) const {
+    if (id >= DRIVER_HEALTH_IDS) return 0;
+    return portOf[id];
+}
+
+// Ports open, port 0 always counts
+uint8_t Driver::getPortCount() const {
+    return portCount;
+}
+
 //----------------------------------------------------------------------------
 
 // Get the protocol version
@@ -90,10 +147,14 @@ uint8_t Driver::getTheNumberOfBulkReadParam(void) {
 // Read a register from a servo with address and length
 bool Driver::readRegister(uint8_t id, uint16_t address, uint16_t length, uint32_t *data) {
 
-    if (!dxl.readRegister(id, address, length, data, &log))
+    if (!admit(id)) return false;
+    uint32_t start   = micros();
+    bool     success = busRead(id, address, length, data);
+    record(BUS_READ, id, start, success, txSize(id, BUS_READ, length), rxSize(id, BUS_READ, length));
+    if (!report(id, success))
     {
-        LOG_ERR(log);
-        LOG_ERR("id: " + String(id) + " address: " + String(address) + " length: " + String(length));
+        if (isQuarantined(id)) return false;
+        LOGF_ERR("%s id: %d address: %d length: %d", log, id, address, length);
         return false;  
     }
     return true;
@@ -102,10 +163,24 @@ bool Driver::readRegister(uint8_t id, uint16_t address, uint16_t length, uint32_
 // Write a register to a servo with address and length
 bool Driver::writeRegister(uint8_t id, uint16_t address, uint16_t length, uint8_t* data) {
 
-    if (!dxl.writeRegister(id, address, length, data, &log))
+    if (!admit(id)) return false;
+    uint32_t start = micros();
+    if (!expectsReply(id, DRIVER_INST_WRITE)) {                                     // No status packet will come, do not wait for one
+        writesNoReply++;
+        bool success = busWrite(id, address, length, data, false);
+        record(BUS_WRITE, id, start, success, txSize(id, BUS_WRITE, length), 0);
+        if (!success) {
+            LOG_ERR(log);
+            return false;
+        }
+        return true;
+    }
+    bool success = busWrite(id, address, length, data, true);
+    record(BUS_WRITE, id, start, success, txSize(id, BUS_WRITE, length), rxSize(id, BUS_WRITE, length));
+    if (!report(id, success))
     {
-        LOG_ERR(log);
-        LOG_ERR("id: " + String(id));
+        if (isQuarantined(id)) return false;
+        LOGF_ERR("%s id: %d", log, id);
         return false;
     }
     return true;
@@ -114,10 +189,15 @@ bool Driver::writeRegister(uint8_t id, uint16_t address, uint16_t length, uint8_
 // Read a register from a servo with item name
 bool Driver::readRegister(uint8_t id, const char *item_name, uint32_t *data) {
 
-    if (!dxl.readRegister(id, item_name, (int32_t*)data, &log))
+    if (!admit(id)) return false;
+    uint32_t start   = micros();
+    bool     success = dxl.readRegister(id, item_name, (int32_t*)data, &log);
+    record(BUS_READ, id, start, success, txSize(id, BUS_READ, DRIVER_ITEM_LENGTH), rxSize(id, BUS_READ, DRIVER_ITEM_LENGTH));
+    if (!report(id, success))
     {
-        LOG_ERR(log);
-        LOG_ERR("id: " + String(id) + " item name: " + String(item_name));
+        if (isQuarantined(id)) return false;
+        LOGF_ERR("%s id: %d", log, id);
+        LOGF_ERR("item name: %s", item_name);
         return false;  
     }
 
@@ -127,46 +207,119 @@ bool Driver::readRegister(uint8_t id, const char *item_name, uint32_t *data) {
 // Write a register to a servo with item name
 bool Driver::writeRegister(uint8_t id, const char *item_name, uint32_t data) {
 
-    if (!dxl.writeRegister(id, item_name, (int32_t)data, &log))
+    if (!admit(id)) return false;
+    uint32_t start = micros();
+    if (!expectsReply(id, DRIVER_INST_WRITE)) {                                     // No status packet will come, do not wait for one
+        writesNoReply++;
+        bool success = dxl.writeOnlyRegister(id, item_name, (int32_t)data, &log);
+        record(BUS_WRITE, id, start, success, txSize(id, BUS_WRITE, DRIVER_ITEM_LENGTH), 0);
+        if (!success) {
+            LOG_ERR(log);
+            return false;
+        }
+    } else if (!report(id, record(BUS_WRITE, id, start, dxl.writeRegister(id, item_name, (int32_t)data, &log),
+                                               txSize(id, BUS_WRITE, DRIVER_ITEM_LENGTH), rxSize(id, BUS_WRITE, DRIVER_ITEM_LENGTH))))
     {
-        LOG_ERR(log);
-        LOG_ERR("id: " + String(id) + " item name: " + String(item_name) + " data: " + String(data));
+        if (isQuarantined(id)) return false;
+        LOGF_ERR("%s id: %d", log, id);
+        LOGF_ERR("item name: %s data: %d", item_name, data);
         return false;  
     }
+    if (estimator != nullptr) {
+        if      (strcmp(item_name, "Goal_Position") == 0) estimator->setGoal(id, (int32_t)data);
+        else if (strcmp(item_name, "Moving_Speed")  == 0) estimator->setSpeed(id, (uint16_t)data);
+        else if (strcmp(item_name, "Torque_Enable") == 0) estimator->setTorque(id, data != 0);
+    }
     return true;
 }
 
+// Read the same register from several servos. When every ID speaks Protocol 2.0 this is one sync read.
+// AX servos on Protocol 1.0 have no sync or bulk read, so for them it is one read per servo by address,
+// without the control table lookup of the named read and without logging, so it can run at the
+// sampling rate; with several ports the reads of different buses overlap. Entries of servos that fail
+// are left unchanged, as are those of quarantined servos, which are skipped. Returns false if any read
+// failed.
+bool Driver::readRegisters(const uint8_t* ids, uint8_t id_num, uint16_t address, uint16_t length, uint32_t* data) {
+    bool batch = isCodecActive() && id_num > 1 && id_num <= DRIVER_SYNC_READ_IDS && length <= 4;
+    for (uint8_t i = 0; i < id_num && batch; i++) {
+        batch = (getProtocol(ids[i]) == 2);
+    }
+    if (batch) {
+        uint8_t  bytes[DRIVER_SYNC_READ_IDS * 4];
+        uint32_t answered = 0;
+        bool     success  = syncRead(ids, id_num, address, length, bytes, &answered);
+        for (uint8_t i = 0; i < id_num; i++) {
+            if (!(answered & (1UL << i))) continue;
+            uint32_t value = 0;
+            for (uint8_t b = 0; b < length; b++) {
+                value |= (uint32_t)bytes[i * length + b] << (8 * b);
+            }
+            data[i] = value;
+        }
+        return success;
+    }
+    if (isCodecActive() && portCount > 1 && length <= 4) return readInterleaved(ids, id_num, address, length, data);
+
+    bool success = true;
+    for (uint8_t i = 0; i < id_num; i++) {
+        uint32_t value = 0;
+        uint32_t start = micros();
+        if (admit(ids[i]) && report(ids[i], record(BUS_READ, ids[i], start, busRead(ids[i], address, length, &value),
+                                                   txSize(ids[i], BUS_READ, length), rxSize(ids[i], BUS_READ, length)))) {
+            data[i] = value;
+        } else {
+            success = false;
+        }
+    }
+    return success;
+}
+
 // Add a sync write handler with address and length
 bool Driver::addSyncWriteHandler(uint16_t address, uint16_t length) {
 
+    uint8_t index = dxl.getTheNumberOfSyncWriteHandler();
     if (!dxl.addSyncWriteHandler(address, length, &log))
     {
         LOG_ERR(log);
         LOG_ERR("address: " + String(address) + " length: " + String(length));
         return false;  
     }
+    if (index < DRIVER_SYNC_HANDLERS) {
+        syncLength[index]  = (uint8_t)length;
+        syncAddress[index] = address;
+    }
+    if (address == 30) goalHandler   = index;                                       // AX Goal_Position
+    if (address == 32) speedHandler  = index;                                       // AX Moving_Speed
+    if (address == 24) torqueHandler = index;                                       // AX Torque_Enable, LED may follow
     return true;
 }
 
 // Add a sync write handler with ID and item name
 bool Driver::addSyncWriteHandler(uint8_t id, const char *item_name) {
 
+    uint8_t index = dxl.getTheNumberOfSyncWriteHandler();
     if (!dxl.addSyncWriteHandler(id, item_name, &log))
     {
         LOG_ERR(log);
         LOG_ERR("id: " + String(id) + " item name: " + String(item_name));
         return false;  
     }
+    const ControlItem* item = dxl.getItemInfo(id, item_name);                      // The model's address and length for the codec
+    if (item != nullptr && index < DRIVER_SYNC_HANDLERS) {
+        syncLength[index]  = item->data_length;
+        syncAddress[index] = item->address;
+    }
+    if (strcmp(item_name, "Goal_Position") == 0) goalHandler = index;
     return true;
 }
 
 // Sync write data for a specific index
 bool Driver::syncWrite(uint8_t index, int32_t *data) {
 
-    if (!dxl.syncWrite(index, data, &log))
+    uint32_t start = micros();
+    if (!record(BUS_SYNC_WRITE, DRIVER_HEALTH_IDS, start, dxl.syncWrite(index, data, &log), 8, 0))
     {
-        LOG_ERR(log);
-        LOG_ERR("index: " + String(index) + " data: " + String(*data));
+        LOGF_ERR("%s index: %d data: %d", log, index, *data);
         return false;  
     }
     return true;
@@ -175,12 +328,26 @@ bool Driver::syncWrite(uint8_t index, int32_t *data) {
 // Sync write data for multiple IDs
 bool Driver::syncWrite(uint8_t index, uint8_t *id, uint8_t id_num, int32_t *data, uint8_t data_num_for_each_id) {
 
-    if (!dxl.syncWrite(index, id, id_num, data, data_num_for_each_id, &log))
+    uint32_t start  = micros();
+    uint8_t  length = (index < DRIVER_SYNC_HANDLERS) ? syncLength[index] : DRIVER_ITEM_LENGTH;
+    bool     sent   = record(BUS_SYNC_WRITE, DRIVER_HEALTH_IDS, start, busSyncWrite(index, id, id_num, data, data_num_for_each_id),
+                             8 + id_num * (1 + length * data_num_for_each_id), 0);
+    for (uint8_t i = 0; i < id_num; i++) {
+        if (id[i] < DRIVER_HEALTH_IDS) busStats[id[i]].count[BUS_SYNC_WRITE]++;
+    }
+    if (!sent)
     {
-        LOG_ERR(log);
-        LOG_ERR("index: " + String(index));
+        LOGF_ERR("%s index: %d", log, index);
         return false;  
     }
+    if (estimator != nullptr) {
+        if (index == goalHandler) estimator->setGoals(id, id_num, data, data_num_for_each_id);
+        for (uint8_t i = 0; i < id_num && (index == speedHandler || index == torqueHandler); i++) {
+            int32_t value = data[i * data_num_for_each_id];
+            if (index == speedHandler) estimator->setSpeed(id[i], (uint16_t)value);
+            else                       estimator->setTorque(id[i], (value & 0xFF) != 0);
+        }
+    }
     return true;
 }
 
@@ -189,18 +356,739 @@ DynamixelWorkbench* Driver::getWorkbench()    {
     return &dxl;
 }
 
+// Attach an estimator that is told about every successful goal, speed and torque write
+void Driver::setEstimator(ServoEstimator* estimator) {
+    this->estimator = estimator;
+}
+
+// Attached estimator, nullptr if none
+ServoEstimator* Driver::getEstimator() {
+    return estimator;
+}
+
+// Publish the snapshot refreshed by the state stage, so modules holding the driver can read it
+void Driver::setState(const RobotState* state) {
+    this->state = state;
+}
+
+// Latest snapshot, nullptr if no state stage is running
+const RobotState* Driver::getState() {
+    return state;
+}
+
+// Read length bytes at address. The codec reads up to 4 bytes into data little-endian; longer reads
+// go to the workbench, which stores them one byte per element.
+bool Driver::busRead(uint8_t id, uint16_t address, uint16_t length, uint32_t* data) {
+    if (!useCodec(id) || length > 4) {
+        if (!onWorkbench(id)) return false;
+        return dxl.readRegister(id, address, length, data, &log);
+    }
+    uint8_t bytes[4];
+    if (!busReadBytes(id, address, length, bytes)) return false;
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        value |= (uint32_t)bytes[i] << (8 * i);
+    }
+    *data = value;
+    return true;
+}
+
+// Read length bytes at address into a byte run, with the codec of the ID's protocol on its port
+bool Driver::busReadBytes(uint8_t id, uint16_t address, uint16_t length, uint8_t* data) {
+    if (length == 0 || length > DRIVER_READ_MAX) {
+        log = "[Driver] Read length out of range!";
+        return false;
+    }
+    if (!useCodec(id)) {                                                            // The workbench packs 1, 2 and 4 bytes, else one per word
+        uint32_t words[DRIVER_READ_MAX];
+        if (!onWorkbench(id) || !dxl.readRegister(id, address, length, words, &log)) return false;
+        bool packed = (length == 1 || length == 2 || length == 4);
+        for (uint16_t i = 0; i < length; i++) {
+            data[i] = packed ? (uint8_t)(words[0] >> (8 * i)) : (uint8_t)words[i];
+        }
+        return true;
+    }
+    return request(portOf[id], id, address, length) && collect(portOf[id], id, length, data);
+}
+
+// Build and send a read of the ID on a port, without waiting for the reply
+bool Driver::request(uint8_t port, uint8_t id, uint16_t address, uint16_t length) {
+    if (getProtocol(id) == 2) {
+        codec2[port].read(id, address, length);
+        return send(port, codec2[port].txBuffer(), codec2[port].txLength());
+    }
+    codec[port].read(id, (uint8_t)address, (uint8_t)length);
+    return send(port, codec[port].txBuffer(), codec[port].txLength());
+}
+
+// Receive the reply to a read of length bytes sent by request and copy its data
+bool Driver::collect(uint8_t port, uint8_t id, uint16_t length, uint8_t* data) {
+    if (getProtocol(id) == 2) {
+        Protocol2Status status;
+        Protocol2Result result = receive2(port, id, Protocol2::statusLength(length), &status);
+        if (result == PROTOCOL2_OK && status.paramLength != length) result = PROTOCOL2_SHORT;
+        if (!settle(result, result == PROTOCOL2_OK ? (status.error & 0x7F) : 0)) return false;
+        memcpy(data, status.params, length);
+        return true;
+    }
+    Protocol1Status status;
+    Protocol1Result result = receive(port, id, (uint8_t)length, &status);
+    if (!settle(result, result == PROTOCOL1_OK ? status.error : 0)) return false;
+    memcpy(data, status.params, length);
+    return true;
+}
+
+// Write length bytes at address, waiting for the status packet when reply is set
+bool Driver::busWrite(uint8_t id, uint16_t address, uint16_t length, uint8_t* data, bool reply) {
+    if (!useCodec(id)) {
+        if (!onWorkbench(id)) return false;
+        return reply ? dxl.writeRegister(id, address, length, data, &log) : dxl.writeOnlyRegister(id, address, length, data, &log);
+    }
+    uint8_t port = portOf[id];
+    if (getProtocol(id) == 2) {
+        if (codec2[port].write(id, address, data, length) == 0) {
+            log = "[Protocol2] Write is too long for the transmit buffer!";
+            return false;
+        }
+        Protocol2Status status;
+        return transfer2(port, id, Protocol2::statusLength(0), reply ? &status : nullptr);
+    }
+    if (codec[port].write(id, (uint8_t)address, data, (uint8_t)length) == 0) {
+        log = "[Protocol1] Write is too long for the transmit buffer!";
+        return false;
+    }
+    Protocol1Status status;
+    return transfer(port, id, 0, reply ? &status : nullptr);
+}
+
+// Ping with the codec of the ID's protocol on its port, or the workbench
+bool Driver::busPing(uint8_t id) {
+    if (!useCodec(id)) {
+        if (!onWorkbench(id)) return false;
+        return dxl.ping(id, &log);
+    }
+    uint8_t port = portOf[id];
+    if (getProtocol(id) == 2) {
+        Protocol2Status status;
+        codec2[port].ping(id);
+        return transfer2(port, id, Protocol2::statusLength(3), &status);           // Model number and firmware version
+    }
+    Protocol1Status status;
+    codec[port].ping(id);
+    return transfer(port, id, 0, &status);
+}
+
+// The workbench reaches the ID: it is on port 0 and speaks the workbench's protocol. Other IDs need the codec.
+bool Driver::onWorkbench(uint8_t id) {
+    if (getProtocol(id) == busProtocol && getPort(id) == 0) return true;
+    log = "[Driver] ID uses another port or protocol, which needs the codec!";
+    return false;
+}
+
+// The codec is selected and the ID's port is open
+bool Driver::useCodec(uint8_t id) const {
+    return codecOn && ports[getPort(id)] != nullptr;
+}
+
+// Sync write one value per ID. The codec handles handlers with a known address and at most 4 bytes,
+// in the bus protocol: the packet header is set once and each ID is appended with its bytes. With
+// several ports, each gets a packet holding the IDs routed to it. All packets are built before the
+// first is sent, so they leave back to back; how far they overlap on the wire depends on the port
+// handler, the Linux one returns once the bytes are queued, the OpenCR one waits for the UART to drain.
+bool Driver::busSyncWrite(uint8_t index, uint8_t* id, uint8_t id_num, int32_t* data, uint8_t data_num_for_each_id) {
+    if (!isCodecActive() || index >= DRIVER_SYNC_HANDLERS || syncAddress[index] == 0xFFFF
+        || syncLength[index] > 4 || data_num_for_each_id != 1) {
+        for (uint8_t i = 0; i < id_num; i++) {
+            if (getPort(id[i]) != 0) {
+                log = "[Driver] Sync write to another port needs the codec!";
+                return false;
+            }
+        }
+        return dxl.syncWrite(index, id, id_num, data, data_num_for_each_id, &log);
+    }
+
+    uint8_t count[DRIVER_PORTS] = {0};
+    for (uint8_t p = 0; p < portCount; p++) {
+        if (busProtocol == 2) codec2[p].syncBegin(syncAddress[index], syncLength[index]);
+        else                  codec[p].syncBegin((uint8_t)syncAddress[index], syncLength[index]);
+    }
+    for (uint8_t i = 0; i < id_num; i++) {
+        uint8_t p = getPort(id[i]);
+        bool added = ports[p] != nullptr
+            && (busProtocol == 2 ? codec2[p].syncAdd(id[i], (uint32_t)data[i]) : codec[p].syncAdd(id[i], (uint32_t)data[i]));
+        if (!added) {
+            log = "[Driver] Sync write is too long for the transmit buffer or its port is closed!";
+            return false;
+        }
+        count[p]++;
+    }
+    bool success = true;
+    for (uint8_t p = 0; p < portCount; p++) {
+        if (count[p] == 0) continue;
+        if (busProtocol == 2) {
+            codec2[p].syncEnd();
+            success &= transfer2(p, PROTOCOL2_BROADCAST_ID, 0, nullptr);
+        } else {
+            codec[p].syncEnd();
+            success &= transfer(p, PROTOCOL1_BROADCAST_ID, 0, nullptr);
+        }
+    }
+    return success;
+}
+
+// Send the packet in a port's codec transmit buffer. With a status, wait for the status packet of
+// paramLength parameters from id and validate it in place. Failures leave a log text that record()
+// sorts into timeouts and corrupt packets.
+bool Driver::transfer(uint8_t port, uint8_t id, uint8_t paramLength, Protocol1Status* status) {
+    if (!send(port, codec[port].txBuffer(), codec[port].txLength())) return false;
+    if (status == nullptr) return true;
+    Protocol1Result result = receive(port, id, paramLength, status);
+    return settle(result, result == PROTOCOL1_OK ? status->error : 0);
+}
+
+// Receive the status packet of paramLength parameters from id on a port until its packet timeout
+Protocol1Result Driver::receive(uint8_t port, uint8_t id, uint8_t paramLength, Protocol1Status* status) {
+    dynamixel::PortHandler* handle = ports[port];
+    uint16_t expected = Protocol1::statusLength(paramLength);
+    uint8_t* rx       = codec[port].rxBuffer();
+    uint16_t received = 0;
+    handle->setPacketTimeout(expected);
+    while (received < expected) {
+        int n = handle->readPort(rx + received, expected - received);
+        if (n > 0)                         received += n;
+        else if (handle->isPacketTimeout()) break;
+    }
+    Protocol1Result result = codec[port].parse(received, id, status);
+    if (result == PROTOCOL1_OK && status->paramLength != paramLength) result = PROTOCOL1_SHORT;
+    return result;
+}
+
+// Send the packet in a port's Protocol 2.0 codec transmit buffer and, with a status, receive its reply
+bool Driver::transfer2(uint8_t port, uint8_t id, uint16_t expected, Protocol2Status* status) {
+    if (!send(port, codec2[port].txBuffer(), codec2[port].txLength())) return false;
+    if (status == nullptr) return true;
+    Protocol2Result result = receive2(port, id, expected, status);
+    return settle(result, result == PROTOCOL2_OK ? (status->error & 0x7F) : 0);    // Bit 7 is the hardware alert, the data is still valid
+}
+
+// Receive one Protocol 2.0 status packet from id on a port. The size comes from its length field,
+// since byte stuffing can make it longer than expected; expected only sizes the timeout. Only this
+// packet's bytes are taken from the port, so the next servo's reply to a sync read stays queued.
+Protocol2Result Driver::receive2(uint8_t port, uint8_t id, uint16_t expected, Protocol2Status* status) {
+    dynamixel::PortHandler* handle = ports[port];
+    uint8_t* rx       = codec2[port].rxBuffer();
+    uint16_t received = 0;
+    uint16_t total    = 7;                                                          // Header, ID and LEN first
+    handle->setPacketTimeout(expected);
+    while (received < total) {
+        int n = handle->readPort(rx + received, total - received);
+        if (n > 0) {
+            received += n;
+            if (total == 7 && received == 7) {
+                total = Protocol2::packetLength(rx);
+                if (total < 11 || total > PROTOCOL2_RX_MAX) break;                  // Garbage, let parse name it
+            }
+        } else if (handle->isPacketTimeout()) {
+            break;
+        }
+    }
+    return codec2[port].parse(received, id, status);
+}
+
+// Write an instruction packet to a port, after dropping anything left in its receive buffer
+bool Driver::send(uint8_t port, const uint8_t* packet, uint16_t length) {
+    dynamixel::PortHandler* handle = ports[port];
+    handle->clearPort();
+    if (handle->writePort((uint8_t*)packet, length) != length) {
+        log = "[Driver] Failed to transmit the instruction packet!";
+        return false;
+    }
+    return true;
+}
+
+// Turn a parse result of either codec (0 valid, -1 nothing received, other negatives malformed) and the
+// status error byte into success or a log text for record()
+bool Driver::settle(int8_t result, uint8_t error) {
+    if (result == -1) {
+        log = "[Driver] There is no status packet!";
+        return false;
+    }
+    if (result != 0) {
+        log = "[Driver] Incorrect status packet!";
+        return false;
+    }
+    if (error != 0) {
+        log = "[Driver] Status packet reports a servo error!";
+        return false;
+    }
+    return true;
+}
+
+// Select the codecs or the workbench for register and sync transfers
+void Driver::setCodec(bool on) {
+    codecOn = on;
+}
+
+// Register and sync transfers go through the codecs: selected and the first port is open
+bool Driver::isCodecActive() const {
+    return codecOn && ports[0] != nullptr;
+}
+
+// Sync read length bytes at address from every listed Protocol 2.0 ID, one instruction per port. Data
+// gets id_num x length bytes in list order and answered a bit per listed ID that replied; entries of
+// IDs that did not are left unchanged, and quarantined IDs are left out of the instruction. Returns
+// false if any listed ID did not answer.
+bool Driver::syncRead(const uint8_t* ids, uint8_t id_num, uint16_t address, uint16_t length, uint8_t* data, uint32_t* answered) {
+    *answered = 0;
+    if (!isCodecActive() || id_num == 0 || id_num > DRIVER_SYNC_READ_IDS || length == 0 || length > DRIVER_READ_MAX) {
+        log = "[Driver] Sync read needs the codec, 1 to 32 IDs and 1 to 16 bytes!";
+        return false;
+    }
+    for (uint8_t p = 0; p < portCount; p++) {
+        if (ports[p] != nullptr) syncReadPort(p, ids, id_num, address, length, data, answered);
+    }
+    return *answered == ((id_num == 32) ? 0xFFFFFFFFUL : (1UL << id_num) - 1);
+}
+
+// Sync read the listed IDs routed to a port. With fast sync read all of them answer in one status
+// packet; when that packet fails the read is repeated as a plain sync read, whose separate replies show
+// which ID is missing. Returns false if any of them did not answer.
+bool Driver::syncReadPort(uint8_t port, const uint8_t* ids, uint8_t id_num, uint16_t address, uint16_t length, uint8_t* data, uint32_t* answered) {
+    uint8_t listed[DRIVER_SYNC_READ_IDS];                                           // IDs sent in the instruction
+    uint8_t index[DRIVER_SYNC_READ_IDS];                                            // Their position in ids
+    uint8_t n       = 0;
+    bool    skipped = false;
+    for (uint8_t i = 0; i < id_num; i++) {
+        if (getPort(ids[i]) != port) continue;
+        if (getProtocol(ids[i]) != 2 || !admit(ids[i])) {
+            skipped = true;
+            continue;
+        }
+        listed[n]  = ids[i];
+        index[n++] = i;
+    }
+    if (n == 0) return !skipped;
+
+    Protocol2& c2 = codec2[port];
+    Protocol2Status status;
+    uint32_t start    = micros();
+    uint16_t fastSize = Protocol2::fastStatusLength(length, n);
+    if (fastSync && fastSize <= PROTOCOL2_RX_MAX) {
+        c2.syncRead(address, length, listed, n, true);
+        bool success = transfer2(port, PROTOCOL2_BROADCAST_ID, fastSize, &status)
+                       && settle(status.paramLength + 3 == (uint16_t)n * (4 + length) ? 0 : -2, 0);
+        for (uint8_t j = 0; j < n && success; j++) {
+            const uint8_t* segment = c2.fastSegment(j, length);                     // ERR ID DATA CRC
+            if (segment[1] != listed[j]) success = settle(-2, 0);
+        }
+        record(BUS_SYNC_READ, DRIVER_HEALTH_IDS, start, success, c2.txLength(), success ? fastSize : 0);
+        if (success) {
+            bool all = !skipped;
+            for (uint8_t j = 0; j < n; j++) {
+                const uint8_t* segment = c2.fastSegment(j, length);
+                busStats[listed[j]].count[BUS_SYNC_READ]++;
+                if (!report(listed[j], (segment[0] & 0x7F) == 0)) {
+                    all = false;
+                    continue;
+                }
+                memcpy(&data[index[j] * length], &segment[2], length);
+                *answered |= 1UL << index[j];
+            }
+            return all;
+        }
+        fastFallbacks++;
+        start = micros();
+    }
+
+    c2.syncRead(address, length, listed, n, false);                                 // Replies come in list order, a silent ID is passed over
+    bool     sent     = send(port, c2.txBuffer(), c2.txLength());
+    uint16_t received = 0;
+    uint8_t  next     = 0;                                                          // First listed ID not answered yet
+    uint8_t  got      = 0;
+    while (sent && next < n && receive2(port, PROTOCOL2_ANY_ID, Protocol2::statusLength(length), &status) == PROTOCOL2_OK) {
+        uint8_t j = next;
+        while (j < n && listed[j] != status.id) j++;
+        if (j == n) continue;                                                       // Not asked for
+        for (; next < j; next++) {
+            report(listed[next], false);
+        }
+        next++;
+        if (!report(listed[j], status.paramLength == length && (status.error & 0x7F) == 0)) continue;
+        memcpy(&data[index[j] * length], status.params, length);
+        *answered |= 1UL << index[j];
+        received  += Protocol2::statusLength(length);
+        got++;
+    }
+    for (uint8_t j = 0; j < n; j++) {
+        busStats[listed[j]].count[BUS_SYNC_READ]++;
+        if (j >= next) report(listed[j], false);
+    }
+    bool success = sent && got == n;
+    record(BUS_SYNC_READ, DRIVER_HEALTH_IDS, start, success, c2.txLength(), received);
+    return success && !skipped;
+}
+
+// One read per servo with the ports taking turns: a request goes out on every port before the replies
+// are collected, so the return delays and replies of servos on different buses overlap. Same contract
+// as readRegisters.
+bool Driver::readInterleaved(const uint8_t* ids, uint8_t id_num, uint16_t address, uint16_t length, uint32_t* data) {
+    uint8_t  next[DRIVER_PORTS] = {0};                                             // Next position in ids to look at per port
+    int16_t  pending[DRIVER_PORTS];                                                 // Position in ids in flight per port, -1 if none
+    uint32_t start[DRIVER_PORTS];
+    bool     success = true;
+
+    while (true) {
+        bool any = false;
+        for (uint8_t p = 0; p < portCount; p++) {
+            pending[p] = -1;
+            while (pending[p] < 0 && next[p] < id_num) {
+                uint8_t i  = next[p]++;
+                uint8_t id = ids[i];
+                if (getPort(id) != p) continue;
+                if (ports[p] == nullptr || !admit(id)) {
+                    success = false;
+                    continue;
+                }
+                start[p] = micros();
+                if (!request(p, id, address, length)) {
+                    report(id, record(BUS_READ, id, start[p], false, txSize(id, BUS_READ, length), 0));
+                    success = false;
+                    continue;
+                }
+                pending[p] = i;
+                any        = true;
+            }
+        }
+        if (!any) break;
+
+        for (uint8_t p = 0; p < portCount; p++) {
+            if (pending[p] < 0) continue;
+            uint8_t i  = (uint8_t)pending[p];
+            uint8_t id = ids[i];
+            uint8_t bytes[4];
+            if (!report(id, record(BUS_READ, id, start[p], collect(p, id, length, bytes), txSize(id, BUS_READ, length), rxSize(id, BUS_READ, length)))) {
+                success = false;
+                continue;
+            }
+            uint32_t value = 0;
+            for (uint8_t b = 0; b < length; b++) {
+                value |= (uint32_t)bytes[b] << (8 * b);
+            }
+            data[i] = value;
+        }
+    }
+    return success;
+}
+
+// Read position, load and moving flag of several servos. Protocol 2.0 IDs are read with one sync read
+// of the X series block; Protocol 1.0 IDs, or a lone Protocol 2.0 ID, with one read of their block
+// each. Entries of servos that fail keep their values and time. Returns false if any read failed.
+bool Driver::readMotion(const uint8_t* ids, uint8_t id_num, ServoMotion* motion) {
+    uint8_t  block[DRIVER_SYNC_READ_IDS * DRIVER_X_MOTION_LENGTH];
+    uint8_t  group[DRIVER_SYNC_READ_IDS];                                          // Protocol 2.0 IDs for the sync read
+    uint8_t  slot[DRIVER_SYNC_READ_IDS];                                           // Their index in ids
+    uint8_t  n       = 0;
+    bool     success = true;
+
+    for (uint8_t i = 0; i < id_num; i++) {
+        if (getProtocol(ids[i]) == 2 && n < DRIVER_SYNC_READ_IDS) {
+            group[n]  = ids[i];
+            slot[n++] = i;
+        }
+    }
+    if (n > 1 && isCodecActive()) {
+        uint32_t answered = 0;
+        success  = syncRead(group, n, DRIVER_X_MOTION_ADDRESS, DRIVER_X_MOTION_LENGTH, block, &answered);
+        uint32_t now = micros();
+        for (uint8_t j = 0; j < n; j++) {
+            if (!(answered & (1UL << j))) continue;
+            const uint8_t* b = &block[j * DRIVER_X_MOTION_LENGTH];
+            ServoMotion&   m = motion[slot[j]];
+            m.moving    = b[0];
+            m.load      = (int16_t)(b[4] | (b[5] << 8));
+            m.position  = (int32_t)((uint32_t)b[10] | ((uint32_t)b[11] << 8) | ((uint32_t)b[12] << 16) | ((uint32_t)b[13] << 24));
+            m.time      = now;
+        }
+    } else {
+        n = 0;                                                                      // Nothing sync read, read every ID below
+    }
+
+    for (uint8_t i = 0; i < id_num; i++) {
+        bool done = false;
+        for (uint8_t j = 0; j < n && !done; j++) done = (slot[j] == i);
+        if (done) continue;
+
+        ServoMotion& m = motion[i];
+        if (getProtocol(ids[i]) == 2) {
+            if (!readBytes(ids[i], DRIVER_X_MOTION_ADDRESS, DRIVER_X_MOTION_LENGTH, block)) {
+                success = false;
+                continue;
+            }
+            m.moving    = block[0];
+            m.load      = (int16_t)(block[4] | (block[5] << 8));
+            m.position  = (int32_t)((uint32_t)block[10] | ((uint32_t)block[11] << 8) | ((uint32_t)block[12] << 16) | ((uint32_t)block[13] << 24));
+        } else {
+            if (!readBytes(ids[i], DRIVER_AX_MOTION_ADDRESS, DRIVER_AX_MOTION_LENGTH, block)) {
+                success = false;
+                continue;
+            }
+            m.position  = block[0] | (block[1] << 8);
+            m.load      = (int16_t)(block[4] | (block[5] << 8));
+            m.moving    = block[10];
+        }
+        m.time = micros();
+    }
+    return success;
+}
+
+// One quiet read of a byte run, counted and passed through the ID's health
+bool Driver::readBytes(uint8_t id, uint16_t address, uint16_t length, uint8_t* data) {
+    if (!admit(id)) return false;
+    uint32_t start = micros();
+    return report(id, record(BUS_READ, id, start, busReadBytes(id, address, length, data), txSize(id, BUS_READ, length), rxSize(id, BUS_READ, length)));
+}
+
+// Use FAST SYNC READ for sync reads
+void Driver::setFastSyncRead(bool on) {
+    fastSync = on;
+}
+
+// Sync reads use FAST SYNC READ
+bool Driver::isFastSyncRead() const {
+    return fastSync;
+}
+
+// Record that an ID speaks another protocol than the bus, like the AX-S1 on a Protocol 2.0 bus
+void Driver::setProtocol(uint8_t id, float protocol_version) {
+    if (id >= DRIVER_HEALTH_IDS) return;
+    protocolOf[id] = (protocol_version >= 2.0f) ? 2 : 1;
+}
+
+// Protocol of an ID, 1 or 2
+uint8_t Driver::getProtocol(uint8_t id) const {
+    if (id >= DRIVER_HEALTH_IDS || protocolOf[id] == 0) return busProtocol;
+    return protocolOf[id];
+}
+
+// Instruction packet size of a transaction, for the byte counters
+uint16_t Driver::txSize(uint8_t id, uint8_t op, uint16_t length) const {
+    bool p2 = (getProtocol(id) == 2);
+    if (op == BUS_READ)  return p2 ? 14 : 8;
+    if (op == BUS_WRITE) return p2 ? 12 + length : 7 + length;
+    return p2 ? 10 : 6;                                                             // Ping
+}
+
+// Status packet size of a successful transaction, for the byte counters
+uint16_t Driver::rxSize(uint8_t id, uint8_t op, uint16_t length) const {
+    bool p2 = (getProtocol(id) == 2);
+    if (op == BUS_READ)  return p2 ? Protocol2::statusLength(length) : Protocol1::statusLength(length);
+    if (op == BUS_WRITE) return p2 ? Protocol2::statusLength(0) : Protocol1::statusLength(0);
+    return p2 ? Protocol2::statusLength(3) : Protocol1::statusLength(0);            // Ping
+}
+
 //-----------------------------------------------------------------------------
 
+// Ping a servo. Pings go to the bus even for a quarantined ID, so a ping is also a manual probe.
 bool Driver::ping(uint8_t dxl_id) {
 
-    if (!dxl.ping(dxl_id, &log))
+    uint32_t start = micros();
+    if (!report(dxl_id, record(BUS_PING, dxl_id, start, busPing(dxl_id), txSize(dxl_id, BUS_PING, 0), rxSize(dxl_id, BUS_PING, 0))))
     {
+        if (isQuarantined(dxl_id)) return false;
         LOG_ERR(log);
         return false;
     }
     return true;
 }
 
+// The ID failed DRIVER_FAIL_LIMIT transfers in a row and is only probed once per backoff
+bool Driver::isQuarantined(uint8_t id) const {
+    return id < DRIVER_HEALTH_IDS && health[id].failures >= DRIVER_FAIL_LIMIT;
+}
+
+// Forget the failures of an ID, 0xFF clears all
+void Driver::clearHealth(uint8_t id) {
+    for (uint16_t i = 0; i < DRIVER_HEALTH_IDS; i++) {
+        if (id != 0xFF && i != id) continue;
+        health[i].retryTime = 0;
+        health[i].backoff   = DRIVER_BACKOFF_MIN;
+        health[i].failures  = 0;
+    }
+}
+
+// A transfer to the ID may use the bus: it is healthy, or quarantined with its probe due. A due probe
+// pushes the next one a backoff away, so only one transfer goes out until the result is reported.
+bool Driver::admit(uint8_t id) {
+    if (!isQuarantined(id)) return true;
+    ServoHealth& h = health[id];
+    uint32_t now = millis();
+    if ((int32_t)(now - h.retryTime) >= 0) {
+        h.retryTime = now + h.backoff;
+        return true;
+    }
+    fastFails++;
+    return false;
+}
+
+// Record the result of a transfer and return it. The failure that reaches DRIVER_FAIL_LIMIT
+// quarantines the ID with one warning; every failed probe doubles the backoff up to
+// DRIVER_BACKOFF_MAX, and any success restores the ID.
+bool Driver::report(uint8_t id, bool success) {
+    if (id >= DRIVER_HEALTH_IDS) return success;                                    // Broadcast has no status to lose
+    ServoHealth& h = health[id];
+
+    if (success) {
+        if (h.failures >= DRIVER_FAIL_LIMIT) LOGF_INF("Servo ID %d answers again, quarantine lifted", id);
+        h.failures = 0;
+        h.backoff  = DRIVER_BACKOFF_MIN;
+        return true;
+    }
+
+    if (h.failures < 255) h.failures++;
+    if (h.failures == DRIVER_FAIL_LIMIT) {
+        trips++;
+        h.backoff   = DRIVER_BACKOFF_MIN;
+        h.retryTime = millis() + h.backoff;
+        LOGF_WRN("Servo ID %d failed %d transfers in a row, quarantined", id, DRIVER_FAIL_LIMIT);
+    } else if (h.failures > DRIVER_FAIL_LIMIT) {
+        h.backoff   = min((uint32_t)h.backoff * 2, (uint32_t)DRIVER_BACKOFF_MAX);
+        h.retryTime = millis() + h.backoff;
+    }
+    return false;
+}
+
+// Record the Status_Return_Level an ID is set to, so writes to it are sent without waiting for a reply
+// when it will not send one
+void Driver::setStatusReturnLevel(uint8_t id, uint8_t level) {
+    if (id >= DRIVER_HEALTH_IDS) return;
+    statusLevel[id] = min(level, (uint8_t)2);
+}
+
+// Recorded Status_Return_Level of an ID
+uint8_t Driver::getStatusReturnLevel(uint8_t id) const {
+    if (id >= DRIVER_HEALTH_IDS) return 0;                                          // Broadcast never replies
+    return statusLevel[id];
+}
+
+// The ID answers the instruction with a status packet. Level 0 answers only PING, level 1 also READ,
+// level 2 every instruction.
+bool Driver::expectsReply(uint8_t id, uint8_t instruction) const {
+    uint8_t level = getStatusReturnLevel(id);
+    if (instruction == DRIVER_INST_PING) return id < DRIVER_HEALTH_IDS;
+    if (instruction == DRIVER_INST_READ) return level >= 1;
+    return level >= 2;
+}
+
+// Count one transaction that started at start (micros). Success costs a subtraction, a count-leading-
+// zeros and a few increments; the log text is only inspected on failure to tell timeouts from
+// corrupt status packets. An id of DRIVER_HEALTH_IDS or more (broadcast) is not counted per ID.
+// Returns success so calls can be chained.
+bool Driver::record(uint8_t op, uint8_t id, uint32_t start, bool success, uint16_t sent, uint16_t received) {
+    uint32_t elapsed = micros() - start;
+    uint8_t  bucket  = elapsed ? 32 - __builtin_clz(elapsed) : 0;                   // 1 + floor(log2(elapsed))
+    if (bucket >= DRIVER_HIST_BUCKETS) bucket = DRIVER_HIST_BUCKETS - 1;
+    latency[op][bucket]++;
+    bytesSent += sent;
+
+    BusStats* s = (id < DRIVER_HEALTH_IDS) ? &busStats[id] : nullptr;
+    if (s != nullptr && op != BUS_SYNC_WRITE && op != BUS_SYNC_READ) s->count[op]++;   // Sync transfers are counted per listed ID by the caller
+    if (success) {
+        bytesReceived += received;
+        return true;
+    }
+    if (s != nullptr && log != NULL && strstr(log, "no status") != NULL) {
+        s->timeouts++;
+    } else if (s != nullptr && log != NULL && strstr(log, "Incorrect") != NULL) {
+        s->corrupt++;
+    } else {
+        otherErrors++;
+    }
+    return false;
+}
+
+// Zero all transaction counters and histograms
+void Driver::clearBusStats() {
+    memset(busStats, 0, sizeof(busStats));
+    memset(latency, 0, sizeof(latency));
+    bytesSent       = 0;
+    bytesReceived   = 0;
+    otherErrors     = 0;
+    statsStart      = millis();
+}
+
+// Print transaction counts of every ID that has seen traffic and the latency histograms
+bool Driver::printBusStats() {
+    static const char* names[BUS_OPS] = {"read", "write", "sync", "ping", "sync read"};
+    uint32_t seconds = (millis() - statsStart) / 1000;
+    PRINTLN("Bus Statistics: \n\r");
+    PRINTLN("Period         : " + String(seconds) + " s | sent " + String(bytesSent) + " B | received " + String(bytesReceived)
+            + " B | other errors " + String(otherErrors));
+    for (uint16_t id = 0; id < DRIVER_HEALTH_IDS; id++) {
+        const BusStats& s = busStats[id];
+        if (s.count[BUS_READ] + s.count[BUS_WRITE] + s.count[BUS_SYNC_WRITE] + s.count[BUS_PING] + s.count[BUS_SYNC_READ] == 0) continue;
+        PRINTLN("ID " + String(id) + (id < 10 ? " " : "") + (id < 100 ? " " : "") + "        : read " + String(s.count[BUS_READ])
+                + " | write " + String(s.count[BUS_WRITE]) + " | sync " + String(s.count[BUS_SYNC_WRITE]) + " | ping " + String(s.count[BUS_PING])
+                + " | sync read " + String(s.count[BUS_SYNC_READ]) + " | timeouts " + String(s.timeouts) + " | corrupt " + String(s.corrupt));
+    }
+    PRINTLN("");
+    PRINTLN("Latency (us)   :  <1    <2    <4    <8   <16   <32   <64  <128  <256  <512   <1k   <2k   <4k   <8k  <16k  more");
+    for (uint8_t op = 0; op < BUS_OPS; op++) {
+        String line = String(names[op]);
+        while (line.length() < 15) line += " ";
+        line += ":";
+        for (uint8_t b = 0; b < DRIVER_HIST_BUCKETS; b++) {
+            String n = String(latency[op][b]);
+            while (n.length() < 6) n = " " + n;
+            line += n;
+        }
+        PRINTLN(line);
+    }
+    return true;
+}
+
+// Print the statistics as comma separated lines: one BUS line of totals, one ID line per ID with
+// traffic (id, reads, writes, syncs, pings, timeouts, corrupt, sync reads) and one HIST line per transaction type
+// (type, bucket counts from 0 us up, bucket b holding 2^(b-1) to 2^b - 1 us)
+bool Driver::dumpBusStats() {
+    PRINTLN("BUS," + String(millis() - statsStart) + "," + String(bytesSent) + "," + String(bytesReceived) + "," + String(otherErrors));
+    for (uint16_t id = 0; id < DRIVER_HEALTH_IDS; id++) {
+        const BusStats& s = busStats[id];
+        if (s.count[BUS_READ] + s.count[BUS_WRITE] + s.count[BUS_SYNC_WRITE] + s.count[BUS_PING] + s.count[BUS_SYNC_READ] == 0) continue;
+        PRINTLN("ID," + String(id) + "," + String(s.count[BUS_READ]) + "," + String(s.count[BUS_WRITE]) + "," + String(s.count[BUS_SYNC_WRITE])
+                + "," + String(s.count[BUS_PING]) + "," + String(s.timeouts) + "," + String(s.corrupt) + "," + String(s.count[BUS_SYNC_READ]));
+    }
+    for (uint8_t op = 0; op < BUS_OPS; op++) {
+        String line = "HIST," + String(op);
+        for (uint8_t b = 0; b < DRIVER_HIST_BUCKETS; b++) {
+            line += "," + String(latency[op][b]);
+        }
+        PRINTLN(line);
+    }
+    return true;
+}
+
+// Print quarantined IDs and IDs with recent failures
+bool Driver::printHealth() {
+    PRINTLN("Servo Health:\n\r");
+    PRINTLN("Quarantines    : " + String(trips) + " | fast fails " + String(fastFails) + " | writes without reply " + String(writesNoReply));
+    uint32_t now   = millis();
+    bool     clean = true;
+    for (uint16_t id = 0; id < DRIVER_HEALTH_IDS; id++) {
+        const ServoHealth& h = health[id];
+        if (h.failures == 0) continue;
+        clean = false;
+        if (h.failures >= DRIVER_FAIL_LIMIT) {
+            int32_t due = (int32_t)(h.retryTime - now);
+            PRINTLN("ID " + String(id) + (id < 10 ? " " : "") + "          : quarantined | failures " + String(h.failures)
+                    + " | backoff " + String(h.backoff) + " ms | probe in " + String(due > 0 ? due : 0) + " ms");
+        } else {
+            PRINTLN("ID " + String(id) + (id < 10 ? " " : "") + "          : failures " + String(h.failures));
+        }
+    }
+    if (clean) PRINTLN("All IDs healthy");
+    return true;
+}
+
 // Get the model name of a servo
 const char * Driver::getModelName(uint8_t id) {
 
@@ -225,31 +1113,144 @@ bool Driver::printStatus() {
   PRINTLN("Number of Sync Write Handlers  : " + String(getTheNumberOfSyncWriteHandler()));
   PRINTLN("Number of Sync Read Handlers   : " + String(getTheNumberOfSyncReadHandler()));
   PRINTLN("Number of Bulk Read Parameters : " + String(getTheNumberOfBulkReadParam()));
+  PRINTLN("Register Transfers             : " + String(isCodecActive() ? "codec" : "workbench"));
+  for (uint8_t p = 0; p < portCount; p++) {
+    uint16_t routed = 0;
+    for (uint16_t id = 0; id < DRIVER_HEALTH_IDS; id++) {
+      if (portOf[id] == p) routed++;
+    }
+    PRINTLN("Port " + String(p) + "                         : " + String(ports[p] != nullptr ? "open" : "closed") + " | " + String(routed) + " IDs routed");
+  }
+  PRINTLN("Sync Read                      : " + String(fastSync ? "fast" : "plain") + " | fast fallbacks " + String(fastFallbacks));
+  PRINTLN("Servo Quarantines              : " + String(trips) + " (dh for details)");
   return true;
 }
 
-// Handle console commands specific to the driver
-bool Driver::runConsoleCommands(const String& cmd, const String& args) {
-    if (cmd == "ds") {
-        printStatus();
-        return true;
+// ds: Print the driver status
+static bool showDriver(void* driver, const CommandArgs&) {
+    return static_cast<Driver*>(driver)->printStatus();
+}
 
-    } else if (cmd == "d?") {
-        printConsoleHelp();
-        return true;
+// db: Print bus transactions and latency histograms
+static bool showBusStats(void* driver, const CommandArgs&) {
+    return static_cast<Driver*>(driver)->printBusStats();
+}
+
+// dbd: Dump the bus statistics as comma separated lines
+static bool dumpBusStats(void* driver, const CommandArgs&) {
+    return static_cast<Driver*>(driver)->dumpBusStats();
+}
 
+// dbc: Clear the bus statistics
+static bool clearBusStats(void* driver, const CommandArgs&) {
+    static_cast<Driver*>(driver)->clearBusStats();
+    PRINTLN("Bus statistics cleared");
+    return true;
+}
+
+// Argument 0 of a 0|1 switch, -1 if it is neither
+static int switchArg(const CommandArgs& args) {
+    if (args.count() != 1) return -1;
+    if (strcmp(args.get(0), "0") == 0) return 0;
+    if (strcmp(args.get(0), "1") == 0) return 1;
+    return -1;
+}
+
+// dc 0|1: Register transfers through the workbench or the codecs
+static bool setCodec(void* module, const CommandArgs& args) {
+    Driver* driver = static_cast<Driver*>(module);
+    int     on     = switchArg(args);
+    if (on < 0) {
+        LOG_ERR("Usage: dc [0|1]");
+        return false;
     }
+    driver->setCodec(on == 1);
+    PRINTLN("Register transfers use the " + String(driver->isCodecActive() ? "codec" : "workbench"));
+    return true;
+}
 
-    return false;
+// df 0|1: Sync reads as SYNC READ or FAST SYNC READ
+static bool setFastSync(void* module, const CommandArgs& args) {
+    Driver* driver = static_cast<Driver*>(module);
+    int     on     = switchArg(args);
+    if (on < 0) {
+        LOG_ERR("Usage: df [0|1]");
+        return false;
+    }
+    driver->setFastSyncRead(on == 1);
+    PRINTLN("Sync reads use " + String(driver->isFastSyncRead() ? "FAST SYNC READ" : "SYNC READ"));
+    return true;
+}
+
+// dr id port: Route an ID to an open port
+static bool routeId(void* module, const CommandArgs& args) {
+    Driver* driver = static_cast<Driver*>(module);
+    long    id     = args.toInt(0, -1);
+    long    port   = args.toInt(1, -1);
+    if (id < 0 || id >= DRIVER_HEALTH_IDS || port < 0 || port >= driver->getPortCount()) {
+        LOG_ERR("Usage: dr [id] [port]");
+        return false;
+    }
+    driver->setPort((uint8_t)id, (uint8_t)port);
+    PRINTLN("ID " + String(id) + " routed to port " + String(port));
+    return true;
+}
+
+// dp id 1|2: Set the protocol an ID speaks
+static bool setIdProtocol(void* module, const CommandArgs& args) {
+    Driver* driver = static_cast<Driver*>(module);
+    long    id     = args.toInt(0, -1);
+    long    proto  = args.toInt(1, -1);
+    if (id < 0 || id >= DRIVER_HEALTH_IDS || (proto != 1 && proto != 2)) {
+        LOG_ERR("Usage: dp [id] [1|2]");
+        return false;
+    }
+    driver->setProtocol((uint8_t)id, (float)proto);
+    PRINTLN("ID " + String(id) + " uses Protocol " + String(proto) + ".0");
+    return true;
+}
+
+// dh: Print servo health and quarantined IDs
+static bool showHealth(void* driver, const CommandArgs&) {
+    return static_cast<Driver*>(driver)->printHealth();
 }
 
+// dhc [id]: Clear the failures of an ID, all IDs without argument
+static bool clearHealth(void* driver, const CommandArgs& args) {
+    long id = args.toInt(0, 0xFF);
+    if (id < 0 || id > 0xFF) {
+        LOG_ERR("Usage: dhc [id]");
+        return false;
+    }
+    static_cast<Driver*>(driver)->clearHealth((uint8_t)id);
+    PRINTLN(id == 0xFF ? String("Health of all IDs cleared") : "Health of ID " + String(id) + " cleared");
+    return true;
+}
+
+// d?: Print the driver help
+static bool showDriverHelp(void* driver, const CommandArgs&) {
+    return static_cast<Driver*>(driver)->printConsoleHelp();
+}
+
+// Console commands, the help is printed from this table
+static const ConsoleCommand driverCommands[] = {
+    { "ds",     "",            "Print driver status",                                               showDriver },
+    { "db",     "",            "Print bus transactions per ID and latency histograms",              showBusStats },
+    { "dbd",    "",            "Dump bus statistics as comma separated lines",                      dumpBusStats },
+    { "dbc",    "",            "Clear bus statistics",                                              clearBusStats },
+    { "dc",     "[0|1]",       "Register transfers through the workbench (0) or the codecs (1)",    setCodec },
+    { "df",     "[0|1]",       "Protocol 2.0 sync reads as SYNC READ (0) or FAST SYNC READ (1)",    setFastSync },
+    { "dp",     "[id] [1|2]",  "Set the protocol an ID speaks on a mixed bus",                      setIdProtocol },
+    { "dr",     "[id] [port]", "Route an ID to an open port",                                       routeId },
+    { "dh",     "",            "Print servo health and quarantined IDs",                            showHealth },
+    { "dhc",    "[id]",        "Clear failures of an ID, all IDs without argument",                 clearHealth },
+    { "d?",     "",            "Print this help information",                                       showDriverHelp },
+};
+const ConsoleCommandTable Driver::commandTable = { "Driver Commands:", driverCommands, sizeof(driverCommands) / sizeof(driverCommands[0]) };
+
 // Print driver-specific help information
 bool Driver::printConsoleHelp() {
-    PRINTLN("Driver Commands:\n\r");
-    PRINTLN("  ds               - Print driver status");
-    PRINTLN("  d?               - Print this help information");
-    PRINTLN("");
-    return true;
+    return CommandRegistry::printHelp(commandTable);
 }
 
 // end of Driver.cpp
@@ -2,6 +2,51 @@
 #define DRIVER_H
 
     #include <DynamixelWorkbench.h>
+    #include "Protocol1.h"
+    #include "Protocol2.h"
+    #include "CommandRegistry.h"
+
+    #define DRIVER_HEALTH_IDS           uint16_t(254)       // IDs 0 to 253 are tracked, 254 is broadcast
+    #define DRIVER_FAIL_LIMIT           uint8_t(3)          // Consecutive failed transfers that quarantine an ID
+    #define DRIVER_BACKOFF_MIN          uint16_t(100)       // First re-probe delay of a quarantined ID in ms
+    #define DRIVER_BACKOFF_MAX          uint16_t(5000)      // Longest re-probe delay in ms, doubled per failed probe
+
+    #define DRIVER_INST_PING            uint8_t(0x01)       // Protocol 1.0 instructions, see expectsReply
+    #define DRIVER_INST_READ            uint8_t(0x02)
+    #define DRIVER_INST_WRITE           uint8_t(0x03)
+
+    #define DRIVER_HIST_BUCKETS         uint8_t(16)         // Log2 latency buckets: 0, 1, 2-3, 4-7 ... us, the last from 16384 us up
+    #define DRIVER_SYNC_HANDLERS        uint8_t(8)          // Sync write handlers whose data length is remembered
+    #define DRIVER_ITEM_LENGTH          uint8_t(2)          // Data bytes counted for named item transfers (length is not looked up)
+    #define DRIVER_READ_MAX             uint16_t(16)        // Longest register run readBytes and syncRead take per ID
+    #define DRIVER_SYNC_READ_IDS        uint8_t(32)         // Most IDs in one sync read, one bit each in the answered mask
+    #define DRIVER_PORTS                uint8_t(2)          // Buses the codecs can drive, port 0 is the one begin opens
+
+    #define DRIVER_AX_MOTION_ADDRESS    uint16_t(36)        // AX: Present_Position (2), Present_Speed (2), Present_Load (2) ... Moving (1 at 46)
+    #define DRIVER_AX_MOTION_LENGTH     uint16_t(11)
+    #define DRIVER_X_MOTION_ADDRESS     uint16_t(122)       // X series: Moving (1), Moving_Status (1), Present_PWM (2), Present_Load (2),
+    #define DRIVER_X_MOTION_LENGTH      uint16_t(14)        //           Present_Velocity (4), Present_Position (4)
+
+    // Transaction types counted by the Driver
+    enum BusOp : uint8_t {
+        BUS_READ = 0,
+        BUS_WRITE,
+        BUS_SYNC_WRITE,
+        BUS_PING,
+        BUS_SYNC_READ,
+        BUS_OPS
+    };
+
+    // Position, load and moving flag of one servo, read in one transfer
+    struct ServoMotion {
+        int32_t         position;                           // Present_Position in ticks
+        int16_t         load;                               // Present_Load as read, AX: bit 10 is the direction, X: signed 0.1 %
+        uint8_t         moving;                             // Moving register
+        uint32_t        time;                               // micros() of the read, left unchanged when the read fails
+    };
+
+    class ServoEstimator;                           // Position estimator fed with every command write, see ServoEstimator.h
+    struct RobotState;                              // Snapshot of the robot refreshed by the state stage, see StateStage.h
 
     class Driver {
         public:
@@ -14,6 +59,10 @@
             bool                setPortHandler(const char *device_name);                    // set the port handler for the controller  
             bool                setBaudrate(uint32_t baud_rate);                            // set the baudrate for the controller
             bool                setPacketHandler(float protocol_version);                   // set the packet handler with the protocol version
+            bool                addPort(const char *device_name, uint32_t baud_rate);       // open another bus for the codecs, before servos are used
+            void                setPort(uint8_t id, uint8_t port);                          // route an ID to a bus, 0 by default
+            uint8_t             getPort(uint8_t id) const;                                  // bus an ID is routed to
+            uint8_t             getPortCount() const;                                       // ports open, port 0 always counts
             
             float               getProtocolVersion(void);                                   // get the protocol version being used
             uint32_t            getBaudrate(void);                                          // get the current baudrate
@@ -25,27 +74,135 @@
             bool                readRegister(uint8_t id, uint16_t address, uint16_t length, uint32_t *data);
             bool                writeRegister(uint8_t id, uint16_t address, uint16_t length, uint8_t* data);
 
-            bool                readRegister(uint8_t id, const char *item_name, uint32_t *data);
+            bool                readRegister(uint8_t id, const char *item_name, uint32_t *data);     // item_name must be a literal, failures log it deferred
             bool                writeRegister(uint8_t id, const char *item_name, uint32_t data);
 
+            bool                readRegisters(const uint8_t* ids, uint8_t id_num,         // read the same register from several servos in one pass
+                                              uint16_t address, uint16_t length, uint32_t* data);
+
+            bool                syncRead(const uint8_t* ids, uint8_t id_num,             // Protocol 2.0 sync read of length bytes from each ID into data,
+                                         uint16_t address, uint16_t length,         // id_num x length bytes; answered gets a bit per ID that replied
+                                         uint8_t* data, uint32_t* answered);
+            bool                readMotion(const uint8_t* ids, uint8_t id_num, ServoMotion* motion);  // position, load and moving of several servos
+            void                setFastSyncRead(bool on);                                   // use FAST SYNC READ, one status packet for all IDs
+            bool                isFastSyncRead() const;                                     // sync reads use FAST SYNC READ
+
             bool                addSyncWriteHandler(uint16_t address, uint16_t length);
             bool                addSyncWriteHandler(uint8_t id, const char *item_name);
             bool                syncWrite(uint8_t index, int32_t *data);
             bool                syncWrite(uint8_t index, uint8_t *id, uint8_t id_num, int32_t *data, uint8_t data_num_for_each_id);
 
             DynamixelWorkbench* getWorkbench();                                             // if you need to expose the workbench pointer
+            void                setEstimator(ServoEstimator* estimator);                    // Pass goal, speed and torque writes to an estimator
+            ServoEstimator*     getEstimator();                                             // Attached estimator, nullptr if none
+            void                setState(const RobotState* state);                          // Publish the snapshot refreshed by the state stage
+            const RobotState*   getState();                                                 // Latest snapshot, nullptr if no state stage
 //---------------------------------------------------------------------------------------------------------------------------------------------------
 
-            bool                ping(uint8_t dxl_id);                                       // ping a servo to check if it is connected
+            bool                ping(uint8_t dxl_id);                                       // ping a servo to check if it is connected, also probes a quarantined ID
+            void                setProtocol(uint8_t id, float protocol_version);            // an ID on a mixed bus speaks another protocol
+            uint8_t             getProtocol(uint8_t id) const;                              // 1 or 2, the bus protocol unless set
+            bool                isQuarantined(uint8_t id) const;                            // ID failed DRIVER_FAIL_LIMIT times in a row and is skipped
+            void                clearHealth(uint8_t id);                                    // forget failures of an ID, 0xFF clears all
+            bool                printHealth();                                              // print quarantined IDs and failure counts
+
+            void                setStatusReturnLevel(uint8_t id, uint8_t level);            // record the Status_Return_Level an ID is set to
+            uint8_t             getStatusReturnLevel(uint8_t id) const;                     // recorded Status_Return_Level, 2 unless told otherwise
+            bool                expectsReply(uint8_t id, uint8_t instruction) const;        // the ID answers this instruction with a status packet
+
+            bool                printBusStats();                                            // print transaction counts per ID and latency histograms
+            bool                dumpBusStats();                                             // print the same as comma separated lines for a host tool
+            void                clearBusStats();                                            // zero all transaction counters and histograms
             const char *        getModelName(uint8_t id);                                   // get the model name of a servo by its ID
 
+            void                setCodec(bool on);                                          // use the codecs for register and sync transfers
+            bool                isCodecActive() const;                                      // register and sync transfers bypass the workbench
+
             bool                printStatus();                                              // Print current driver status
-            bool                runConsoleCommands(const String& cmd, const String& args);  // Process console commands for driver control
             bool                printConsoleHelp();                                         // Print driver-specific help information
+            static const ConsoleCommandTable commandTable;                                  // Console commands and their help
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------
         private:
             const char*         log = NULL;         // Log string for debugging 
             DynamixelWorkbench  dxl;                // DynamixelWorkbench instance for managing servos
+            ServoEstimator*     estimator = nullptr;    // Receives command writes
+            const RobotState*   state = nullptr;        // Snapshot published by the state stage
+            uint8_t             goalHandler = 0xFF;     // Index of the Goal_Position sync write handler, 0xFF if none
+            uint8_t             speedHandler = 0xFF;    // Index of the Moving_Speed sync write handler, 0xFF if none
+            uint8_t             torqueHandler = 0xFF;   // Index of the Torque_Enable sync write handler, 0xFF if none
+
+            // Circuit breaker state of one ID. After DRIVER_FAIL_LIMIT consecutive failures the ID is
+            // quarantined: transfers fail at once without touching the bus, except one probe per backoff.
+            struct ServoHealth {
+                uint32_t        retryTime;              // millis() at which a quarantined ID may be probed
+                uint16_t        backoff;                // Current re-probe delay in ms
+                uint8_t         failures;               // Consecutive failed transfers, saturates at 255
+            };
+            ServoHealth         health[DRIVER_HEALTH_IDS];  // Per ID, index = ID
+            uint32_t            trips       = 0;        // IDs quarantined since start
+            uint32_t            fastFails   = 0;        // Transfers refused without bus access
+            uint8_t             statusLevel[DRIVER_HEALTH_IDS]; // Status_Return_Level per ID, index = ID
+            uint32_t            writesNoReply = 0;      // Writes sent without waiting for a status packet
+
+            // Transaction counters of one ID
+            struct BusStats {
+                uint32_t        count[BUS_OPS];         // Transactions per type, sync transfers count once per listed ID
+                uint32_t        timeouts;               // Status packets that never came
+                uint32_t        corrupt;                // Status packets that failed the checksum or were malformed
+            };
+            BusStats            busStats[DRIVER_HEALTH_IDS];            // Per ID, index = ID
+            uint32_t            latency[BUS_OPS][DRIVER_HIST_BUCKETS];  // Log2 histogram of transaction time per type
+            uint32_t            bytesSent       = 0;    // Instruction bytes, from Protocol 1.0 packet sizes
+            uint32_t            bytesReceived   = 0;    // Status bytes of successful transactions
+            uint32_t            otherErrors     = 0;    // Failures that were neither timeouts nor corrupt packets
+            uint32_t            statsStart      = 0;    // millis() when the counters were cleared
+            uint8_t             syncLength[DRIVER_SYNC_HANDLERS];       // Data length per sync write handler
+            uint16_t            syncAddress[DRIVER_SYNC_HANDLERS];      // Start address per sync write handler, 0xFFFF if unknown
+
+            // Register reads, writes, pings, sync writes and sync reads go through a codec per protocol,
+            // writing into its own buffers and a second handle on the bus UART; named transfers stay on
+            // the workbench. Sync writes are built in the bus protocol, from the address and length the
+            // handler was added with or the workbench's control table for named handlers. Each ID is talked to in its own
+            // protocol, so a Protocol 1.0 AX-S1 can share a Protocol 2.0 bus.
+            //
+            // Further buses are driven by the codecs only. Each ID is routed to one port; sync writes are
+            // split into one packet per port and reads take turns across ports, so each bus carries part
+            // of the traffic and replies on different buses overlap.
+            Protocol1           codec[DRIVER_PORTS];    // Builds instruction packets and parses status packets in place, per port
+            Protocol2           codec2[DRIVER_PORTS];   // The same for Protocol 2.0 IDs
+            dynamixel::PortHandler* ports[DRIVER_PORTS];    // Raw handles on the buses, nullptr if not open
+            uint8_t             portCount = 1;          // Ports in use, port 0 always counts
+            uint8_t             portOf[DRIVER_HEALTH_IDS];  // Port per ID, index = ID
+            bool                codecOn = true;         // Codecs selected, only used with an open port
+            uint8_t             busProtocol = 1;        // Protocol of the workbench's packet handler
+            uint8_t             protocolOf[DRIVER_HEALTH_IDS];  // Protocol per ID, 0 follows busProtocol
+            bool                fastSync = true;        // Sync reads use FAST SYNC READ
+            uint32_t            fastFallbacks = 0;      // Fast sync reads repeated as plain sync reads
+
+            bool                busRead(uint8_t id, uint16_t address, uint16_t length, uint32_t* data);             // one read, codec or workbench
+            bool                busReadBytes(uint8_t id, uint16_t address, uint16_t length, uint8_t* data);         // one read into a byte run
+            bool                busPing(uint8_t id);                                                                // one ping, codec or workbench
+            bool                onWorkbench(uint8_t id);                                                            // the workbench speaks the ID's protocol on its bus
+            bool                useCodec(uint8_t id) const;                                                         // the codec can reach the ID
+            bool                request(uint8_t port, uint8_t id, uint16_t address, uint16_t length);               // send a read without waiting
+            bool                collect(uint8_t port, uint8_t id, uint16_t length, uint8_t* data);                  // receive the reply to request
+            bool                readInterleaved(const uint8_t* ids, uint8_t id_num, uint16_t address, uint16_t length, uint32_t* data);
+            bool                syncReadPort(uint8_t port, const uint8_t* ids, uint8_t id_num, uint16_t address,    // syncRead of the IDs on one port
+                                             uint16_t length, uint8_t* data, uint32_t* answered);
+            bool                readBytes(uint8_t id, uint16_t address, uint16_t length, uint8_t* data);            // counted and health checked busReadBytes
+            bool                busWrite(uint8_t id, uint16_t address, uint16_t length, uint8_t* data, bool reply);  // one write, codec or workbench
+            bool                busSyncWrite(uint8_t index, uint8_t* id, uint8_t id_num, int32_t* data, uint8_t data_num_for_each_id);
+            bool                transfer(uint8_t port, uint8_t id, uint8_t paramLength, Protocol1Status* status);   // send the codec packet, receive its status unless status is nullptr
+            bool                transfer2(uint8_t port, uint8_t id, uint16_t expected, Protocol2Status* status);    // the same for Protocol 2.0, expected sizes the timeout
+            Protocol1Result     receive(uint8_t port, uint8_t id, uint8_t paramLength, Protocol1Status* status);    // receive and parse one Protocol 1.0 status packet
+            Protocol2Result     receive2(uint8_t port, uint8_t id, uint16_t expected, Protocol2Status* status);     // receive and parse one Protocol 2.0 status packet
+            bool                send(uint8_t port, const uint8_t* packet, uint16_t length);                         // write an instruction packet to a port
+            bool                settle(int8_t result, uint8_t error);                               // turn a parse result into success or a log text
+            uint16_t            txSize(uint8_t id, uint8_t op, uint16_t length) const;              // instruction packet bytes for statistics
+            uint16_t            rxSize(uint8_t id, uint8_t op, uint16_t length) const;              // status packet bytes for statistics
+            bool                record(uint8_t op, uint8_t id, uint32_t start, bool success, uint16_t sent, uint16_t received);  // count one transaction, returns success
+            bool                admit(uint8_t id);                                          // a transfer to id may use the bus
+            bool                report(uint8_t id, bool success);                           // record a transfer result, true if a failure should be logged
     };
 #endif
\ No newline at end of file
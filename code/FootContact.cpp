@@ -0,0 +1,212 @@
+#include "FootContact.h"
+#include "Console.h"
+#include "Debug.h"
+
+// Constructor for FootContact class
+FootContact::FootContact() {
+    stateStage      = nullptr;
+    gc              = nullptr;
+    running         = true;
+    touchdown       = CONTACT_TOUCHDOWN;
+    liftoff         = CONTACT_LIFTOFF;
+    samples         = 0;
+    readErrors      = 0;
+    loadMask        = 0;
+
+    for (uint8_t leg = 0; leg < HEXAPOD_LEGS; leg++) {
+        ids[leg * 2]     = leg * LEG_SERVOS + 2;                                    // Femur
+        ids[leg * 2 + 1] = leg * LEG_SERVOS + 3;                                    // Tibia
+        loadMask        |= (1UL << (ids[leg * 2] - 1)) | (1UL << (ids[leg * 2 + 1] - 1));
+        touchdowns[leg]  = 0;
+        liftoffs[leg]    = 0;
+    }
+    reset();
+}
+
+// Initialize with the state stage and gait controller
+bool FootContact::begin(StateStage* stateStage, GaitController* gc) {
+    if (stateStage == nullptr || gc == nullptr) {
+        LOG_ERR("FootContact dependencies are not initialized.");
+        return false;
+    }
+    this->stateStage = stateStage;
+    this->gc        = gc;
+    reset();
+
+    LOG_INF("FootContact initialized successfully.");
+    return true;
+}
+
+// Filter the femur and tibia loads of the latest state stage pass and update the contact state. Loads
+// are only read while a gait is walking, so the bus is left to the motion player and recorder otherwise.
+bool FootContact::update() {
+    if (!running) return true;
+    if (gc->getGaitType() == GAIT_IDLE) {
+        stateStage->setLoadMask(0);
+        lastPass = micros();                                                        // Loads polled before walking are not a pass
+        if (contact != 0 || sentContact != 0) {
+            reset();
+            gc->setContact(0);
+        }
+        return true;
+    }
+    stateStage->setLoadMask(loadMask);                                              // Read from the next state update on
+
+    const RobotState& state = stateStage->get();
+    uint32_t pass = lastPass;
+    for (uint8_t i = 0; i < CONTACT_SERVOS; i++) {                                  // All loads of a pass share its time
+        uint32_t time = state.loadTime[ids[i] - 1];
+        if ((int32_t)(time - pass) > 0) pass = time;
+    }
+    if (pass == lastPass) return true;                                              // No new pass since the last update
+    lastPass = pass;
+    samples++;
+
+    uint16_t raw[CONTACT_SERVOS];
+    bool     stale = false;
+    for (uint8_t i = 0; i < CONTACT_SERVOS; i++) {
+        raw[i] = state.load[ids[i] - 1];
+        if (state.loadTime[ids[i] - 1] != pass) stale = true;
+    }
+    if (stale) readErrors++;
+
+    for (uint8_t leg = 0; leg < HEXAPOD_LEGS; leg++) {
+        float sample = (float)((raw[leg * 2] & 0x3FF) + (raw[leg * 2 + 1] & 0x3FF));  // Load magnitude, bit 10 is the direction
+        load[leg]   += CONTACT_FILTER * (sample - load[leg]);
+
+        uint8_t bit  = 1 << leg;
+        bool    down = contact & bit;
+        bool    past = down ? (load[leg] < liftoff) : (load[leg] > touchdown);
+        if (!past) {
+            pending[leg] = 0;
+            continue;
+        }
+        if (++pending[leg] < CONTACT_DEBOUNCE) continue;
+
+        pending[leg] = 0;
+        contact     ^= bit;
+        if (down) {
+            liftoffs[leg]++;
+        } else {
+            touchdowns[leg]++;
+        }
+    }
+
+    if (contact != sentContact && gc->setContact(contact)) sentContact = contact;
+    return true;
+}
+
+// Start sampling
+bool FootContact::start() {
+    reset();
+    running = true;
+    return true;
+}
+
+// Stop sampling and clear the contact passed to the gait
+bool FootContact::stop() {
+    running = false;
+    reset();
+    if (stateStage != nullptr) stateStage->setLoadMask(0);
+    return gc->setContact(0);
+}
+
+// Sampling is enabled
+bool FootContact::isRunning() const {
+    return running;
+}
+
+// Set the touchdown and liftoff thresholds, touchdown must be above liftoff for hysteresis
+bool FootContact::setThresholds(uint16_t touchdown, uint16_t liftoff) {
+    if (touchdown <= liftoff || touchdown > 2046) {
+        LOG_ERR("Invalid contact thresholds " + String(touchdown) + " " + String(liftoff));
+        return false;
+    }
+    this->touchdown = touchdown;
+    this->liftoff   = liftoff;
+    return true;
+}
+
+// Feet on the ground, bit 0 = leg 0
+uint8_t FootContact::getContact() const {
+    return contact;
+}
+
+// Clear the filter and contact state
+void FootContact::reset() {
+    contact     = 0;
+    sentContact = 0;
+    for (uint8_t leg = 0; leg < HEXAPOD_LEGS; leg++) {
+        load[leg]    = 0.0f;
+        pending[leg] = 0;
+    }
+    lastPass    = micros();
+}
+
+// Print contact status
+bool FootContact::printStatus() {
+    PRINTLN("FootContact Status: \n\r");
+    PRINTLN("State            : " + String(running ? "Running" : "Stopped") + " | contact 0x" + String((int)contact, HEX));
+    PRINTLN("Thresholds       : touchdown " + String(touchdown) + " | liftoff " + String(liftoff));
+    for (uint8_t leg = 0; leg < HEXAPOD_LEGS; leg++) {
+        PRINTLN("Leg " + String(leg) + "            : " + String((contact & (1 << leg)) ? "down" : "up  ")
+                + " | load " + String(load[leg], 0) + " | touchdowns " + String(touchdowns[leg]) + " | liftoffs " + String(liftoffs[leg]));
+    }
+    PRINTLN("Samples          : " + String(samples) + " | read errors " + String(readErrors));
+    PRINTLN("Early Touchdowns : " + String(gc->getEarlyTouchdowns()));
+    return true;
+}
+
+// fs: Print the contact status
+static bool showContact(void* contact, const CommandArgs&) {
+    return static_cast<FootContact*>(contact)->printStatus();
+}
+
+// fon: Start load sampling while walking
+static bool startContact(void* contact, const CommandArgs&) {
+    static_cast<FootContact*>(contact)->start();
+    LOG_INF("Foot contact sampling started");
+    return true;
+}
+
+// foff: Stop load sampling
+static bool stopContact(void* contact, const CommandArgs&) {
+    static_cast<FootContact*>(contact)->stop();
+    LOG_INF("Foot contact sampling stopped");
+    return true;
+}
+
+// ft [down] [up]: Set the touchdown and liftoff thresholds
+static bool setContactThresholds(void* contact, const CommandArgs& args) {
+    if (args.count() < 2) {
+        LOG_ERR("Usage: ft [touchdown] [liftoff]");
+        return false;
+    }
+    uint16_t down = (uint16_t)args.toInt(0, 0);
+    uint16_t up   = (uint16_t)args.toInt(1, 0);
+    if (!static_cast<FootContact*>(contact)->setThresholds(down, up)) return false;
+    LOG_INF("Contact thresholds set to " + String(down) + " " + String(up));
+    return true;
+}
+
+// f?: Print the foot contact help
+static bool showContactHelp(void* contact, const CommandArgs&) {
+    return static_cast<FootContact*>(contact)->printConsoleHelp();
+}
+
+// Console commands, the help is printed from this table
+static const ConsoleCommand footContactCommands[] = {
+    { "fs",     "",            "Show foot contact status",                                      showContact },
+    { "fon",    "",            "Start load sampling while walking",                             startContact },
+    { "foff",   "",            "Stop load sampling",                                            stopContact },
+    { "ft",     "[down] [up]", "Set touchdown and liftoff load thresholds (default 180 100)",   setContactThresholds },
+    { "f?",     "",            "Show this help",                                                showContactHelp },
+};
+const ConsoleCommandTable FootContact::commandTable = { "Foot Contact Commands:", footContactCommands, sizeof(footContactCommands) / sizeof(footContactCommands[0]) };
+
+// Print foot contact help information
+bool FootContact::printConsoleHelp() {
+    return CommandRegistry::printHelp(commandTable);
+}
+
+// end of FootContact.cpp
@@ -0,0 +1,60 @@
+#ifndef FOOTCONTACT_H
+#define FOOTCONTACT_H
+
+    #include <Arduino.h>
+    #include "StateStage.h"
+    #include "Hexapod.h"
+    #include "GaitController.h"
+    #include "CommandRegistry.h"
+
+    #define CONTACT_SERVOS              uint8_t(HEXAPOD_LEGS * 2)   // Femur and tibia of every leg
+    #define CONTACT_FILTER              float(0.4)          // Low-pass weight of a new sample, 0 to 1
+    #define CONTACT_TOUCHDOWN           uint16_t(180)       // Filtered femur + tibia load that flags touchdown (0 to 2046)
+    #define CONTACT_LIFTOFF             uint16_t(100)       // Filtered femur + tibia load that flags liftoff, below touchdown
+    #define CONTACT_DEBOUNCE            uint8_t(2)          // Consecutive samples past a threshold before the state changes
+
+    // Estimates foot contact from the load on the femur and tibia servos. While walking it has the state
+    // stage read Present_Load of all twelve servos in one pass per update, and filters each new pass from
+    // the snapshot: the magnitudes are low-pass filtered and touchdown and liftoff are flagged per leg
+    // with hysteresis and debounce. Contact changes are passed to the gait controller, which ends a
+    // descending swing as soon as the foot lands.
+    class FootContact {
+        public:
+            FootContact();                                                          // Constructor
+            bool            begin(StateStage* stateStage, GaitController* gc);      // Initialize with the state stage and gait controller
+            bool            update();                                               // Filter the latest load pass, call after the state stage
+
+            bool            start();                                                // Start sampling
+            bool            stop();                                                 // Stop sampling and clear contact
+            bool            isRunning() const;                                      // Sampling is enabled
+            bool            setThresholds(uint16_t touchdown, uint16_t liftoff);    // Touchdown and liftoff load thresholds
+            uint8_t         getContact() const;                                     // Feet on the ground, bit 0 = leg 0
+
+            bool            printStatus();                                          // Print contact status
+            bool            printConsoleHelp();                                     // Print foot contact help information
+            static const ConsoleCommandTable commandTable;                          // Console commands and their help
+
+        private:
+            StateStage*     stateStage;                                             // Reads the loads and holds them in the snapshot
+            GaitController* gc;                                                     // Receives contact changes
+
+            bool            running;                                                // Sampling is enabled
+            uint8_t         ids[CONTACT_SERVOS];                                    // Femur and tibia IDs, two per leg
+            uint32_t        loadMask;                                               // Femur and tibia IDs as a state stage load mask
+            uint32_t        lastPass;                                               // Time of the last load pass filtered in us
+            float           load[HEXAPOD_LEGS];                                     // Filtered femur + tibia load per leg
+            uint8_t         pending[HEXAPOD_LEGS];                                  // Samples past the threshold towards a state change
+            uint8_t         contact;                                                // Feet on the ground, bit 0 = leg 0
+            uint8_t         sentContact;                                            // Last contact mask passed to the gait
+            uint16_t        touchdown;                                              // Touchdown threshold
+            uint16_t        liftoff;                                                // Liftoff threshold
+
+            uint32_t        touchdowns[HEXAPOD_LEGS];                               // Touchdowns flagged per leg
+            uint32_t        liftoffs[HEXAPOD_LEGS];                                 // Liftoffs flagged per leg
+            uint32_t        samples;                                                // Passes filtered
+            uint32_t        readErrors;                                             // Passes a servo did not answer, its last load is used
+
+            void            reset();                                                // Clear the filter and contact state
+    };
+
+#endif // FOOTCONTACT_H
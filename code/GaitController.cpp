@@ -4,69 +4,422 @@
 #include "Console.h"
 #include "Debug.h"
 
+static const float legBaseX[HEXAPOD_LEGS] = {LEG_0_BASE_X, LEG_1_BASE_X, LEG_2_BASE_X, LEG_3_BASE_X, LEG_4_BASE_X, LEG_5_BASE_X};
+static const float legBaseY[HEXAPOD_LEGS] = {LEG_0_BASE_Y, LEG_1_BASE_Y, LEG_2_BASE_Y, LEG_3_BASE_Y, LEG_4_BASE_Y, LEG_5_BASE_Y};
+
 // Constructor for GaitController class
 GaitController::GaitController() {
     hexapod             = nullptr;
-    currentPhase        = 0;
-    currentStep         = 0;
-    
+    tickPeriod          = CONTROL_TICK_PERIOD;
+
+    holder              = nullptr;
     gaitType            = GAIT_IDLE;
     gaitWalkDirection   = 0;
     gaitRotateDirection = ROTATE_CW;
     gaitSpeed           = 300;
     gaitStepSize        = 100;
-    
+    stridePreset        = GAIT_STRIDE_DEFAULT;
+    strideTable         = &gaitStrideTables[GAIT_STRIDE_DEFAULT];
+
+    controlTicks        = 0;
+    velocityMode        = false;
+    maxAccel            = GAIT_MAX_ACCEL;
+    maxJerk             = GAIT_MAX_JERK;
+    phaseRate           = 1.0f;
+    gaitPhase           = 0.0f;
+    gaitFrequency       = 0.0f;
+    dutyFactor          = gaitPatterns[GAIT_TRIPOD].duty;
+    turn                = 0.0f;
+    contactMask         = 0;
+    swingClear          = 0;
+    earlyTouchdowns     = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+        velocityTarget[i] = 0;
+        velocityRamp[i]   = {0.0f, 0.0f};
+    }
+    for (uint8_t leg = 0; leg < HEXAPOD_LEGS; leg++) {
+        strideTicks[leg]   = 0.0f;
+        offsetTarget[leg]  = 0.0f;
+        offsets[leg]       = 0.0f;
+        legPhase[leg]      = 0.0f;
+        legDuty[leg]       = dutyFactor;
+        legLiftoff[leg]    = 0.0f;
+        legHalfStride[leg] = 0.0f;
+        legTouchdown[leg]  = 0.0f;
+        legSwingLift[leg]  = 0.0f;
+        legStanceLift[leg] = 0.0f;
+    }
+    stepTick            = 0;
+    motionTicks         = 0;
+    stepTicks           = 0;
+    setpointSeq         = 0;
+    writtenSeq          = 0;
+    appliedSpeed        = 0;
 }
 
-// Initialize the GaitController with a Hexapod instance
-bool GaitController::begin(Hexapod* hexapod){
+// Initialize the GaitController with a Hexapod instance and the control tick period
+bool GaitController::begin(Hexapod* hexapod, uint32_t tickPeriod){
     
     this->hexapod       = hexapod;
+    this->tickPeriod    = tickPeriod;
     gaitType            = GAIT_IDLE;    // Start with idle gait
-    currentPhase        = 0;            // Reset current phase
-    currentStep         = 0;            // Reset current step
 
     gaitWalkDirection   = 0;            // Default direction
     gaitRotateDirection = ROTATE_CW;    // Default rotation direction
     gaitSpeed           = 300;          // Default speed
     gaitStepSize        = 100;          // Default step size
 
+    // Standing foot positions, and the direction each foot moves when its coxa steps forward
+    for (uint8_t leg = 0; leg < HEXAPOD_LEGS; leg++) {
+        float angle   = (gaitCoxaDirection[leg] * 90.0f + (gaitCoxaNeutral[leg] - 512) * (300.0f / 1023.0f)) * DEG_TO_RAD;
+        footX[leg]    = legBaseX[leg] + GAIT_FOOT_RADIUS * cosf(angle);
+        footY[leg]    = legBaseY[leg] + GAIT_FOOT_RADIUS * sinf(angle);
+        float sign    = (sinf(angle) < 0.0f) ? 1.0f : -1.0f;              // Tangent pointing towards +x
+        forwardX[leg] = -sinf(angle) * sign;
+        forwardY[leg] =  cosf(angle) * sign;
+    }
+
+    const int32_t* standUp = hexapod->getStandUpPose();                             // Hexapod::begin() already stood the robot up
+    for (uint8_t i = 0; i < HEXAPOD_SERVOS; i++) {
+        setpoints[i]  = standUp[i];
+        stepStart[i]  = standUp[i];
+        stepTarget[i] = standUp[i];
+    }
+    stepTick            = 0;
+    motionTicks         = 0;
+    stepTicks           = 0;
+    setpointSeq         = 0;
+    writtenSeq          = 0;
+    appliedSpeed        = hexapod->getSpeed();
+
     LOG_INF("GaitController initialized successfully.");
     return true;
 }
 
-// Update the gait controller, called periodically
+// Write the latest staged setpoints and speed to the servos, called from loop()
 bool GaitController::update() {
-    if (gaitType == GAIT_IDLE) return false;  // Do nothing if in idle gait
+    uint16_t speed = gaitSpeed;
+    if (phaseRate > 1.0f) speed = (uint16_t)min(1023.0f, speed * phaseRate);   // Faster steps need faster servos
+    if (speed != appliedSpeed) {                                                    // Speed changes are bus writes, so they happen here
+        if (hexapod->setSpeed(speed)) appliedSpeed = speed;
+    }
 
-    switch (gaitType) {
-        case GAIT_WAVE:                 // Perform wave gait
-            doWaveGait();
+    if (setpointSeq == writtenSeq) return false;                                    // Nothing new from the control stage
+
+    int32_t  frame[HEXAPOD_SERVOS];
+    uint32_t seq;
+    noInterrupts();                                                                 // Take a consistent copy of the frame
+    for (uint8_t i = 0; i < HEXAPOD_SERVOS; i++) {
+        frame[i] = setpoints[i];
+    }
+    seq = setpointSeq;
+    interrupts();
+
+    if (!hexapod->moveAll(frame)) return false;                                     // Frame stays pending and is retried next update
+    writtenSeq = seq;
+    return true;
+}
+
+// Control stage, called from the control tick interrupt: no bus or console I/O here
+void GaitController::controlTick() {
+    GaitCommand command;
+    while (commandQueue.pop(command)) {
+        applyCommand(command);
+    }
+    controlTicks = controlTicks + 1;
+    rampVelocity();
+
+    if (stepTick < stepTicks) {                                                     // Step in progress: interpolate, then let the servos settle
+        stepTick++;
+        if (stepTick <= motionTicks) interpolateStep();
+        return;
+    }
+    if (gaitType == GAIT_IDLE) return;                                              // Do nothing if in idle gait
+
+    runOscillator();
+}
+
+// Queue a command for the control stage, must be called from loop() context only
+bool GaitController::submit(const GaitCommand& command) {
+    if (!commandQueue.push(command)) {
+        LOG_WRN("Gait command queue full, command dropped.");
+        return false;
+    }
+    return true;
+}
+
+// Apply a queued command, runs in the control stage
+void GaitController::applyCommand(const GaitCommand& command) {
+    switch (command.type) {
+        case GAIT_CMD_SET_TYPE:
+            gaitType        = (GaitType)command.value;  // Set the new gait type
+            if (gaitType == GAIT_IDLE) {
+                stageStandUp();                         // Stand still when stopping
+            } else {
+                startPattern(gaitType);                 // Blend from the current pose into the new pattern
+            }
+            break;
+        case GAIT_CMD_SET_SPEED:
+            gaitSpeed       = (uint16_t)command.value;
+            break;
+        case GAIT_CMD_SET_STEP_SIZE:
+            gaitStepSize    = (uint16_t)command.value;
+            break;
+        case GAIT_CMD_SET_WALK_DIRECTION:
+            gaitWalkDirection = (int8_t)command.value;
+            break;
+        case GAIT_CMD_SET_ROTATE_DIRECTION:
+            gaitRotateDirection = (RotateDirection)command.value;
+            break;
+        case GAIT_CMD_SET_STRIDE:
+            stridePreset    = (uint8_t)command.value;
+            strideTable     = &gaitStrideTables[stridePreset];  // Takes effect from the next staged step
             break;
-        case GAIT_RIPPLE:               // Perform ripple gait
-            doRippleGait();
+        case GAIT_CMD_SET_VX:
+        case GAIT_CMD_SET_VY:
+        case GAIT_CMD_SET_WZ:
+            velocityTarget[command.type - GAIT_CMD_SET_VX] = command.value;
             break;
-        case GAIT_TRIPOD:               // Perform tripod gait
-            doTripodGait();
+        case GAIT_CMD_SET_VELOCITY_MODE:
+            velocityMode    = command.value != 0;       // Takes effect at each leg's next liftoff, the cycle is not restarted
             break;
-        case GAIT_ROTATE:               // Perform rotate gait
-            doRotateGait();
+        case GAIT_CMD_SET_ACCEL_LIMIT:
+            maxAccel        = (uint16_t)command.value;
             break;
-        default:                        // If an unknown gait type is set, do nothing
-            LOG_ERR("Unknown gait type, no action taken.");
+        case GAIT_CMD_SET_JERK_LIMIT:
+            maxJerk         = (uint16_t)command.value;
+            break;
+        case GAIT_CMD_SET_DUTY:
+            dutyFactor      = command.value / 1000.0f;  // Legs take it at their next liftoff
+            break;
+        case GAIT_CMD_SET_OFFSET:
+            offsetTarget[command.value / 1000] = (command.value % 1000) / 1000.0f;
+            break;
+        case GAIT_CMD_SET_CONTACT:
+            contactMask     = (uint8_t)command.value;
             break;
     }
-    return true;
+}
+
+// Start a step towards goal positions for a set of servos. The step is timed so that the quintic's
+// peak velocity on the joint with the largest travel matches the servo Moving_Speed limit.
+void GaitController::stagePose(const uint8_t* ids, uint8_t num_servos, const int32_t* positions) {
+    for (uint8_t i = 0; i < num_servos; i++) {
+        uint8_t index = ids[i] - 1;                                                 // Servo IDs 1 to 18 map to slots 0 to 17
+        if (index >= HEXAPOD_SERVOS) continue;
+        stepTarget[index] = positions[i];
+    }
+
+    uint32_t maxDelta = 0;
+    for (uint8_t i = 0; i < HEXAPOD_SERVOS; i++) {
+        stepStart[i]  = setpoints[i];                                               // Start from where the last step left off
+        int32_t delta = stepTarget[i] - stepStart[i];
+        if (delta < 0) delta = -delta;
+        if ((uint32_t)delta > maxDelta) maxDelta = delta;
+    }
+
+    uint16_t speed = gaitSpeed;
+    if (speed == 0) speed = 1023;                                                   // Moving_Speed 0 means maximum speed
+    float moveTime  = (float)maxDelta * (float)(GAIT_US_PER_TICK / speed) * QUINTIC_PEAK_VELOCITY / phaseRate;
+    motionTicks     = (uint32_t)ceilf(moveTime / (float)tickPeriod);
+    if (motionTicks == 0) motionTicks = 1;
+    stepTicks       = motionTicks + (GAIT_STEP_SETTLE + tickPeriod - 1) / tickPeriod;
+    stepTick        = 0;
+}
+
+// Produce the setpoint frame for the current step tick
+void GaitController::interpolateStep() {
+    float s = Trajectory::smoothstep5((float)stepTick / (float)motionTicks);
+    for (uint8_t i = 0; i < HEXAPOD_SERVOS; i++) {
+        setpoints[i] = stepStart[i] + (int32_t)lroundf((float)(stepTarget[i] - stepStart[i]) * s);
+    }
+    setpointSeq = setpointSeq + 1;
+}
+
+// Stage the standing pose for all servos
+void GaitController::stageStandUp() {
+    stagePose(hexapod->getServoIDs(), HEXAPOD_SERVOS, hexapod->getStandUpPose());
+}
+
+// Advance the velocity ramps by one tick. Yaw is limited like the tangential motion of a foot at GAIT_YAW_RADIUS.
+void GaitController::rampVelocity() {
+    float dt    = (float)tickPeriod * 1e-6f;
+    float accel = maxAccel;
+    float jerk  = maxJerk;
+    Trajectory::rampTo(velocityRamp[0], velocityTarget[0], accel, jerk, dt);
+    Trajectory::rampTo(velocityRamp[1], velocityTarget[1], accel, jerk, dt);
+    Trajectory::rampTo(velocityRamp[2], velocityTarget[2] * DEG_TO_RAD, accel / GAIT_YAW_RADIUS, jerk / GAIT_YAW_RADIUS, dt);
+}
+
+// Oscillator period at phase rate 1: a swing lifts and lowers the femur and tibia, each half timed like
+// a staged step at gaitSpeed, and takes (1 - duty) of the cycle
+float GaitController::cycleTime() const {
+    uint16_t speed = gaitSpeed;
+    if (speed == 0) speed = 1023;                                                   // Moving_Speed 0 means maximum speed
+    float swing = 2.0f * (float)(GAIT_TIBIA_UP - GAIT_TIBIA_DOWN) * (float)(GAIT_US_PER_TICK / speed) * QUINTIC_PEAK_VELOCITY * 1e-6f;
+    return swing / (1.0f - dutyFactor);
+}
+
+// Plan the coxa travel of every leg, latched by each leg at its next liftoff. With the preset stride all
+// legs step the same, or turn in place for the rotate pattern. With a velocity command each foot travels
+// its own velocity times the stance time, projected on the arc its coxa can sweep; if the largest stride
+// would exceed the preset, the oscillator is sped up (and Moving_Speed raised) instead, up to
+// GAIT_MAX_PHASE_RATE.
+void GaitController::planStrides() {
+    float limit = (float)strideTable->strideTicks;
+    if (!velocityMode) {
+        float rotate = (gaitRotateDirection == ROTATE_CCW) ? 1.0f : -1.0f;
+        for (uint8_t leg = 0; leg < HEXAPOD_LEGS; leg++) {
+            strideTicks[leg] = limit * (1.0f - turn - turn * rotate * gaitCoxaDirection[leg]);
+        }
+        phaseRate = 1.0f;
+        return;
+    }
+
+    float stance = dutyFactor * cycleTime();
+    float vx     = velocityRamp[0].velocity;
+    float vy     = velocityRamp[1].velocity;
+    float wz     = velocityRamp[2].velocity;
+    float travel[HEXAPOD_LEGS];
+    float peak   = 0.0f;
+    for (uint8_t leg = 0; leg < HEXAPOD_LEGS; leg++) {
+        float dx    = (vx - wz * footY[leg]) * stance;                              // Foot velocity from body velocity and yaw
+        float dy    = (vy + wz * footX[leg]) * stance;
+        float arc   = dx * forwardX[leg] + dy * forwardY[leg];                      // Only the tangential part can be stepped
+        travel[leg] = arc / GAIT_FOOT_RADIUS * RAD_TO_DEG * (1023.0f / 300.0f);
+        if (fabsf(travel[leg]) > peak) peak = fabsf(travel[leg]);
+    }
+
+    uint16_t speed   = (gaitSpeed == 0) ? 1023 : gaitSpeed;
+    float    maxRate = min(GAIT_MAX_PHASE_RATE, 1023.0f / speed);
+    float    rate    = 1.0f;
+    if (peak > limit) {
+        rate = ceilf(peak / limit * 8.0f) / 8.0f;                                   // Eighth steps keep Moving_Speed writes rare
+        if (rate > maxRate) rate = maxRate;
+        if (rate < 1.0f) rate = 1.0f;
+    }
+    for (uint8_t leg = 0; leg < HEXAPOD_LEGS; leg++) {
+        strideTicks[leg] = constrain(travel[leg] / rate, -limit, limit);
+    }
+    phaseRate = rate;
+}
+
+// Load a pattern and stage a step from the current pose to the pattern's frame at phase 0
+void GaitController::startPattern(GaitType type) {
+    const GaitPattern& pattern = gaitPatterns[type];
+    dutyFactor = pattern.duty;
+    turn       = pattern.turn;
+    gaitPhase  = 0.0f;
+    planStrides();
+
+    int32_t frame[HEXAPOD_SERVOS];
+    for (uint8_t leg = 0; leg < HEXAPOD_LEGS; leg++) {
+        offsetTarget[leg]  = pattern.offsets[leg];
+        offsets[leg]       = pattern.offsets[leg];
+        legPhase[leg]      = 1.0f - pattern.offsets[leg];
+        legPhase[leg]     -= floorf(legPhase[leg]);
+        legDuty[leg]       = dutyFactor;
+        legHalfStride[leg] = strideTicks[leg] * 0.5f;
+        legLiftoff[leg]    = -legHalfStride[leg];
+        legTouchdown[leg]  = legHalfStride[leg];
+        legSwingLift[leg]  = 0.0f;
+        legStanceLift[leg] = 0.0f;
+        evaluateLeg(leg, &frame[leg * LEG_SERVOS]);
+    }
+    swingClear = 0;
+    stagePose(hexapod->getServoIDs(), HEXAPOD_SERVOS, frame);
+}
+
+// Advance the oscillator one tick and produce a setpoint frame, O(legs) for every pattern
+void GaitController::runOscillator() {
+    float dt    = (float)tickPeriod * 1e-6f;
+    float slew  = GAIT_OFFSET_SLEW * dt;
+    gaitFrequency = phaseRate / cycleTime();
+    float phase = gaitPhase + gaitFrequency * dt;
+    gaitPhase   = phase - floorf(phase);
+
+    bool planned = false;
+    for (uint8_t leg = 0; leg < HEXAPOD_LEGS; leg++) {
+        float error  = offsetTarget[leg] - offsets[leg];
+        error       -= roundf(error);                                               // Shortest way round the cycle
+        offsets[leg] += constrain(error, -slew, slew);
+        offsets[leg] -= floorf(offsets[leg]);
+
+        float p = gaitPhase - offsets[leg];
+        p -= floorf(p);
+        if (p < legPhase[leg] - 0.5f) {                                             // Wrapped round: liftoff
+            if (!planned) {
+                planStrides();
+                planned = true;
+            }
+            legLiftoff[leg]    = -legHalfStride[leg];                               // Where the stance ended
+            legDuty[leg]       = dutyFactor;
+            legHalfStride[leg] = strideTicks[leg] * 0.5f;
+            legTouchdown[leg]  = legHalfStride[leg];
+            legSwingLift[leg]  = legStanceLift[leg];
+            legStanceLift[leg] = 0.0f;
+            swingClear        &= ~(1 << leg);
+        }
+
+        float swing = 1.0f - legDuty[leg];
+        if (p < swing) {
+            uint8_t bit = 1 << leg;
+            if (!(contactMask & bit)) swingClear |= bit;                            // Contact from the last stance has cleared
+            float s = p / swing;
+            if (s > GAIT_CONTACT_WINDOW && (contactMask & swingClear & bit)) {      // Landed early: start the stance where the foot is
+                swingPose(leg, s, legTouchdown[leg], legStanceLift[leg]);
+                offsets[leg] = gaitPhase - swing;                                   // Jump the leg to stance, it slews back to its offset
+                offsets[leg] -= floorf(offsets[leg]);
+                p = swing;
+                earlyTouchdowns = earlyTouchdowns + 1;
+            }
+        }
+        legPhase[leg] = p;
+
+        int32_t positions[LEG_SERVOS];
+        evaluateLeg(leg, positions);
+        for (uint8_t j = 0; j < LEG_SERVOS; j++) {
+            setpoints[leg * LEG_SERVOS + j] = positions[j];
+        }
+    }
+    setpointSeq = setpointSeq + 1;
+}
+
+// Coxa offset and foot lift at swing fraction s: the coxa moves from liftoff to half a stride forward
+// while the foot rises from the height it stood at to full lift, then lowers to the ground
+void GaitController::swingPose(uint8_t leg, float s, float& coxa, float& lift) {
+    float base = (s < 0.5f) ? legSwingLift[leg] : 0.0f;
+    coxa = legLiftoff[leg] + (legHalfStride[leg] - legLiftoff[leg]) * Trajectory::smoothstep5(s);
+    lift = base + (1.0f - base) * Trajectory::smoothstep5(1.0f - fabsf(2.0f * s - 1.0f));
+}
+
+// Joint positions of one leg at its phase. Stance sweeps the coxa from touchdown back to half a stride
+// behind at constant speed, holding the foot at the height it touched down.
+void GaitController::evaluateLeg(uint8_t leg, int32_t* positions) {
+    float p     = legPhase[leg];
+    float swing = 1.0f - legDuty[leg];
+    float coxa;
+    float lift;
+    if (p < swing) {
+        swingPose(leg, p / swing, coxa, lift);
+    } else {
+        float u = (p - swing) / legDuty[leg];
+        coxa    = legTouchdown[leg] - (legTouchdown[leg] + legHalfStride[leg]) * u;
+        lift    = legStanceLift[leg];
+    }
+    positions[0] = gaitCoxaNeutral[leg] + gaitCoxaDirection[leg] * (int32_t)lroundf(coxa);
+    positions[1] = GAIT_FEMUR_DOWN + (int32_t)lroundf((GAIT_FEMUR_UP - GAIT_FEMUR_DOWN) * lift);
+    positions[2] = GAIT_TIBIA_DOWN + (int32_t)lroundf((GAIT_TIBIA_UP - GAIT_TIBIA_DOWN) * lift);
 }
 
 // Set the current gait type
 bool GaitController::setGaitType(GaitType newGait) {
-    gaitType        = newGait;      // Set the new gait type
-    currentPhase    = 0;            // Reset current phase for the new gait
-    currentStep     = 0;            // Reset current step for the new gait
-    hexapod->moveStandUp();         // Reset hexapod position when changing gait
+    if (holder != nullptr) {
+        LOG_ERR("Gait is held by " + String(holder) + ", stop it first.");
+        return false;
+    }
     LOG_DBG("Gait set to: ");
-    switch (gaitType) {
+    switch (newGait) {
         case GAIT_IDLE:
             LOG_DBG("Idle");
             break;
@@ -86,8 +439,7 @@ bool GaitController::setGaitType(GaitType newGait) {
             LOG_DBG("Unknown");
             break;
     }
-    return true;
-    
+    return submit({GAIT_CMD_SET_TYPE, (int16_t)newGait});
 }
 
 // Get the current gait type
@@ -95,122 +447,126 @@ GaitType GaitController::getGaitType() const {
     return gaitType;
 }
 
+// Keep the gait idle while another module writes Goal_Position, so the two never sync write over each other
+bool GaitController::hold(const char* owner) {
+    if (holder != nullptr) {
+        return strcmp(holder, owner) == 0;
+    }
+    if (gaitType != GAIT_IDLE) {
+        return false;
+    }
+    holder = owner;
+    return true;
+}
+
+// End the hold taken by owner, a hold taken by another module is kept
+void GaitController::release(const char* owner) {
+    if (holder != nullptr && strcmp(holder, owner) == 0) {
+        holder = nullptr;
+    }
+}
+
+// Module holding the gait, nullptr if none
+const char* GaitController::getHolder() const {
+    return holder;
+}
+
 // Setters and getters
 void GaitController::setWalkDirection(int8_t w_dir) {
     if (w_dir < -180) w_dir = -180;
     if (w_dir > 180) w_dir = 180;
-    gaitWalkDirection = w_dir;
+    submit({GAIT_CMD_SET_WALK_DIRECTION, w_dir});
 }
 int8_t GaitController::getWalkDirection() const {
     return gaitWalkDirection;
 }
 
+void GaitController::setRotateDirection(RotateDirection r_dir) {
+    submit({GAIT_CMD_SET_ROTATE_DIRECTION, (int16_t)r_dir});
+}
+RotateDirection GaitController::getRotateDirection() const {
+    return gaitRotateDirection;
+}
+
 bool GaitController::setGaitSpeed(uint16_t speed) {
-    if (speed < 0) speed = 0;
     if (speed > 1023) speed = 1023;
-    gaitSpeed = speed;
-    return hexapod->setSpeed(speed);
+    return submit({GAIT_CMD_SET_SPEED, (int16_t)speed});
 }
 uint16_t GaitController::getGaitSpeed() const {
     return gaitSpeed;
 }
 
 void GaitController::setGaitStepSize(uint16_t step_size) {
-    if (step_size < 0) step_size = 0;
     if (step_size > 1023) step_size = 1023;
-    gaitStepSize = step_size;
+    submit({GAIT_CMD_SET_STEP_SIZE, (int16_t)step_size});
 }
 uint16_t GaitController::getGaitStepSize() const {
     return gaitStepSize;
 }
 
-
-
-// Perform the wave gait, one leg swings at a time
-bool GaitController::doWaveGait() {
-
-    if(hexapod->isMoving()) return false;      // If hexapod is already moving, do nothing
-
-    if (currentPhase == (HEXAPOD_LEGS)) {                                           // if end of the wave gait cycle
-        hexapod->moveStandUp();                                                     // Move hexapod to standing position
-        currentPhase = 0;                                                           // Reset phase for the next cycle                                     
-        currentStep  = 0;                                                           // Reset step for the next cycle
-
-    } else {                                                                        // If not at the end of the wave gait cycle
-        switch(currentStep) {
-            case 0:                                                                 // If current step is 0, move the current leg up
-                hexapod->move(poseWaveGaitIDs[currentPhase], LEG_SERVOS, poseWaveGaitLegUp[currentPhase]);
-                break;
-            case 1:                                                                 // If current step is 1, move the current leg down
-                hexapod->move(poseWaveGaitIDs[currentPhase], LEG_SERVOS, poseWaveGaitLegDown[currentPhase]);
-                currentPhase    = (currentPhase + 1) % (HEXAPOD_LEGS+1);            // Increment phase with wrap-around
-                break;
-        }   
-        currentStep     = (currentStep  + 1) % 2;                                   // Toggle between up and down poses
+bool GaitController::setStridePreset(uint8_t preset) {
+    if (preset >= GAIT_STRIDE_PRESETS) {
+        LOG_ERR("Invalid stride preset " + String(preset));
+        return false;
     }
-    return true;                                                                    // Return true to indicate gait was performed
+    return submit({GAIT_CMD_SET_STRIDE, (int16_t)preset});
+}
+uint8_t GaitController::getStridePreset() const {
+    return stridePreset;
 }
 
+bool GaitController::setVelocity(int16_t vx, int16_t vy, int16_t wz) {
+    bool ok = submit({GAIT_CMD_SET_VX, vx});
+    ok = submit({GAIT_CMD_SET_VY, vy}) && ok;
+    ok = submit({GAIT_CMD_SET_WZ, wz}) && ok;
+    return submit({GAIT_CMD_SET_VELOCITY_MODE, 1}) && ok;
+}
 
-// Perform the ripple gait, two legs swing with a phase offset
-bool GaitController::doRippleGait() {
-
-    if(hexapod->isMoving()) return false;                                           // If hexapod is already moving, do nothing
-
-    if (currentPhase == HEXAPOD_LEGS/2) {                                           // If end of the ripple gait cycle
-        hexapod->moveStandUp();                                                     // Move hexapod to standing position
-        currentPhase = 0;                                                           // Reset phase for the next cycle
-        currentStep  = 0;                                                           // Reset step for the next cycle
-
-    } else {                                                                        // If not at the end of the ripple gait cycle
-        switch(currentStep) {
-            case 0:                                                                 // If current step is 0, move the two legs up
-                hexapod->move(poseRippleGaitIDs[currentPhase], LEG_SERVOS*2, poseRippleGaitLegUp[currentPhase]);
-                break;
+bool GaitController::clearVelocity() {
+    bool ok = setVelocity(0, 0, 0);
+    return submit({GAIT_CMD_SET_VELOCITY_MODE, 0}) && ok;
+}
 
-            case 1:                                                                 // If current step is 1, move the two legs down
-                hexapod->move(poseRippleGaitIDs[currentPhase], LEG_SERVOS*2, poseRippleGaitLegDown[currentPhase]);
-                currentPhase    = (currentPhase + 1) % (HEXAPOD_LEGS/2+1);            // Increment phase with wrap-around
-                break;
-        }
-        currentStep     = (currentStep + 1) % 2;                                    // Toggle between up and down poses
+bool GaitController::setDutyFactor(float duty) {
+    if (duty < GAIT_DUTY_MIN || duty > GAIT_DUTY_MAX) {
+        LOG_ERR("Invalid duty factor " + String(duty, 3));
+        return false;
     }
-    return true;
+    return submit({GAIT_CMD_SET_DUTY, (int16_t)lroundf(duty * 1000.0f)});
+}
+float GaitController::getDutyFactor() const {
+    return dutyFactor;
 }
 
-// Perform the tripod gait, three legs swing at a time
-bool GaitController::doTripodGait() {
-
-    if(hexapod->isMoving()) return false;                                                 // If hexapod is already moving, do nothing
-
-    if (currentPhase == HEXAPOD_LEGS/3) {                                           // If end of the tripod gait cycle
-        hexapod->moveStandUp();                                                     // Move hexapod to standing position
-        currentPhase = 0;                                                           // Reset phase for the next cycle
-        currentStep  = 0;                                                           // Reset step for the next cycle
+bool GaitController::setPhaseOffset(uint8_t leg, float offset) {
+    if (leg >= HEXAPOD_LEGS || offset < 0.0f || offset >= 1.0f) {
+        LOG_ERR("Invalid phase offset " + String(offset, 3) + " for leg " + String(leg));
+        return false;
+    }
+    int16_t value = leg * 1000 + (int16_t)lroundf(offset * 1000.0f) % 1000;
+    return submit({GAIT_CMD_SET_OFFSET, value});
+}
 
-    } else {                                                                        // If not at the end of the tripod gait cycle
-        switch(currentStep) {
-            case 0:                                                                 // If current step is 0, move the two legs up
-                hexapod->move(poseTripodGaitIDs[currentPhase], LEG_SERVOS*3, poseTripodGaitLegUp[currentPhase]);
-                break;
+bool GaitController::setContact(uint8_t legMask) {
+    return submit({GAIT_CMD_SET_CONTACT, (int16_t)(legMask & 0x3F)});
+}
+uint32_t GaitController::getEarlyTouchdowns() const {
+    return earlyTouchdowns;
+}
+float GaitController::getPhase() const {
+    return gaitPhase;
+}
 
-            case 1:                                                                 // If current step is 1, move the two legs down
-                hexapod->move(poseTripodGaitIDs[currentPhase], LEG_SERVOS*3, poseTripodGaitLegDown[currentPhase]);
-                currentPhase    = (currentPhase + 1) % (HEXAPOD_LEGS/3+1);          // Increment phase with wrap-around
-                break;
-        }
-        currentStep     = (currentStep + 1) % 2;                                    // Toggle between up and down poses
+bool GaitController::setVelocityLimits(uint16_t accel, uint16_t jerk) {
+    if (accel == 0 || jerk == 0 || accel > INT16_MAX || jerk > INT16_MAX) {
+        LOG_ERR("Invalid velocity limits " + String(accel) + " " + String(jerk));
+        return false;
     }
-    return true;
+    bool ok = submit({GAIT_CMD_SET_ACCEL_LIMIT, (int16_t)accel});
+    return submit({GAIT_CMD_SET_JERK_LIMIT, (int16_t)jerk}) && ok;
 }
 
-// Perform the rotate gait
-bool GaitController::doRotateGait() {
-    if(hexapod->isMoving()) return false;                                                 // If hexapod is already moving, do nothing
-    // TODO: Implement rotate gait logic
-    return true;
 
-};
 
 // Print the current gait status to Serial
 bool GaitController::printStatus() {
@@ -236,97 +592,191 @@ bool GaitController::printStatus() {
             PRINT("Unknown");
             break;
     }
-    PRINT(" | Step " + String((int)currentStep));
-    PRINTLN(" | Phase " + String((int)currentPhase));
+    PRINTLN(" | Phase " + String(gaitPhase, 3) + " | " + String(gaitFrequency, 3) + " Hz"
+            + (holder != nullptr ? " | held by " + String(holder) : ""));
+    String legs = "";
+    for (uint8_t leg = 0; leg < HEXAPOD_LEGS; leg++) {
+        legs += " " + String(offsets[leg], 2);
+    }
+    PRINTLN("Duty Factor      : " + String(dutyFactor, 3) + " | offsets" + legs);
+    PRINTLN("Foot Contact     : 0x" + String((int)contactMask, HEX) + " | early touchdowns " + String((unsigned long)earlyTouchdowns));
     PRINTLN("Walk Direction   : " + String((int)gaitWalkDirection));
     PRINTLN("Rotate Direction : " + String(gaitRotateDirection == ROTATE_CW ? "CW" : "CCW"));
     PRINTLN("Gait Speed       : " + String((int)gaitSpeed));
     PRINTLN("Gait Step Size   : " + String((int)gaitStepSize));
+    PRINTLN("Stride Preset    : " + String((int)stridePreset) + " " + String(strideTable->name) + " | " + String(strideTable->stride, 0) + " mm");
+    PRINTLN("Velocity         : " + String(velocityMode ? "on" : "off") + " | target " + String((int)velocityTarget[0]) + " " + String((int)velocityTarget[1]) + " " + String((int)velocityTarget[2])
+            + " | ramp " + String(velocityRamp[0].velocity, 0) + " " + String(velocityRamp[1].velocity, 0) + " " + String(velocityRamp[2].velocity * RAD_TO_DEG, 0));
+    PRINTLN("Velocity Limits  : accel " + String((int)maxAccel) + " mm/s^2 | jerk " + String((int)maxJerk) + " mm/s^3 | phase rate " + String(phaseRate, 3));
+    PRINTLN("Control Ticks    : " + String((unsigned long)controlTicks) + " | Step tick " + String((unsigned long)stepTick) + "/" + String((unsigned long)stepTicks));
+    PRINTLN("Command Queue    : " + String(commandQueue.size()) + "/" + String(commandQueue.capacity()) + " | Dropped " + String((unsigned long)commandQueue.getDropped()));
+    PRINTLN("Setpoint Frames  : staged " + String((unsigned long)setpointSeq) + " | written " + String((unsigned long)writtenSeq));
     return true;
 }
 
-// Process console commands for gait control
-bool GaitController::runConsoleCommands(const String& cmd, const String& args) {
-    
-    if (cmd == "gs") {
-        if(!printStatus()) LOG_ERR("Failed to print status");
-        return true;
+// gs: Print the gait status
+static bool showGait(void* gc, const CommandArgs&) {
+    if (static_cast<GaitController*>(gc)->printStatus()) return true;
+    LOG_ERR("Failed to print status");
+    return false;
+}
 
-    } else if (cmd == "gw") {
-        setGaitType(GAIT_WAVE);
-        LOG_INF("Gait set to WAVE");
-        return true;
+// Start a gait, refused while another module holds the gait
+static bool startGait(void* gc, GaitType type, const char* name) {
+    if (!static_cast<GaitController*>(gc)->setGaitType(type)) return false;
+    LOG_INF("Gait set to " + String(name));
+    return true;
+}
 
-    } else if (cmd == "gr") {
-        setGaitType(GAIT_RIPPLE);
-        LOG_INF("Gait set to RIPPLE");
-        return true;
+// gw: Start the wave gait
+static bool startWave(void* gc, const CommandArgs&) {
+    return startGait(gc, GAIT_WAVE, "WAVE");
+}
 
-    } else if (cmd == "gt") {
-        setGaitType(GAIT_TRIPOD);
-        LOG_INF("Gait set to TRIPOD");
-        return true;
+// gr: Start the ripple gait
+static bool startRipple(void* gc, const CommandArgs&) {
+    return startGait(gc, GAIT_RIPPLE, "RIPPLE");
+}
 
-    } else if (cmd == "gi") {
-        setGaitType(GAIT_IDLE);
-        LOG_INF("Gait set to IDLE");
-        return true;
+// gt: Start the tripod gait
+static bool startTripod(void* gc, const CommandArgs&) {
+    return startGait(gc, GAIT_TRIPOD, "TRIPOD");
+}
 
-    } else if (cmd == "grt") {
-        setGaitType(GAIT_ROTATE);
-        LOG_INF("Gait set to ROTATE");
-        return true;
+// gi: Go idle
+static bool startIdle(void* gc, const CommandArgs&) {
+    return startGait(gc, GAIT_IDLE, "IDLE");
+}
 
-    } else if (cmd == "gswd") {
-        int8_t dir = args.toInt();
-        setWalkDirection(dir);
-        LOG_INF("Walk direction set to " + String(dir));
-        return true;
+// grt: Start the rotate gait
+static bool startRotate(void* gc, const CommandArgs&) {
+    return startGait(gc, GAIT_ROTATE, "ROTATE");
+}
 
-    } else if (cmd == "gsrd") {
-        //int8_t dir = args.toInt();
-        //setRotateDirection(dir);
-        //LOG_INF("Rotate direction set to " + String(dir));
-        return true;
-    
-    } else if (cmd == "gss") {
-        uint16_t speed = args.toInt();
-        if (!setGaitSpeed(speed)) {
-            LOG_ERR("Failed to set gait speed");
+// gswd dir: Set the walk direction
+static bool setWalkDirection(void* gc, const CommandArgs& args) {
+    int8_t dir = (int8_t)args.toInt(0, 0);
+    static_cast<GaitController*>(gc)->setWalkDirection(dir);
+    LOG_INF("Walk direction set to " + String(dir));
+    return true;
+}
+
+// gsrd dir: Set the rotate direction, not wired to the gait yet
+static bool setRotateDirection(void*, const CommandArgs&) {
+    return true;
+}
+
+// gss speed: Set the gait speed
+static bool setGaitSpeed(void* gc, const CommandArgs& args) {
+    if (static_cast<GaitController*>(gc)->setGaitSpeed((uint16_t)args.toInt(0, 0))) return true;
+    LOG_ERR("Failed to set gait speed");
+    return false;
+}
+
+// gsz size: Set the gait step size
+static bool setGaitStepSize(void* gc, const CommandArgs& args) {
+    uint16_t size = (uint16_t)args.toInt(0, 0);
+    static_cast<GaitController*>(gc)->setGaitStepSize(size);
+    LOG_INF("Gait step size set to " + String(size));
+    return true;
+}
+
+// gsp [preset]: Set the stride preset, list the presets without argument
+static bool setStridePreset(void* gc, const CommandArgs& args) {
+    if (args.count() == 0) {
+        for (uint8_t i = 0; i < GAIT_STRIDE_PRESETS; i++) {
+            PRINTLN("  " + String(i) + " " + String(gaitStrideTables[i].name) + " | " + String(gaitStrideTables[i].stride, 0) + " mm");
         }
         return true;
+    }
+    uint8_t preset = (uint8_t)args.toInt(0, 0);
+    if (!static_cast<GaitController*>(gc)->setStridePreset(preset)) return false;
+    LOG_INF("Stride preset set to " + String(gaitStrideTables[preset].name));
+    return true;
+}
 
-    } else if (cmd == "gsz") {
-        uint16_t size = args.toInt();
-        setGaitStepSize(size);
-        LOG_INF("Gait step size set to " + String(size));
-        return true;
+// gv vx vy wz: Walk at a body velocity, missing components are 0
+static bool setVelocity(void* gc, const CommandArgs& args) {
+    int16_t vx = (int16_t)args.toInt(0, 0);
+    int16_t vy = (int16_t)args.toInt(1, 0);
+    int16_t wz = (int16_t)args.toInt(2, 0);
+    if (!static_cast<GaitController*>(gc)->setVelocity(vx, vy, wz)) return false;
+    LOG_INF("Velocity set to " + String(vx) + " mm/s, " + String(vy) + " mm/s, " + String(wz) + " deg/s");
+    return true;
+}
 
-    } else if (cmd == "g?") {
-        printConsoleHelp();
-        return true;
+// gvo: Stop following the velocity
+static bool clearVelocity(void* gc, const CommandArgs&) {
+    if (!static_cast<GaitController*>(gc)->clearVelocity()) return false;
+    LOG_INF("Velocity mode off, using the preset stride");
+    return true;
+}
+
+// gvl accel jerk: Set the velocity limits
+static bool setVelocityLimits(void* gc, const CommandArgs& args) {
+    if (args.count() < 2) {
+        LOG_ERR("Usage: gvl [accel] [jerk]");
+        return false;
     }
+    uint16_t accel = (uint16_t)args.toInt(0, 0);
+    uint16_t jerk  = (uint16_t)args.toInt(1, 0);
+    if (!static_cast<GaitController*>(gc)->setVelocityLimits(accel, jerk)) return false;
+    LOG_INF("Velocity limits set to " + String(accel) + " mm/s^2, " + String(jerk) + " mm/s^3");
+    return true;
+}
 
-    return false;
+// gdf duty: Set the duty factor
+static bool setDutyFactor(void* gc, const CommandArgs& args) {
+    float duty = atof(args.get(0));
+    if (!static_cast<GaitController*>(gc)->setDutyFactor(duty)) return false;
+    LOG_INF("Duty factor set to " + String(duty, 3));
+    return true;
+}
+
+// gpo leg offset: Set the phase offset of a leg
+static bool setPhaseOffset(void* gc, const CommandArgs& args) {
+    if (args.count() < 2) {
+        LOG_ERR("Usage: gpo [leg] [offset]");
+        return false;
+    }
+    uint8_t leg    = (uint8_t)args.toInt(0, 0);
+    float   offset = atof(args.get(1));
+    if (!static_cast<GaitController*>(gc)->setPhaseOffset(leg, offset)) return false;
+    LOG_INF("Leg " + String(leg) + " phase offset set to " + String(offset, 3));
+    return true;
 }
 
+// g?: Print the gait help
+static bool showGaitHelp(void* gc, const CommandArgs&) {
+    return static_cast<GaitController*>(gc)->printConsoleHelp();
+}
+
+// Console commands, the help is printed from this table
+static const ConsoleCommand gaitCommands[] = {
+    { "gs",     "",               "Show current gait status",                                       showGait },
+    { nullptr,  "",               "",                                                               nullptr },
+    { "gw",     "",               "start Wave gait",                                                startWave },
+    { "gr",     "",               "start Ripple gait",                                              startRipple },
+    { "gt",     "",               "start Tripod gait",                                              startTripod },
+    { "gi",     "",               "start Idle gait",                                                startIdle },
+    { "grt",    "",               "start Rotate gait",                                              startRotate },
+    { nullptr,  "",               "",                                                               nullptr },
+    { "gswd",   "[dir]",          "Set walk direction -180 to 180 (default 0)",                     setWalkDirection },
+    { "gsrd",   "[dir]",          "Set rotate direction CW or CCW (default CW)",                    setRotateDirection },
+    { "gss",    "[speed]",        "Set gait speed 0 to 1023 (default 300)",                         setGaitSpeed },
+    { "gsz",    "[size]",         "Set gait step size (default 100)",                               setGaitStepSize },
+    { "gsp",    "[preset]",       "Set stride preset, list presets if none given (default 1)",      setStridePreset },
+    { "gdf",    "[duty]",         "Set duty factor 0.5 to 0.95, higher is slower and more stable",  setDutyFactor },
+    { "gpo",    "[leg] [ofs]",    "Set the phase offset of a leg 0 to 1 cycle",                     setPhaseOffset },
+    { "gv",     "[vx] [vy] [wz]", "Walk at a body velocity in mm/s, mm/s, deg/s",                   setVelocity },
+    { "gvo",    "",               "Stop following the velocity, use the preset stride",             clearVelocity },
+    { "gvl",    "[acc] [jerk]",   "Set velocity limits in mm/s^2, mm/s^3 (default 200 1000)",       setVelocityLimits },
+    { "g?",     "",               "Show this help",                                                 showGaitHelp },
+};
+const ConsoleCommandTable GaitController::commandTable = { "Gait Commands:", gaitCommands, sizeof(gaitCommands) / sizeof(gaitCommands[0]) };
+
 // Print gait-specific help information
 bool GaitController::printConsoleHelp() {
-    PRINTLN("Gait Commands:\n\r");
-    PRINTLN("  gs               - Show current gait status");
-    PRINTLN("");
-    PRINTLN("  gw               - start Wave gait");
-    PRINTLN("  gr               - start Ripple gait");
-    PRINTLN("  gt               - start Tripod gait");
-    PRINTLN("  gi               - start Idle gait");
-    PRINTLN("  grt              - start Rotate gait");
-    PRINTLN("");
-    PRINTLN("  gswd [dir]       - Set walk direction -180 to 180 (default 0)");
-    PRINTLN("  gsrd [dir]       - Set rotate direction CW or CCW (default CW)");
-    PRINTLN("  gss [speed]      - Set gait speed 0 to 1023 (default 300)");
-    PRINTLN("  gsz [size]       - Set gait step size (default 100)");
-    PRINTLN("  g?               - Show this help");
-    PRINTLN("");
-    return true;
+    return CommandRegistry::printHelp(commandTable);
 }
 // GaitController.cpp
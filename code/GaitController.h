@@ -2,6 +2,22 @@
 #define GaitController_h
 
     #include "Hexapod.h"
+    #include "ControlTick.h"
+    #include "SPSCQueue.h"
+    #include "Trajectory.h"
+    #include "CommandRegistry.h"
+
+    #define GAIT_QUEUE_SIZE     uint16_t(16)        // Number of slots in the gait command queue (power of two)
+    #define GAIT_US_PER_TICK    uint32_t(440000)    // Servo travel time per position tick at Moving_Speed 1 in us (AX-18A: 0.111 rpm/unit)
+    #define GAIT_STEP_SETTLE    uint32_t(20000)     // Extra time added to every step for the servos to settle in us
+    #define GAIT_MAX_ACCEL      uint16_t(200)       // Default body acceleration limit in mm/s^2
+    #define GAIT_MAX_JERK       uint16_t(1000)      // Default body jerk limit in mm/s^3
+    #define GAIT_YAW_RADIUS     float(250.0)        // Typical foot distance from the body center, converts the limits to yaw in mm
+    #define GAIT_MAX_PHASE_RATE float(2.0)          // Largest step timing speed-up once the stride reaches the preset length
+    #define GAIT_DUTY_MIN       float(0.5)          // Lowest duty factor, keeps at least three feet on the ground
+    #define GAIT_DUTY_MAX       float(0.95)         // Highest duty factor
+    #define GAIT_OFFSET_SLEW    float(0.25)         // Largest change of a leg phase offset in cycles per second
+    #define GAIT_CONTACT_WINDOW float(0.5)          // Swing fraction after which foot contact ends the swing (foot descending)
 
     enum GaitType {
         GAIT_IDLE,
@@ -16,14 +32,54 @@
         ROTATE_CCW
     };
 
+    enum GaitCommandType : uint8_t {
+        GAIT_CMD_SET_TYPE,                          // value = GaitType
+        GAIT_CMD_SET_SPEED,                         // value = servo speed 0 to 1023
+        GAIT_CMD_SET_STEP_SIZE,                     // value = step size 0 to 1023
+        GAIT_CMD_SET_WALK_DIRECTION,                // value = direction -180 to 180
+        GAIT_CMD_SET_ROTATE_DIRECTION,              // value = RotateDirection
+        GAIT_CMD_SET_STRIDE,                        // value = stride preset index
+        GAIT_CMD_SET_VX,                            // value = forward velocity in mm/s
+        GAIT_CMD_SET_VY,                            // value = left velocity in mm/s
+        GAIT_CMD_SET_WZ,                            // value = counter-clockwise yaw rate in deg/s
+        GAIT_CMD_SET_VELOCITY_MODE,                 // value = 1 stride follows the velocity, 0 fixed preset stride
+        GAIT_CMD_SET_ACCEL_LIMIT,                   // value = acceleration limit in mm/s^2
+        GAIT_CMD_SET_JERK_LIMIT,                    // value = jerk limit in mm/s^3
+        GAIT_CMD_SET_DUTY,                          // value = duty factor in 1/1000
+        GAIT_CMD_SET_OFFSET,                        // value = leg * 1000 + phase offset in 1/1000 cycle
+        GAIT_CMD_SET_CONTACT                        // value = feet on the ground, bit 0 = leg 0
+    };
+
+    struct GaitStrideTable;                         // Stride presets, see GaitPoses.h
+
+    struct GaitCommand {
+        GaitCommandType type;                       // Command type
+        int16_t         value;                      // Command argument
+    };
+
+    // The gait runs in two stages: controlTick() is called from the control timer interrupt,
+    // drains the command queue and produces servo setpoints; update() is called from loop()
+    // and streams the latest setpoints to the bus. Setters only enqueue commands, so console
+    // and RC code never block on, or race with, the control stage.
+    //
+    // Gaits are generated by one phase oscillator: each leg runs at the oscillator phase minus its
+    // offset, swings for the first (1 - duty) of its cycle and is on the ground for the rest. The
+    // gait types only select a GaitPattern; duty and offsets can be changed while walking.
     class GaitController {
         public:
             GaitController();                                           // Constructor
-            bool            begin(Hexapod* hexapod);                    // Initialize with Hexapod
-            bool            update();                                   // Update the gait controller
+            bool            begin(Hexapod* hexapod,                     // Initialize with Hexapod
+                                  uint32_t tickPeriod = CONTROL_TICK_PERIOD);
+            bool            update();                                   // Write pending setpoints to the servos, call in loop()
+            void            controlTick();                              // Advance the gait and produce setpoints, call from the control tick ISR
+
+            bool            submit(const GaitCommand& command);         // Queue a command for the control stage
 
             bool            setGaitType(GaitType newGait);              // Set the current gait type
             GaitType        getGaitType() const;                        // Get the current gait type
+            bool            hold(const char* owner);                    // Keep the gait idle while owner drives the servos, false if walking or held by another
+            void            release(const char* owner);                 // End the hold taken by owner
+            const char*     getHolder() const;                          // Module holding the gait, nullptr if none
             void            setWalkDirection(int8_t w_dir);               // -180 to 180
             int8_t          getWalkDirection() const;
             void            setRotateDirection(RotateDirection r_dir); // -180 to 180
@@ -32,29 +88,98 @@
             uint16_t        getGaitSpeed() const;
             void            setGaitStepSize(uint16_t step_size);                 // 0 to 1023
             uint16_t        getGaitStepSize() const;
+            bool            setStridePreset(uint8_t preset);            // Select a stride preset from GaitPoses.h
+            uint8_t         getStridePreset() const;
+            bool            setVelocity(int16_t vx, int16_t vy, int16_t wz);   // Body velocity in mm/s and deg/s, the stride follows it
+            bool            clearVelocity();                            // Return to the fixed stride of the preset
+            bool            setVelocityLimits(uint16_t accel, uint16_t jerk);  // Acceleration and jerk limits in mm/s^2 and mm/s^3
+            bool            setDutyFactor(float duty);                  // GAIT_DUTY_MIN to GAIT_DUTY_MAX, legs pick it up at their next liftoff
+            float           getDutyFactor() const;
+            bool            setPhaseOffset(uint8_t leg, float offset);  // 0 to 1 cycle, the leg slews to it at GAIT_OFFSET_SLEW
+            bool            setContact(uint8_t legMask);                // Feet sensed on the ground, a descending swing ends on contact
+            uint32_t        getEarlyTouchdowns() const;                 // Swings ended early by contact
+            float           getPhase() const;                           // Oscillator phase in cycles, 0 to 1
 
             bool            printStatus();                              // Print current gait status to Serial
-            bool            runConsoleCommands(const String& cmd, const String& args);  // Process console commands for gait control
             bool            printConsoleHelp();                         // Print gait-specific help information
+            static const ConsoleCommandTable commandTable;              // Console commands and their help
 
 
 
         private:
             Hexapod*        hexapod;                                    // Pointer to the Hexapod instance
+            uint32_t        tickPeriod;                                 // Control tick period in us
+
+            SPSCQueue<GaitCommand, GAIT_QUEUE_SIZE> commandQueue;       // Commands from loop() to the control stage
+            const char*     holder;                                     // Module driving the servos instead of the gait, loop() only
+
+            // Control stage state, written only from controlTick()
+            volatile GaitType        gaitType;                          // Current gait type
+            volatile int8_t          gaitWalkDirection;                 // -180 to 180
+            volatile RotateDirection gaitRotateDirection;               // Clockwise or counter-clockwise
+            volatile uint16_t        gaitSpeed;                         // 0 to 1023
+            volatile uint16_t        gaitStepSize;                      // 0 to 1023
+            volatile uint8_t         stridePreset;                      // Index of the selected stride preset
+            const GaitStrideTable* volatile strideTable;                // Stride of the selected preset, in flash
+            volatile uint32_t        controlTicks;                      // Number of control ticks run
+
+            // Phase oscillator
+            volatile float           gaitPhase;                         // Oscillator phase in cycles, 0 to 1
+            volatile float           gaitFrequency;                     // Oscillator frequency in cycles per second
+            volatile float           dutyFactor;                        // Duty factor legs take at liftoff
+            float                    turn;                              // Turn component of the pattern
+            float                    offsetTarget[HEXAPOD_LEGS];        // Requested phase offsets
+            float                    offsets[HEXAPOD_LEGS];             // Phase offsets, slewed towards offsetTarget
+            float                    legPhase[HEXAPOD_LEGS];            // Phase of each leg in its own cycle
+            float                    legDuty[HEXAPOD_LEGS];             // Duty factor of each leg's current cycle
+            float                    legLiftoff[HEXAPOD_LEGS];          // Coxa offset at liftoff in ticks
+            float                    legHalfStride[HEXAPOD_LEGS];       // Half the coxa travel of each leg's current cycle in ticks
+            float                    legTouchdown[HEXAPOD_LEGS];        // Coxa offset at touchdown in ticks
+            float                    legSwingLift[HEXAPOD_LEGS];        // Foot lift the swing started from, 0 to 1
+            float                    legStanceLift[HEXAPOD_LEGS];       // Foot lift held through the stance, non-zero after an early touchdown
+
+            // Foot contact
+            volatile uint8_t         contactMask;                       // Feet sensed on the ground, bit 0 = leg 0
+            uint8_t                  swingClear;                        // Legs that have been seen off the ground since liftoff
+            volatile uint32_t        earlyTouchdowns;                   // Swings ended early by contact
+
+            // Body velocity command, ramped every tick and turned into a stride at each liftoff
+            volatile bool            velocityMode;                      // Stride follows the velocity instead of the preset
+            volatile int16_t         velocityTarget[3];                 // Commanded vx, vy in mm/s and wz in deg/s
+            Trajectory::Ramp         velocityRamp[3];                   // Limited vx, vy in mm/s and wz in rad/s
+            volatile uint16_t        maxAccel;                          // Acceleration limit in mm/s^2
+            volatile uint16_t        maxJerk;                           // Jerk limit in mm/s^3
+            float                    footX[HEXAPOD_LEGS];               // Standing foot position from the body center in mm
+            float                    footY[HEXAPOD_LEGS];
+            float                    forwardX[HEXAPOD_LEGS];            // Unit direction a foot moves when its coxa steps forward
+            float                    forwardY[HEXAPOD_LEGS];
+            float                    strideTicks[HEXAPOD_LEGS];         // Planned coxa travel of each leg in ticks
+            volatile float           phaseRate;                         // Oscillator speed-up when the stride reaches the preset length
+
+            // Step interpolated from stepStart to stepTarget, used to stand up and to blend into a new pattern
+            int32_t                  stepStart[HEXAPOD_SERVOS];         // Setpoints when the step was staged
+            int32_t                  stepTarget[HEXAPOD_SERVOS];        // Keyframe the step moves to
+            uint32_t                 stepTick;                          // Ticks elapsed in the current step
+            uint32_t                 motionTicks;                       // Ticks spent interpolating
+            uint32_t                 stepTicks;                         // Total ticks in the step, including settle time
+
+            // Setpoint frame shared between the control stage and loop()
+            volatile int32_t         setpoints[HEXAPOD_SERVOS];         // Goal positions for servo IDs 1 to 18
+            volatile uint32_t        setpointSeq;                       // Incremented every time a new frame is staged
+            uint32_t                 writtenSeq;                        // Last frame written to the bus
+            uint16_t                 appliedSpeed;                      // Last speed written to the bus
 
-            uint8_t         currentPhase;                               // Current phase of the gait
-            uint8_t         currentStep;                                // Current step in the gait sequence
-            
-            GaitType        gaitType;                                   // Current gait type
-            int8_t          gaitWalkDirection;                          // -180 to 180
-            RotateDirection gaitRotateDirection;                        // Clockwise or counter-clockwise
-            uint16_t        gaitSpeed;                                  // 0 to 1023
-            uint16_t        gaitStepSize;                               // 0 to 1023
-
-            bool            doWaveGait();                               // Perform the wave gait
-            bool            doRippleGait();                             // Perform the ripple gait
-            bool            doTripodGait();                             // Perform the tripod gait
-            bool            doRotateGait();                             // Perform the rotate gait
+            void            applyCommand(const GaitCommand& command);   // Apply a queued command in the control stage
+            void            stagePose(const uint8_t* ids, uint8_t num_servos, const int32_t* positions);  // Start a step towards goal positions for a set of servos
+            void            interpolateStep();                          // Produce the setpoint frame for the current step tick
+            void            stageStandUp();                             // Stage the standing pose for all servos
+            void            rampVelocity();                             // Advance the velocity ramps by one tick
+            float           cycleTime() const;                          // Oscillator period at phase rate 1 in s
+            void            planStrides();                              // Plan the coxa travel of every leg and the phase rate
+            void            startPattern(GaitType type);                // Load a pattern and blend into its first frame
+            void            runOscillator();                            // Advance the oscillator and produce a setpoint frame
+            void            evaluateLeg(uint8_t leg, int32_t* positions);   // Joint positions of one leg at its phase
+            void            swingPose(uint8_t leg, float s, float& coxa, float& lift);  // Coxa offset and foot lift at swing fraction s
     };
 
 #endif // GaitController_h
@@ -1,23 +1,73 @@
 #ifndef __GAITPOSES_H__
-#define __GAITPOSES_H__ 
+#define __GAITPOSES_H__
 
     #define HEXAPOD_LEGS   uint8_t(6)   // Maximum number of legs
     #define LEG_SERVOS     uint8_t(3)   // Number of servos per leg
-    #define D 100                       // Coxa movement offset for all gaits
 
-    // Wave Gait Poses
-    uint8_t poseWaveGaitIDs[HEXAPOD_LEGS][LEG_SERVOS]     = {{1    , 2  , 3  }, {4    , 5  , 6  }, {7    , 8  , 9  }, {10   , 11 , 12 }, {13   , 14 , 15 }, {16   , 17 , 18 }};
-    int32_t poseWaveGaitLegUp[HEXAPOD_LEGS][LEG_SERVOS]   = {{665  , 665, 972}, {358  , 665, 972}, {512  , 665, 972}, {512  , 665, 972}, {358  , 665, 972}, {665  , 665, 972}}; 
-    int32_t poseWaveGaitLegDown[HEXAPOD_LEGS][LEG_SERVOS] = {{665-D, 358, 665}, {358+D, 358, 665}, {512-D, 358, 665}, {512+D, 358, 665}, {358-D, 358, 665}, {665+D, 358, 665}}; 
+    // Gait geometry
+    #define GAIT_FOOT_RADIUS        float(150.0)    // Horizontal distance from coxa axis to foot when standing in mm
+    #define GAIT_FEMUR_UP           int32_t(665)    // Femur position with the foot lifted
+    #define GAIT_TIBIA_UP           int32_t(972)    // Tibia position with the foot lifted
+    #define GAIT_FEMUR_DOWN         int32_t(358)    // Femur position with the foot on the ground
+    #define GAIT_TIBIA_DOWN         int32_t(665)    // Tibia position with the foot on the ground
 
-    // Ripple Gait Poses
-    uint8_t poseRippleGaitIDs[HEXAPOD_LEGS/2][LEG_SERVOS*2]     = {{1    , 2  , 3  , 4    , 5  , 6  }, {7    , 8  , 9  , 10   , 11 , 12 }, {13   , 14 , 15 , 16   , 17 , 18 }}; 
-    int32_t poseRippleGaitLegUp[HEXAPOD_LEGS/2][LEG_SERVOS*2]   = {{665  , 665, 972, 358  , 665, 972}, {512  , 665, 972, 512  , 665, 972}, {358  , 665, 972, 665  , 665, 972}}; 
-    int32_t poseRippleGaitLegDown[HEXAPOD_LEGS/2][LEG_SERVOS*2] = {{665-D, 358, 665, 358+D, 358, 665}, {512-D, 358, 665, 512+D, 358, 665}, {358-D, 358, 665, 665+D, 358, 665}}; 
+    // Stride presets, foot travel per step in mm
+    #define GAIT_STRIDE_SHORT       float(40.0)     // Short stride, most stable
+    #define GAIT_STRIDE_MEDIUM      float(76.0)     // Medium stride, 100 ticks of coxa travel
+    #define GAIT_STRIDE_LONG        float(100.0)    // Long stride, uses the full coxa range of the rear/front legs
+    #define GAIT_STRIDE_PRESETS     uint8_t(3)      // Number of stride presets
+    #define GAIT_STRIDE_DEFAULT     uint8_t(1)      // Medium stride
 
-    // Tripod Gait Poses
-    uint8_t poseTripodGaitIDs[HEXAPOD_LEGS/3][LEG_SERVOS*3]     = {{1    , 2  , 3  , 10   , 11 , 12 , 13   , 14 , 15 }, { 4   ,5  , 6  , 7    , 8  , 9  ,16   , 17 , 18 }}; 
-    int32_t poseTripodGaitLegUp[HEXAPOD_LEGS/3][LEG_SERVOS*3]   = {{665  , 665, 972, 512  , 665, 972, 358  , 665, 972}, {358  ,665, 972, 512  , 665, 972,665  , 665, 972}}; 
-    int32_t poseTripodGaitLegDown[HEXAPOD_LEGS/3][LEG_SERVOS*3] = {{665-D, 358, 665, 512+D, 358, 665, 358-D, 358, 665}, {358+D,358, 665, 512-D, 358, 665,665+D, 358, 665}}; 
+    constexpr int32_t gaitCoxaNeutral[HEXAPOD_LEGS]   = {665, 358, 512, 512, 358, 665};    // Coxa position of each leg when standing
+    constexpr int32_t gaitCoxaDirection[HEXAPOD_LEGS] = { -1,  +1,  -1,  +1,  -1,  +1};    // Coxa travel direction of each leg during a step
 
-#endif // __GAITPOSES_H__
\ No newline at end of file
+    // asin(x) by its Taylor series, accurate to 1e-5 for |x| <= 0.35 (strides up to ~100 mm)
+    constexpr float gaitAsin(float x) {
+        return x + x*x*x / 6.0f + 3.0f*x*x*x*x*x / 40.0f + 15.0f*x*x*x*x*x*x*x / 336.0f;
+    }
+
+    // Coxa travel in ticks for a foot that sweeps a chord of the given length on the foot circle
+    constexpr int32_t gaitStrideTicks(float stride) {
+        return int32_t(2.0f * gaitAsin(stride / (2.0f * GAIT_FOOT_RADIUS)) * (180.0f / float(M_PI)) * (1023.0f / 300.0f) + 0.5f);
+    }
+
+    // Stride preset
+    struct GaitStrideTable {
+        const char* name;                                                   // Preset name
+        float       stride;                                                 // Foot travel per step in mm
+        int32_t     strideTicks;                                            // Coxa travel per step in ticks
+    };
+
+    constexpr GaitStrideTable makeGaitStrideTable(const char* name, float stride) {
+        return { name, stride, gaitStrideTicks(stride) };
+    }
+
+    static_assert(358 - gaitStrideTicks(GAIT_STRIDE_LONG) >= 225 && 665 + gaitStrideTicks(GAIT_STRIDE_LONG) <= 798,
+                  "Long stride exceeds the coxa angle limits");
+
+    // Stride presets, generated at compile time into flash
+    constexpr GaitStrideTable gaitStrideTables[GAIT_STRIDE_PRESETS] = {
+        makeGaitStrideTable("short",  GAIT_STRIDE_SHORT),
+        makeGaitStrideTable("medium", GAIT_STRIDE_MEDIUM),
+        makeGaitStrideTable("long",   GAIT_STRIDE_LONG)
+    };
+
+    // Phase oscillator parameters of a gait. Leg i is in swing while frac(phase - offsets[i]) < 1 - duty,
+    // so every gait, and anything in between, is just a duty factor and six offsets.
+    struct GaitPattern {
+        const char* name;                                                   // Pattern name
+        float       duty;                                                   // Fraction of the cycle each foot is on the ground
+        float       offsets[HEXAPOD_LEGS];                                  // Phase offset of each leg in cycles
+        float       turn;                                                   // 0 walks forward, 1 turns in place with the preset stride
+    };
+
+    // Patterns indexed by GaitType, the idle entry is never run
+    constexpr GaitPattern gaitPatterns[] = {
+        { "idle",   0.5f,        { 0.0f,      0.0f,      0.0f,      0.0f,      0.0f,      0.0f      }, 0.0f },
+        { "wave",   5.0f / 6.0f, { 0.0f,      1.0f/6.0f, 2.0f/6.0f, 3.0f/6.0f, 4.0f/6.0f, 5.0f/6.0f }, 0.0f },
+        { "ripple", 2.0f / 3.0f, { 0.0f,      0.0f,      1.0f/3.0f, 1.0f/3.0f, 2.0f/3.0f, 2.0f/3.0f }, 0.0f },
+        { "tripod", 0.5f,        { 0.0f,      0.5f,      0.5f,      0.0f,      0.0f,      0.5f      }, 0.0f },
+        { "rotate", 0.5f,        { 0.0f,      0.5f,      0.5f,      0.0f,      0.0f,      0.5f      }, 1.0f }
+    };
+
+#endif // __GAITPOSES_H__
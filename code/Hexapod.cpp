@@ -34,11 +34,23 @@ bool Hexapod::begin(Driver* driver , Servo* servo) {
   legs[4].init(4, 13, 14, 15, LEG_4_BASE_X, LEG_4_BASE_Y, LEG_4_BASE_Z, LEG_4_BASE_R, HEXAPOD_SPEED, driver, servo);
   legs[5].init(5, 16, 17, 18, LEG_5_BASE_X, LEG_5_BASE_Y, LEG_5_BASE_Z, LEG_5_BASE_R, HEXAPOD_SPEED, driver, servo);
 
-  if (!driver->addSyncWriteHandler(1, "Goal_Position")) {           // Add sync write handler
+  if (!driver->addSyncWriteHandler(1, "Goal_Position")) {           // Add sync write handler first, it is handler_index 0
     LOG_ERR("Failed to add sync write handler for Goal_Position");
     return false;
   }
 
+  int32_t cwLimits[HEXAPOD_SERVOS], ccwLimits[HEXAPOD_SERVOS];      // Joint limits in poseHexapodIDs order: coxa, femur, tibia per leg
+  for (int i = 0; i < HEXAPOD_SERVOS; i++) {
+    switch (i % LEG_SERVOS) {
+      case 0:     cwLimits[i] = COXA_CW_LIMIT;  ccwLimits[i] = COXA_CCW_LIMIT;  break;
+      case 1:     cwLimits[i] = FEMUR_CW_LIMIT; ccwLimits[i] = FEMUR_CCW_LIMIT; break;
+      default:    cwLimits[i] = TIBIA_CW_LIMIT; ccwLimits[i] = TIBIA_CCW_LIMIT; break;
+    }
+  }
+  if (!servo->initServos(poseHexapodIDs, HEXAPOD_SERVOS, HEXAPOD_SPEED, cwLimits, ccwLimits)) {
+    LOG_ERR("Failed to initialize all leg servos");                 // Legs with answering servos still stand up
+  }
+
   if (!moveStandUp()) {                                             // Move Hexapod to standing position
     LOG_ERR("Failed to move Hexapod to standing position");
     return false;
@@ -63,6 +75,11 @@ bool Hexapod::move(uint8_t *ids, uint8_t num_servos, int32_t *positions) {
   return driver->syncWrite(handler_index, ids, num_servos, positions, num_positions);
 }
 
+// Move all hexapod servos, positions ordered as returned by getServoIDs()
+bool Hexapod::moveAll(int32_t *positions) {
+  return move(poseHexapodIDs, HEXAPOD_SERVOS, positions);
+}
+
 // Check if any leg is currently moving
 bool Hexapod::isMoving() {
   for (int i = 0; i < HEXAPOD_LEGS; ++i) {
@@ -107,6 +124,16 @@ uint16_t Hexapod::getSpeed() const {
   return this->speed;
 }
 
+// Get the IDs of all hexapod servos
+const uint8_t* Hexapod::getServoIDs() const {
+  return poseHexapodIDs;
+}
+
+// Get the standing pose for all hexapod servos
+const int32_t* Hexapod::getStandUpPose() const {
+  return poseHexapodStandUP;
+}
+
 //--------------------------------------------------------------------------------
 
 // Print the status of all legs
@@ -119,59 +146,60 @@ bool Hexapod::printStatus() {
   return true;
 }
 
-// Process console commands for hexapod control
-bool Hexapod::runConsoleCommands(const String& cmd, const String& args) {
-    if (cmd == "hs") {
-        printStatus();
-        return true;
-
-    } else if (cmd == "hss") {
-        if (args.length() > 0) {
-            int newSpeed = args.toInt();
-            setSpeed(newSpeed);
-            speed = newSpeed;
-            LOG_INF("Hexapod speed set to " + String(newSpeed));
-        } else {
-            setSpeed(HEXAPOD_SPEED);
-            speed = HEXAPOD_SPEED;
-            LOG_INF("Hexapod speed: " + String((int)HEXAPOD_SPEED));
-        }
-        return true;
-
-    } else if (cmd == "hgs") {
-        PRINTLN("Hexapod Speed: " + String(speed));
-        return true;
-
-    } else if (cmd == "hsu") {
-        if (moveStandUp()) LOG_INF("Hexapod standing up");
-        return true;
-
-    } else if (cmd == "hsd") {
-        if (moveStandDown()) LOG_INF("Hexapod standing down");
-        return true;
-        
-    } else if (cmd == "h?") {
-        printConsoleHelp();
-        return true;
+// hs: Print the status of all legs
+static bool showHexapod(void* hexapod, const CommandArgs&) {
+    return static_cast<Hexapod*>(hexapod)->printStatus();
+}
 
-    }
+// hss [speed]: Set the hexapod speed, the default without an argument
+static bool setHexapodSpeed(void* hexapod, const CommandArgs& args) {
+    long speed = args.toInt(0, HEXAPOD_SPEED);
+    if (!static_cast<Hexapod*>(hexapod)->setSpeed((uint16_t)speed)) return false;
+    LOG_INF("Hexapod speed set to " + String(speed));
+    return true;
+}
 
-    return false;
+// hgs: Print the hexapod speed
+static bool showHexapodSpeed(void* hexapod, const CommandArgs&) {
+    PRINTLN("Hexapod Speed: " + String(static_cast<Hexapod*>(hexapod)->getSpeed()));
+    return true;
 }
 
+// hsu: Stand up
+static bool standUp(void* hexapod, const CommandArgs&) {
+    if (!static_cast<Hexapod*>(hexapod)->moveStandUp()) return false;
+    LOG_INF("Hexapod standing up");
+    return true;
+}
+
+// hsd: Stand down
+static bool standDown(void* hexapod, const CommandArgs&) {
+    if (!static_cast<Hexapod*>(hexapod)->moveStandDown()) return false;
+    LOG_INF("Hexapod standing down");
+    return true;
+}
+
+// h?: Print the hexapod help
+static bool showHexapodHelp(void* hexapod, const CommandArgs&) {
+    return static_cast<Hexapod*>(hexapod)->printConsoleHelp();
+}
+
+// Console commands, the help is printed from this table
+static const ConsoleCommand hexapodCommands[] = {
+    { "hs",     "",        "Print hexapod legs status",         showHexapod },
+    { nullptr,  "",        "",                                  nullptr },
+    { "hss",    "[speed]", "Set hexapod speed (default: 100)",  setHexapodSpeed },
+    { "hgs",    "",        "Get hexapod speed",                 showHexapodSpeed },
+    { nullptr,  "",        "",                                  nullptr },
+    { "hsu",    "",        "Hexapod stand up",                  standUp },
+    { "hsd",    "",        "Hexapod stand down",                standDown },
+    { "h?",     "",        "Print this help information",       showHexapodHelp },
+};
+const ConsoleCommandTable Hexapod::commandTable = { "Hexapod Commands:", hexapodCommands, sizeof(hexapodCommands) / sizeof(hexapodCommands[0]) };
+
 // Print hexapod-specific help information
 bool Hexapod::printConsoleHelp() {
-    PRINTLN("Hexapod Commands:\n\r");
-    PRINTLN("  hs               - Print hexapod legs status");
-    PRINTLN("");
-    PRINTLN("  hss [speed]      - Set hexapod speed (default: " + String(HEXAPOD_SPEED) + ")");
-    PRINTLN("  hgs              - Get hexapod speed");
-    PRINTLN("");
-    PRINTLN("  hsu              - Hexapod stand up");
-    PRINTLN("  hsd              - Hexapod stand down");
-    PRINTLN("  h?               - Print this help information");
-    PRINTLN("");
-    return true;
+    return CommandRegistry::printHelp(commandTable);
 }
 
 
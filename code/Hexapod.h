@@ -3,6 +3,7 @@
 
   #include "Leg.h"
   #include "Driver.h"
+  #include "CommandRegistry.h"
 
   // Hexapod configuration constants
   #define handler_index  uint8_t(0)                                         // Index for sync write handler
@@ -49,6 +50,7 @@
       bool      update();                                                   // Update the hexapod state
 
       bool      move(uint8_t *ids, uint8_t num_servos, int32_t *positions); // Move Hexapod
+      bool      moveAll(int32_t *positions);                                // Move all hexapod servos, positions ordered as getServoIDs()
       bool      isMoving();                                                 // Check if any leg is currently moving
       bool      moveStandUp();                                              // Move Hexapod Up
       bool      moveStandDown();                                            // Move Hexapod Down
@@ -56,9 +58,12 @@
       bool      setSpeed(uint16_t speed);                                   // Set the speed of the hexapod
       uint16_t  getSpeed() const;                                           // Get the current speed of the hexapod
 
+      const uint8_t* getServoIDs() const;                                   // Get the IDs of all hexapod servos
+      const int32_t* getStandUpPose() const;                                // Get the standing pose for all hexapod servos
+
       bool      printStatus();                                              // Print the status of all legs
-      bool      runConsoleCommands(const String& cmd, const String& args);  // Process console commands for hexapod control
       bool      printConsoleHelp();                                         // Print hexapod-specific help information
+      static const ConsoleCommandTable commandTable;                        // Console commands and their help
       
       Leg     legs[HEXAPOD_LEGS];                                           // Array of legs
 
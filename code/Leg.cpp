@@ -1,7 +1,10 @@
 #include "Servo.h"
 #include "Leg.h"
+#include "Hexapod.h"
 #include "LegPoses.h"
 #include "Kinematics.h"
+#include "ServoEstimator.h"
+#include "StateStage.h"
 #include "Console.h"
 #include "Debug.h"
 
@@ -42,30 +45,14 @@ bool Leg::init( uint8_t index,
   this->servo      = servo;      // Set the servo pointer
   this->speed      = speed;      // Set default speed
 
-  if (!servo->init(servoIDs[Coxa] , speed, COXA_CW_LIMIT, COXA_CCW_LIMIT)) {   // Initialize coxa servo with velocity
-    LOG_ERR("Failed to initialize coxa servo.");
-    return false;
-  }
-  if (!servo->init(servoIDs[Femur], speed, FEMUR_CW_LIMIT, FEMUR_CCW_LIMIT)) {   // Initialize femur servo with velocity
-    LOG_ERR("Failed to initialize femur servo.");
-    return false;
-  }
-  if (!servo->init(servoIDs[Tibia], speed, TIBIA_CW_LIMIT, TIBIA_CCW_LIMIT)) {   // Initialize tibia servo with velocity
-    LOG_ERR("Failed to initialize tibia servo.");
-    return false;
-  }
-
-  LOG_INF("Leg initialized successfully. (Servo IDs: " + String(servoIDs[Coxa]) + ", " + String(servoIDs[Femur]) + ", " + String(servoIDs[Tibia]) + ")");
+  // The servos of all legs are brought up together by Hexapod::begin
   return true;
 
 }
 
 // Update the leg state
 bool Leg::update() {
-  // Update each servo
-  for (int i = 0; i < LEG_SERVOS; i++) {
-    servo->update(servoIDs[i]);
-  }
+  // Servo telemetry is polled by the state stage, once per tick for all servos
   return true;
 }
 
@@ -73,7 +60,7 @@ bool Leg::update() {
 bool Leg::move(int32_t *positions) {
   const uint8_t num_positions   = 1;
   if(!driver->syncWrite(handler_index, servoIDs, LEG_SERVOS, positions, num_positions)) {
-    LOG_ERR("Failed to move leg.");
+    LOGF_ERR("Failed to move leg %d.", index);
     return false;
   }
   return true;
@@ -122,7 +109,7 @@ bool Leg::setSpeed(uint16_t speed) {
   if (speed > 1023) speed = 1023;
   for (int i = 0; i < LEG_SERVOS; i++) {
     if (!servo->setGoalSpeed(servoIDs[i], speed)) {
-      LOG_ERR("Failed to set speed for leg servo.");
+      LOGF_ERR("Failed to set speed for leg %d servo ID %d.", index, servoIDs[i]);
       return false;
     }
   }
@@ -149,25 +136,41 @@ bool Leg::setServoPositions(uint16_t coxa, uint16_t femur, uint16_t tibia) {
   int32_t positions[LEG_SERVOS] = { static_cast<int32_t>(coxa), static_cast<int32_t>(femur), static_cast<int32_t>(tibia) };
   const uint8_t num_positions = 1;
   if (!driver->syncWrite(handler_index, servoIDs, LEG_SERVOS, positions, num_positions)) {
-    LOG_ERR("Failed to set servo positions via syncWrite.");
+    LOGF_ERR("Failed to set leg %d servo positions via syncWrite.", index);
     return false;
   }
   return true;
 }
 
-// Get the current positions of the leg joints
+// Get the current positions of the leg joints, from the estimator or the state snapshot when there is
+// one (no bus traffic)
 bool Leg::getServoPositions(uint16_t* coxa, uint16_t* femur, uint16_t* tibia) {
-  // TODO: use syncRead
+  ServoEstimator* estimator = driver->getEstimator();
+  uint16_t positions[LEG_SERVOS];
+  if (estimator != nullptr && estimator->getPositions(servoIDs, LEG_SERVOS, positions)) {
+    *coxa  = positions[Coxa];
+    *femur = positions[Femur];
+    *tibia = positions[Tibia];
+    return true;
+  }
+  const RobotState* state = driver->getState();
+  uint32_t mask = (1UL << (servoIDs[Coxa] - 1)) | (1UL << (servoIDs[Femur] - 1)) | (1UL << (servoIDs[Tibia] - 1));
+  if (state != nullptr && (state->positionValid & mask) == mask) {
+    *coxa  = state->position[servoIDs[Coxa] - 1];
+    *femur = state->position[servoIDs[Femur] - 1];
+    *tibia = state->position[servoIDs[Tibia] - 1];
+    return true;
+  }
   if (!servo->getPresentPosition(servoIDs[Coxa], coxa)) {
-    LOG_ERR("Failed to get coxa position.");
+    LOGF_ERR("Failed to get leg %d coxa position.", index);
     return false;
   }
   if (!servo->getPresentPosition(servoIDs[Femur], femur)) {
-    LOG_ERR("Failed to get femur position.");
+    LOGF_ERR("Failed to get leg %d femur position.", index);
     return false;
   }
   if (!servo->getPresentPosition(servoIDs[Tibia], tibia)) {
-    LOG_ERR("Failed to get tibia position.");
+    LOGF_ERR("Failed to get leg %d tibia position.", index);
     return false;
   }
   return true;
@@ -179,13 +182,13 @@ bool Leg::getServoPositions(uint16_t* coxa, uint16_t* femur, uint16_t* tibia) {
 bool Leg::setTipLocalPosition(float tip_local_x, float tip_local_y, float tip_local_z) {
   uint16_t positions[LEG_SERVOS];
   if (!IK::getIKLocal(tip_local_x, tip_local_y, tip_local_z, baseR, positions)) {
-    LOG_ERR("Failed to compute inverse kinematics.");
+    LOGF_ERR("Failed to compute leg %d inverse kinematics.", index);
     return false;
   }
   
-  LOG_INF("Coxa Angle Tick: " + String(positions[0]));
-  LOG_INF("Femur Angle Tick: " + String(positions[1]));
-  LOG_INF("Tibia Angle Tick: " + String(positions[2]));
+  LOGF_INF("Coxa Angle Tick: %d", positions[0]);
+  LOGF_INF("Femur Angle Tick: %d", positions[1]);
+  LOGF_INF("Tibia Angle Tick: %d", positions[2]);
 
   return setServoPositions(positions[Coxa], positions[Femur], positions[Tibia]);
 }
@@ -194,7 +197,7 @@ bool Leg::setTipLocalPosition(float tip_local_x, float tip_local_y, float tip_lo
 bool Leg::getTipLocalPosition(float* tip_local_x, float* tip_local_y, float* tip_local_z) {
   uint16_t coxa = 0, femur = 0, tibia = 0;
   if (!getServoPositions(&coxa, &femur, &tibia)) {
-    LOG_ERR("Failed to get servo positions.");
+    LOGF_ERR("Failed to get leg %d servo positions.", index);
     return false;
   }
   return IK::getFKLocal(coxa, femur, tibia, baseR, tip_local_x, tip_local_y, tip_local_z);
@@ -211,7 +214,7 @@ bool Leg::setTipGlobalPosition(float tip_global_x, float tip_global_y, float tip
 bool Leg::getTipGlobalPosition(float* tip_global_x, float* tip_global_y, float* tip_global_z) {
   float tip_local_x, tip_local_y, tip_local_z;
   if (!getTipLocalPosition(&tip_local_x, &tip_local_y, &tip_local_z)) {
-    LOG_ERR("Failed to get local tip position.");
+    LOGF_ERR("Failed to get leg %d local tip position.", index);
     return false;
   }
   IK::local2Global(tip_local_x, tip_local_y, tip_local_z, baseX, baseY, baseZ, tip_global_x, tip_global_y, tip_global_z);
@@ -236,7 +239,7 @@ bool Leg::printStatus() {
     return false;
   }
 
-  if (!getTipLocalPosition(&tip_local_X, &tip_local_Y, &tip_local_Z)) {
+  if (!IK::getFKLocal(coxaAngle, femurAngle, tibiaAngle, baseR, &tip_local_X, &tip_local_Y, &tip_local_Z)) {   // Same positions, no second read
     LOG_ERR("Failed to get leg tip position.");
     return false;
   }
@@ -259,260 +262,269 @@ bool Leg::printStatus() {
   return true;
 }
 
-// Process console commands for leg control
-bool Leg::runConsoleCommands(const String& cmd, const String& args, int index) {
-    if (cmd == "ls") {
-        printStatus();
-        return true;
-
-    } else if (cmd == "lss") {
-        int newSpeed = LEG_SPEED; // Default speed
-
-        if (args.length() > 0) {
-            int count = 0, arg1 = 0, arg2 = 0;
-            count = sscanf(args.c_str(), "%d %d", &arg1, &arg2);
-            switch(count) {
-              case 1:                 // only leg index is mentioned
-                newSpeed = LEG_SPEED;
-                break;
-              case 2:
-                newSpeed = arg2;      // leg index and speed are mentioned
-                break;
-              default:
-                LOG_ERR("Invalid parameters");
-                break;
-            }
-        }
-        setSpeed(newSpeed);
-        speed = newSpeed;
-        LOG_INF("Leg " + String(index) + " speed: " + String((int)speed));
-        return true;
-
-    } else if (cmd == "lpu") {
-        movePointUp();
-        LOG_INF("Leg " + String(index) + " point moving up");
-        return true;
-
-    } else if (cmd == "lpd") {
-        movePointDown();
-        LOG_INF("Leg " + String(index) + " point moving down");
-        return true;
-
-    } else if (cmd == "lpo") {
-        movePointOut();
-        LOG_INF("Leg " + String(index) + " point moving out");
-        return true;
-
-    } else if (cmd == "lsu") {
-        moveStandUp();
-        LOG_INF("Leg " + String(index) + " standing up");
-        return true;
-
-    } else if (cmd == "lsd") {
-        moveStandDown();
-        LOG_INF("Leg " + String(index) + " standing down");
-        return true;
-
-    } else if (cmd == "lssp") {
-        uint16_t coxaPos = COXA_DEFAULT, femurPos = FEMUR_DEFAULT, tibiaPos = TIBIA_DEFAULT;
-        if (args.length() > 0) {
-              int count = 0, arg1 = 0, arg2 = 0, arg3 = 0, arg4 = 0;
-              count = sscanf(args.c_str(), "%d %d %d %d", &arg1, &arg2, &arg3, &arg4);
-              switch(count) {
-                case 1:                 // only leg index is mentioned
-                  coxaPos = COXA_DEFAULT, femurPos = FEMUR_DEFAULT, tibiaPos = TIBIA_DEFAULT;
-                  break;
-                case 2:
-                  coxaPos = arg2, femurPos = FEMUR_DEFAULT, tibiaPos = TIBIA_DEFAULT;
-                  break;
-                case 3:
-                  coxaPos = arg2, femurPos = arg3, tibiaPos = TIBIA_DEFAULT;
-                  break;
-                case 4:
-                  coxaPos = arg2, femurPos = arg3, tibiaPos = arg4;
-                  break;
-                default:
-                  LOG_ERR("Invalid parameters");
-                  break;
-              }
-        }
-        setServoPositions(coxaPos, femurPos, tibiaPos);
-        LOG_INF("Leg " + String(index) + " servo positions set to: Coxa: " + String(coxaPos) + ", Femur: " + String(femurPos) + ", Tibia: " + String(tibiaPos));
-        return true;
-
-    } else if (cmd == "lgsp") {
-        uint16_t coxaPos = 0, femurPos = 0, tibiaPos = 0;
-        getServoPositions(&coxaPos, &femurPos, &tibiaPos);
-        LOG_INF("Leg " + String(index) + " servo positions: Coxa: " + String(coxaPos) + ", Femur: " + String(femurPos) + ", Tibia: " + String(tibiaPos));
-        return true;
-
-    } else if (cmd == "lstpl") {
-        if (args.length() > 0) {
-            int count = 0, i = 0; float local_x = 0, local_y = 0, local_z = 0;
-            count = sscanf(args.c_str(), "%d %f %f %f", &i, &local_x, &local_y, &local_z);
-            if (count == 4) {
-                setTipLocalPosition(local_x, local_y, local_z);
-                LOG_INF("Leg " + String(index) + " tip local position set to: X: " + String(local_x) + ", Y: " + String(local_y) + ", Z: " + String(local_z));
-            } else {
-                LOG_ERR("Invalid parameters for lstlp. Usage: lstlp n x y z");
-            }
-        } else {
-            LOG_ERR("Invalid parameters for lstlp. Usage: lstlp n x y z");
-        }
-        return true;
-
-    } else if (cmd == "lgtpl") {
-        float tip_local_x = 0, tip_local_y = 0, tip_local_z = 0;
-        getTipLocalPosition(&tip_local_x, &tip_local_y, &tip_local_z);
-        LOG_INF("Leg " + String(index) + " tip local position: X: " + String(tip_local_x) + ", Y: " + String(tip_local_y) + ", Z: " + String(tip_local_z));
-        return true;
-
-    } else if (cmd == "lstpg") {
-        if (args.length() > 0) {
-            int count = 0, i = 0; float global_x = 0, global_y = 0, global_z = 0;
-            count = sscanf(args.c_str(), "%d %f %f %f", &i, &global_x, &global_y, &global_z);
-            if (count == 4) {
-                setTipGlobalPosition(global_x, global_y, global_z);
-                LOG_INF("Leg " + String(index) + " tip global position set to: X: " + String(global_x) + ", Y: " + String(global_y) + ", Z: " + String(global_z));
-            } else {
-                LOG_ERR("Invalid parameters for lstgp. Usage: lstgp n x y z");
-            }
-        } else {
-            LOG_ERR("Invalid parameters for lstgp. Usage: lstgp n x y z");
-        }
-        return true;
-
-    } else if (cmd == "lgtpg") {
-        float tip_global_x = 0, tip_global_y = 0, tip_global_z = 0;
-        getTipGlobalPosition(&tip_global_x, &tip_global_y, &tip_global_z);
-        LOG_INF("Leg " + String(index) + " tip global position: X: " + String(tip_global_x) + ", Y: " + String(tip_global_y) + ", Z: " + String(tip_global_z));
-        return true;
-
-    } else if (cmd == "lgikl") {
-        int count = 0, i = 0; float local_x = 0, local_y = 0, local_z = 0;
-        count = sscanf(args.c_str(), "%d %f %f %f", &i, &local_x, &local_y, &local_z);
-        if (count == 4) {
-            uint16_t positions[LEG_SERVOS];
-            if (IK::getIKLocal(local_x, local_y, local_z, baseR, positions)) {
-                LOG_INF("Leg " + String(index) + " IK Local Positions: Coxa: " + String(positions[Coxa]) + ", Femur: " + String(positions[Femur]) + ", Tibia: " + String(positions[Tibia]));
-            } else {
-                LOG_ERR("Failed to compute IK Local.");
-            }
-        } else {
-            LOG_ERR("Invalid parameters for lgikl. Usage: lgikl n x y z");
-        }
-        return true;
-
-    } else if (cmd == "lgikg") {
-        int count = 0, i = 0; float global_x = 0, global_y = 0, global_z = 0;
-        count = sscanf(args.c_str(), "%d %f %f %f", &i, &global_x, &global_y, &global_z);
-        if (count == 4) {
-            uint16_t positions[LEG_SERVOS];
-            if (IK::getIKGlobal(global_x, global_y, global_z, baseX, baseY, baseZ, baseR, positions)) {
-                LOG_INF("Leg " + String(index) + " IK Global Positions: Coxa: " + String(positions[Coxa]) + ", Femur: " + String(positions[Femur]) + ", Tibia: " + String(positions[Tibia]));
-            } else {
-                LOG_ERR("Failed to compute IK Global.");
-            }
-        } else {
-            LOG_ERR("Invalid parameters for lgikg. Usage: lgikg n x y z");
-        }
-        return true;
-
-    } else if (cmd == "lgfkl") {
-        int count = 0, i = 0; uint16_t coxa = 0, femur = 0, tibia = 0;
-        float local_x = 0, local_y = 0, local_z = 0;
-        count = sscanf(args.c_str(), "%d %hu %hu %hu", &i, &coxa, &femur, &tibia);
-        if (count == 4) {
-            if (IK::getFKLocal(coxa, femur, tibia, baseR,&local_x, &local_y, &local_z)) {
-                LOG_INF("Leg " + String(index) + " FK Local Position: X: " + String(local_x) + ", Y: " + String(local_y) + ", Z: " + String(local_z));
-            } else {
-                LOG_ERR("Failed to compute FK Local.");
-            }
-        } else {
-            LOG_ERR("Invalid parameters for lgfkl. Usage: lgfkl n c f t");
-        }
-        return true;
-
-    } else if (cmd == "lgfkg") {
-        int count = 0, i = 0; uint16_t coxa = 0, femur = 0, tibia = 0;
-        float global_x = 0, global_y = 0, global_z = 0;
-        count = sscanf(args.c_str(), "%d %hu %hu %hu", &i, &coxa, &femur, &tibia);
-        if (count == 4) {
-            if (IK::getFKGlobal(coxa, femur, tibia, baseX, baseY, baseZ, baseR, &global_x, &global_y, &global_z)) {
-                LOG_INF("Leg " + String(index) + " FK Global Position: X: " + String(global_x) + ", Y: " + String(global_y) + ", Z: " + String(global_z));
-            } else {
-                LOG_ERR("Failed to compute FK Global.");
-            }
-        } else {
-            LOG_ERR("Invalid parameters for lgfkg. Usage: lgfkg n c f t");
-        }
-        return true;
-    } else if (cmd == "lltg") {
-        int count = 0, i = 0; float local_x = 0, local_y = 0, local_z = 0;
-        float global_x = 0, global_y = 0, global_z = 0;
-        count = sscanf(args.c_str(), "%d %f %f %f", &i, &local_x, &local_y, &local_z);
-        if (count == 4) {
-            IK::local2Global(local_x, local_y, local_z, baseX, baseY, baseZ, &global_x, &global_y, &global_z);
-            LOG_INF("Leg " + String(index) + " Local to Global: X: " + String(global_x) + ", Y: " + String(global_y) + ", Z: " + String(global_z));
-        } else {
-            LOG_ERR("Invalid parameters for lltg. Usage: lltg n x y z");
-        }
-        return true;
-        
-    } else if (cmd == "lgtl") {
-        int count = 0, i = 0; float global_x = 0, global_y = 0, global_z = 0;
-        float local_x = 0, local_y = 0, local_z = 0;
-        count = sscanf(args.c_str(), "%d %f %f %f", &i, &global_x, &global_y, &global_z);
-        if (count == 4) {
-            IK::global2Local(global_x, global_y, global_z, baseX, baseY, baseZ, &local_x, &local_y, &local_z);
-            LOG_INF("Leg " + String(index) + " Global to Local: X: " + String(local_x) + ", Y: " + String(local_y) + ", Z: " + String(local_z));
-        } else {
-            LOG_ERR("Invalid parameters for lgtl. Usage: lgtl n x y z");
-        }
-        return true;
-
-    } else if (cmd == "l?") {
-        printConsoleHelp();
-        return true;
+// Leg commands are registered with the hexapod, argument 0 selects the leg (default 0)
+static uint8_t legIndex(const CommandArgs& args) {
+    long index = args.toInt(0, 0);
+    return (index < 0 || index >= HEXAPOD_LEGS) ? 0 : (uint8_t)index;
+}
+
+// Leg selected by argument 0
+static Leg& legOf(void* hexapod, const CommandArgs& args) {
+    return static_cast<Hexapod*>(hexapod)->legs[legIndex(args)];
+}
+
+// ls [n]: Print the leg status
+static bool showLeg(void* hexapod, const CommandArgs& args) {
+    return legOf(hexapod, args).printStatus();
+}
+
+// lss [n] [speed]: Set the leg speed
+static bool setLegSpeed(void* hexapod, const CommandArgs& args) {
+    Leg& leg = legOf(hexapod, args);
+    if (!leg.setSpeed((uint16_t)args.toInt(1, LEG_SPEED))) return false;
+    LOG_INF("Leg " + String(legIndex(args)) + " speed: " + String(leg.getSpeed()));
+    return true;
+}
+
+// lpu [n]: Move the leg point up
+static bool movePointUp(void* hexapod, const CommandArgs& args) {
+    if (!legOf(hexapod, args).movePointUp()) return false;
+    LOG_INF("Leg " + String(legIndex(args)) + " point moving up");
+    return true;
+}
+
+// lpd [n]: Move the leg point down
+static bool movePointDown(void* hexapod, const CommandArgs& args) {
+    if (!legOf(hexapod, args).movePointDown()) return false;
+    LOG_INF("Leg " + String(legIndex(args)) + " point moving down");
+    return true;
+}
+
+// lpo [n]: Move the leg point out
+static bool movePointOut(void* hexapod, const CommandArgs& args) {
+    if (!legOf(hexapod, args).movePointOut()) return false;
+    LOG_INF("Leg " + String(legIndex(args)) + " point moving out");
+    return true;
+}
+
+// lsu [n]: Move the leg to the stand up position
+static bool moveStandUp(void* hexapod, const CommandArgs& args) {
+    if (!legOf(hexapod, args).moveStandUp()) return false;
+    LOG_INF("Leg " + String(legIndex(args)) + " standing up");
+    return true;
+}
 
+// lsd [n]: Move the leg to the stand down position
+static bool moveStandDown(void* hexapod, const CommandArgs& args) {
+    if (!legOf(hexapod, args).moveStandDown()) return false;
+    LOG_INF("Leg " + String(legIndex(args)) + " standing down");
+    return true;
+}
+
+// lssp [n] [c] [f] [t]: Set the servo positions, missing ones take their default
+static bool setServoPositions(void* hexapod, const CommandArgs& args) {
+    uint16_t coxa  = (uint16_t)args.toInt(1, COXA_DEFAULT);
+    uint16_t femur = (uint16_t)args.toInt(2, FEMUR_DEFAULT);
+    uint16_t tibia = (uint16_t)args.toInt(3, TIBIA_DEFAULT);
+    if (!legOf(hexapod, args).setServoPositions(coxa, femur, tibia)) return false;
+    LOG_INF("Leg " + String(legIndex(args)) + " servo positions set to: Coxa: " + String(coxa) + ", Femur: " + String(femur) + ", Tibia: " + String(tibia));
+    return true;
+}
+
+// lgsp [n]: Print the servo positions
+static bool showServoPositions(void* hexapod, const CommandArgs& args) {
+    uint16_t coxa = 0, femur = 0, tibia = 0;
+    if (!legOf(hexapod, args).getServoPositions(&coxa, &femur, &tibia)) return false;
+    LOG_INF("Leg " + String(legIndex(args)) + " servo positions: Coxa: " + String(coxa) + ", Femur: " + String(femur) + ", Tibia: " + String(tibia));
+    return true;
+}
+
+// Point x y z after the leg index, false if any is missing
+static bool pointArgs(const CommandArgs& args, float* x, float* y, float* z) {
+    int index;
+    return sscanf(args.rest(), "%d %f %f %f", &index, x, y, z) == 4;
+}
+
+// lstpl n x y z: Set the tip position relative to the leg base
+static bool setTipLocal(void* hexapod, const CommandArgs& args) {
+    float x, y, z;
+    if (!pointArgs(args, &x, &y, &z)) {
+        LOG_ERR("Invalid parameters for lstpl. Usage: lstpl n x y z");
+        return false;
     }
-    return false;
+    if (!legOf(hexapod, args).setTipLocalPosition(x, y, z)) return false;
+    LOG_INF("Leg " + String(legIndex(args)) + " tip local position set to: X: " + String(x) + ", Y: " + String(y) + ", Z: " + String(z));
+    return true;
 }
 
-// Print leg-specific help information
-bool Leg::printConsoleHelp() {
-    PRINTLN("Leg Commands:\n\r");
-    PRINTLN("  ls  [n]            - Print leg status (default: 0)");
-    PRINTLN("  lss [n] [speed]    - Set leg speed (default: 0, " + String((int)LEG_SPEED) + ")");
-    PRINTLN("");
-    PRINTLN("  lpu [n]            - Move leg point up (default: 0)");
-    PRINTLN("  lpd [n]            - Move leg point down (default: 0)");
-    PRINTLN("  lpo [n]            - Move leg point out (default: 0)");
-    PRINTLN("");
-    PRINTLN("  lsu [n]            - Move leg to stand up position (default: 0)");
-    PRINTLN("  lsd [n]            - Move leg to stand down position (default: 0)");
-    PRINTLN("");
-    PRINTLN("  lssp [n][c][f][t]  - Set leg servo positions (default: 0, " + String(COXA_DEFAULT) + ", " + String(FEMUR_DEFAULT) + ", " + String(TIBIA_DEFAULT) + ")");
-    PRINTLN("  lgsp [n]           - Get leg servo positions (default: 0)");
-    PRINTLN("");
-    PRINTLN("  lstpl n x y z      - Set leg tip local position");
-    PRINTLN("  lgtpl [n]          - Get leg tip local position (default: 0)");
-    PRINTLN("");
-    PRINTLN("  lstpg n x y z      - Set leg tip global position");
-    PRINTLN("  lgtpg [n]          - Get leg tip global position (default: 0)");
-    PRINTLN("");
-    PRINTLN("  lgikl n x y z      - Compute IK in local coords (relative to leg base)");
-    PRINTLN("  lgikg n x y z      - Compute IK in global coords (relative to body center)");
-    PRINTLN("");
-    PRINTLN("  lgfkl n c f t      - Compute FK in local coords (relative to leg base)");
-    PRINTLN("  lgfkg n c f t      - Compute FK in global coords (relative to body center)");
-    PRINTLN("");
-    PRINTLN("  lltg n x y z       - Compute global coordinates from local coordinates");
-    PRINTLN("  lgtl n x y z       - Compute local coordinates from global coordinates");
-    PRINTLN("");
-    PRINTLN("  l?                 - Show this help");
-    PRINTLN("");
+// lgtpl [n]: Print the tip position relative to the leg base
+static bool showTipLocal(void* hexapod, const CommandArgs& args) {
+    float x = 0, y = 0, z = 0;
+    if (!legOf(hexapod, args).getTipLocalPosition(&x, &y, &z)) return false;
+    LOG_INF("Leg " + String(legIndex(args)) + " tip local position: X: " + String(x) + ", Y: " + String(y) + ", Z: " + String(z));
+    return true;
+}
+
+// lstpg n x y z: Set the tip position relative to the body center
+static bool setTipGlobal(void* hexapod, const CommandArgs& args) {
+    float x, y, z;
+    if (!pointArgs(args, &x, &y, &z)) {
+        LOG_ERR("Invalid parameters for lstpg. Usage: lstpg n x y z");
+        return false;
+    }
+    if (!legOf(hexapod, args).setTipGlobalPosition(x, y, z)) return false;
+    LOG_INF("Leg " + String(legIndex(args)) + " tip global position set to: X: " + String(x) + ", Y: " + String(y) + ", Z: " + String(z));
     return true;
 }
 
+// lgtpg [n]: Print the tip position relative to the body center
+static bool showTipGlobal(void* hexapod, const CommandArgs& args) {
+    float x = 0, y = 0, z = 0;
+    if (!legOf(hexapod, args).getTipGlobalPosition(&x, &y, &z)) return false;
+    LOG_INF("Leg " + String(legIndex(args)) + " tip global position: X: " + String(x) + ", Y: " + String(y) + ", Z: " + String(z));
+    return true;
+}
 
+// lgikl n x y z: Compute the IK of a point relative to the leg base
+static bool showIKLocal(void* hexapod, const CommandArgs& args) {
+    float x, y, z, baseX, baseY, baseZ, baseR;
+    if (!pointArgs(args, &x, &y, &z)) {
+        LOG_ERR("Invalid parameters for lgikl. Usage: lgikl n x y z");
+        return false;
+    }
+    legOf(hexapod, args).getBasePosition(&baseX, &baseY, &baseZ, &baseR);
+    uint16_t positions[LEG_SERVOS];
+    if (!IK::getIKLocal(x, y, z, baseR, positions)) {
+        LOG_ERR("Failed to compute IK Local.");
+        return false;
+    }
+    LOG_INF("Leg " + String(legIndex(args)) + " IK Local Positions: Coxa: " + String(positions[Leg::Coxa]) + ", Femur: " + String(positions[Leg::Femur]) + ", Tibia: " + String(positions[Leg::Tibia]));
+    return true;
+}
+
+// lgikg n x y z: Compute the IK of a point relative to the body center
+static bool showIKGlobal(void* hexapod, const CommandArgs& args) {
+    float x, y, z, baseX, baseY, baseZ, baseR;
+    if (!pointArgs(args, &x, &y, &z)) {
+        LOG_ERR("Invalid parameters for lgikg. Usage: lgikg n x y z");
+        return false;
+    }
+    legOf(hexapod, args).getBasePosition(&baseX, &baseY, &baseZ, &baseR);
+    uint16_t positions[LEG_SERVOS];
+    if (!IK::getIKGlobal(x, y, z, baseX, baseY, baseZ, baseR, positions)) {
+        LOG_ERR("Failed to compute IK Global.");
+        return false;
+    }
+    LOG_INF("Leg " + String(legIndex(args)) + " IK Global Positions: Coxa: " + String(positions[Leg::Coxa]) + ", Femur: " + String(positions[Leg::Femur]) + ", Tibia: " + String(positions[Leg::Tibia]));
+    return true;
+}
+
+// Servo positions c f t after the leg index, false if any is missing
+static bool jointArgs(const CommandArgs& args, uint16_t* coxa, uint16_t* femur, uint16_t* tibia) {
+    int index;
+    return sscanf(args.rest(), "%d %hu %hu %hu", &index, coxa, femur, tibia) == 4;
+}
+
+// lgfkl n c f t: Compute the FK relative to the leg base
+static bool showFKLocal(void* hexapod, const CommandArgs& args) {
+    uint16_t coxa, femur, tibia;
+    float    x = 0, y = 0, z = 0, baseX, baseY, baseZ, baseR;
+    if (!jointArgs(args, &coxa, &femur, &tibia)) {
+        LOG_ERR("Invalid parameters for lgfkl. Usage: lgfkl n c f t");
+        return false;
+    }
+    legOf(hexapod, args).getBasePosition(&baseX, &baseY, &baseZ, &baseR);
+    if (!IK::getFKLocal(coxa, femur, tibia, baseR, &x, &y, &z)) {
+        LOG_ERR("Failed to compute FK Local.");
+        return false;
+    }
+    LOG_INF("Leg " + String(legIndex(args)) + " FK Local Position: X: " + String(x) + ", Y: " + String(y) + ", Z: " + String(z));
+    return true;
+}
+
+// lgfkg n c f t: Compute the FK relative to the body center
+static bool showFKGlobal(void* hexapod, const CommandArgs& args) {
+    uint16_t coxa, femur, tibia;
+    float    x = 0, y = 0, z = 0, baseX, baseY, baseZ, baseR;
+    if (!jointArgs(args, &coxa, &femur, &tibia)) {
+        LOG_ERR("Invalid parameters for lgfkg. Usage: lgfkg n c f t");
+        return false;
+    }
+    legOf(hexapod, args).getBasePosition(&baseX, &baseY, &baseZ, &baseR);
+    if (!IK::getFKGlobal(coxa, femur, tibia, baseX, baseY, baseZ, baseR, &x, &y, &z)) {
+        LOG_ERR("Failed to compute FK Global.");
+        return false;
+    }
+    LOG_INF("Leg " + String(legIndex(args)) + " FK Global Position: X: " + String(x) + ", Y: " + String(y) + ", Z: " + String(z));
+    return true;
+}
+
+// lltg n x y z: Convert a point from leg base to body center coordinates
+static bool localToGlobal(void* hexapod, const CommandArgs& args) {
+    float x, y, z, gx = 0, gy = 0, gz = 0, baseX, baseY, baseZ, baseR;
+    if (!pointArgs(args, &x, &y, &z)) {
+        LOG_ERR("Invalid parameters for lltg. Usage: lltg n x y z");
+        return false;
+    }
+    legOf(hexapod, args).getBasePosition(&baseX, &baseY, &baseZ, &baseR);
+    IK::local2Global(x, y, z, baseX, baseY, baseZ, &gx, &gy, &gz);
+    LOG_INF("Leg " + String(legIndex(args)) + " Local to Global: X: " + String(gx) + ", Y: " + String(gy) + ", Z: " + String(gz));
+    return true;
+}
+
+// lgtl n x y z: Convert a point from body center to leg base coordinates
+static bool globalToLocal(void* hexapod, const CommandArgs& args) {
+    float x, y, z, lx = 0, ly = 0, lz = 0, baseX, baseY, baseZ, baseR;
+    if (!pointArgs(args, &x, &y, &z)) {
+        LOG_ERR("Invalid parameters for lgtl. Usage: lgtl n x y z");
+        return false;
+    }
+    legOf(hexapod, args).getBasePosition(&baseX, &baseY, &baseZ, &baseR);
+    IK::global2Local(x, y, z, baseX, baseY, baseZ, &lx, &ly, &lz);
+    LOG_INF("Leg " + String(legIndex(args)) + " Global to Local: X: " + String(lx) + ", Y: " + String(ly) + ", Z: " + String(lz));
+    return true;
+}
+
+// l?: Print the leg help
+static bool showLegHelp(void* hexapod, const CommandArgs& args) {
+    return legOf(hexapod, args).printConsoleHelp();
+}
+
+// Console commands, the help is printed from this table
+static const ConsoleCommand legCommands[] = {
+    { "ls",     "[n]",          "Print leg status (default: 0)",                          showLeg },
+    { "lss",    "[n] [speed]",  "Set leg speed (default: 0, 100)",                        setLegSpeed },
+    { nullptr,  "",             "",                                                       nullptr },
+    { "lpu",    "[n]",          "Move leg point up (default: 0)",                         movePointUp },
+    { "lpd",    "[n]",          "Move leg point down (default: 0)",                       movePointDown },
+    { "lpo",    "[n]",          "Move leg point out (default: 0)",                        movePointOut },
+    { nullptr,  "",             "",                                                       nullptr },
+    { "lsu",    "[n]",          "Move leg to stand up position (default: 0)",             moveStandUp },
+    { "lsd",    "[n]",          "Move leg to stand down position (default: 0)",           moveStandDown },
+    { nullptr,  "",             "",                                                       nullptr },
+    { "lssp",   "[n][c][f][t]", "Set leg servo positions (default: 0, 512, 358, 665)",    setServoPositions },
+    { "lgsp",   "[n]",          "Get leg servo positions (default: 0)",                   showServoPositions },
+    { nullptr,  "",             "",                                                       nullptr },
+    { "lstpl",  "n x y z",      "Set leg tip local position",                             setTipLocal },
+    { "lgtpl",  "[n]",          "Get leg tip local position (default: 0)",                showTipLocal },
+    { nullptr,  "",             "",                                                       nullptr },
+    { "lstpg",  "n x y z",      "Set leg tip global position",                            setTipGlobal },
+    { "lgtpg",  "[n]",          "Get leg tip global position (default: 0)",               showTipGlobal },
+    { nullptr,  "",             "",                                                       nullptr },
+    { "lgikl",  "n x y z",      "Compute IK in local coords (relative to leg base)",      showIKLocal },
+    { "lgikg",  "n x y z",      "Compute IK in global coords (relative to body center)",  showIKGlobal },
+    { nullptr,  "",             "",                                                       nullptr },
+    { "lgfkl",  "n c f t",      "Compute FK in local coords (relative to leg base)",      showFKLocal },
+    { "lgfkg",  "n c f t",      "Compute FK in global coords (relative to body center)",  showFKGlobal },
+    { nullptr,  "",             "",                                                       nullptr },
+    { "lltg",   "n x y z",      "Compute global coordinates from local coordinates",      localToGlobal },
+    { "lgtl",   "n x y z",      "Compute local coordinates from global coordinates",      globalToLocal },
+    { nullptr,  "",             "",                                                       nullptr },
+    { "l?",     "",             "Show this help",                                         showLegHelp },
+};
+const ConsoleCommandTable Leg::commandTable = { "Leg Commands:", legCommands, sizeof(legCommands) / sizeof(legCommands[0]) };
+
+// Print leg-specific help information
+bool Leg::printConsoleHelp() {
+    return CommandRegistry::printHelp(commandTable);
+}
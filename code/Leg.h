@@ -3,6 +3,7 @@
 
   #include "Servo.h"
   #include "Driver.h"
+  #include "CommandRegistry.h"
 
   #define handler_index   0                 // Index for sync write handler
   
@@ -25,7 +26,7 @@
   class Leg {
     public:
       Leg();                                  // Constructor
-      bool    init( uint8_t legIndex,         // Initialize the leg servos
+      bool    init( uint8_t legIndex,         // Set up the leg, its servos are initialized by Hexapod::begin
                     uint8_t coxaID,           
                     uint8_t femurID, 
                     uint8_t tibiaID,
@@ -63,8 +64,12 @@
       bool      getTipGlobalPosition(float* tip_global_x, float* tip_global_y, float* tip_global_z);
 // -----------------------------------------------------------------------------------------------
       bool      printStatus();                                                            // Print current joint angles to Serial
-      bool      runConsoleCommands( const String& cmd, const String& args, int legIndex); // Process console commands for leg control
       bool      printConsoleHelp();                                                       // Print leg-specific help information
+      static const ConsoleCommandTable commandTable;                                      // Console commands and their help
+
+      enum LegJoint { Coxa  = 0,                                                          // Enum for leg joints, public for the console handlers
+                      Femur = 1, 
+                      Tibia = 2 };
 // -----------------------------------------------------------------------------------------------      
     private:
       Driver*   driver  = nullptr;          // Pointer to the driver instance
@@ -78,10 +83,6 @@
       float     baseR   = 0.0;              // Base Rotation position from body center
 
       uint8_t   servoIDs[LEG_SERVOS]={0,0,0};  // Servo IDs for the leg joints
-
-      enum LegJoint { Coxa  = 0,                  // Enum for leg joints
-                      Femur = 1, 
-                      Tibia = 2 };
   };
 
 #endif // LEG_H
\ No newline at end of file
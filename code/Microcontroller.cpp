@@ -139,110 +139,97 @@ bool Microcontroller::printStatus() {
 
 }
 
-// Process console commands for microcontroller control
-bool Microcontroller::runConsoleCommands(const String& cmd, const String& args) {
-    if (cmd == "ms") {
-        if (!printStatus()) {
-            LOG_ERR("Failed to print status");
-        }
-        return true;
-
-    } else if (cmd == "mbv") {
-        PRINTLN("Battery Voltage: " + String(getBatteryVoltage(), 4) + "V");
-        return true;
-        
-    } else if (cmd == "mbc") {
-        PRINTLN("Battery check: " + String(checkBattery()? "PASSED" : "FAILED"));
-        return true;
-        
-    } else if (cmd == "mpm") {
-        PRINTLN("Play melody: " + String(playMelody() ? "SUCCESS" : "FAILED"));
-        return true;
-        
-    } else if (cmd == "mlon") {
-        // Turn on LED: mlon [led_id] (1-4 for user LEDs, 0 for built-in, 5 for status)
-        int ledId = 1; // Default to user LED 1
-        if (args.length() > 0) {
-            int parsedId = args.toInt();
-            if (parsedId >= 0 && parsedId <= 5) {
-                ledId = parsedId;
-            }
-        }
-        
-        uint8_t actualLedPin;
-        String ledName;
-        switch (ledId) {
-            case 0:  actualLedPin = LED_BUILTIN;      ledName = "Built-in"; break;
-            case 1:  actualLedPin = BDPIN_LED_USER_1; ledName = "User1";    break;
-            case 2:  actualLedPin = BDPIN_LED_USER_2; ledName = "User2";    break;
-            case 3:  actualLedPin = BDPIN_LED_USER_3; ledName = "User3";    break;
-            case 4:  actualLedPin = BDPIN_LED_USER_4; ledName = "User4";    break;
-            case 5:  actualLedPin = BDPIN_LED_STATUS; ledName = "Status";   break;
-            default: actualLedPin = BDPIN_LED_USER_1; ledName = "User1";    break;
-        }
-        
-        PRINTLN(ledName + " LED turned " + String(ledOn(actualLedPin) ? "ON" : "FAILED"));
-        return true;
-        
-    } else if (cmd == "mloff") {
-        // Turn off LED: mloff [led_id] (1-4 for user LEDs, 0 for built-in, 5 for status)
-        int ledId = 1; // Default to user LED 1
-        if (args.length() > 0) {
-            int parsedId = args.toInt();
-            if (parsedId >= 0 && parsedId <= 5) {
-                ledId = parsedId;
-            }
-        }
-        
-        uint8_t actualLedPin;
-        String ledName;
-        switch (ledId) {
-            case 0:  actualLedPin = LED_BUILTIN;      ledName = "Built-in"; break;
-            case 1:  actualLedPin = BDPIN_LED_USER_1; ledName = "User1";    break;
-            case 2:  actualLedPin = BDPIN_LED_USER_2; ledName = "User2";    break;
-            case 3:  actualLedPin = BDPIN_LED_USER_3; ledName = "User3";    break;
-            case 4:  actualLedPin = BDPIN_LED_USER_4; ledName = "User4";    break;
-            case 5:  actualLedPin = BDPIN_LED_STATUS; ledName = "Status";   break;
-            default: actualLedPin = BDPIN_LED_USER_1; ledName = "User1";    break;
-        }
-        
-        PRINTLN(ledName + " LED turned " + String(ledOff(actualLedPin) ? "OFF" : "FAILED"));
-        return true;
+// ms: Print the microcontroller status
+static bool showMc(void* mc, const CommandArgs&) {
+    if (static_cast<Microcontroller*>(mc)->printStatus()) return true;
+    LOG_ERR("Failed to print status");
+    return false;
+}
 
-    } else if (cmd == "mu") {
-        PRINTLN("Microcontroller Uptime: " + String(getUpTime()) + " ms");
-        return true;
+// mbv: Print the battery voltage
+static bool showBatteryVoltage(void* mc, const CommandArgs&) {
+    PRINTLN("Battery Voltage: " + String(static_cast<Microcontroller*>(mc)->getBatteryVoltage(), 4) + "V");
+    return true;
+}
 
-    } else if (cmd == "mr") {
-        resetMicrocontroller();
-        return true;
+// mbc: Check the battery
+static bool checkBattery(void* mc, const CommandArgs&) {
+    bool passed = static_cast<Microcontroller*>(mc)->checkBattery();
+    PRINTLN("Battery check: " + String(passed ? "PASSED" : "FAILED"));
+    return passed;
+}
 
+// mpm: Play the melody
+static bool playMelody(void* mc, const CommandArgs&) {
+    bool played = static_cast<Microcontroller*>(mc)->playMelody();
+    PRINTLN("Play melody: " + String(played ? "SUCCESS" : "FAILED"));
+    return played;
+}
 
-            
-    } else if (cmd == "m?") {
-        printConsoleHelp();
-        return true;
-            
-    }   
-    return false;
+// LED pin and name of an mlon/mloff argument: 0 built-in, 1-4 user, 5 status, user LED 1 otherwise
+static uint8_t ledPin(const CommandArgs& args, const char** name) {
+    switch (args.toInt(0, 1)) {
+        case 0:  *name = "Built-in"; return LED_BUILTIN;
+        case 2:  *name = "User2";    return BDPIN_LED_USER_2;
+        case 3:  *name = "User3";    return BDPIN_LED_USER_3;
+        case 4:  *name = "User4";    return BDPIN_LED_USER_4;
+        case 5:  *name = "Status";   return BDPIN_LED_STATUS;
+        default: *name = "User1";    return BDPIN_LED_USER_1;
+    }
+}
+
+// mlon [0-5]: Turn on an LED
+static bool ledOn(void* mc, const CommandArgs& args) {
+    const char* name;
+    bool on = static_cast<Microcontroller*>(mc)->ledOn(ledPin(args, &name));
+    PRINTLN(String(name) + " LED turned " + (on ? "ON" : "FAILED"));
+    return on;
+}
+
+// mloff [0-5]: Turn off an LED
+static bool ledOff(void* mc, const CommandArgs& args) {
+    const char* name;
+    bool off = static_cast<Microcontroller*>(mc)->ledOff(ledPin(args, &name));
+    PRINTLN(String(name) + " LED turned " + (off ? "OFF" : "FAILED"));
+    return off;
+}
+
+// mu: Print the uptime
+static bool showUpTime(void* mc, const CommandArgs&) {
+    PRINTLN("Microcontroller Uptime: " + String(static_cast<Microcontroller*>(mc)->getUpTime()) + " ms");
+    return true;
+}
+
+// mr: Reset the microcontroller
+static bool resetMc(void* mc, const CommandArgs&) {
+    static_cast<Microcontroller*>(mc)->resetMicrocontroller();
+    return true;
+}
+
+// m?: Print the microcontroller help
+static bool showMcHelp(void* mc, const CommandArgs&) {
+    return static_cast<Microcontroller*>(mc)->printConsoleHelp();
 }
 
+// Console commands, the help is printed from this table
+static const ConsoleCommand mcCommands[] = {
+    { "ms",     "",      "Show microcontroller status",                     showMc },
+    { nullptr,  "",      "",                                                nullptr },
+    { "mbv",    "",      "Read battery voltage",                            showBatteryVoltage },
+    { "mbc",    "",      "Check battery status",                            checkBattery },
+    { nullptr,  "",      "",                                                nullptr },
+    { "mpm",    "",      "Play melody",                                     playMelody },
+    { "mlon",   "[0-5]", "Turn on LED (0=builtin, 1-4=user, 5=status)",     ledOn },
+    { "mloff",  "[0-5]", "Turn off LED (0=builtin, 1-4=user, 5=status)",    ledOff },
+    { nullptr,  "",      "",                                                nullptr },
+    { "mu",     "",      "Show microcontroller uptime in milliseconds",     showUpTime },
+    { "mr",     "",      "Reset the microcontroller",                       resetMc },
+    { nullptr,  "",      "",                                                nullptr },
+    { "m?",     "",      "Show this help",                                  showMcHelp },
+};
+const ConsoleCommandTable Microcontroller::commandTable = { "Microcontroller Commands:", mcCommands, sizeof(mcCommands) / sizeof(mcCommands[0]) };
+
 // Print microcontroller-specific help information
 bool Microcontroller::printConsoleHelp() {
-    PRINTLN("Microcontroller Commands:\n\r");
-    PRINTLN("  ms               - Show microcontroller status");
-    PRINTLN("");
-    PRINTLN("  mbv              - Read battery voltage");
-    PRINTLN("  mbc              - Check battery status");
-    PRINTLN("");
-    PRINTLN("  mpm              - Play melody");
-    PRINTLN("  mlon [0-5]       - Turn on LED (0=builtin, 1-4=user, 5=status)");
-    PRINTLN("  mloff [0-5]      - Turn off LED (0=builtin, 1-4=user, 5=status)");
-    PRINTLN("");
-    PRINTLN("  mu               - Show microcontroller uptime in milliseconds");
-    PRINTLN("  mr               - Reset the microcontroller");
-    PRINTLN("");
-    PRINTLN("  m?               - Show this help");
-    PRINTLN("");
-    return true;
-}
\ No newline at end of file
+    return CommandRegistry::printHelp(commandTable);
+}
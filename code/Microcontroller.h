@@ -2,6 +2,7 @@
 #define MICROCONTROLLER_H   
 
     #include <Arduino.h>          // Include Arduino library for basic functions
+    #include "CommandRegistry.h"  // Console command tables
 
     class Microcontroller {
         
@@ -20,8 +21,8 @@
             unsigned long   getUpTime();                // get the uptime of the microcontroller in milliseconds
 
             bool            printStatus();              // print the current status to the given stream
-            bool            runConsoleCommands(const String& cmd, const String& args);  // Process console commands for microcontroller control
             bool            printConsoleHelp();                // Print microcontroller-specific help information
+            static const ConsoleCommandTable commandTable;     // Console commands and their help
 
         private:
             
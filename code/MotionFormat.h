@@ -0,0 +1,121 @@
+#ifndef MOTIONFORMAT_H
+#define MOTIONFORMAT_H
+
+    // Packed motion page format, shared by the firmware and the host compiler in mtn/.
+    // Depends only on <stdint.h> so the host tool can include it to verify its output.
+    //
+    // Each page is a bit stream, least significant bit first, starting on a byte boundary:
+    //
+    //   first step   pause:16 time:16 position:10 x MOTION_SERVOS
+    //   other steps  timed:1 [pause:16 time:16] mask:MOTION_SERVOS width:4 delta:width x popcount(mask)
+    //
+    // Pause and time are in ms. mask has one bit per servo whose position changed from the previous
+    // step; deltas are zigzag coded (0, -1, 1, -2, ...) with the smallest width that fits all of them.
+
+    #include <stdint.h>
+
+    #define MOTION_SERVOS           uint8_t(20)         // Servo IDs 1 to 20 are enabled in the RoboPlus motion files
+    #define MOTION_NO_PAGE          uint8_t(0)          // RoboPlus page number meaning "none" for next/exit pages
+    #define MOTION_POSITION_BITS    uint8_t(10)         // AX-18A goal positions are 0 to 1023
+    #define MOTION_TIME_BITS        uint8_t(16)         // Pause and move time in ms
+    #define MOTION_WIDTH_BITS       uint8_t(4)          // Width field of a delta step
+
+    // One decoded RoboPlus keyframe
+    struct MotionStep {
+        uint16_t        positions[MOTION_SERVOS];       // Goal positions for servo IDs 1 to 20
+        uint16_t        pause;                          // Hold time after the move in ms
+        uint16_t        time;                           // Move time in ms
+    };
+
+    // Page index entry with the RoboPlus play_param values
+    struct MotionPage {
+        const char*     name;                           // Page name
+        uint8_t         number;                         // RoboPlus page number
+        uint8_t         next;                           // Page played after the last repeat, MOTION_NO_PAGE to stop
+        uint8_t         exit;                           // Page played when stopped, MOTION_NO_PAGE to stop at once
+        uint8_t         repeat;                         // Number of times the page is played
+        float           speedRate;                      // Playback speed multiplier, step times are divided by it
+        uint8_t         numSteps;                       // Number of keyframes
+        const uint8_t*  data;                           // Packed keyframes, in flash
+        uint16_t        size;                           // Size of the packed keyframes in bytes
+    };
+
+    // Streams keyframes out of a packed page one at a time. Only the previous keyframe is kept,
+    // so pages are never unpacked into RAM.
+    class MotionDecoder {
+        public:
+            MotionDecoder() : page(nullptr), bitPos(0), stepIndex(0), pause(0), time(0) {
+                for (uint8_t i = 0; i < MOTION_SERVOS; i++) positions[i] = 0;
+            }
+
+            // Start decoding a page from its first keyframe
+            void begin(const MotionPage* page) {
+                this->page = page;
+                rewind();
+            }
+
+            // Restart the current page
+            void rewind() {
+                bitPos    = 0;
+                stepIndex = 0;
+            }
+
+            // Index of the next keyframe to be decoded
+            uint8_t getStepIndex() const {
+                return stepIndex;
+            }
+
+            // Decode the next keyframe, returns false at the end of the page or on a corrupt stream
+            bool next(MotionStep& step) {
+                if (page == nullptr || stepIndex >= page->numSteps) return false;
+
+                if (stepIndex == 0 || readBits(1)) {                                    // Timing is only stored when it changes
+                    pause = (uint16_t)readBits(MOTION_TIME_BITS);
+                    time  = (uint16_t)readBits(MOTION_TIME_BITS);
+                }
+
+                if (stepIndex == 0) {                                                   // Key frame: all positions
+                    for (uint8_t i = 0; i < MOTION_SERVOS; i++) {
+                        positions[i] = (uint16_t)readBits(MOTION_POSITION_BITS);
+                    }
+                } else {                                                                // Delta frame: changed positions only
+                    uint32_t mask  = readBits(MOTION_SERVOS);
+                    uint8_t  width = (uint8_t)readBits(MOTION_WIDTH_BITS);
+                    for (uint8_t i = 0; i < MOTION_SERVOS; i++) {
+                        if (!(mask & (1UL << i))) continue;
+                        uint32_t zigzag = readBits(width);
+                        int32_t  delta  = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+                        positions[i]    = (uint16_t)(positions[i] + delta);
+                    }
+                }
+                if (bitPos > (uint32_t)page->size * 8) return false;                    // Ran past the end of the page
+
+                for (uint8_t i = 0; i < MOTION_SERVOS; i++) {
+                    step.positions[i] = positions[i];
+                }
+                step.pause = pause;
+                step.time  = time;
+                stepIndex++;
+                return true;
+            }
+
+        private:
+            const MotionPage*   page;                       // Page being decoded
+            uint32_t            bitPos;                     // Read position in the page bit stream
+            uint8_t             stepIndex;                  // Index of the next keyframe
+            uint16_t            pause;                      // Pause of the previous keyframe
+            uint16_t            time;                       // Move time of the previous keyframe
+            uint16_t            positions[MOTION_SERVOS];   // Positions of the previous keyframe
+
+            // Read n bits, least significant bit first; bits past the end of the page read as zero
+            uint32_t readBits(uint8_t n) {
+                uint32_t value = 0;
+                for (uint8_t i = 0; i < n; i++, bitPos++) {
+                    uint32_t byte = bitPos >> 3;
+                    if (byte < page->size && (page->data[byte] & (1 << (bitPos & 7)))) value |= 1UL << i;
+                }
+                return value;
+            }
+    };
+
+#endif // MOTIONFORMAT_H
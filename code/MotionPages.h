@@ -0,0 +1,47 @@
+#ifndef __MOTIONPAGES_H__
+#define __MOTIONPAGES_H__
+
+    // Generated by mtn/mtnc from Basic_Motions.mtn, do not edit.
+    // 6 pages, 20 steps, 269 bytes of packed keyframes (880 bytes unpacked). See MotionFormat.h for the format.
+
+    const uint8_t motionData[] = {
+        // 1 StandingLow
+        0x00, 0x00, 0xE8, 0x03, 0x99, 0x9A, 0x35, 0x83, 0x59, 0x99, 0x32, 0x0F, 0xA0, 0x59, 0x33, 0x00,
+        0x98, 0x29, 0xF3, 0x66, 0x99, 0x35, 0x43, 0xA6, 0x99, 0x32, 0x0F, 0x20, 0x33,
+        // 2 Tripod_FW
+        0x00, 0x00, 0xE8, 0x03, 0x99, 0x9A, 0x35, 0x03, 0x73, 0x33, 0x33, 0x9F, 0x19, 0x33, 0x33, 0x00,
+        0x98, 0x29, 0xF3, 0x66, 0x99, 0x35, 0x03, 0xC0, 0x33, 0x33, 0x0F, 0x20, 0x33, 0x20, 0x01, 0x22,
+        0x67, 0xD2, 0x9C, 0x69, 0xC9, 0x16, 0x72, 0xD9, 0xCC, 0x65, 0xCE, 0x98, 0xD1, 0x5C, 0x36, 0xB3,
+        0x19, 0x01, 0x12, 0x48, 0x9A, 0x33, 0x69, 0x02,
+        // 3 Tripod_BW
+        0x00, 0x00, 0xE8, 0x03, 0x99, 0x9A, 0x35, 0x03, 0x40, 0x33, 0x33, 0x6F, 0x26, 0x33, 0x33, 0x00,
+        0x98, 0x29, 0xF3, 0x66, 0x99, 0x35, 0xC3, 0x8C, 0x33, 0x33, 0x0F, 0x20, 0x33, 0x20, 0x01, 0x22,
+        0x67, 0xD2, 0x9C, 0x69, 0xC9, 0x16, 0xD2, 0xD9, 0x4C, 0x66, 0xCB, 0x8E, 0xD1, 0x64, 0x36, 0x93,
+        0x19, 0x01, 0x12, 0x48, 0x9A, 0x33, 0x69, 0x02,
+        // 4 HeadScan1
+        0x00, 0x00, 0xE8, 0x03, 0x99, 0x9A, 0x35, 0x83, 0x59, 0x99, 0x32, 0x0F, 0xA0, 0x59, 0x33, 0x00,
+        0x98, 0x29, 0xF3, 0x66, 0x99, 0x35, 0x43, 0xA6, 0x99, 0x32, 0x0F, 0x00, 0x33, 0x00, 0x00, 0x68,
+        0x01, 0x08, 0x00, 0x80, 0xD4, 0x7F, 0x00, 0x00, 0xA4, 0xFD, 0x03,
+        // 5 HeadScan2
+        0x00, 0x00, 0xE8, 0x03, 0x99, 0x9A, 0x35, 0x83, 0x59, 0x99, 0x32, 0x0F, 0xA0, 0x59, 0x33, 0x00,
+        0x98, 0x29, 0xF3, 0x66, 0x99, 0x35, 0x43, 0xA6, 0x99, 0x32, 0x0F, 0x80, 0x59, 0x00, 0x00, 0x78,
+        0x01, 0x38, 0x13, 0x00, 0x00, 0xAC, 0xFE, 0xD3, 0x04, 0x00, 0x80, 0xB5, 0xFF, 0x99, 0x00,
+        // 6 HeadScan3
+        0x00, 0x00, 0xE8, 0x03, 0x99, 0x9A, 0x35, 0x83, 0x59, 0x99, 0x32, 0x0F, 0xA0, 0x59, 0x33, 0x00,
+        0x98, 0x29, 0xF3, 0x66, 0x99, 0x35, 0x43, 0xA6, 0x99, 0x32, 0x0F, 0xA0, 0xED, 0x00, 0x00, 0x70,
+        0xAB, 0x0D, 0x00, 0x00, 0x53, 0x20
+    };
+
+    const MotionPage motionPages[] = {
+        //  name            page  next  exit  repeat  speed  steps  data                size
+        {   "StandingLow",     1,    0,    0,      1,   2.0f,    1,  motionData +    0,   29 },
+        {   "Tripod_FW",       2,    0,    0,      7,   2.0f,    4,  motionData +   29,   56 },
+        {   "Tripod_BW",       3,    0,    0,      1,   2.0f,    4,  motionData +   85,   56 },
+        {   "HeadScan1",       4,    0,    0,      1,   1.0f,    4,  motionData +  141,   43 },
+        {   "HeadScan2",       5,    0,    0,      1,   1.0f,    4,  motionData +  184,   47 },
+        {   "HeadScan3",       6,    0,    0,      1,   1.0f,    3,  motionData +  231,   38 }
+    };
+
+    #define MOTION_PAGES    uint8_t(sizeof(motionPages) / sizeof(motionPages[0]))     // Number of compiled motion pages
+
+#endif // __MOTIONPAGES_H__
@@ -0,0 +1,318 @@
+#include "MotionPlayer.h"
+#include "MotionPages.h"
+#include "Trajectory.h"
+#include "Console.h"
+#include "Debug.h"
+
+// Constructor for MotionPlayer class
+MotionPlayer::MotionPlayer() {
+    driver          = nullptr;
+    gc              = nullptr;
+    page            = nullptr;
+    stepIndex       = 0;
+    repeatCount     = 0;
+    stopRequested   = false;
+    stepDone        = false;
+    stepStart       = 0;
+    moveTime        = 0;
+    pauseTime       = 0;
+    framesWritten   = 0;
+    writeErrors     = 0;
+
+    for (uint8_t i = 0; i < MOTION_SERVOS; i++) {
+        ids[i]   = i + 1;
+        from[i]  = 512;
+        frame[i] = 512;
+    }
+}
+
+// Initialize the motion player
+bool MotionPlayer::begin(Driver* driver, GaitController* gc) {
+    if (driver == nullptr || gc == nullptr) {
+        LOG_ERR("Driver or GaitController is not initialized.");
+        return false;
+    }
+    this->driver    = driver;
+    this->gc        = gc;
+    page            = nullptr;
+
+    LOG_INF("MotionPlayer initialized with " + String(MOTION_PAGES) + " pages.");
+    return true;
+}
+
+// Interpolate and write one frame of the playing page, call in loop()
+bool MotionPlayer::update() {
+    if (page == nullptr) return true;                                               // Nothing to play
+    if (gc->getGaitType() != GAIT_IDLE) {                                           // Gait was started before the hold was taken
+        LOG_WRN("Gait started, motion halted.");
+        return halt();
+    }
+
+    uint32_t elapsed = micros() - stepStart;
+
+    if (elapsed < moveTime) {                                                       // Moving: quintic ease between keyframes
+        float s = Trajectory::smoothstep5((float)elapsed / (float)moveTime);
+        for (uint8_t i = 0; i < MOTION_SERVOS; i++) {
+            frame[i] = from[i] + (int32_t)lroundf((float)((int32_t)target.positions[i] - from[i]) * s);
+        }
+        return writeFrame();
+    }
+
+    if (!stepDone) {                                                                // Land exactly on the keyframe once
+        for (uint8_t i = 0; i < MOTION_SERVOS; i++) {
+            frame[i] = target.positions[i];
+        }
+        if (!writeFrame()) return false;                                            // Retried next update
+        stepDone = true;
+    }
+
+    if (elapsed < moveTime + pauseTime) return true;                                // Holding the keyframe
+    return nextStep();
+}
+
+// Play a page by RoboPlus page number
+bool MotionPlayer::play(uint8_t number) {
+    const MotionPage* next = findPage(number);
+    if (next == nullptr) {
+        LOG_ERR("Motion page " + String(number) + " not found.");
+        return false;
+    }
+    return startPage(next);
+}
+
+// Play a page by name
+bool MotionPlayer::play(const String& name) {
+    const MotionPage* next = findPage(name);
+    if (next == nullptr) {
+        LOG_ERR("Motion page " + name + " not found.");
+        return false;
+    }
+    return startPage(next);
+}
+
+// Finish the current step, then play the exit page or stop
+bool MotionPlayer::stop() {
+    if (page == nullptr) return true;
+    stopRequested = true;
+    return true;
+}
+
+// Stop immediately, the servos finish their last written goal
+bool MotionPlayer::halt() {
+    page          = nullptr;
+    stopRequested = false;
+    if (gc != nullptr) gc->release(MOTION_GAIT_HOLD);
+    return true;
+}
+
+// Check if a page is playing
+bool MotionPlayer::isPlaying() const {
+    return page != nullptr;
+}
+
+// Find a page by RoboPlus page number
+const MotionPage* MotionPlayer::findPage(uint8_t number) const {
+    for (uint8_t i = 0; i < MOTION_PAGES; i++) {
+        if (motionPages[i].number == number) return &motionPages[i];
+    }
+    return nullptr;
+}
+
+// Find a page by name, case-insensitive
+const MotionPage* MotionPlayer::findPage(const String& name) const {
+    for (uint8_t i = 0; i < MOTION_PAGES; i++) {
+        if (name.equalsIgnoreCase(motionPages[i].name)) return &motionPages[i];
+    }
+    return nullptr;
+}
+
+// Start a page from its first keyframe, starting from the present positions if nothing is playing
+bool MotionPlayer::startPage(const MotionPage* next) {
+    if (!gc->hold(MOTION_GAIT_HOLD)) {                                              // The gait refuses to start until halt()
+        LOG_ERR("Set the gait to idle and stop the recorder before playing a motion.");
+        return false;
+    }
+    bool playing = page != nullptr;
+    if (!loadPage(next)) return false;
+    if (!playing && !readPositions(target)) {
+        LOG_WRN("Failed to read present positions, first step will not be interpolated.");
+    }
+
+    stopRequested   = false;
+    startStep();
+    LOG_INF("Playing motion page " + String(page->number) + " " + String(page->name));
+    return true;
+}
+
+// Decode the first keyframe of a page and make it the current page
+bool MotionPlayer::loadPage(const MotionPage* next) {
+    decoder.begin(next);
+    if (!decoder.next(target)) {
+        LOG_ERR("Motion page " + String(next->number) + " is empty or corrupt.");
+        halt();
+        return false;
+    }
+    page        = next;
+    stepIndex   = 0;
+    repeatCount = 0;
+    return true;
+}
+
+// Start moving from the last frame towards the current keyframe
+void MotionPlayer::startStep() {
+    float rate = page->speedRate > 0.0f ? page->speedRate : 1.0f;
+
+    for (uint8_t i = 0; i < MOTION_SERVOS; i++) {
+        from[i] = frame[i];
+    }
+    moveTime    = (uint32_t)(target.time  * 1000.0f / rate);
+    pauseTime   = (uint32_t)(target.pause * 1000.0f / rate);
+    stepStart   = micros();
+    stepDone    = false;
+}
+
+// Advance to the next keyframe, repeat, chain to the next page, or stop
+bool MotionPlayer::nextStep() {
+    if (decoder.next(target)) {                                                     // More keyframes in this page
+        stepIndex++;
+        startStep();
+        return true;
+    }
+
+    repeatCount++;
+    const MotionPage* next = nullptr;
+    if (stopRequested) {                                                            // Stop: play the exit page, if any
+        next = findPage(page->exit);
+        stopRequested = false;
+    } else if (repeatCount < page->repeat) {                                        // Repeat this page
+        decoder.rewind();
+        if (!decoder.next(target)) return halt();
+        stepIndex = 0;
+        startStep();
+        return true;
+    } else {                                                                        // Chain to the next page, if any
+        next = findPage(page->next);
+    }
+
+    if (next == nullptr) {
+        LOG_INF("Motion page " + String(page->name) + " finished.");
+        return halt();
+    }
+    if (!loadPage(next)) return false;
+    startStep();
+    return true;
+}
+
+// Sync write the current frame to all motion servos
+bool MotionPlayer::writeFrame() {
+    if (!driver->syncWrite(MOTION_SYNC_WRITE_HANDLER, ids, MOTION_SERVOS, frame, 1)) {
+        writeErrors++;
+        return false;
+    }
+    framesWritten++;
+    return true;
+}
+
+// Read present positions of all motion servos into the frame, servos that do not answer start at the fallback keyframe
+bool MotionPlayer::readPositions(const MotionStep& fallback) {
+    bool success = true;
+    for (uint8_t i = 0; i < MOTION_SERVOS; i++) {
+        uint32_t position = 0;
+        if (driver->readRegister(ids[i], "Present_Position", &position)) {
+            frame[i] = position;
+        } else {
+            frame[i] = fallback.positions[i];
+            success  = false;
+        }
+    }
+    return success;
+}
+
+// Print current player status
+bool MotionPlayer::printStatus() {
+    PRINTLN("MotionPlayer Status: \n\r");
+    if (page == nullptr) {
+        PRINTLN("Page             : none");
+    } else {
+        PRINTLN("Page             : " + String(page->number) + " " + String(page->name)
+                + " | Step " + String(stepIndex + 1) + "/" + String(page->numSteps)
+                + " | Repeat " + String(repeatCount + 1) + "/" + String(page->repeat)
+                + (stopRequested ? " | Stopping" : ""));
+    }
+    PRINTLN("Frames           : written " + String(framesWritten) + " | errors " + String(writeErrors));
+    return true;
+}
+
+// Print the compiled pages
+bool MotionPlayer::printPages() {
+    PRINTLN("Motion Pages:\n\r");
+    for (uint8_t i = 0; i < MOTION_PAGES; i++) {
+        const MotionPage& p = motionPages[i];
+        PRINTLN("  " + String(p.number) + "\t" + String(p.name)
+                + " | steps " + String(p.numSteps)
+                + " | " + String(p.size) + " bytes"
+                + " | repeat " + String(p.repeat)
+                + " | speed " + String(p.speedRate, 1)
+                + " | next " + String(p.next)
+                + " | exit " + String(p.exit));
+    }
+    return true;
+}
+
+// ps: Print the player status
+static bool showMotion(void* motion, const CommandArgs&) {
+    return static_cast<MotionPlayer*>(motion)->printStatus();
+}
+
+// pl: List the compiled pages
+static bool listPages(void* motion, const CommandArgs&) {
+    return static_cast<MotionPlayer*>(motion)->printPages();
+}
+
+// pp [page|name]: Play a page by number or name
+static bool playPage(void* module, const CommandArgs& args) {
+    MotionPlayer* motion = static_cast<MotionPlayer*>(module);
+    if (args.count() == 0) {
+        LOG_ERR("Usage: pp [page|name]");
+        return false;
+    }
+    if (isDigit(args.get(0)[0])) return motion->play((uint8_t)args.toInt(0, 0));
+    return motion->play(String(args.rest()));
+}
+
+// px: Stop after the current step and play the exit page
+static bool stopMotion(void* motion, const CommandArgs&) {
+    static_cast<MotionPlayer*>(motion)->stop();
+    LOG_INF("Motion stopping.");
+    return true;
+}
+
+// ph: Halt the motion immediately
+static bool haltMotion(void* motion, const CommandArgs&) {
+    static_cast<MotionPlayer*>(motion)->halt();
+    LOG_INF("Motion halted.");
+    return true;
+}
+
+// p?: Print the motion player help
+static bool showMotionHelp(void* motion, const CommandArgs&) {
+    return static_cast<MotionPlayer*>(motion)->printConsoleHelp();
+}
+
+// Console commands, the help is printed from this table
+static const ConsoleCommand motionCommands[] = {
+    { "ps",     "",            "Show motion player status",                             showMotion },
+    { "pl",     "",            "List compiled motion pages",                            listPages },
+    { "pp",     "[page|name]", "Play a motion page by number or name",                  playPage },
+    { "px",     "",            "Stop after the current step and play the exit page",   stopMotion },
+    { "ph",     "",            "Halt the motion immediately",                           haltMotion },
+    { "p?",     "",            "Show this help",                                        showMotionHelp },
+};
+const ConsoleCommandTable MotionPlayer::commandTable = { "Motion Commands:", motionCommands, sizeof(motionCommands) / sizeof(motionCommands[0]) };
+
+// Print motion-specific help information
+bool MotionPlayer::printConsoleHelp() {
+    return CommandRegistry::printHelp(commandTable);
+}
+
+// end of MotionPlayer.cpp
@@ -0,0 +1,65 @@
+#ifndef MOTIONPLAYER_H
+#define MOTIONPLAYER_H
+
+    #include <Arduino.h>
+    #include "Driver.h"
+    #include "GaitController.h"
+    #include "MotionFormat.h"
+    #include "CommandRegistry.h"
+
+    #define MOTION_SYNC_WRITE_HANDLER   uint8_t(0)          // Goal_Position sync write handler added by Hexapod::begin()
+    #define MOTION_GAIT_HOLD            "motion"            // Name the player holds the gait under while a page plays
+
+    // Plays compiled RoboPlus motion pages. update() is non-blocking: every call interpolates
+    // between keyframes from the elapsed time and sync-writes one frame for all motion servos.
+    // Keyframes are streamed out of the packed pages one at a time by a MotionDecoder.
+    class MotionPlayer {
+        public:
+            MotionPlayer();                                                         // Constructor
+            bool                begin(Driver* driver, GaitController* gc);          // Initialize with driver and gait controller
+            bool                update();                                           // Write the next frame, call in loop()
+
+            bool                play(uint8_t number);                               // Play a page by RoboPlus page number
+            bool                play(const String& name);                           // Play a page by name
+            bool                stop();                                             // Finish the current step, then play the exit page
+            bool                halt();                                             // Stop immediately where the servos are
+            bool                isPlaying() const;                                  // Check if a page is playing
+            const MotionPage*   findPage(uint8_t number) const;                     // Find a page by number, nullptr if not compiled
+            const MotionPage*   findPage(const String& name) const;                 // Find a page by name, nullptr if not compiled
+
+            bool                printStatus();                                      // Print current player status
+            bool                printPages();                                       // Print the compiled pages
+            bool                printConsoleHelp();                                 // Print motion-specific help information
+            static const ConsoleCommandTable commandTable;                          // Console commands and their help
+
+        private:
+            Driver*             driver;                                             // Pointer to the driver instance
+            GaitController*     gc;                                                 // Gait controller, must be idle while a page plays
+
+            const MotionPage*   page;                                               // Page being played, nullptr when stopped
+            MotionDecoder       decoder;                                            // Streams keyframes of the current page
+            MotionStep          target;                                             // Keyframe being moved to
+            uint8_t             stepIndex;                                          // Keyframe being moved to
+            uint8_t             repeatCount;                                        // Completed repeats of the current page
+            bool                stopRequested;                                      // stop() was called
+            bool                stepDone;                                           // Final frame of the current step was written
+
+            uint32_t            stepStart;                                          // Time the current step started in us
+            uint32_t            moveTime;                                           // Move time of the current step in us
+            uint32_t            pauseTime;                                          // Pause time of the current step in us
+            int32_t             from[MOTION_SERVOS];                                // Positions at the start of the step
+            int32_t             frame[MOTION_SERVOS];                               // Last frame written to the servos
+            uint8_t             ids[MOTION_SERVOS];                                 // Servo IDs 1 to 20
+
+            uint32_t            framesWritten;                                      // Number of frames written
+            uint32_t            writeErrors;                                        // Number of failed sync writes
+
+            bool                startPage(const MotionPage* next);                  // Start a page from its first step
+            bool                loadPage(const MotionPage* next);                   // Decode the first keyframe of a page
+            void                startStep();                                        // Start moving towards the current keyframe
+            bool                nextStep();                                         // Advance to the next keyframe, page or stop
+            bool                writeFrame();                                       // Sync write the current frame
+            bool                readPositions(const MotionStep& fallback);          // Read present positions into frame[]
+    };
+
+#endif // MOTIONPLAYER_H
@@ -0,0 +1,131 @@
+#include "Protocol1.h"
+
+// Constructor for Protocol1 class
+Protocol1::Protocol1() {
+    length      = 0;
+    sum         = 0;
+    syncData    = 0;
+    tx[0]       = 0xFF;                                                             // The header never changes
+    tx[1]       = 0xFF;
+}
+
+// Build PING: FF FF ID 02 01 CHK
+uint16_t Protocol1::ping(uint8_t id) {
+    length = header(id, PROTOCOL1_PING, 0);
+    return close();
+}
+
+// Build READ: FF FF ID 04 02 ADDR LEN CHK
+uint16_t Protocol1::read(uint8_t id, uint8_t address, uint8_t count) {
+    length       = header(id, PROTOCOL1_READ, 2);
+    tx[length++] = address;
+    tx[length++] = count;
+    return close();
+}
+
+// Build WRITE: FF FF ID LEN+3 03 ADDR DATA... CHK
+uint16_t Protocol1::write(uint8_t id, uint8_t address, const uint8_t* data, uint8_t count) {
+    if (count + 7 > PROTOCOL1_TX_MAX) return 0;
+    length       = header(id, PROTOCOL1_WRITE, count + 1);
+    tx[length++] = address;
+    for (uint8_t i = 0; i < count; i++) {
+        tx[length++] = data[i];
+    }
+    return close();
+}
+
+// Start a SYNC WRITE: FF FF FE LEN 83 ADDR L, then (ID DATA[L]) per servo and CHK. The length field
+// is filled in by syncEnd; everything else of the header is summed now.
+void Protocol1::syncBegin(uint8_t address, uint8_t count) {
+    tx[2]       = PROTOCOL1_BROADCAST_ID;
+    tx[4]       = PROTOCOL1_SYNC_WRITE;
+    tx[5]       = address;
+    tx[6]       = count;
+    length      = 7;
+    syncData    = count;
+    sum         = PROTOCOL1_BROADCAST_ID + PROTOCOL1_SYNC_WRITE + address + count;
+}
+
+// Append one ID and the low syncData bytes of value, little-endian, to the sum as they go in
+bool Protocol1::syncAdd(uint8_t id, uint32_t value) {
+    if (length + 1 + syncData + 1 > PROTOCOL1_TX_MAX) return false;                  // Keep room for the checksum
+    tx[length++] = id;
+    sum         += id;
+    for (uint8_t i = 0; i < syncData; i++) {
+        uint8_t b    = (uint8_t)(value >> (8 * i));
+        tx[length++] = b;
+        sum         += b;
+    }
+    return true;
+}
+
+// Close a SYNC WRITE with its length field and checksum
+uint16_t Protocol1::syncEnd() {
+    uint8_t field = (uint8_t)(length - 3);                                          // Instruction, params and checksum
+    tx[3]         = field;
+    tx[length++]  = (uint8_t)~(sum + field);
+    return length;
+}
+
+// Instruction packet built last
+const uint8_t* Protocol1::txBuffer() const {
+    return tx;
+}
+
+// Length of the instruction packet built last
+uint16_t Protocol1::txLength() const {
+    return length;
+}
+
+// Receive buffer for status packets
+uint8_t* Protocol1::rxBuffer() {
+    return rx;
+}
+
+// Status packet size: FF FF ID LEN ERR PARAMS... CHK
+uint16_t Protocol1::statusLength(uint8_t paramLength) {
+    return 6 + paramLength;
+}
+
+// Validate the status packet of received bytes in rxBuffer, expected from id, and point status at it
+Protocol1Result Protocol1::parse(uint16_t received, uint8_t id, Protocol1Status* status) const {
+    if (received == 0) return PROTOCOL1_NO_STATUS;
+    if (received < 6) return PROTOCOL1_SHORT;
+    if (rx[0] != 0xFF || rx[1] != 0xFF) return PROTOCOL1_BAD_HEADER;
+
+    uint8_t field = rx[3];
+    if (field < 2 || received < (uint16_t)field + 4) return PROTOCOL1_SHORT;
+
+    uint8_t check = 0;
+    for (uint16_t i = 2; i < (uint16_t)field + 3; i++) {
+        check += rx[i];
+    }
+    if ((uint8_t)~check != rx[field + 3]) return PROTOCOL1_BAD_CHECKSUM;
+    if (rx[2] != id) return PROTOCOL1_WRONG_ID;
+
+    status->id          = rx[2];
+    status->error       = rx[4];
+    status->params      = &rx[5];
+    status->paramLength = field - 2;
+    return PROTOCOL1_OK;
+}
+
+// Write FF FF ID LEN INST and return the index of the first parameter
+uint16_t Protocol1::header(uint8_t id, uint8_t instruction, uint8_t paramLength) {
+    tx[2] = id;
+    tx[3] = paramLength + 2;
+    tx[4] = instruction;
+    return 5;
+}
+
+// Append the checksum of ID through the last parameter and return the packet length
+uint16_t Protocol1::close() {
+    uint8_t check = 0;
+    for (uint16_t i = 2; i < length; i++) {
+        check += tx[i];
+    }
+    tx[length++] = (uint8_t)~check;
+    return length;
+}
+
+// end of Protocol1.cpp
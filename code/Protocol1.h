@@ -0,0 +1,70 @@
+#ifndef PROTOCOL1_H
+#define PROTOCOL1_H
+
+    #include <stdint.h>
+
+    #define PROTOCOL1_TX_MAX            uint16_t(128)       // Largest instruction packet, a sync write of 20 IDs x 4 bytes is 108
+    #define PROTOCOL1_RX_MAX            uint16_t(64)        // Largest status packet accepted
+    #define PROTOCOL1_BROADCAST_ID      uint8_t(0xFE)       // Broadcast ID, used by sync write
+
+    #define PROTOCOL1_PING              uint8_t(0x01)       // Instructions
+    #define PROTOCOL1_READ              uint8_t(0x02)
+    #define PROTOCOL1_WRITE             uint8_t(0x03)
+    #define PROTOCOL1_SYNC_WRITE        uint8_t(0x83)
+
+    // Result of parsing a status packet
+    enum Protocol1Result : int8_t {
+        PROTOCOL1_OK            = 0,                        // Valid status packet
+        PROTOCOL1_NO_STATUS     = -1,                       // Nothing received
+        PROTOCOL1_SHORT         = -2,                       // Fewer bytes than the length field announces
+        PROTOCOL1_BAD_HEADER    = -3,                       // Does not start with 0xFF 0xFF
+        PROTOCOL1_BAD_CHECKSUM  = -4,                       // Checksum mismatch
+        PROTOCOL1_WRONG_ID      = -5                        // Answer from another ID
+    };
+
+    // A status packet parsed in place: params points into the receive buffer
+    struct Protocol1Status {
+        uint8_t         id;                                 // ID of the answering servo
+        uint8_t         error;                              // Error bits of the status packet
+        const uint8_t*  params;                             // First parameter byte
+        uint8_t         paramLength;                        // Number of parameter bytes
+    };
+
+    // Dynamixel Protocol 1.0 codec working on two preallocated buffers. Instruction packets are written
+    // straight into the transmit buffer; a sync write keeps its header from syncBegin and only appends
+    // one ID and its data per syncAdd, carrying the checksum along. Status packets are
+    // validated in the receive buffer and returned as a view, without copying.
+    //
+    // Packet layout: 0xFF 0xFF ID LENGTH INSTRUCTION/ERROR PARAMS... CHECKSUM, where LENGTH counts the
+    // bytes after it and CHECKSUM = ~(ID + LENGTH + INSTRUCTION/ERROR + PARAMS) & 0xFF.
+    class Protocol1 {
+        public:
+            Protocol1();                                                            // Constructor
+
+            uint16_t        ping(uint8_t id);                                       // Build PING, returns the packet length
+            uint16_t        read(uint8_t id, uint8_t address, uint8_t length);      // Build READ of length bytes
+            uint16_t        write(uint8_t id, uint8_t address, const uint8_t* data, uint8_t length);  // Build WRITE, 0 if too long
+
+            void            syncBegin(uint8_t address, uint8_t length);             // Start a SYNC WRITE of length bytes per ID
+            bool            syncAdd(uint8_t id, uint32_t value);                    // Append one ID, value little-endian; false when full
+            uint16_t        syncEnd();                                              // Close the SYNC WRITE, returns the packet length
+
+            const uint8_t*  txBuffer() const;                                       // Instruction packet built last
+            uint16_t        txLength() const;                                       // Its length in bytes
+            uint8_t*        rxBuffer();                                             // Where the status packet is received
+            static uint16_t statusLength(uint8_t paramLength);                      // Status packet size for paramLength parameter bytes
+
+            Protocol1Result parse(uint16_t received, uint8_t id, Protocol1Status* status) const;  // Validate the status packet in rxBuffer
+
+        private:
+            uint8_t         tx[PROTOCOL1_TX_MAX];                                   // Instruction packet
+            uint8_t         rx[PROTOCOL1_RX_MAX];                                   // Status packet
+            uint16_t        length;                                                 // Bytes used in tx
+            uint8_t         sum;                                                    // Running checksum of a sync write being built
+            uint8_t         syncData;                                               // Data bytes per ID of the sync write being built
+
+            uint16_t        header(uint8_t id, uint8_t instruction, uint8_t paramLength);  // Write the header, returns the first param index
+            uint16_t        close();                                                // Append the checksum of tx[2..length)
+    };
+
+#endif // PROTOCOL1_H
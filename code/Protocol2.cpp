@@ -0,0 +1,214 @@
+#include "Protocol2.h"
+
+// CRC-16 lookup table for polynomial 0x8005, as used by Dynamixel Protocol 2.0
+static const uint16_t crcTable[256] = {
+    0x0000, 0x8005, 0x800F, 0x000A, 0x801B, 0x001E, 0x0014, 0x8011,
+    0x8033, 0x0036, 0x003C, 0x8039, 0x0028, 0x802D, 0x8027, 0x0022,
+    0x8063, 0x0066, 0x006C, 0x8069, 0x0078, 0x807D, 0x8077, 0x0072,
+    0x0050, 0x8055, 0x805F, 0x005A, 0x804B, 0x004E, 0x0044, 0x8041,
+    0x80C3, 0x00C6, 0x00CC, 0x80C9, 0x00D8, 0x80DD, 0x80D7, 0x00D2,
+    0x00F0, 0x80F5, 0x80FF, 0x00FA, 0x80EB, 0x00EE, 0x00E4, 0x80E1,
+    0x00A0, 0x80A5, 0x80AF, 0x00AA, 0x80BB, 0x00BE, 0x00B4, 0x80B1,
+    0x8093, 0x0096, 0x009C, 0x8099, 0x0088, 0x808D, 0x8087, 0x0082,
+    0x8183, 0x0186, 0x018C, 0x8189, 0x0198, 0x819D, 0x8197, 0x0192,
+    0x01B0, 0x81B5, 0x81BF, 0x01BA, 0x81AB, 0x01AE, 0x01A4, 0x81A1,
+    0x01E0, 0x81E5, 0x81EF, 0x01EA, 0x81FB, 0x01FE, 0x01F4, 0x81F1,
+    0x81D3, 0x01D6, 0x01DC, 0x81D9, 0x01C8, 0x81CD, 0x81C7, 0x01C2,
+    0x0140, 0x8145, 0x814F, 0x014A, 0x815B, 0x015E, 0x0154, 0x8151,
+    0x8173, 0x0176, 0x017C, 0x8179, 0x0168, 0x816D, 0x8167, 0x0162,
+    0x8123, 0x0126, 0x012C, 0x8129, 0x0138, 0x813D, 0x8137, 0x0132,
+    0x0110, 0x8115, 0x811F, 0x011A, 0x810B, 0x010E, 0x0104, 0x8101,
+    0x8303, 0x0306, 0x030C, 0x8309, 0x0318, 0x831D, 0x8317, 0x0312,
+    0x0330, 0x8335, 0x833F, 0x033A, 0x832B, 0x032E, 0x0324, 0x8321,
+    0x0360, 0x8365, 0x836F, 0x036A, 0x837B, 0x037E, 0x0374, 0x8371,
+    0x8353, 0x0356, 0x035C, 0x8359, 0x0348, 0x834D, 0x8347, 0x0342,
+    0x03C0, 0x83C5, 0x83CF, 0x03CA, 0x83DB, 0x03DE, 0x03D4, 0x83D1,
+    0x83F3, 0x03F6, 0x03FC, 0x83F9, 0x03E8, 0x83ED, 0x83E7, 0x03E2,
+    0x83A3, 0x03A6, 0x03AC, 0x83A9, 0x03B8, 0x83BD, 0x83B7, 0x03B2,
+    0x0390, 0x8395, 0x839F, 0x039A, 0x838B, 0x038E, 0x0384, 0x8381,
+    0x0280, 0x8285, 0x828F, 0x028A, 0x829B, 0x029E, 0x0294, 0x8291,
+    0x82B3, 0x02B6, 0x02BC, 0x82B9, 0x02A8, 0x82AD, 0x82A7, 0x02A2,
+    0x82E3, 0x02E6, 0x02EC, 0x82E9, 0x02F8, 0x82FD, 0x82F7, 0x02F2,
+    0x02D0, 0x82D5, 0x82DF, 0x02DA, 0x82CB, 0x02CE, 0x02C4, 0x82C1,
+    0x8243, 0x0246, 0x024C, 0x8249, 0x0258, 0x825D, 0x8257, 0x0252,
+    0x0270, 0x8275, 0x827F, 0x027A, 0x826B, 0x026E, 0x0264, 0x8261,
+    0x0220, 0x8225, 0x822F, 0x022A, 0x823B, 0x023E, 0x0234, 0x8231,
+    0x8213, 0x0216, 0x021C, 0x8219, 0x0208, 0x820D, 0x8207, 0x0202
+};
+
+// Constructor for Protocol2 class
+Protocol2::Protocol2() {
+    length      = 0;
+    overflow    = false;
+    syncData    = 0;
+    tx[0]       = 0xFF;                                                             // The header never changes
+    tx[1]       = 0xFF;
+    tx[2]       = 0xFD;
+    tx[3]       = 0x00;
+}
+
+// Build PING: FF FF FD 00 ID 03 00 01 CRC
+uint16_t Protocol2::ping(uint8_t id) {
+    begin(id, PROTOCOL2_PING);
+    return close();
+}
+
+// Build READ: FF FF FD 00 ID 07 00 02 ADDR_L ADDR_H LEN_L LEN_H CRC
+uint16_t Protocol2::read(uint8_t id, uint16_t address, uint16_t count) {
+    begin(id, PROTOCOL2_READ);
+    put((uint8_t)address);
+    put((uint8_t)(address >> 8));
+    put((uint8_t)count);
+    put((uint8_t)(count >> 8));
+    return close();
+}
+
+// Build WRITE: FF FF FD 00 ID LEN_L LEN_H 03 ADDR_L ADDR_H DATA... CRC
+uint16_t Protocol2::write(uint8_t id, uint16_t address, const uint8_t* data, uint16_t count) {
+    begin(id, PROTOCOL2_WRITE);
+    put((uint8_t)address);
+    put((uint8_t)(address >> 8));
+    for (uint16_t i = 0; i < count; i++) {
+        put(data[i]);
+    }
+    return close();
+}
+
+// Build SYNC READ or FAST SYNC READ: FF FF FD 00 FE LEN_L LEN_H 82|8A ADDR_L ADDR_H LEN_L LEN_H ID... CRC
+uint16_t Protocol2::syncRead(uint16_t address, uint16_t count, const uint8_t* ids, uint8_t id_num, bool fast) {
+    begin(PROTOCOL2_BROADCAST_ID, fast ? PROTOCOL2_FAST_SYNC_READ : PROTOCOL2_SYNC_READ);
+    put((uint8_t)address);
+    put((uint8_t)(address >> 8));
+    put((uint8_t)count);
+    put((uint8_t)(count >> 8));
+    for (uint8_t i = 0; i < id_num; i++) {
+        put(ids[i]);
+    }
+    return close();
+}
+
+// Start a SYNC WRITE: FF FF FD 00 FE LEN_L LEN_H 83 ADDR_L ADDR_H LEN_L LEN_H, then ID DATA... per syncAdd
+void Protocol2::syncBegin(uint16_t address, uint16_t count) {
+    begin(PROTOCOL2_BROADCAST_ID, PROTOCOL2_SYNC_WRITE);
+    put((uint8_t)address);
+    put((uint8_t)(address >> 8));
+    put((uint8_t)count);
+    put((uint8_t)(count >> 8));
+    syncData = count;
+}
+
+// Append one ID and syncData bytes of value, little-endian, zero past its 4 bytes
+bool Protocol2::syncAdd(uint8_t id, uint32_t value) {
+    put(id);
+    for (uint16_t i = 0; i < syncData; i++) {
+        put(i < 4 ? (uint8_t)(value >> (8 * i)) : 0);
+    }
+    return !overflow;
+}
+
+// Close a SYNC WRITE with its length field and CRC
+uint16_t Protocol2::syncEnd() {
+    return close();
+}
+
+// Instruction packet built last
+const uint8_t* Protocol2::txBuffer() const {
+    return tx;
+}
+
+// Length of the instruction packet built last
+uint16_t Protocol2::txLength() const {
+    return length;
+}
+
+// Receive buffer for status packets
+uint8_t* Protocol2::rxBuffer() {
+    return rx;
+}
+
+// Status packet size: FF FF FD 00 ID LEN_L LEN_H 55 ERR PARAMS... CRC_L CRC_H
+uint16_t Protocol2::statusLength(uint16_t paramLength) {
+    return 11 + paramLength;
+}
+
+// Fast sync read status size: header, ID, LEN and 55, then ERR ID DATA CRC per ID
+uint16_t Protocol2::fastStatusLength(uint16_t count, uint8_t id_num) {
+    return 8 + (uint16_t)id_num * (4 + count);
+}
+
+// Size of the packet whose header, ID and LEN are in rx
+uint16_t Protocol2::packetLength(const uint8_t* rx) {
+    return 7 + (rx[5] | ((uint16_t)rx[6] << 8));
+}
+
+// Validate the status packet of received bytes in rxBuffer, expected from id or PROTOCOL2_ANY_ID, remove its byte stuffing
+// in place and point status at it
+Protocol2Result Protocol2::parse(uint16_t received, uint8_t id, Protocol2Status* status) {
+    if (received == 0) return PROTOCOL2_NO_STATUS;
+    if (received < 11) return PROTOCOL2_SHORT;
+    if (rx[0] != 0xFF || rx[1] != 0xFF || rx[2] != 0xFD || rx[3] != 0x00) return PROTOCOL2_BAD_HEADER;
+
+    uint16_t total = packetLength(rx);
+    if (total < 11 || total > PROTOCOL2_RX_MAX || received < total) return PROTOCOL2_SHORT;
+    if (crc(rx, total - 2) != (rx[total - 2] | ((uint16_t)rx[total - 1] << 8))) return PROTOCOL2_BAD_CRC;
+    if (rx[7] != PROTOCOL2_STATUS) return PROTOCOL2_NOT_STATUS;
+    if (rx[4] != id && id != PROTOCOL2_ANY_ID) return PROTOCOL2_WRONG_ID;
+
+    uint16_t w = 8;                                                                 // Compact the error and params over stuffing bytes
+    for (uint16_t r = 8; r < total - 2; r++) {
+        rx[w++] = rx[r];
+        if (rx[w - 3] == 0xFF && rx[w - 2] == 0xFF && rx[w - 1] == 0xFD && r + 1 < total - 2 && rx[r + 1] == 0xFD) r++;
+    }
+
+    status->id          = rx[4];
+    status->error       = rx[8];
+    status->params      = &rx[9];
+    status->paramLength = w - 9;
+    return PROTOCOL2_OK;
+}
+
+// Start of the segment of listed ID index in a parsed fast sync read: ERR ID DATA[length] CRC_L CRC_H
+const uint8_t* Protocol2::fastSegment(uint8_t index, uint16_t count) const {
+    return &rx[8 + (uint16_t)index * (4 + count)];
+}
+
+// CRC-16 of a byte run
+uint16_t Protocol2::crc(const uint8_t* data, uint16_t count) {
+    uint16_t value = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        value = (value << 8) ^ crcTable[((value >> 8) ^ data[i]) & 0xFF];
+    }
+    return value;
+}
+
+// Write the header, ID and instruction; LEN is filled in by close
+void Protocol2::begin(uint8_t id, uint8_t instruction) {
+    tx[4]       = id;
+    tx[7]       = instruction;
+    length      = 8;
+    overflow    = false;
+}
+
+// Append a byte, with a stuffing 0xFD when it completes 0xFF 0xFF 0xFD
+void Protocol2::put(uint8_t b) {
+    if (length + 3 > PROTOCOL2_TX_MAX) {                                            // Room for a stuffing byte and the CRC
+        overflow = true;
+        return;
+    }
+    tx[length++] = b;
+    if (b == 0xFD && tx[length - 2] == 0xFF && tx[length - 3] == 0xFF) tx[length++] = 0xFD;
+}
+
+// Fill in LEN, append the CRC and return the packet length, 0 if the packet did not fit
+uint16_t Protocol2::close() {
+    if (overflow) return 0;
+    uint16_t field = length - 5;                                                    // Instruction, params and CRC
+    tx[5]          = (uint8_t)field;
+    tx[6]          = (uint8_t)(field >> 8);
+    uint16_t value = crc(tx, length);
+    tx[length++]   = (uint8_t)value;
+    tx[length++]   = (uint8_t)(value >> 8);
+    return length;
+}
+
+// end of Protocol2.cpp
@@ -0,0 +1,87 @@
+#ifndef PROTOCOL2_H
+#define PROTOCOL2_H
+
+    #include <stdint.h>
+
+    #define PROTOCOL2_TX_MAX            uint16_t(128)       // Largest instruction packet, a sync read of 20 IDs is 34
+    #define PROTOCOL2_RX_MAX            uint16_t(400)       // Largest status packet, a fast sync read of 20 IDs x 14 bytes is 368
+    #define PROTOCOL2_BROADCAST_ID      uint8_t(0xFE)       // Broadcast ID, used by sync write and (fast) sync read
+    #define PROTOCOL2_ANY_ID            uint8_t(0xFF)       // Passed to parse, accepts a status packet from any ID
+
+    #define PROTOCOL2_PING              uint8_t(0x01)       // Instructions
+    #define PROTOCOL2_READ              uint8_t(0x02)
+    #define PROTOCOL2_WRITE             uint8_t(0x03)
+    #define PROTOCOL2_STATUS            uint8_t(0x55)
+    #define PROTOCOL2_SYNC_READ         uint8_t(0x82)
+    #define PROTOCOL2_SYNC_WRITE        uint8_t(0x83)
+    #define PROTOCOL2_FAST_SYNC_READ    uint8_t(0x8A)
+
+    // Result of parsing a status packet
+    enum Protocol2Result : int8_t {
+        PROTOCOL2_OK            = 0,                        // Valid status packet
+        PROTOCOL2_NO_STATUS     = -1,                       // Nothing received
+        PROTOCOL2_SHORT         = -2,                       // Fewer bytes than the length field announces
+        PROTOCOL2_BAD_HEADER    = -3,                       // Does not start with 0xFF 0xFF 0xFD 0x00
+        PROTOCOL2_BAD_CRC       = -4,                       // CRC mismatch
+        PROTOCOL2_WRONG_ID      = -5,                       // Answer from another ID
+        PROTOCOL2_NOT_STATUS    = -6                        // Instruction field is not STATUS
+    };
+
+    // A status packet parsed in place: params points into the receive buffer
+    struct Protocol2Status {
+        uint8_t         id;                                 // ID of the answering servo, 0xFE for fast sync read
+        uint8_t         error;                              // Error byte of the status packet
+        const uint8_t*  params;                             // First parameter byte
+        uint16_t        paramLength;                        // Number of parameter bytes after removing byte stuffing
+    };
+
+    // Dynamixel Protocol 2.0 codec working on two preallocated buffers, the counterpart of Protocol1.
+    //
+    // Packet layout: 0xFF 0xFF 0xFD 0x00 ID LEN_L LEN_H INSTRUCTION PARAMS... CRC_L CRC_H, where LEN counts
+    // the bytes after it and the CRC-16 (polynomial 0x8005) covers everything before it. A status
+    // packet has INSTRUCTION 0x55 followed by an error byte. Any 0xFF 0xFF 0xFD from the instruction on
+    // is followed by a stuffing 0xFD, added when building and removed in place when parsing.
+    //
+    // SYNC WRITE is built like Protocol1's: syncBegin writes the header, each syncAdd appends one ID and
+    // its data, and syncEnd fills in LEN and the CRC.
+    //
+    // SYNC READ gets one status packet per ID in the order listed. FAST SYNC READ gets a single status
+    // packet from ID 0xFE holding ERR ID DATA[length] CRC_L CRC_H per listed ID, see fastSegment.
+    class Protocol2 {
+        public:
+            Protocol2();                                                            // Constructor
+
+            uint16_t        ping(uint8_t id);                                       // Build PING, returns the packet length
+            uint16_t        read(uint8_t id, uint16_t address, uint16_t length);    // Build READ of length bytes
+            uint16_t        write(uint8_t id, uint16_t address, const uint8_t* data, uint16_t length);  // Build WRITE, 0 if too long
+            uint16_t        syncRead(uint16_t address, uint16_t length,             // Build SYNC READ or FAST SYNC READ, 0 if too long
+                                     const uint8_t* ids, uint8_t id_num, bool fast);
+            void            syncBegin(uint16_t address, uint16_t length);           // Start a SYNC WRITE of length bytes per ID
+            bool            syncAdd(uint8_t id, uint32_t value);                    // Append one ID, value little-endian; false when full
+            uint16_t        syncEnd();                                              // Close the SYNC WRITE, returns the packet length, 0 if it did not fit
+
+            const uint8_t*  txBuffer() const;                                       // Instruction packet built last
+            uint16_t        txLength() const;                                       // Its length in bytes
+            uint8_t*        rxBuffer();                                             // Where the status packet is received
+            static uint16_t statusLength(uint16_t paramLength);                     // Status packet size for paramLength bytes, unstuffed
+            static uint16_t fastStatusLength(uint16_t length, uint8_t id_num);      // Fast sync read status size, unstuffed
+            static uint16_t packetLength(const uint8_t* rx);                        // Whole packet size from its first 7 bytes
+
+            Protocol2Result parse(uint16_t received, uint8_t id, Protocol2Status* status);  // Validate and unstuff the status packet in rxBuffer
+            const uint8_t*  fastSegment(uint8_t index, uint16_t length) const;      // ERR of listed ID index in a parsed fast sync read
+
+            static uint16_t crc(const uint8_t* data, uint16_t length);              // CRC-16 of a byte run
+
+        private:
+            uint8_t         tx[PROTOCOL2_TX_MAX];                                   // Instruction packet
+            uint8_t         rx[PROTOCOL2_RX_MAX];                                   // Status packet
+            uint16_t        length;                                                 // Bytes used in tx
+            bool            overflow;                                               // A put did not fit
+            uint16_t        syncData;                                               // Data bytes per ID of the sync write being built
+
+            void            begin(uint8_t id, uint8_t instruction);                 // Write the header and instruction
+            void            put(uint8_t b);                                         // Append a byte, stuffing after 0xFF 0xFF 0xFD
+            uint16_t        close();                                                // Fill in LEN, append the CRC, 0 on overflow
+    };
+
+#endif // PROTOCOL2_H
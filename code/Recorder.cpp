@@ -0,0 +1,505 @@
+#include "Recorder.h"
+#include "Console.h"
+#include "Debug.h"
+
+// Constructor for Recorder class
+Recorder::Recorder() {
+    driver          = nullptr;
+    servo           = nullptr;
+    gc              = nullptr;
+    motion          = nullptr;
+    state           = RECORDER_IDLE;
+    relaxMask       = 0;
+
+    tail            = 0;
+    used            = 0;
+    samples         = 0;
+
+    lastSample      = 0;
+    sinceKey        = 0;
+    captured        = 0;
+    missed          = 0;
+    evicted         = 0;
+    readErrors      = 0;
+    maxSampleTime   = 0;
+
+    readPos         = 0;
+    readSamples     = 0;
+    replayStart     = 0;
+    prevTime        = 0;
+    nextTime        = 0;
+
+    for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+        ids[i]          = i + 1;
+        position[i]     = 512;
+        encoded[i]      = 512;
+        prevFrame[i]    = 512;
+        nextFrame[i]    = 512;
+        frame[i]        = 512;
+    }
+}
+
+// Initialize the recorder
+bool Recorder::begin(Driver* driver, Servo* servo, GaitController* gc, MotionPlayer* motion) {
+    if (driver == nullptr || servo == nullptr || gc == nullptr || motion == nullptr) {
+        LOG_ERR("Recorder dependencies are not initialized.");
+        return false;
+    }
+    this->driver    = driver;
+    this->servo     = servo;
+    this->gc        = gc;
+    this->motion    = motion;
+    state           = RECORDER_IDLE;
+    clear();
+
+    LOG_INF("Recorder initialized successfully.");
+    return true;
+}
+
+// Take a sample or write a replay frame, call every RECORDER_PERIOD
+bool Recorder::update() {
+    if (state != RECORDER_IDLE && gc->getGaitType() != GAIT_IDLE) {                 // Gait was started before the hold was taken
+        LOG_WRN("Gait started, recorder stopped.");
+        return stop();
+    }
+    switch (state) {
+        case RECORDER_RECORDING:
+            return sample();
+        case RECORDER_REPLAYING:
+            return replayFrame();
+        default:
+            return true;
+    }
+}
+
+// Start recording: relax the selected servos and sample all positions every RECORDER_PERIOD
+bool Recorder::record(uint32_t relaxMask) {
+    if (state != RECORDER_IDLE) {
+        LOG_ERR("Recorder is busy.");
+        return false;
+    }
+    if (!gc->hold(RECORDER_GAIT_HOLD)) {                                            // Also fails while the motion player holds it
+        LOG_ERR("Stop the gait and motion player before recording.");
+        return false;
+    }
+
+    this->relaxMask = relaxMask & RECORDER_ALL_SERVOS;
+    for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+        if ((this->relaxMask & (1UL << i)) && !servo->torqueOff(ids[i])) {
+            LOG_WRN("Failed to turn torque off for servo " + String(ids[i]));
+        }
+    }
+
+    clear();
+    captured        = 0;
+    missed          = 0;
+    evicted         = 0;
+    readErrors      = 0;
+    maxSampleTime   = 0;
+    sinceKey        = 0;
+    state           = RECORDER_RECORDING;
+    lastSample      = micros();
+    sample();                                                                       // First sample is always a key sample
+
+    LOG_INF("Recording at " + String(1000000UL / RECORDER_PERIOD) + " Hz.");
+    return true;
+}
+
+// Replay the capture buffer, starting with a lead-in move from the present pose
+bool Recorder::replay() {
+    if (state != RECORDER_IDLE) {
+        LOG_ERR("Recorder is busy.");
+        return false;
+    }
+    if (samples == 0) {
+        LOG_ERR("Nothing recorded.");
+        return false;
+    }
+    if (!gc->hold(RECORDER_GAIT_HOLD)) {                                            // Also fails while the motion player holds it
+        LOG_ERR("Stop the gait and motion player before replay.");
+        return false;
+    }
+
+    uint32_t present[RECORDER_SERVOS];
+    uint8_t  periods = 0;
+    readPos     = tail;
+    readSamples = samples;
+    readPos     = (readPos + readRecord(readPos, nextFrame, &periods)) % RECORDER_BUFFER_SIZE;
+    readSamples--;
+
+    for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+        present[i] = nextFrame[i];                                                  // Servos that do not answer start at the first sample
+    }
+    driver->readRegisters(ids, RECORDER_SERVOS, RECORDER_PRESENT_POSITION, RECORDER_POSITION_LENGTH, present);
+    for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+        prevFrame[i] = present[i];
+        frame[i]     = present[i];
+    }
+    if (!driver->syncWrite(RECORDER_SYNC_WRITE_HANDLER, ids, RECORDER_SERVOS, frame, 1)) {
+        LOG_ERR("Failed to write the start pose.");
+        gc->release(RECORDER_GAIT_HOLD);
+        return false;
+    }
+    for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+        if (!servo->torqueOn(ids[i])) LOG_WRN("Failed to turn torque on for servo " + String(ids[i]));
+    }
+
+    prevTime    = 0;
+    nextTime    = RECORDER_LEAD_IN;
+    replayStart = micros();
+    state       = RECORDER_REPLAYING;
+    LOG_INF("Replaying " + String(samples) + " samples.");
+    return true;
+}
+
+// Stop recording or replay and hold the current pose
+bool Recorder::stop() {
+    if (state == RECORDER_RECORDING) {
+        state = RECORDER_IDLE;
+        for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+            frame[i] = position[i];
+        }
+        LOG_INF("Recorded " + String(captured) + " samples, " + String(used) + " bytes.");
+        bool held = holdPose();
+        gc->release(RECORDER_GAIT_HOLD);
+        return held;
+    }
+    if (state == RECORDER_REPLAYING) {
+        state = RECORDER_IDLE;
+        gc->release(RECORDER_GAIT_HOLD);
+        LOG_INF("Replay stopped.");
+    }
+    return true;
+}
+
+// Empty the capture buffer
+bool Recorder::clear() {
+    if (state != RECORDER_IDLE) {
+        LOG_ERR("Recorder is busy.");
+        return false;
+    }
+    tail    = 0;
+    used    = 0;
+    samples = 0;
+    return true;
+}
+
+// Write the capture buffer as binary, oldest record first
+bool Recorder::dump(Stream* stream) {
+    if (stream == nullptr) return false;
+    if (state == RECORDER_RECORDING) {
+        LOG_ERR("Stop recording before dumping.");
+        return false;
+    }
+
+    log::flush();                                                                   // Queued console text goes out first, the dump is written directly
+    uint8_t header[12] = { 'R', 'R', 'E', 'C', 1, RECORDER_SERVOS,
+                           (uint8_t)(RECORDER_PERIOD), (uint8_t)(RECORDER_PERIOD >> 8),
+                           (uint8_t)(RECORDER_PERIOD >> 16), (uint8_t)(RECORDER_PERIOD >> 24),
+                           (uint8_t)(used), (uint8_t)(used >> 8) };
+    stream->write(header, sizeof(header));
+
+    uint16_t first = used < RECORDER_BUFFER_SIZE - tail ? used : RECORDER_BUFFER_SIZE - tail;  // Ring may wrap once
+    stream->write(&buffer[tail], first);
+    stream->write(&buffer[0], used - first);
+    return true;
+}
+
+// Get the current state
+RecorderState Recorder::getState() const {
+    return state;
+}
+
+// Get the number of samples in the capture buffer
+uint32_t Recorder::getSampleCount() const {
+    return samples;
+}
+
+// Read all positions and append one record, late samples record the number of periods that passed
+bool Recorder::sample() {
+    uint32_t start   = micros();
+    uint32_t elapsed = start - lastSample;
+    uint32_t periods = captured == 0 ? 0 : (elapsed + RECORDER_PERIOD / 2) / RECORDER_PERIOD;
+    if (captured != 0 && periods == 0) return true;                                 // Called early, not due yet
+    if (periods > 1) missed += periods - 1;
+    lastSample = captured == 0 ? start : lastSample + periods * RECORDER_PERIOD;    // Sample times stay on the period grid
+    if (periods > 0x7F) periods = 0x7F;
+
+    if (!driver->readRegisters(ids, RECORDER_SERVOS, RECORDER_PRESENT_POSITION, RECORDER_POSITION_LENGTH, position)) {
+        readErrors++;                                                               // Failed servos keep their last position
+    }
+
+    uint8_t record[RECORDER_MAX_RECORD];
+    bool    key    = sinceKey == 0 || sinceKey >= RECORDER_KEY_INTERVAL;
+    uint8_t length = encode(record, (uint8_t)periods, key);
+    if (!key && RECORDER_BUFFER_SIZE - used < length) {                             // Make room first, a delta needs the record before it
+        while (RECORDER_BUFFER_SIZE - used < length && used > 0) evictBlock();
+        if (used == 0) {
+            key    = true;
+            length = encode(record, (uint8_t)periods, key);
+        }
+    }
+    if (!append(record, length)) return false;
+
+    sinceKey = key ? 1 : sinceKey + 1;
+    captured++;
+
+    uint32_t sampleTime = micros() - start;
+    if (sampleTime > maxSampleTime) maxSampleTime = sampleTime;
+    return true;
+}
+
+// Interpolate between the samples around the current replay time and write one frame
+bool Recorder::replayFrame() {
+    uint32_t t = micros() - replayStart;
+
+    while (t >= nextTime) {                                                         // Move to the next pair of samples
+        if (readSamples == 0) {
+            for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+                frame[i] = nextFrame[i];
+            }
+            driver->syncWrite(RECORDER_SYNC_WRITE_HANDLER, ids, RECORDER_SERVOS, frame, 1);
+            state = RECORDER_IDLE;
+            gc->release(RECORDER_GAIT_HOLD);
+            LOG_INF("Replay finished.");
+            return true;
+        }
+        uint8_t periods = 0;
+        for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+            prevFrame[i] = nextFrame[i];
+        }
+        readPos  = (readPos + readRecord(readPos, nextFrame, &periods)) % RECORDER_BUFFER_SIZE;
+        readSamples--;
+        prevTime = nextTime;
+        nextTime = nextTime + (uint32_t)(periods ? periods : 1) * RECORDER_PERIOD;
+    }
+
+    float s = (float)(t - prevTime) / (float)(nextTime - prevTime);
+    for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+        frame[i] = prevFrame[i] + (int32_t)lroundf((float)(nextFrame[i] - prevFrame[i]) * s);
+    }
+    return driver->syncWrite(RECORDER_SYNC_WRITE_HANDLER, ids, RECORDER_SERVOS, frame, 1);
+}
+
+// Encode the current positions as a key or delta record against the newest record
+uint8_t Recorder::encode(uint8_t* record, uint8_t periods, bool key) {
+    uint8_t length = 0;
+    record[length++] = (key ? 0x80 : 0x00) | (periods & 0x7F);
+
+    if (key) {
+        uint32_t bits = 0;
+        uint8_t  count = 0;
+        for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+            bits  |= (position[i] & 0x3FF) << count;
+            count += 10;
+            while (count >= 8) {
+                record[length++] = (uint8_t)bits;
+                bits  >>= 8;
+                count  -= 8;
+            }
+        }
+    } else {
+        uint32_t mask = 0;
+        for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+            if (position[i] != encoded[i]) mask |= 1UL << i;
+        }
+        record[length++] = (uint8_t)(mask);
+        record[length++] = (uint8_t)(mask >> 8);
+        record[length++] = (uint8_t)(mask >> 16);
+        for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+            if (!(mask & (1UL << i))) continue;
+            int32_t delta = (int32_t)position[i] - (int32_t)encoded[i];
+            if (delta >= -127 && delta <= 127) {
+                record[length++] = (uint8_t)(int8_t)delta;
+            } else {
+                record[length++] = 0x80;                                            // Escape: absolute position follows
+                record[length++] = (uint8_t)(position[i]);
+                record[length++] = (uint8_t)(position[i] >> 8);
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+        encoded[i] = position[i];
+    }
+    return length;
+}
+
+// Append a record, trimming the oldest blocks if the ring is full
+bool Recorder::append(const uint8_t* record, uint8_t length) {
+    while (RECORDER_BUFFER_SIZE - used < length && used > 0) evictBlock();
+    if (RECORDER_BUFFER_SIZE - used < length) return false;
+
+    uint16_t head = (tail + used) % RECORDER_BUFFER_SIZE;
+    for (uint8_t i = 0; i < length; i++) {
+        buffer[(head + i) % RECORDER_BUFFER_SIZE] = record[i];
+    }
+    used += length;
+    samples++;
+    return true;
+}
+
+// Drop the oldest record and every delta record after it, so the ring always starts with a key sample
+void Recorder::evictBlock() {
+    do {
+        uint8_t length = recordLength(tail);
+        tail     = (tail + length) % RECORDER_BUFFER_SIZE;
+        used    -= length;
+        samples--;
+        evicted++;
+    } while (used > 0 && !(peek(tail) & 0x80));
+}
+
+// Length of the record at a ring offset
+uint8_t Recorder::recordLength(uint16_t offset) const {
+    if (peek(offset) & 0x80) return 1 + (RECORDER_SERVOS * 10 + 7) / 8;             // Key record
+
+    uint32_t mask   = peek(offset + 1) | ((uint32_t)peek(offset + 2) << 8) | ((uint32_t)peek(offset + 3) << 16);
+    uint8_t  length = 4;
+    for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+        if (!(mask & (1UL << i))) continue;
+        length += peek(offset + length) == 0x80 ? 3 : 1;
+    }
+    return length;
+}
+
+// Decode the record at a ring offset on top of the previous positions, returns its length
+uint8_t Recorder::readRecord(uint16_t offset, int32_t* positions, uint8_t* periods) const {
+    uint8_t header = peek(offset);
+    uint8_t length = 1;
+    *periods = header & 0x7F;
+
+    if (header & 0x80) {
+        uint32_t bits  = 0;
+        uint8_t  count = 0;
+        for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+            while (count < 10) {
+                bits  |= (uint32_t)peek(offset + length++) << count;
+                count += 8;
+            }
+            positions[i] = bits & 0x3FF;
+            bits  >>= 10;
+            count  -= 10;
+        }
+        return length;
+    }
+
+    uint32_t mask = peek(offset + 1) | ((uint32_t)peek(offset + 2) << 8) | ((uint32_t)peek(offset + 3) << 16);
+    length = 4;
+    for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+        if (!(mask & (1UL << i))) continue;
+        uint8_t value = peek(offset + length++);
+        if (value == 0x80) {
+            positions[i] = peek(offset + length) | ((int32_t)peek(offset + length + 1) << 8);
+            length += 2;
+        } else {
+            positions[i] += (int8_t)value;
+        }
+    }
+    return length;
+}
+
+// Byte at a ring offset
+uint8_t Recorder::peek(uint16_t offset) const {
+    return buffer[offset % RECORDER_BUFFER_SIZE];
+}
+
+// Hold the last positions and turn torque back on for the relaxed servos
+bool Recorder::holdPose() {
+    bool success = driver->syncWrite(RECORDER_SYNC_WRITE_HANDLER, ids, RECORDER_SERVOS, frame, 1);
+    for (uint8_t i = 0; i < RECORDER_SERVOS; i++) {
+        if ((relaxMask & (1UL << i)) && !servo->torqueOn(ids[i])) success = false;
+    }
+    relaxMask = 0;
+    return success;
+}
+
+// Print recorder status
+bool Recorder::printStatus() {
+    PRINTLN("Recorder Status: \n\r");
+    PRINT("State            : ");
+    switch (state) {
+        case RECORDER_IDLE:
+            PRINTLN("Idle");
+            break;
+        case RECORDER_RECORDING:
+            PRINTLN("Recording");
+            break;
+        case RECORDER_REPLAYING:
+            PRINTLN("Replaying");
+            break;
+    }
+    PRINTLN("Buffer           : " + String(samples) + " samples | " + String(used) + "/" + String(RECORDER_BUFFER_SIZE) + " bytes"
+            + " | " + String(samples ? (float)used / (float)samples : 0.0f, 1) + " bytes/sample");
+    PRINTLN("Capture          : " + String(captured) + " samples | missed " + String(missed)
+            + " | trimmed " + String(evicted) + " | read errors " + String(readErrors));
+    PRINTLN("Max Sample Time  : " + String(maxSampleTime) + " us (period " + String(RECORDER_PERIOD) + " us)");
+    return true;
+}
+
+// es: Print the recorder status
+static bool showRecorder(void* recorder, const CommandArgs&) {
+    return static_cast<Recorder*>(recorder)->printStatus();
+}
+
+// er [ids|all]: Record, relaxing the given servo IDs or all of them
+static bool startRecording(void* recorder, const CommandArgs& args) {
+    uint32_t mask = 0;
+    if (args.count() == 0 || strcmp(args.get(0), "all") == 0) {
+        mask = RECORDER_ALL_SERVOS;
+    } else {
+        const char* p = args.rest();                                                // Space-separated servo IDs, more than are tokenized
+        char*       end;
+        for (long id = strtol(p, &end, 10); end != p; id = strtol(p, &end, 10)) {
+            if (id >= 1 && id <= RECORDER_SERVOS) mask |= 1UL << (id - 1);
+            p = end;
+        }
+    }
+    return static_cast<Recorder*>(recorder)->record(mask);
+}
+
+// ex: Stop recording or replay and hold the pose
+static bool stopRecorder(void* recorder, const CommandArgs&) {
+    return static_cast<Recorder*>(recorder)->stop();
+}
+
+// ep: Replay the recording
+static bool startReplay(void* recorder, const CommandArgs&) {
+    return static_cast<Recorder*>(recorder)->replay();
+}
+
+// ed: Dump the recording as binary on the console stream
+static bool dumpRecording(void* recorder, const CommandArgs&) {
+    return static_cast<Recorder*>(recorder)->dump(log::getLogStream());
+}
+
+// ec: Clear the recording
+static bool clearRecording(void* recorder, const CommandArgs&) {
+    if (!static_cast<Recorder*>(recorder)->clear()) return false;
+    LOG_INF("Capture buffer cleared.");
+    return true;
+}
+
+// e?: Print the recorder help
+static bool showRecorderHelp(void* recorder, const CommandArgs&) {
+    return static_cast<Recorder*>(recorder)->printConsoleHelp();
+}
+
+// Console commands, the help is printed from this table
+static const ConsoleCommand recorderCommands[] = {
+    { "es",     "",          "Show recorder status",                                showRecorder },
+    { "er",     "[ids|all]", "Record, torque off the given servo IDs (default all)", startRecording },
+    { "ex",     "",          "Stop recording or replay and hold the pose",          stopRecorder },
+    { "ep",     "",          "Replay the recording",                                startReplay },
+    { "ed",     "",          "Dump the recording as binary",                        dumpRecording },
+    { "ec",     "",          "Clear the recording",                                 clearRecording },
+    { "e?",     "",          "Show this help",                                      showRecorderHelp },
+};
+const ConsoleCommandTable Recorder::commandTable = { "Recorder Commands:", recorderCommands, sizeof(recorderCommands) / sizeof(recorderCommands[0]) };
+
+// Print recorder-specific help information
+bool Recorder::printConsoleHelp() {
+    return CommandRegistry::printHelp(commandTable);
+}
+
+// end of Recorder.cpp
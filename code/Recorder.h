@@ -0,0 +1,104 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+
+    #include <Arduino.h>
+    #include "Driver.h"
+    #include "Servo.h"
+    #include "GaitController.h"
+    #include "MotionPlayer.h"
+    #include "CommandRegistry.h"
+
+    #define RECORDER_SERVOS             uint8_t(20)         // Servo IDs 1 to 20 are sampled
+    #define RECORDER_PERIOD             uint32_t(20000)     // Sample period in us (50 Hz)
+    #define RECORDER_BUFFER_SIZE        uint16_t(16384)     // Capture ring buffer size in bytes
+    #define RECORDER_KEY_INTERVAL       uint8_t(50)         // Samples between key samples, the ring is trimmed back to a key sample
+    #define RECORDER_LEAD_IN            uint32_t(1000000)   // Time to move from the present pose to the first sample on replay in us
+    #define RECORDER_PRESENT_POSITION   uint16_t(36)        // AX-18A Present_Position address
+    #define RECORDER_POSITION_LENGTH    uint16_t(2)         // AX-18A Present_Position length
+    #define RECORDER_SYNC_WRITE_HANDLER uint8_t(0)          // Goal_Position sync write handler added by Hexapod::begin()
+    #define RECORDER_GAIT_HOLD          "recorder"          // Name the recorder holds the gait under while recording or replaying
+    #define RECORDER_MAX_RECORD         uint8_t(64)         // Largest encoded sample in bytes
+    #define RECORDER_ALL_SERVOS         uint32_t(0xFFFFF)   // Mask with all 20 servos
+
+    // Capture format, one record per sample:
+    //   header   bit 7 = key sample, bits 0-6 = sample periods since the previous sample
+    //   key      20 positions packed 10 bits each, least significant bit first (25 bytes)
+    //   delta    3 byte mask of changed servos, then per changed servo an int8 delta,
+    //            or 0x80 followed by the absolute position as uint16 when the delta does not fit
+    // Dumps start with "RREC", version, servo count, sample period (uint32) and byte count (uint16),
+    // all little endian, followed by the records from oldest to newest.
+
+    enum RecorderState : uint8_t {
+        RECORDER_IDLE,
+        RECORDER_RECORDING,
+        RECORDER_REPLAYING
+    };
+
+    class Recorder {
+        public:
+            Recorder();                                                             // Constructor
+            bool            begin(Driver* driver, Servo* servo, GaitController* gc, MotionPlayer* motion);
+            bool            update();                                               // Take a sample or write a replay frame, call every RECORDER_PERIOD
+
+            bool            record(uint32_t relaxMask);                             // Start recording, torque off the servos in the mask (bit 0 = ID 1)
+            bool            replay();                                               // Replay the capture buffer with time interpolation
+            bool            stop();                                                 // Stop recording or replay, hold the current pose
+            bool            clear();                                                // Empty the capture buffer
+            bool            dump(Stream* stream);                                   // Write the capture buffer as binary
+
+            RecorderState   getState() const;                                       // Get the current state
+            uint32_t        getSampleCount() const;                                 // Samples in the capture buffer
+
+            bool            printStatus();                                          // Print recorder status
+            bool            printConsoleHelp();                                     // Print recorder-specific help information
+            static const ConsoleCommandTable commandTable;                          // Console commands and their help
+
+        private:
+            Driver*         driver;                                                 // Pointer to the driver instance
+            Servo*          servo;                                                  // Pointer to the servo instance
+            GaitController* gc;                                                     // Gait controller, must be idle
+            MotionPlayer*   motion;                                                 // Motion player, must be stopped
+
+            RecorderState   state;                                                  // Current state
+            uint8_t         ids[RECORDER_SERVOS];                                   // Servo IDs 1 to 20
+            uint32_t        relaxMask;                                              // Servos with torque off while recording
+
+            // Capture ring buffer of whole records
+            uint8_t         buffer[RECORDER_BUFFER_SIZE];                           // Encoded samples
+            uint16_t        tail;                                                   // Offset of the oldest record
+            uint16_t        used;                                                   // Bytes in use
+            uint32_t        samples;                                                // Records in the buffer
+
+            // Recording state
+            uint32_t        lastSample;                                             // Time of the last sample in us
+            uint32_t        position[RECORDER_SERVOS];                              // Last sampled positions
+            uint32_t        encoded[RECORDER_SERVOS];                               // Positions of the newest record, base of the next delta
+            uint8_t         sinceKey;                                               // Samples since the last key sample
+            uint32_t        captured;                                               // Samples taken since record()
+            uint32_t        missed;                                                 // Sample periods missed since record()
+            uint32_t        evicted;                                                // Samples trimmed from the ring since record()
+            uint32_t        readErrors;                                             // Failed position reads since record()
+            uint32_t        maxSampleTime;                                          // Longest sample in us
+
+            // Replay state
+            uint16_t        readPos;                                                // Offset of the next record to replay
+            uint32_t        readSamples;                                            // Records left to replay
+            uint32_t        replayStart;                                            // Time replay started in us
+            uint32_t        prevTime;                                               // Replay time of prevFrame in us
+            uint32_t        nextTime;                                               // Replay time of nextFrame in us
+            int32_t         prevFrame[RECORDER_SERVOS];                             // Sample before the current time
+            int32_t         nextFrame[RECORDER_SERVOS];                             // Sample after the current time
+            int32_t         frame[RECORDER_SERVOS];                                 // Last frame written
+
+            bool            sample();                                               // Read all positions and append a record
+            bool            replayFrame();                                          // Interpolate and write one replay frame
+            uint8_t         encode(uint8_t* record, uint8_t periods, bool key);     // Encode the current positions
+            bool            append(const uint8_t* record, uint8_t length);          // Append a record to the ring
+            void            evictBlock();                                           // Drop the oldest records up to the next key sample
+            uint8_t         recordLength(uint16_t offset) const;                    // Length of the record at offset
+            uint8_t         readRecord(uint16_t offset, int32_t* positions, uint8_t* periods) const;   // Decode a record
+            uint8_t         peek(uint16_t offset) const;                            // Byte at a ring offset
+            bool            holdPose();                                             // Write the last positions and torque on relaxed servos
+    };
+
+#endif // RECORDER_H
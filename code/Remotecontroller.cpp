@@ -120,27 +120,25 @@ bool Remotecontroller::printStatus() {
     return true;
 }
 
-// Handle console commands specific to the remote controller
-bool Remotecontroller::runConsoleCommands(const String& cmd, const String& args) {
-    if (cmd == "rs") {
-        printStatus();
-        return true;
-
-    } else if (cmd == "r?") {
-        printConsoleHelp();
-        return true;
-
-    }
+// rs: Print the remotecontroller status
+static bool showRcStatus(void* rc, const CommandArgs&) {
+    return static_cast<Remotecontroller*>(rc)->printStatus();
+}
 
-    return false;
+// r?: Print the remotecontroller help
+static bool showRcHelp(void* rc, const CommandArgs&) {
+    return static_cast<Remotecontroller*>(rc)->printConsoleHelp();
 }
 
+// Console commands, the help is printed from this table
+static const ConsoleCommand rcCommands[] = {
+    { "rs",     "", "Print remotecontroller status",        showRcStatus },
+    { "r?",     "", "Print this help information",          showRcHelp },
+};
+const ConsoleCommandTable Remotecontroller::commandTable = { "Remotecontroller Commands:", rcCommands, sizeof(rcCommands) / sizeof(rcCommands[0]) };
+
 // Print remotecontroller-specific help information
 bool Remotecontroller::printConsoleHelp() {
-    PRINTLN("Remotecontroller Commands:\n\r");
-    PRINTLN("  rs               - Print remotecontroller status");
-    PRINTLN("  r?               - Print this help information");
-    PRINTLN("");
-    return true;
+    return CommandRegistry::printHelp(commandTable);
 }
 
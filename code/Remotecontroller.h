@@ -6,6 +6,7 @@
     #include "Hexapod.h"                    // Include Hexapod class for managing the hexapod robot
     #include "Turret.h"                     // Include Turret class for managing the sensor turret
     #include "GaitController.h"             // Include GaitController for movement control
+    #include "CommandRegistry.h"            // Console command tables
     
     class Remotecontroller {
         public:
@@ -14,8 +15,8 @@
             bool update();                  // Update the remote controller state
 
             bool      printStatus();
-            bool      runConsoleCommands(const String& cmd, const String& args);
             bool      printConsoleHelp();
+            static const ConsoleCommandTable commandTable;
 
             uint16_t  getLastButtonPressed();            
             uint16_t  getLastButtonDepressed();
@@ -0,0 +1,51 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+    #include <stdint.h>
+    #include <atomic>
+
+    // Lock-free single-producer single-consumer ring buffer.
+    // One context (e.g. loop()) may call push(), one other context (e.g. a timer ISR) may call pop().
+    // SIZE must be a power of two; one slot is kept free to tell full from empty.
+    template <typename T, uint16_t SIZE>
+    class SPSCQueue {
+        static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "SPSCQueue size must be a power of two");
+
+        public:
+            SPSCQueue() : head(0), tail(0), dropped(0) {}
+
+            // Producer side: returns false and counts a drop if the queue is full
+            bool push(const T& item) {
+                uint16_t h    = head.load(std::memory_order_relaxed);
+                uint16_t next = (h + 1) & (SIZE - 1);
+                if (next == tail.load(std::memory_order_acquire)) {
+                    dropped++;
+                    return false;
+                }
+                items[h] = item;
+                head.store(next, std::memory_order_release);
+                return true;
+            }
+
+            // Consumer side: returns false if the queue is empty
+            bool pop(T& item) {
+                uint16_t t = tail.load(std::memory_order_relaxed);
+                if (t == head.load(std::memory_order_acquire)) return false;
+                item = items[t];
+                tail.store((t + 1) & (SIZE - 1), std::memory_order_release);
+                return true;
+            }
+
+            bool        isEmpty() const     { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+            uint16_t    size() const        { return (head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire)) & (SIZE - 1); }
+            uint16_t    capacity() const    { return SIZE - 1; }
+            uint32_t    getDropped() const  { return dropped; }
+
+        private:
+            T                       items[SIZE];        // Ring storage
+            std::atomic<uint16_t>   head;               // Next slot to write, owned by the producer
+            std::atomic<uint16_t>   tail;               // Next slot to read, owned by the consumer
+            uint32_t                dropped;            // Items rejected because the queue was full (producer only)
+    };
+
+#endif // SPSC_QUEUE_H
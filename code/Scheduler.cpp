@@ -0,0 +1,312 @@
+#include "Scheduler.h"
+#include "Debug.h"
+
+// Constructor for Scheduler
+Scheduler::Scheduler(ClockFunction clock) {
+    this->clock = clock;
+    taskCount   = 0;
+    nextIdle    = 0;
+    loops       = 0;
+    idleLoops   = 0;
+}
+
+// Initialize the scheduler, all periodic tasks are released immediately
+bool Scheduler::begin() {
+    if (clock == nullptr) {
+        LOG_ERR("Scheduler clock is not initialized.");
+        return false;
+    }
+
+    uint32_t now = clock();
+    for (uint8_t i = 0; i < taskCount; i++) {
+        tasks[i].nextRelease = now;
+    }
+    resetStats();
+
+    LOG_INF("Scheduler initialized successfully. (" + String(taskCount) + " tasks)");
+    return true;
+}
+
+// Run the highest priority due task, or one idle task if nothing is due
+bool Scheduler::update() {
+    uint32_t now = clock();
+    loops++;
+
+    uint8_t index = findDueTask(now);
+    if (index != SCHEDULER_INVALID_TASK) {
+        runTask(index, tasks[index].nextRelease);
+        return true;
+    }
+
+    idleLoops++;
+    index = findIdleTask();
+    if (index != SCHEDULER_INVALID_TASK) {
+        runTask(index, now);
+    }
+    return true;
+}
+
+// Register a task, returns its index or SCHEDULER_INVALID_TASK
+uint8_t Scheduler::addTask(const char* name, TaskFunction function, uint32_t period, uint8_t priority, uint32_t deadline) {
+    if (function == nullptr || taskCount >= SCHEDULER_MAX_TASKS) {
+        LOG_ERR("Failed to add scheduler task: " + String(name));
+        return SCHEDULER_INVALID_TASK;
+    }
+
+    SchedulerTask& task = tasks[taskCount];
+    task.name           = name;
+    task.function       = function;
+    task.period         = period;
+    task.deadline       = (deadline != 0) ? deadline : period;
+    task.priority       = priority;
+    task.enabled        = true;
+    task.essential      = false;
+    task.nextRelease    = clock();
+
+    return taskCount++;
+}
+
+// Enable or disable a task, a re-enabled task is released immediately
+bool Scheduler::setTaskEnabled(uint8_t index, bool enabled) {
+    if (index >= taskCount) return false;
+    if (!enabled && tasks[index].essential) return false;
+    if (enabled && !tasks[index].enabled) {
+        tasks[index].nextRelease = clock();
+    }
+    tasks[index].enabled = enabled;
+    return true;
+}
+
+// Mark a task that must never be disabled
+bool Scheduler::setTaskEssential(uint8_t index) {
+    if (index >= taskCount) return false;
+    tasks[index].essential = true;
+    return true;
+}
+
+// Change the period of a task, the deadline follows the period
+bool Scheduler::setTaskPeriod(uint8_t index, uint32_t period) {
+    if (index >= taskCount) return false;
+    tasks[index].period      = period;
+    tasks[index].deadline    = period;
+    tasks[index].nextRelease = clock();
+    return true;
+}
+
+// Get the number of registered tasks
+uint8_t Scheduler::getTaskCount() const {
+    return taskCount;
+}
+
+// Get a task for inspection
+const SchedulerTask* Scheduler::getTask(uint8_t index) const {
+    if (index >= taskCount) return nullptr;
+    return &tasks[index];
+}
+
+// Clear all run statistics
+void Scheduler::resetStats() {
+    for (uint8_t i = 0; i < taskCount; i++) {
+        tasks[i].runs        = 0;
+        tasks[i].overruns    = 0;
+        tasks[i].skipped     = 0;
+        tasks[i].maxExec     = 0;
+        tasks[i].maxLateness = 0;
+        for (uint8_t b = 0; b < SCHEDULER_JITTER_BINS; b++) {
+            tasks[i].jitter[b] = 0;
+        }
+    }
+    loops     = 0;
+    idleLoops = 0;
+}
+
+//-----------------------------------------------------------------------------
+
+// Find the highest priority periodic task that is due, earliest release wins a tie
+uint8_t Scheduler::findDueTask(uint32_t now) {
+    uint8_t  best         = SCHEDULER_INVALID_TASK;
+    uint32_t bestLateness = 0;
+
+    for (uint8_t i = 0; i < taskCount; i++) {
+        const SchedulerTask& task = tasks[i];
+        if (!task.enabled || task.period == SCHEDULER_IDLE) continue;
+
+        int32_t lateness = (int32_t)(now - task.nextRelease);           // Wrap-safe comparison
+        if (lateness < 0) continue;                                     // Not released yet
+
+        if (best == SCHEDULER_INVALID_TASK ||
+            task.priority < tasks[best].priority ||
+            (task.priority == tasks[best].priority && (uint32_t)lateness > bestLateness)) {
+            best         = i;
+            bestLateness = (uint32_t)lateness;
+        }
+    }
+    return best;
+}
+
+// Find the next enabled idle task in round-robin order
+uint8_t Scheduler::findIdleTask() {
+    for (uint8_t n = 0; n < taskCount; n++) {
+        uint8_t i = (nextIdle + n) % taskCount;
+        if (tasks[i].enabled && tasks[i].period == SCHEDULER_IDLE) {
+            nextIdle = (i + 1) % taskCount;
+            return i;
+        }
+    }
+    return SCHEDULER_INVALID_TASK;
+}
+
+// Execute a task and record lateness, execution time and deadline overruns
+void Scheduler::runTask(uint8_t index, uint32_t release) {
+    SchedulerTask& task = tasks[index];
+
+    uint32_t start = clock();
+    task.function();
+    uint32_t end   = clock();
+
+    uint32_t lateness = start - release;
+    uint32_t exec     = end - start;
+
+    task.runs++;
+    if (exec > task.maxExec)         task.maxExec     = exec;
+    if (lateness > task.maxLateness) task.maxLateness = lateness;
+    task.jitter[jitterBin(lateness)]++;
+
+    if (task.period == SCHEDULER_IDLE) return;                          // Idle tasks have no release schedule
+
+    if (end - release > task.deadline) task.overruns++;
+
+    // Advance to the next release; if whole periods were missed, drop them instead of bursting to catch up
+    task.nextRelease = release + task.period;
+    int32_t behind = (int32_t)(end - task.nextRelease);
+    if (behind >= (int32_t)task.period) {
+        uint32_t missed   = (uint32_t)behind / task.period;
+        task.skipped     += missed;
+        task.nextRelease += missed * task.period;
+    }
+}
+
+// Bucket index for a lateness value: bin 0 is below 2^BASE us, each next bin doubles, last bin is open-ended
+uint8_t Scheduler::jitterBin(uint32_t lateness) {
+    uint8_t bin = 0;
+    lateness >>= SCHEDULER_JITTER_BASE;
+    while (lateness != 0 && bin < SCHEDULER_JITTER_BINS - 1) {
+        lateness >>= 1;
+        bin++;
+    }
+    return bin;
+}
+
+//-----------------------------------------------------------------------------
+
+// Print task table and statistics
+bool Scheduler::printStatus() {
+    PRINTLN("\nScheduler Status:");
+    PRINTLN("Loops: " + String(loops) + " | Idle: " + String(idleLoops));
+    PRINTLN("ID Name       Period  Prio      Runs  Overrun  Skipped  MaxExec  MaxLate");
+
+    for (uint8_t i = 0; i < taskCount; i++) {
+        const SchedulerTask& task = tasks[i];
+        char line[96];
+        snprintf(line, sizeof(line), "%2u %-10s %6lu %5u %9lu %8lu %8lu %8lu %8lu%s",
+                 (unsigned)i, task.name,
+                 (unsigned long)task.period, (unsigned)task.priority,
+                 (unsigned long)task.runs, (unsigned long)task.overruns, (unsigned long)task.skipped,
+                 (unsigned long)task.maxExec, (unsigned long)task.maxLateness,
+                 task.enabled ? "" : " (disabled)");
+        PRINTLN(line);
+    }
+
+    PRINT("\nJitter histogram (us):    ");
+    for (uint8_t b = 0; b < SCHEDULER_JITTER_BINS; b++) {
+        char label[12];
+        if (b < SCHEDULER_JITTER_BINS - 1) {
+            snprintf(label, sizeof(label), " <%-6lu", 1UL << (SCHEDULER_JITTER_BASE + b));
+        } else {
+            snprintf(label, sizeof(label), " >=%-5lu", 1UL << (SCHEDULER_JITTER_BASE + b - 1));
+        }
+        PRINT(label);
+    }
+    PRINTLN("");
+
+    for (uint8_t i = 0; i < taskCount; i++) {
+        char line[24];
+        snprintf(line, sizeof(line), "%2u %-10s            ", (unsigned)i, tasks[i].name);
+        PRINT(line);
+        for (uint8_t b = 0; b < SCHEDULER_JITTER_BINS; b++) {
+            snprintf(line, sizeof(line), " %-7lu", (unsigned long)tasks[i].jitter[b]);
+            PRINT(line);
+        }
+        PRINTLN("");
+    }
+    return true;
+}
+
+// ks: Print the task table and statistics
+static bool showScheduler(void* scheduler, const CommandArgs&) {
+    return static_cast<Scheduler*>(scheduler)->printStatus();
+}
+
+// kr: Reset the task statistics
+static bool resetScheduler(void* scheduler, const CommandArgs&) {
+    static_cast<Scheduler*>(scheduler)->resetStats();
+    LOG_INF("Scheduler statistics reset");
+    return true;
+}
+
+// ke id / kd id: Enable or disable a task, an essential task is never disabled
+static bool enableTask(void* module, const CommandArgs& args) {
+    Scheduler* scheduler = static_cast<Scheduler*>(module);
+    bool enable = strcmp(args.command(), "ke") == 0;
+    int  index  = 0;
+    char extra  = 0;
+    if (sscanf(args.rest(), "%d %c", &index, &extra) != 1 || index < 0 || index >= scheduler->getTaskCount()) {
+        LOG_ERR("Invalid parameters. Usage: " + String(args.command()) + " id");
+        return false;
+    }
+    const char* name = scheduler->getTask((uint8_t)index)->name;
+    if (!scheduler->setTaskEnabled((uint8_t)index, enable)) {
+        LOG_ERR("Task " + String(name) + " can not be disabled");
+        return false;
+    }
+    LOG_INF("Task " + String(name) + (enable ? " enabled" : " disabled"));
+    return true;
+}
+
+// kp id period: Set a task period in us
+static bool setTaskPeriod(void* module, const CommandArgs& args) {
+    Scheduler* scheduler = static_cast<Scheduler*>(module);
+    int  index  = 0;
+    long period = 0;
+    if (sscanf(args.rest(), "%d %ld", &index, &period) != 2 || period < 0 || !scheduler->setTaskPeriod((uint8_t)index, (uint32_t)period)) {
+        LOG_ERR("Invalid parameters. Usage: kp id period_us");
+        return false;
+    }
+    LOG_INF("Task " + String(scheduler->getTask((uint8_t)index)->name) + " period set to " + String(period) + " us");
+    return true;
+}
+
+// k?: Print the scheduler help
+static bool showSchedulerHelp(void* scheduler, const CommandArgs&) {
+    return static_cast<Scheduler*>(scheduler)->printConsoleHelp();
+}
+
+// Console commands, the help is printed from this table
+static const ConsoleCommand schedulerCommands[] = {
+    { "ks",     "",          "Print task table, overruns and jitter histogram", showScheduler },
+    { "kr",     "",          "Reset task statistics",                           resetScheduler },
+    { nullptr,  "",          "",                                                nullptr },
+    { "ke",     "id",        "Enable task",                                     enableTask },
+    { "kd",     "id",        "Disable task",                                    enableTask },
+    { "kp",     "id period", "Set task period in us (0 = run when idle)",       setTaskPeriod },
+    { nullptr,  "",          "",                                                nullptr },
+    { "k?",     "",          "Print this help information",                     showSchedulerHelp },
+};
+const ConsoleCommandTable Scheduler::commandTable = { "Scheduler Commands:", schedulerCommands, sizeof(schedulerCommands) / sizeof(schedulerCommands[0]) };
+
+// Print scheduler-specific help information
+bool Scheduler::printConsoleHelp() {
+    return CommandRegistry::printHelp(commandTable);
+}
+
+// end of Scheduler.cpp
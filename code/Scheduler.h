@@ -0,0 +1,72 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+    #include <Arduino.h>
+    #include "CommandRegistry.h"
+
+    #define SCHEDULER_MAX_TASKS     uint8_t(16)         // Maximum number of tasks that can be registered
+    #define SCHEDULER_JITTER_BINS   uint8_t(8)          // Number of log2 buckets in the jitter histogram
+    #define SCHEDULER_JITTER_BASE   uint8_t(4)          // First bucket holds latencies below 2^4 = 16 us
+    #define SCHEDULER_IDLE          uint32_t(0)         // Period value for tasks that only run when nothing else is due
+    #define SCHEDULER_INVALID_TASK  uint8_t(0xFF)       // Returned by addTask() when the task table is full
+
+    typedef void            (*TaskFunction)();          // Task body, called once per release
+    typedef unsigned long   (*ClockFunction)();         // Microsecond time source, micros() unless another is given
+
+    struct SchedulerTask {
+        const char*     name;                           // Task name for status output
+        TaskFunction    function;                       // Task body
+        uint32_t        period;                         // Release period in us (SCHEDULER_IDLE = run when idle)
+        uint32_t        deadline;                       // Allowed time from release to completion in us
+        uint8_t         priority;                       // 0 is the highest priority
+        bool            enabled;                        // Task is released only when enabled
+        bool            essential;                      // Task can not be disabled, e.g. the console that would re-enable it
+
+        uint32_t        nextRelease;                    // Time of the next release in us
+        uint32_t        runs;                           // Number of completed runs
+        uint32_t        overruns;                       // Runs that completed after their deadline
+        uint32_t        skipped;                        // Releases dropped because the task fell a whole period behind
+        uint32_t        maxExec;                        // Longest execution time in us
+        uint32_t        maxLateness;                    // Longest delay from release to start in us
+        uint32_t        jitter[SCHEDULER_JITTER_BINS];  // Histogram of release-to-start delay, log2 buckets
+    };
+
+    class Scheduler {
+        public:
+            Scheduler(ClockFunction clock = micros);                                        // Constructor, optional time source
+
+            bool            begin();                                                        // Initialize the scheduler and release all tasks now
+            bool            update();                                                       // Run at most one task, call in loop()
+
+            uint8_t         addTask(    const char*     name,                               // Register a task, returns its index
+                                        TaskFunction    function,
+                                        uint32_t        period,
+                                        uint8_t         priority,
+                                        uint32_t        deadline = 0);                      // 0 = deadline equals period
+
+            bool            setTaskEnabled(uint8_t index, bool enabled);                    // Enable or disable a task, false for an essential one
+            bool            setTaskEssential(uint8_t index);                                // Mark a task that must never be disabled
+            bool            setTaskPeriod(uint8_t index, uint32_t period);                  // Change the period of a task
+            uint8_t         getTaskCount() const;                                           // Get the number of registered tasks
+            const SchedulerTask* getTask(uint8_t index) const;                              // Get a task for inspection
+            void            resetStats();                                                   // Clear all run statistics
+
+            bool            printStatus();                                                  // Print task table and statistics
+            bool            printConsoleHelp();                                             // Print scheduler-specific help information
+            static const ConsoleCommandTable commandTable;                                  // Console commands and their help
+
+        private:
+            ClockFunction   clock;                                                          // Microsecond time source
+            SchedulerTask   tasks[SCHEDULER_MAX_TASKS];                                     // Registered tasks
+            uint8_t         taskCount;                                                      // Number of registered tasks
+            uint8_t         nextIdle;                                                       // Round-robin cursor for idle tasks
+            uint32_t        loops;                                                          // Number of update() calls
+            uint32_t        idleLoops;                                                      // update() calls where no periodic task was due
+
+            uint8_t         findDueTask(uint32_t now);                                      // Highest priority task whose release time has passed
+            uint8_t         findIdleTask();                                                 // Next enabled idle task, round-robin
+            void            runTask(uint8_t index, uint32_t release);                       // Execute a task and record its statistics
+            static uint8_t  jitterBin(uint32_t lateness);                                   // Histogram bucket for a lateness value
+    };
+
+#endif // SCHEDULER_H
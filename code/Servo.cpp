@@ -1,11 +1,39 @@
 #include "Servo.h"
 #include "Driver.h"
+#include "ServoEstimator.h"
 #include "Console.h"
 #include "Debug.h"
 
 
 // Constructor for Servo
-Servo::Servo(){}
+Servo::Servo() {
+    driver      = nullptr;
+    budget      = SERVO_TELEMETRY_BUDGET;
+    windowStart = 0;
+    windowSpent = 0;
+    readCost    = SERVO_READ_COST;
+    reads       = 0;
+    deferred    = 0;
+    maxSpent    = 0;
+
+    periods[SERVO_POSITION]    = SERVO_POSITION_PERIOD;
+    periods[SERVO_LOAD]        = SERVO_LOAD_PERIOD;
+    periods[SERVO_VOLTAGE]     = SERVO_VOLTAGE_PERIOD;
+    periods[SERVO_TEMPERATURE] = SERVO_TEMPERATURE_PERIOD;
+
+    for (uint8_t i = 0; i < SERVO_TELEMETRY_SERVOS; i++) {
+        ServoTelemetry& t = telemetry[i];
+        t.position      = 0;
+        t.load          = 0;
+        t.voltage       = 0;
+        t.temperature   = 0;
+        t.errors        = 0;
+        for (uint8_t f = 0; f < SERVO_FIELDS; f++) {
+            t.time[f]   = 0;
+            t.polled[f] = 0;
+        }
+    }
+}
 
 //initialize the DynamixelWorkbench instance
 bool Servo::begin(Driver* driver) {
@@ -90,6 +118,26 @@ bool Servo::getStatusReturnLevel(uint8_t id, uint8_t* level) {
     return true;
 }
 
+// Set Return Delay Time in 2 us units
+bool Servo::setReturnDelayTime(uint8_t id, uint8_t return_delay_time) {
+    if (!driver->writeRegister(id, "Return_Delay_Time", (uint32_t)return_delay_time)) return false;
+    return true;
+}
+
+// Set Status Return Level. The write is sent without waiting for a reply if either the old or the
+// new level would suppress it, then the level is read back (reads are answered from level 1).
+bool Servo::setStatusReturnLevel(uint8_t id, uint8_t level) {
+    uint8_t known = driver->getStatusReturnLevel(id);
+    driver->setStatusReturnLevel(id, min(known, level));
+    if (!driver->writeRegister(id, "Status_Return_Level", (uint32_t)level)) {
+        driver->setStatusReturnLevel(id, known);
+        return false;
+    }
+    driver->setStatusReturnLevel(id, level);
+    if (level >= 1 && !readStatusLevel(id)) return false;
+    return driver->getStatusReturnLevel(id) == level;
+}
+
     // Get Alarm LED
 bool Servo::getAlarmLED(uint8_t id, uint8_t* alarm_led) {
     if (!driver->readRegister(id, "Alarm_LED", (uint32_t*)alarm_led)) return false;
@@ -266,171 +314,576 @@ bool Servo::init(   uint8_t dxl_id,
     return result;
 }
 
-bool Servo::update(uint8_t id) {
-    // Update the state of the servo
-    return true;
+// Initialize several servos at once. Only the ping pass waits for status packets; angle limits,
+// Moving_Speed and Torque_Enable with LED then go out as one sync write each to the servos that
+// answered, instead of six acknowledged writes per servo. Returns false if any servo is missing.
+bool Servo::initServos( const uint8_t* ids,
+                        uint8_t id_num,
+                        int32_t speed,
+                        const int32_t* CW_angles,
+                        const int32_t* CCW_angles) {
+    if (id_num > SERVO_INIT_MAX) {
+        LOG_ERR("Too many servos for one init: " + String(id_num));
+        return false;
+    }
+    if (!addInitHandlers()) return false;
+
+    uint32_t start = millis();
+    uint8_t  found[SERVO_INIT_MAX];
+    int32_t  limits[SERVO_INIT_MAX];
+    int32_t  speeds[SERVO_INIT_MAX];
+    int32_t  torque[SERVO_INIT_MAX];
+    uint8_t  n = 0;
+    String   missing = "";
+
+    for (uint8_t i = 0; i < id_num; i++) {
+        if (!ping(ids[i])) {
+            missing += " " + String(ids[i]);
+            continue;
+        }
+        readStatusLevel(ids[i]);                                                    // Writes to tuned servos must not wait for a reply
+        found[n]  = ids[i];
+        limits[n] = (CW_angles[i] & 0xFFFF) | ((CCW_angles[i] & 0xFFFF) << 16);    // CW_Angle_Limit low word, CCW_Angle_Limit high word
+        speeds[n] = speed;
+        torque[n] = 1 | (1 << 8);                                                   // Torque_Enable and LED on
+        n++;
+    }
+
+    bool success = (n == id_num);
+    if (n > 0) {
+        success &= driver->syncWrite(limitsHandler, found, n, limits, 1);
+        success &= driver->syncWrite(speedHandler,  found, n, speeds, 1);
+        success &= driver->syncWrite(torqueHandler, found, n, torque, 1);
+    }
+
+    if (missing.length() > 0) LOG_ERR("Servos not answering:" + missing);
+    LOG_INF("Initialized " + String(n) + " of " + String(id_num) + " servos in " + String(millis() - start) + " ms");
+    return success;
+}
+
+// Register the sync write handlers used by initServos, once
+bool Servo::addInitHandlers() {
+    if (torqueHandler != 0xFF) return true;
+    uint8_t first = driver->getTheNumberOfSyncWriteHandler();
+    if (!driver->addSyncWriteHandler(SERVO_ANGLE_LIMITS, 4)) return false;
+    if (!driver->addSyncWriteHandler(SERVO_MOVING_SPEED, 2)) return false;
+    if (!driver->addSyncWriteHandler(SERVO_TORQUE_ENABLE, 2)) return false;
+    limitsHandler = first;
+    speedHandler  = first + 1;
+    torqueHandler = first + 2;
+    return true;
+}
+
+// Read Status_Return_Level into the driver
+bool Servo::readStatusLevel(uint8_t id) {
+    uint32_t level = 0;
+    if (!driver->readRegister(id, SERVO_STATUS_LEVEL, 1, &level)) return false;
+    driver->setStatusReturnLevel(id, (uint8_t)level);
+    return true;
+}
+
+// Tune the bus timing of several servos. For each servo the Return_Delay_Time is lowered to the
+// smallest value at which SERVO_TUNE_READS reads in a row succeed, plus SERVO_TUNE_MARGIN, and the
+// Status_Return_Level is set to 1 so writes are no longer answered. Both are EEPROM settings and stay
+// after a power cycle; initServos reads the level back at boot. Prints round trips per servo and bus
+// transactions per second before and after.
+bool Servo::tuneBus(const uint8_t* ids, uint8_t id_num) {
+    static const uint8_t candidates[] = {0, 1, 2, 4, 8, 16, 32, 64, 125, 250};   // Return delays tried, in 2 us units
+    float   before  = measureThroughput(ids, id_num);
+    bool    success = true;
+
+    for (uint8_t i = 0; i < id_num; i++) {
+        uint8_t  id       = ids[i];
+        uint32_t value    = 0;
+        uint8_t  failures = 0;
+        if (!readStatusLevel(id) || !driver->readRegister(id, SERVO_RETURN_DELAY, 1, &value)) {
+            LOG_ERR("Servo ID " + String(id) + " not answering, not tuned");
+            success = false;
+            continue;
+        }
+        uint8_t  original   = (uint8_t)value;
+        uint8_t  chosen     = original;
+        uint32_t tripBefore = measureRoundTrip(id, SERVO_TUNE_READS, &failures);
+
+        for (uint8_t c = 0; c < sizeof(candidates) && candidates[c] < original; c++) {
+            driver->clearHealth(id);                                                // Failed trials must not quarantine the servo
+            if (!setReturnDelayTime(id, candidates[c])) continue;
+            measureRoundTrip(id, SERVO_TUNE_READS, &failures);
+            if (failures == 0) {
+                chosen = min(candidates[c] + SERVO_TUNE_MARGIN, (int)original);
+                break;
+            }
+        }
+
+        driver->clearHealth(id);
+        bool reliable = setReturnDelayTime(id, chosen);
+        if (reliable) {
+            measureRoundTrip(id, SERVO_TUNE_READS, &failures);
+            reliable = (failures == 0);
+        }
+        if (!reliable) {
+            LOG_WRN("Servo ID " + String(id) + " unreliable at the tuned delay, restoring " + String(original * 2) + " us");
+            driver->clearHealth(id);
+            setReturnDelayTime(id, original);
+            chosen = original;
+        }
+        uint32_t tripAfter = measureRoundTrip(id, SERVO_TUNE_READS, &failures);
+
+        if (!setStatusReturnLevel(id, 1)) {
+            LOG_ERR("Failed to set status return level of servo ID " + String(id));
+            success = false;
+        }
+        PRINTLN("ID " + String(id) + (id < 10 ? " " : "") + "            : return delay " + String(original * 2) + " -> " + String(chosen * 2)
+                + " us | round trip " + String(tripBefore) + " -> " + String(tripAfter) + " us | status level 1");
+    }
+
+    float after = measureThroughput(ids, id_num);
+    PRINTLN("Bus throughput   : " + String(before, 0) + " -> " + String(after, 0) + " transactions/s");
+    return success;
+}
+
+// Average round trip of reads of one byte in us, failed reads are counted and left out
+uint32_t Servo::measureRoundTrip(uint8_t id, uint8_t reads, uint8_t* failures) {
+    uint32_t total = 0;
+    uint8_t  good  = 0;
+    *failures      = 0;
+    for (uint8_t n = 0; n < reads; n++) {
+        uint32_t value = 0;
+        uint32_t start = micros();
+        if (driver->readRegisters(&id, 1, SERVO_PRESENT_TEMPERATURE, 1, &value)) {
+            total += micros() - start;
+            good++;
+        } else {
+            (*failures)++;
+        }
+    }
+    return good ? total / good : 0;
+}
+
+// Transactions per second of a mix of one position read and one LED write per servo, as the gait and
+// telemetry produce. Writes are answered or not according to the servo's status return level.
+float Servo::measureThroughput(const uint8_t* ids, uint8_t id_num) {
+    uint32_t count = 0;
+    uint8_t  on    = 1;
+    uint32_t start = micros();
+    for (uint8_t r = 0; r < SERVO_TUNE_ROUNDS; r++) {
+        for (uint8_t i = 0; i < id_num; i++) {
+            uint32_t value = 0;
+            uint8_t  id    = ids[i];
+            driver->readRegisters(&id, 1, SERVO_PRESENT_POSITION, 2, &value);
+            driver->writeRegister(id, SERVO_LED, 1, &on);
+            count += 2;
+        }
+    }
+    uint32_t elapsed = micros() - start;
+    return elapsed ? count * 1e6f / elapsed : 0.0f;
 }
 
-// Process console commands for servo control
-bool Servo::runConsoleCommands(const String& cmd, const String& args) {
-    int id = 1, arg2 = 0, arg3 = 0; // Default values
-    if (args.length() > 0) {
-        int n = sscanf(args.c_str(), "%d %d %d", &id, &arg2, &arg3);
-        if (n > 3) {
-            LOG_ERR("Too many arguments");
-            return true;
+// Poll the telemetry fields of a servo that are due. Every read is timed and charged to a window of
+// SERVO_TELEMETRY_WINDOW, and no read starts once the window's budget would be exceeded, so telemetry
+// never holds the bus long enough to delay the gait's writes. Fields left over are due again on the next
+// call; servos read in one window are not due again until their period has passed, so the polling
+// rotates through all servos when the budget is short.
+bool Servo::update(uint8_t id) {
+    if (driver == nullptr || id < 1 || id > SERVO_TELEMETRY_SERVOS) return true;
+    ServoTelemetry& t = telemetry[id - 1];
+
+    uint32_t now = micros();
+    if (now - windowStart >= SERVO_TELEMETRY_WINDOW) {
+        if (windowSpent > maxSpent) maxSpent = windowSpent;
+        windowStart = now;
+        windowSpent = 0;
+    }
+
+    bool     success = true;
+    uint32_t value   = 0;
+    uint32_t time    = 0;
+
+    if (isDue(t, SERVO_POSITION, now) && hasBudget()) {
+        if (poll(id, SERVO_PRESENT_POSITION, 2, &value, &time)) {
+            t.position                  = (uint16_t)value;
+            t.time[SERVO_POSITION]      = time;
+            ServoEstimator* estimator   = driver->getEstimator();
+            if (estimator != nullptr) estimator->correct(id, t.position, time);
+        } else {
+            success = false;
         }
-        if (id < 1 || id > 253) // Validate servo ID
-            id = 1;
+        t.polled[SERVO_POSITION] = now;
     }
 
-    if (cmd == "ss") {
-        if (arg2 > id && arg2 < 253) {
-            for (int i = id; i <= arg2; i++) {
-                printStatus(i);
-            }
+    if (isDue(t, SERVO_LOAD, now) && hasBudget()) {
+        if (poll(id, SERVO_PRESENT_LOAD, 2, &value, &time)) {
+            t.load                      = (uint16_t)value;
+            t.time[SERVO_LOAD]          = time;
         } else {
-            printStatus(id);
+            success = false;
         }
-        return true;
+        t.polled[SERVO_LOAD] = now;
+    }
 
-    } else if (cmd == "sp") {
-        if (arg2 > 0 && arg2 > id && arg2 < 253) {
-            for (int i = id; i <= arg2; i++) {
-                PRINTLN("Servo ID " + String(i) + " ping: " + String(ping((uint8_t)i) ? "SUCCESS" : "FAILED"));
-            }
+    // Present_Voltage and Present_Temperature are adjacent, one read returns both
+    if ((isDue(t, SERVO_VOLTAGE, now) || isDue(t, SERVO_TEMPERATURE, now)) && hasBudget()) {
+        if (poll(id, SERVO_PRESENT_VOLTAGE, 2, &value, &time)) {
+            t.voltage                   = (uint8_t)(value & 0xFF);
+            t.temperature               = (uint8_t)(value >> 8);
+            t.time[SERVO_VOLTAGE]       = time;
+            t.time[SERVO_TEMPERATURE]   = time;
         } else {
-            PRINTLN("Servo ID " + String(id) + " ping: " + String(ping((uint8_t)id) ? "SUCCESS" : "FAILED"));
+            success = false;
         }
-        return true;
-
-    } else if (cmd == "sgmn") {
-        uint16_t model_number;
-        getModelNumber((uint8_t)id, &model_number);
-        PRINTLN("Servo ID " + String(id) + " model number: " + String(model_number));
-        return true;
-
-    } else if (cmd == "sgfv") {
-        uint8_t firmware_version;
-        getFirmwareVersion((uint8_t)id, &firmware_version);
-        PRINTLN("Servo ID " + String(id) + " firmware version: " + String(firmware_version));
-        return true;
-
-    } else if (cmd == "sgal") {
-        uint16_t CW_angle, CCW_angle;
-        getAngleLimits((uint8_t)id, &CW_angle, &CCW_angle);
-        PRINTLN("Servo ID " + String(id) + " angle limits: CW " + String(CW_angle) + " ~ CCW " + String(CCW_angle));
-        return true;
-
-    } else if (cmd == "sgp") {
-        uint16_t presentPos;
-        getPresentPosition((uint8_t)id, &presentPos);
-        PRINTLN("Servo ID " + String(id) + " current position: " + String(presentPos));
-        return true;
-        
-    } else if (cmd == "sgs") {
-        uint16_t presentSpeed;
-        getPresentSpeed((uint8_t)id, &presentSpeed);
-        PRINTLN("Servo ID " + String(id) + " current speed: " + String(presentSpeed));
-        return true;
-        
-    } else if (cmd == "sgl") {
-        uint16_t presentLoad;
-        bool load_dir;
-        getPresentLoad((uint8_t)id, &load_dir, &presentLoad);
-        PRINTLN("Servo ID " + String(id) + " current load: " + String(load_dir==1 ? "CW " : "CCW ")+ String(presentLoad) );
-        return true;
-
-    } else if (cmd == "sgv") {
-        uint8_t presentVoltage;
-        getPresentVoltage((uint8_t)id, &presentVoltage);
-        PRINTLN("Servo ID " + String(id) + " current voltage: " + String((float)presentVoltage/10) + " V");
-        return true;
-
-    } else if (cmd == "sgt") {
-        uint8_t presentTemperature;
-        getPresentTemperature((uint8_t)id, &presentTemperature);
-        PRINTLN("Servo ID " + String(id) + " current temperature: " + String(presentTemperature) + " C");
-        return true;
-
-    } else if (cmd == "sglo") {
-        PRINTLN("Servo ID " + String(id) + " EEPROM is " + String(isLock((uint8_t)id) ? "LOCKED" : "UNLOCKED"));
-        return true;
-
-    } else if (cmd == "sgpn") {
-        uint16_t punch = 0;
-        getPunch((uint8_t)id, &punch);
-        PRINTLN("Servo ID " + String(id) + " punch: " + String(punch));
-        return true;
-
-    } else if (cmd == "sim") {
-        PRINTLN("Servo ID " + String(id) + " is " + String(isMoving((uint8_t)id) ? "MOVING" : "NOT MOVING"));
-        return true;
-
-    } else if (cmd == "sit") {
-        PRINTLN("Servo ID " + String(id) + " torque is " + String(isTorqueOn((uint8_t)id) ? "ENABLED" : "DISABLED"));
-        return true;
-
-    } else if (cmd == "sil") {
-        PRINTLN("Servo ID " + String(id) + " LED is " + String(isLedOn((uint8_t)id) ? "ON" : "OFF"));
-        return true;
-
-    } else if (cmd == "ssp") {
-        if (arg2 < 0 || arg2 > 1023)                // Validate position (typical range for AX is 0-1023)
-            arg2 = 512;                             // Center position
-        setGoalPosition((uint8_t)id, (int32_t)arg2);
-        PRINTLN("Servo ID " + String(id) + " position set to " + String(arg2));
-        return true;
-
-    } else if (cmd == "sss") {
-        if (arg2 < 0 || arg2 > 1023)                // Validate speed (typical range is 0-1023)
-            arg2 = 100;                             // default speed
-        setGoalSpeed((uint8_t)id, (int32_t)arg2);
-        PRINTLN("Servo ID " + String(id) + " speed set to " + String(arg2));
-        return true;
-
-    } else if (cmd == "ssal") {
-        if (arg2 < 0 || arg2 > 1023)                // Validate ANGLE (typical range is 0-1023)
-            arg2 = 412;                             // default CW angle
-        if (arg3 < 0 || arg3 > 1023)                // Validate ANGLE (typical range is 0-1023)
-            arg3 = 612;                             // default CCW angle
-
-        setAngleLimits((uint8_t)id, (int32_t)arg2, (int32_t)arg3);
-        PRINTLN("Servo ID " + String(id) + " angle limits: CW " + String(arg2) + " ~ CCW " + String(arg3));
-        return true;
-
-    } else if (cmd == "ston") {
-        
-        bool result = torqueOn((uint8_t)id);
-        PRINTLN("Servo ID " + String(id) + " torque " + String(result ? "ENABLED" : "FAILED"));
-        return true;
-
-    } else if (cmd == "stoff") {
-        
-        bool result = torqueOff((uint8_t)id);
-        PRINTLN("Servo ID " + String(id) + " torque " + String(result ? "DISABLED" : "FAILED"));
-        return true;
-        
-    } else if (cmd == "slon") {
-        
-        bool result = ledOn((uint8_t)id);
-        PRINTLN("Servo ID " + String(id) + " LED " + String(result ? "ON" : "FAILED"));
-        return true;
-
-    } else if (cmd == "sloff") {
-        
-        bool result = ledOff((uint8_t)id);
-        PRINTLN("Servo ID " + String(id) + " LED " + String(result ? "OFF" : "FAILED"));
-        return true;
-
-    } else if (cmd == "s?") {
-        printConsoleHelp();
-        return true;
+        t.polled[SERVO_VOLTAGE]     = now;
+        t.polled[SERVO_TEMPERATURE] = now;
     }
-    
+
+    return success;
+}
+
+// Last polled values of a servo, nullptr if the ID is not polled
+const ServoTelemetry* Servo::getTelemetry(uint8_t id) const {
+    if (id < 1 || id > SERVO_TELEMETRY_SERVOS) return nullptr;
+    return &telemetry[id - 1];
+}
+
+// Set the poll period of a telemetry field in ms, 0 disables the field
+bool Servo::setFieldPeriod(uint8_t field, uint16_t period) {
+    if (field >= SERVO_FIELDS) {
+        LOG_ERR("Invalid telemetry field " + String(field));
+        return false;
+    }
+    periods[field] = period;
+    return true;
+}
+
+// Set the bus time for telemetry per window in us, 0 stops polling
+bool Servo::setBudget(uint32_t budget) {
+    if (budget > SERVO_TELEMETRY_WINDOW / 2) {
+        LOG_ERR("Telemetry budget " + String(budget) + " us is over half the window");
+        return false;
+    }
+    this->budget = budget;
+    return true;
+}
+
+// The field is enabled and its period has passed since the last attempt
+bool Servo::isDue(const ServoTelemetry& t, uint8_t field, uint32_t now) const {
+    if (periods[field] == 0) return false;
+    if (t.polled[field] == 0) return true;
+    return now - t.polled[field] >= (uint32_t)periods[field] * 1000;
+}
+
+// Another read fits in the current window. The first read of a window always fits, so a read
+// slower than the budget still makes progress.
+bool Servo::hasBudget() {
+    if (budget == 0) return false;
+    if (windowSpent == 0 || windowSpent + readCost <= budget) return true;
+    deferred++;
     return false;
 }
 
+// Read a register, charge its bus time to the window and stamp the value at the middle of the transfer
+bool Servo::poll(uint8_t id, uint16_t address, uint16_t length, uint32_t* value, uint32_t* time) {
+    uint32_t start   = micros();
+    bool     success = driver->readRegisters(&id, 1, address, length, value);
+    uint32_t elapsed = micros() - start;
+
+    windowSpent += elapsed;
+    readCost     = (readCost * 7 + elapsed) / 8;
+    *time        = start + elapsed / 2;
+    if (*time == 0) *time = 1;                                                                  // 0 is kept for never read
+    if (success) {
+        reads++;
+    } else {
+        telemetry[id - 1].errors++;
+    }
+    return success;
+}
+
+// Print the telemetry table and bus usage
+bool Servo::printTelemetry() {
+    PRINTLN("Servo Telemetry: \n\r");
+    PRINTLN("Budget           : " + String(budget) + " us per " + String(SERVO_TELEMETRY_WINDOW / 1000) + " ms | max used " + String(maxSpent) + " us");
+    PRINTLN("Periods          : position " + String(periods[SERVO_POSITION]) + " | load " + String(periods[SERVO_LOAD])
+            + " | voltage " + String(periods[SERVO_VOLTAGE]) + " | temperature " + String(periods[SERVO_TEMPERATURE]) + " ms");
+    PRINTLN("Reads            : " + String(reads) + " | deferred " + String(deferred) + " | read cost " + String(readCost) + " us");
+    uint32_t now = micros();
+    for (uint8_t i = 0; i < SERVO_TELEMETRY_SERVOS; i++) {
+        const ServoTelemetry& t = telemetry[i];
+        String line = "ID " + String(i + 1) + (i < 9 ? " " : "") + "            : ";
+        if (t.time[SERVO_POSITION] == 0 && t.time[SERVO_LOAD] == 0 && t.time[SERVO_VOLTAGE] == 0) {
+            PRINTLN(line + "no reads | errors " + String(t.errors));
+            continue;
+        }
+        PRINTLN(line + "pos " + String(t.position) + " | load " + String((t.load & 0x400) ? "CW " : "CCW ") + String(t.load & 0x3FF)
+                + " | " + String((float)t.voltage / 10, 1) + " V | " + String(t.temperature) + " °C"
+                + " | age " + String((now - t.time[SERVO_POSITION]) / 1000) + " ms | errors " + String(t.errors));
+    }
+    return true;
+}
+
+// Servo ID of argument 0, 1 when missing or out of range
+static uint8_t servoId(const CommandArgs& args) {
+    long id = args.toInt(0, 1);
+    return (id < 1 || id > 253) ? 1 : (uint8_t)id;
+}
+
+// Last servo ID of a range, argument 1 when it is above the first, the first otherwise
+static uint8_t lastServoId(const CommandArgs& args, uint8_t first) {
+    long last = args.toInt(1, 0);
+    return (last > first && last < 253) ? (uint8_t)last : first;
+}
+
+// ss [id] [id]: Print the status of a range of servos
+static bool showServo(void* module, const CommandArgs& args) {
+    Servo*  servo = static_cast<Servo*>(module);
+    uint8_t first = servoId(args);
+    uint8_t last  = lastServoId(args, first);
+    bool    ok    = true;
+    for (uint8_t id = first; id <= last; id++) {
+        ok &= servo->printStatus(id);
+    }
+    return ok;
+}
+
+// sp [id] [id]: Ping a range of servos
+static bool pingServo(void* module, const CommandArgs& args) {
+    Servo*  servo = static_cast<Servo*>(module);
+    uint8_t first = servoId(args);
+    uint8_t last  = lastServoId(args, first);
+    bool    ok    = true;
+    for (uint8_t id = first; id <= last; id++) {
+        bool found = servo->ping(id);
+        PRINTLN("Servo ID " + String(id) + " ping: " + String(found ? "SUCCESS" : "FAILED"));
+        ok &= found;
+    }
+    return ok;
+}
+
+// sgmn [id]: Print the model number
+static bool showModelNumber(void* servo, const CommandArgs& args) {
+    uint8_t  id     = servoId(args);
+    uint16_t number = 0;
+    bool     ok     = static_cast<Servo*>(servo)->getModelNumber(id, &number);
+    PRINTLN("Servo ID " + String(id) + " model number: " + String(number));
+    return ok;
+}
+
+// sgfv [id]: Print the firmware version
+static bool showFirmwareVersion(void* servo, const CommandArgs& args) {
+    uint8_t id      = servoId(args);
+    uint8_t version = 0;
+    bool    ok      = static_cast<Servo*>(servo)->getFirmwareVersion(id, &version);
+    PRINTLN("Servo ID " + String(id) + " firmware version: " + String(version));
+    return ok;
+}
+
+// sgal [id]: Print the angle limits
+static bool showAngleLimits(void* servo, const CommandArgs& args) {
+    uint8_t  id  = servoId(args);
+    uint16_t cw  = 0;
+    uint16_t ccw = 0;
+    bool     ok  = static_cast<Servo*>(servo)->getAngleLimits(id, &cw, &ccw);
+    PRINTLN("Servo ID " + String(id) + " angle limits: CW " + String(cw) + " ~ CCW " + String(ccw));
+    return ok;
+}
+
+// sgp [id]: Print the present position
+static bool showPosition(void* servo, const CommandArgs& args) {
+    uint8_t  id       = servoId(args);
+    uint16_t position = 0;
+    bool     ok       = static_cast<Servo*>(servo)->getPresentPosition(id, &position);
+    PRINTLN("Servo ID " + String(id) + " current position: " + String(position));
+    return ok;
+}
+
+// sgs [id]: Print the present speed
+static bool showSpeed(void* servo, const CommandArgs& args) {
+    uint8_t  id    = servoId(args);
+    uint16_t speed = 0;
+    bool     ok    = static_cast<Servo*>(servo)->getPresentSpeed(id, &speed);
+    PRINTLN("Servo ID " + String(id) + " current speed: " + String(speed));
+    return ok;
+}
+
+// sgl [id]: Print the present load
+static bool showLoad(void* servo, const CommandArgs& args) {
+    uint8_t  id   = servoId(args);
+    uint16_t load = 0;
+    bool     cw   = false;
+    bool     ok   = static_cast<Servo*>(servo)->getPresentLoad(id, &cw, &load);
+    PRINTLN("Servo ID " + String(id) + " current load: " + String(cw ? "CW " : "CCW ") + String(load));
+    return ok;
+}
+
+// sgv [id]: Print the present voltage
+static bool showVoltage(void* servo, const CommandArgs& args) {
+    uint8_t id      = servoId(args);
+    uint8_t voltage = 0;
+    bool    ok      = static_cast<Servo*>(servo)->getPresentVoltage(id, &voltage);
+    PRINTLN("Servo ID " + String(id) + " current voltage: " + String((float)voltage / 10) + " V");
+    return ok;
+}
+
+// sgt [id]: Print the present temperature
+static bool showTemperature(void* servo, const CommandArgs& args) {
+    uint8_t id          = servoId(args);
+    uint8_t temperature = 0;
+    bool    ok          = static_cast<Servo*>(servo)->getPresentTemperature(id, &temperature);
+    PRINTLN("Servo ID " + String(id) + " current temperature: " + String(temperature) + " C");
+    return ok;
+}
+
+// sglo [id]: Print the EEPROM lock
+static bool showLock(void* servo, const CommandArgs& args) {
+    uint8_t id = servoId(args);
+    PRINTLN("Servo ID " + String(id) + " EEPROM is " + String(static_cast<Servo*>(servo)->isLock(id) ? "LOCKED" : "UNLOCKED"));
+    return true;
+}
+
+// sgpn [id]: Print the punch
+static bool showPunch(void* servo, const CommandArgs& args) {
+    uint8_t  id    = servoId(args);
+    uint16_t punch = 0;
+    bool     ok    = static_cast<Servo*>(servo)->getPunch(id, &punch);
+    PRINTLN("Servo ID " + String(id) + " punch: " + String(punch));
+    return ok;
+}
+
+// sim [id]: Print whether the servo moves
+static bool showMoving(void* servo, const CommandArgs& args) {
+    uint8_t id = servoId(args);
+    PRINTLN("Servo ID " + String(id) + " is " + String(static_cast<Servo*>(servo)->isMoving(id) ? "MOVING" : "NOT MOVING"));
+    return true;
+}
+
+// sit [id]: Print whether the torque is on
+static bool showTorque(void* servo, const CommandArgs& args) {
+    uint8_t id = servoId(args);
+    PRINTLN("Servo ID " + String(id) + " torque is " + String(static_cast<Servo*>(servo)->isTorqueOn(id) ? "ENABLED" : "DISABLED"));
+    return true;
+}
+
+// sil [id]: Print whether the LED is on
+static bool showLed(void* servo, const CommandArgs& args) {
+    uint8_t id = servoId(args);
+    PRINTLN("Servo ID " + String(id) + " LED is " + String(static_cast<Servo*>(servo)->isLedOn(id) ? "ON" : "OFF"));
+    return true;
+}
+
+// ssp [id] [pos]: Set the goal position, the center when out of range
+static bool setPosition(void* servo, const CommandArgs& args) {
+    uint8_t id       = servoId(args);
+    long    position = args.toInt(1, 0);
+    if (position < 0 || position > 1023) position = 512;
+    if (!static_cast<Servo*>(servo)->setGoalPosition(id, (int32_t)position)) return false;
+    PRINTLN("Servo ID " + String(id) + " position set to " + String(position));
+    return true;
+}
+
+// sss [id] [spd]: Set the goal speed, 100 when out of range
+static bool setSpeed(void* servo, const CommandArgs& args) {
+    uint8_t id    = servoId(args);
+    long    speed = args.toInt(1, 0);
+    if (speed < 0 || speed > 1023) speed = 100;
+    if (!static_cast<Servo*>(servo)->setGoalSpeed(id, (int32_t)speed)) return false;
+    PRINTLN("Servo ID " + String(id) + " speed set to " + String(speed));
+    return true;
+}
+
+// ssal [id] [cw] [ccw]: Set the angle limits, 412 ~ 612 when out of range
+static bool setAngleLimits(void* servo, const CommandArgs& args) {
+    uint8_t id  = servoId(args);
+    long    cw  = args.toInt(1, 0);
+    long    ccw = args.toInt(2, 0);
+    if (cw < 0 || cw > 1023)   cw  = 412;
+    if (ccw < 0 || ccw > 1023) ccw = 612;
+    if (!static_cast<Servo*>(servo)->setAngleLimits(id, (int32_t)cw, (int32_t)ccw)) return false;
+    PRINTLN("Servo ID " + String(id) + " angle limits: CW " + String(cw) + " ~ CCW " + String(ccw));
+    return true;
+}
+
+// ston [id]: Enable the torque
+static bool torqueOn(void* servo, const CommandArgs& args) {
+    uint8_t id = servoId(args);
+    bool    ok = static_cast<Servo*>(servo)->torqueOn(id);
+    PRINTLN("Servo ID " + String(id) + " torque " + String(ok ? "ENABLED" : "FAILED"));
+    return ok;
+}
+
+// stoff [id]: Disable the torque
+static bool torqueOff(void* servo, const CommandArgs& args) {
+    uint8_t id = servoId(args);
+    bool    ok = static_cast<Servo*>(servo)->torqueOff(id);
+    PRINTLN("Servo ID " + String(id) + " torque " + String(ok ? "DISABLED" : "FAILED"));
+    return ok;
+}
+
+// slon [id]: Turn on the LED
+static bool ledOn(void* servo, const CommandArgs& args) {
+    uint8_t id = servoId(args);
+    bool    ok = static_cast<Servo*>(servo)->ledOn(id);
+    PRINTLN("Servo ID " + String(id) + " LED " + String(ok ? "ON" : "FAILED"));
+    return ok;
+}
+
+// sloff [id]: Turn off the LED
+static bool ledOff(void* servo, const CommandArgs& args) {
+    uint8_t id = servoId(args);
+    bool    ok = static_cast<Servo*>(servo)->ledOff(id);
+    PRINTLN("Servo ID " + String(id) + " LED " + String(ok ? "OFF" : "FAILED"));
+    return ok;
+}
+
+// sbt [id] [id]: Tune the return delay of a range of servos, the telemetry servos without argument
+static bool tuneBus(void* servo, const CommandArgs& args) {
+    uint8_t ids[SERVO_TELEMETRY_SERVOS];
+    uint8_t n     = 0;
+    int     first = 1;
+    int     last  = SERVO_TELEMETRY_SERVOS;
+    if (args.count() > 0) {
+        first = servoId(args);
+        last  = lastServoId(args, (uint8_t)first);
+    }
+    for (int i = first; i <= last && n < SERVO_TELEMETRY_SERVOS; i++) {
+        ids[n++] = (uint8_t)i;
+    }
+    return static_cast<Servo*>(servo)->tuneBus(ids, n);
+}
+
+// sts: Print the polled telemetry and bus budget usage
+static bool showTelemetry(void* servo, const CommandArgs&) {
+    return static_cast<Servo*>(servo)->printTelemetry();
+}
+
+// str field ms: Set the poll period of a telemetry field
+static bool setFieldPeriod(void* servo, const CommandArgs& args) {
+    long field  = args.toInt(0, -1);
+    long period = args.toInt(1, -1);
+    if (args.count() != 2 || field < 0 || period < 0 || period > 65535) {
+        LOG_ERR("Usage: str [field 0-3] [ms]");
+        return false;
+    }
+    if (!static_cast<Servo*>(servo)->setFieldPeriod((uint8_t)field, (uint16_t)period)) return false;
+    PRINTLN("Telemetry field " + String(field) + " period set to " + String(period) + " ms");
+    return true;
+}
+
+// stb us: Set the telemetry bus budget per window
+static bool setBudget(void* servo, const CommandArgs& args) {
+    long us = args.toInt(0, -1);
+    if (us < 0) {
+        LOG_ERR("Usage: stb [us]");
+        return false;
+    }
+    if (!static_cast<Servo*>(servo)->setBudget((uint32_t)us)) return false;
+    PRINTLN("Telemetry budget set to " + String(us) + " us per window");
+    return true;
+}
+
+// s?: Print the servo help
+static bool showServoHelp(void* servo, const CommandArgs&) {
+    return static_cast<Servo*>(servo)->printConsoleHelp();
+}
+
 // Print the status of a servo for debugging
 bool Servo::printStatus(uint8_t id) {
 
@@ -507,40 +960,49 @@ bool Servo::printStatus(uint8_t id) {
     return true;
 }
 
+// Console commands, the help is printed from this table
+static const ConsoleCommand servoCommands[] = {
+    { "ss",     "[id] [id]",       "Show servo status for range of id's (default id=1)",                                    showServo },
+    { "sp",     "[id] [id]",       "Ping servo for range of id's (default id=1)",                                           pingServo },
+    { "sgmn",   "[id]",            "Get servo model number (default id=1)",                                                 showModelNumber },
+    { "sgfv",   "[id]",            "Get servo firmware version (default id=1)",                                             showFirmwareVersion },
+    { nullptr,  "",                "",                                                                                      nullptr },
+    { "sgp",    "[id]",            "Get servo position (default id=1)",                                                     showPosition },
+    { "sgs",    "[id]",            "Get servo speed (default id=1)",                                                        showSpeed },
+    { "sgal",   "[id]",            "Get servo angle limits (default id=1)",                                                 showAngleLimits },
+    { "sgl",    "[id]",            "Get servo load (default id=1)",                                                         showLoad },
+    { "sgv",    "[id]",            "Get servo voltage (default id=1)",                                                      showVoltage },
+    { "sgt",    "[id]",            "Get servo temperature (default id=1)",                                                  showTemperature },
+    { "sglo",   "[id]",            "Get servo lock status (default id=1)",                                                  showLock },
+    { "sgpn",   "[id]",            "Get servo punch (default id=1)",                                                        showPunch },
+    { nullptr,  "",                "",                                                                                      nullptr },
+    { "sim",    "[id]",            "Check is servo moving (default id=1)",                                                  showMoving },
+    { "sit",    "[id]",            "Check is servo torque enabled (default id=1)",                                          showTorque },
+    { "sil",    "[id]",            "Check is servo LED enabled (default id=1)",                                             showLed },
+    { nullptr,  "",                "",                                                                                      nullptr },
+    { "ssp",    "[id] [pos]",      "Set servo position (default id=1, pos=512)",                                            setPosition },
+    { "sss",    "[id] [spd]",      "Set servo speed (default id=1, spd=100)",                                               setSpeed },
+    { "ssal",   "[id] [cw] [ccw]", "Set servo angle limits (default id=1, cw=0, ccw=1023)",                                 setAngleLimits },
+    { nullptr,  "",                "",                                                                                      nullptr },
+    { "ston",   "[id]",            "Enable servo torque (default id=1)",                                                    torqueOn },
+    { "stoff",  "[id]",            "Disable servo torque (default id=1)",                                                   torqueOff },
+    { "slon",   "[id]",            "Turn on servo LED (default id=1)",                                                      ledOn },
+    { "sloff",  "[id]",            "Turn off servo LED (default id=1)",                                                     ledOff },
+    { nullptr,  "",                "",                                                                                      nullptr },
+    { "sbt",    "[id] [id]",       "Tune return delay and status level for range of id's (default 1 to 20, writes EEPROM)", tuneBus },
+    { nullptr,  "",                "",                                                                                      nullptr },
+    { "sts",    "",                "Show polled telemetry and bus budget usage",                                            showTelemetry },
+    { "str",    "[field] [ms]",    "Set telemetry poll period (0 pos, 1 load, 2 volt, 3 temp; 0 ms disables)",              setFieldPeriod },
+    { "stb",    "[us]",            "Set telemetry bus budget per window (default 500, 0 stops polling)",                    setBudget },
+    { nullptr,  "",                "",                                                                                      nullptr },
+    { "s?",     "",                "Show this help message",                                                                showServoHelp },
+};
+const ConsoleCommandTable Servo::commandTable = { "Servo Commands:", servoCommands, sizeof(servoCommands) / sizeof(servoCommands[0]) };
+
 // Print servo-specific help information
 bool Servo::printConsoleHelp() {
-    PRINTLN("Servo Commands:\n\r");
-    PRINTLN("  ss [id] [id]         - Show servo status for range of id's (default id=1)");
-    PRINTLN("  sp [id] [id]         - Ping servo for range of id's (default id=1)");
-    PRINTLN("  sgmn [id]            - Get servo model number (default id=1)");
-    PRINTLN("  sgfv [id]            - Get servo firmware version (default id=1)");
-    PRINTLN("");
-    PRINTLN("  sgp [id]             - Get servo position (default id=1)");
-    PRINTLN("  sgs [id]             - Get servo speed (default id=1)");
-    PRINTLN("  sgal [id]            - Get servo angle limits (default id=1)");
-    PRINTLN("  sgl [id]             - Get servo load (default id=1)");
-    PRINTLN("  sgv [id]             - Get servo voltage (default id=1)");
-    PRINTLN("  sgt [id]             - Get servo temperature (default id=1)");
-    PRINTLN("  sglo [id]            - Get servo lock status (default id=1)");
-    PRINTLN("  sgpn [id]            - Get servo punch (default id=1)");
-    PRINTLN("");
-    PRINTLN("  sim [id]             - Check is servo moving (default id=1)");
-    PRINTLN("  sit [id]             - Check is servo torque enabled (default id=1)");
-    PRINTLN("  sil [id]             - Check is servo LED enabled (default id=1)");
-    PRINTLN("");
-    PRINTLN("  ssp [id] [pos]       - Set servo position (default id=1, pos=512)");
-    PRINTLN("  sss [id] [spd]       - Set servo speed (default id=1, spd=100)");
-    PRINTLN("  ssal [id] [cw] [ccw] - Set servo angle limits (default id=1, cw=0, ccw=1023)");
-    PRINTLN("");
-    PRINTLN("  ston [id]            - Enable servo torque (default id=1)");
-    PRINTLN("  stoff [id]           - Disable servo torque (default id=1)");
-    PRINTLN("  slon [id]            - Turn on servo LED (default id=1)");
-    PRINTLN("  sloff [id]           - Turn off servo LED (default id=1)");
-    PRINTLN("");
-    PRINTLN("  s?                   - Show this help message");
-    PRINTLN("");
-    return true;
-}
-
-
-// End of Servo.cpp
\ No newline at end of file
+    return CommandRegistry::printHelp(commandTable);
+}
+
+
+// End of Servo.cpp
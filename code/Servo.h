@@ -2,6 +2,50 @@
 #define SERVO_H
 
     #include "Driver.h"
+    #include "CommandRegistry.h"
+
+    #define SERVO_TELEMETRY_SERVOS      uint8_t(20)         // Servo IDs 1 to 20 are polled for telemetry
+    #define SERVO_TELEMETRY_BUDGET      uint32_t(500)       // Bus time for telemetry reads per window in us
+    #define SERVO_TELEMETRY_WINDOW      uint32_t(20000)     // Budget window in us, one state stage update
+    #define SERVO_READ_COST             uint32_t(300)       // Initial estimate of one register read in us
+    #define SERVO_POSITION_PERIOD       uint16_t(500)       // Default Present_Position poll period in ms
+    #define SERVO_LOAD_PERIOD           uint16_t(500)       // Default Present_Load poll period in ms
+    #define SERVO_VOLTAGE_PERIOD        uint16_t(2000)      // Default Present_Voltage poll period in ms
+    #define SERVO_TEMPERATURE_PERIOD    uint16_t(2000)      // Default Present_Temperature poll period in ms
+    #define SERVO_PRESENT_POSITION      uint16_t(36)        // AX-18A Present_Position address, 2 bytes
+    #define SERVO_PRESENT_LOAD          uint16_t(40)        // AX-18A Present_Load address, 2 bytes
+    #define SERVO_PRESENT_VOLTAGE       uint16_t(42)        // AX-18A Present_Voltage address, followed by Present_Temperature
+    #define SERVO_ANGLE_LIMITS          uint16_t(6)         // AX-18A CW_Angle_Limit address, followed by CCW_Angle_Limit (4 bytes)
+    #define SERVO_TORQUE_ENABLE         uint16_t(24)        // AX-18A Torque_Enable address, followed by LED (2 bytes)
+    #define SERVO_MOVING_SPEED          uint16_t(32)        // AX-18A Moving_Speed address, 2 bytes
+    #define SERVO_INIT_MAX              uint8_t(32)         // Most servos brought up by one initServos call
+    #define SERVO_RETURN_DELAY          uint16_t(5)         // AX-18A Return_Delay_Time address, in 2 us units
+    #define SERVO_STATUS_LEVEL          uint16_t(16)        // AX-18A Status_Return_Level address
+    #define SERVO_PRESENT_TEMPERATURE   uint16_t(43)        // AX-18A Present_Temperature address, 1 byte
+    #define SERVO_LED                   uint16_t(25)        // AX-18A LED address, 1 byte
+    #define SERVO_TUNE_READS            uint8_t(20)         // Reads that must all succeed at a return delay for it to be safe
+    #define SERVO_TUNE_MARGIN           uint8_t(2)          // Return delay units (2 us each) added to the smallest safe delay
+    #define SERVO_TUNE_ROUNDS           uint8_t(5)          // Passes over the servos when measuring transactions per second
+
+    // Telemetry fields polled by Servo::update
+    enum ServoField : uint8_t {
+        SERVO_POSITION = 0,
+        SERVO_LOAD,
+        SERVO_VOLTAGE,
+        SERVO_TEMPERATURE,
+        SERVO_FIELDS
+    };
+
+    // Last polled values of one servo. A time of 0 means the field has never been read.
+    struct ServoTelemetry {
+        uint16_t            position;                       // Present_Position in ticks
+        uint16_t            load;                           // Present_Load, bit 10 is the direction
+        uint8_t             voltage;                        // Present_Voltage in 0.1 V
+        uint8_t             temperature;                    // Present_Temperature in °C
+        uint32_t            time[SERVO_FIELDS];             // Time of the last successful read per field in us
+        uint32_t            polled[SERVO_FIELDS];           // Time of the last attempt per field in us
+        uint16_t            errors;                         // Failed reads
+    };
 
     class Servo {
         public:
@@ -23,6 +67,8 @@
             bool                getVoltageLimit(uint8_t id, uint8_t* min_voltage, uint8_t* max_voltage);    // get the voltage limit of a servo by its ID
             bool                getMaxTorque(uint8_t id, uint16_t* max_torque);                             // get the max torque of a servo by its ID
             bool                getStatusReturnLevel(uint8_t id, uint8_t* level);                           // get the status return level of a servo by its ID
+            bool                setReturnDelayTime(uint8_t id, uint8_t return_delay_time);                  // set the return delay time of a servo in 2 us units
+            bool                setStatusReturnLevel(uint8_t id, uint8_t level);                            // set the status return level of a servo and tell the driver
             bool                getAlarmLED(uint8_t id, uint8_t* alarm_led);                                // get the alarm LED of a servo by its ID
             bool                getShutdown(uint8_t id, uint8_t* shutdown);                                 // get the shutdown of a servo by its ID
 
@@ -60,15 +106,47 @@
                                         int32_t speed,
                                         int32_t CW_angle, 
                                         int32_t CCW_angle);
+            bool                initServos( const uint8_t* ids,                                         // initialize several servos with one ping pass and sync writes
+                                            uint8_t id_num,
+                                            int32_t speed,
+                                            const int32_t* CW_angles,
+                                            const int32_t* CCW_angles);
 
-            bool                update(uint8_t id);                                                         // update the state of a servo
+            bool                tuneBus(const uint8_t* ids, uint8_t id_num);                                // set the smallest safe return delay and status level 1, report the gain
+            bool                update(uint8_t id);                                                         // poll due telemetry fields of a servo within the bus budget
+            const ServoTelemetry* getTelemetry(uint8_t id) const;                                           // last polled values of a servo, nullptr if not polled
+            bool                setFieldPeriod(uint8_t field, uint16_t period);                             // set the poll period of a telemetry field in ms, 0 disables it
+            bool                setBudget(uint32_t budget);                                                 // set the telemetry bus time per window in us, 0 stops polling
+            bool                printTelemetry();                                                           // print the telemetry table and bus usage
 
-            bool                runConsoleCommands(const String& cmd, const String& args);                  // Process console commands for servo control
             bool                printStatus(uint8_t id);                                                    // print the status of a servo for debugging
             bool                printConsoleHelp();                                                         // Print servo-specific help information
+            static const ConsoleCommandTable commandTable;                                                  // Console commands and their help
 //---------------------------------------------------------------------------------------------------------------------------------------------------
         private:
             Driver*             driver;                                                                     // Pointer to Driver instance
+
+            ServoTelemetry      telemetry[SERVO_TELEMETRY_SERVOS];                                          // Polled values per servo, index = ID - 1
+            uint16_t            periods[SERVO_FIELDS];                                                      // Poll period per field in ms
+            uint32_t            budget;                                                                     // Bus time for telemetry per window in us
+            uint32_t            windowStart;                                                                // Start of the current budget window in us
+            uint32_t            windowSpent;                                                                // Bus time used in the current window in us
+            uint32_t            readCost;                                                                   // Running average of one read in us
+            uint32_t            reads;                                                                      // Telemetry reads taken
+            uint32_t            deferred;                                                                   // Due reads left for a later window
+            uint32_t            maxSpent;                                                                   // Most bus time used in one window in us
+
+            uint8_t             limitsHandler   = 0xFF;                                                     // Sync write handler of the angle limits, 0xFF until first used
+            uint8_t             speedHandler    = 0xFF;                                                     // Sync write handler of Moving_Speed
+            uint8_t             torqueHandler   = 0xFF;                                                     // Sync write handler of Torque_Enable and LED
+            bool                addInitHandlers();                                                          // register the sync write handlers used by initServos
+            bool                readStatusLevel(uint8_t id);                                                // read Status_Return_Level into the driver
+            uint32_t            measureRoundTrip(uint8_t id, uint8_t reads, uint8_t* failures);             // average read round trip in us
+            float               measureThroughput(const uint8_t* ids, uint8_t id_num);                      // mixed read and write transactions per second
+
+            bool                isDue(const ServoTelemetry& t, uint8_t field, uint32_t now) const;          // field period has passed since the last attempt
+            bool                hasBudget();                                                                // another read fits in the current window
+            bool                poll(uint8_t id, uint16_t address, uint16_t length, uint32_t* value, uint32_t* time);  // timed read charged to the window
     };
 
 #endif // SERVO_H
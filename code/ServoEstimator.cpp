@@ -0,0 +1,255 @@
+#include "ServoEstimator.h"
+#include "Debug.h"
+
+// Constructor for ServoEstimator class
+ServoEstimator::ServoEstimator() {
+    driver      = nullptr;
+    alpha       = ESTIMATOR_ALPHA;
+    beta        = ESTIMATOR_BETA;
+    reads       = 0;
+    meanSquare  = 0.0f;
+
+    for (uint8_t i = 0; i < ESTIMATOR_SERVOS; i++) {
+        ids[i]                = i + 1;
+        tracks[i].position    = 512.0f;
+        tracks[i].speedBias   = 0.0f;
+        tracks[i].residual    = 0.0f;
+        tracks[i].time        = 0;
+        tracks[i].readTime    = 0;
+        tracks[i].goal        = 512;
+        tracks[i].speed       = 0;
+        tracks[i].torque      = false;
+        tracks[i].valid       = false;
+    }
+}
+
+// Initialize, attach to the driver and take one read of every servo to start from
+bool ServoEstimator::begin(Driver* driver) {
+    if (driver == nullptr) {
+        LOG_ERR("ServoEstimator driver is not initialized.");
+        return false;
+    }
+    this->driver = driver;
+    driver->setEstimator(this);
+
+    uint32_t positions[ESTIMATOR_SERVOS];
+    for (uint8_t i = 0; i < ESTIMATOR_SERVOS; i++) {
+        positions[i] = 0xFFFF;
+    }
+    driver->readRegisters(ids, ESTIMATOR_SERVOS, ESTIMATOR_PRESENT_POSITION, ESTIMATOR_POSITION_LENGTH, positions);
+    uint32_t now = micros();
+    for (uint8_t i = 0; i < ESTIMATOR_SERVOS; i++) {
+        if (positions[i] > 1023) continue;                                          // Not answering, stays invalid until read
+        tracks[i].position = (float)positions[i];
+        tracks[i].time     = now;
+        tracks[i].readTime = now;
+        tracks[i].valid    = true;
+    }
+
+    LOG_INF("ServoEstimator initialized successfully.");
+    return true;
+}
+
+// Goal_Position written
+void ServoEstimator::setGoal(uint8_t id, int32_t position) {
+    ServoTrack* t = track(id);
+    if (t == nullptr) return;
+    rebase(*t, micros());
+    t->goal = (int16_t)position;
+}
+
+// Goal_Position sync written, data holds stride values per ID with the goal first
+void ServoEstimator::setGoals(const uint8_t* ids, uint8_t id_num, const int32_t* data, uint8_t stride) {
+    uint32_t now = micros();
+    for (uint8_t i = 0; i < id_num; i++) {
+        ServoTrack* t = track(ids[i]);
+        if (t == nullptr) continue;
+        rebase(*t, now);
+        t->goal = (int16_t)data[i * stride];
+    }
+}
+
+// Moving_Speed written
+void ServoEstimator::setSpeed(uint8_t id, uint16_t speed) {
+    ServoTrack* t = track(id);
+    if (t == nullptr) return;
+    rebase(*t, micros());
+    t->speed = speed;
+}
+
+// Torque_Enable written. A torqued servo holds its goal register, so enabling torque starts from the
+// goal being where the servo is.
+void ServoEstimator::setTorque(uint8_t id, bool on) {
+    ServoTrack* t = track(id);
+    if (t == nullptr) return;
+    rebase(*t, micros());
+    if (on && !t->torque) t->goal = (int16_t)lroundf(t->position);
+    t->torque    = on;
+    t->speedBias = 0.0f;
+}
+
+// Correct a servo with a position read taken at time. The residual against the prediction moves the
+// position by alpha; while the servo is moving it also moves the speed bias by beta per second of
+// prediction since the last read.
+void ServoEstimator::correct(uint8_t id, uint16_t position, uint32_t time) {
+    ServoTrack* t = track(id);
+    if (t == nullptr || position > 1023) return;
+
+    if (!t->valid) {                                                                // First read: take it as is
+        t->position = (float)position;
+        t->time     = time;
+        t->readTime = time;
+        t->valid    = true;
+        return;
+    }
+
+    float predicted = predict(*t, time);
+    float residual  = (float)position - predicted;
+    float distance  = (float)t->goal - predicted;
+    float interval  = (float)(time - t->readTime) * 1e-6f;
+    bool  moving    = t->torque && fabsf(distance) > ESTIMATOR_DEADBAND;
+
+    if (moving && interval > 0.0f) {
+        float along    = (distance > 0.0f) ? residual : -residual;                  // Positive when the servo is ahead of the model
+        float limit    = (t->speed ? t->speed : ESTIMATOR_MAX_SPEED) * ESTIMATOR_TICKS_PER_SPEED;
+        t->speedBias   = constrain(t->speedBias + beta * along / interval, -limit, limit);
+    } else {
+        t->speedBias  *= 0.5f;                                                      // Arrived or relaxed: forget the bias
+    }
+    t->position  = predicted + alpha * residual;
+    t->time      = time;
+    t->readTime  = time;
+    t->residual  = residual;
+
+    reads++;
+    meanSquare  += 0.05f * (residual * residual - meanSquare);
+}
+
+// Estimated position now
+float ServoEstimator::getPosition(uint8_t id) const {
+    return getPosition(id, micros());
+}
+
+// Estimated position at time
+float ServoEstimator::getPosition(uint8_t id, uint32_t time) const {
+    const ServoTrack* t = track(id);
+    if (t == nullptr) return 0.0f;
+    return predict(*t, time);
+}
+
+// Rounded estimates now, false if any servo is not estimated or has never been read
+bool ServoEstimator::getPositions(const uint8_t* ids, uint8_t id_num, uint16_t* positions) const {
+    uint32_t now     = micros();
+    bool     success = true;
+    for (uint8_t i = 0; i < id_num; i++) {
+        const ServoTrack* t = track(ids[i]);
+        if (t == nullptr || !t->valid) {
+            success = false;
+            continue;
+        }
+        positions[i] = (uint16_t)constrain(lroundf(predict(*t, now)), 0L, 1023L);
+    }
+    return success;
+}
+
+// Time of the last correction in us, 0 if the servo has never been read
+uint32_t ServoEstimator::getReadTime(uint8_t id) const {
+    const ServoTrack* t = track(id);
+    if (t == nullptr || !t->valid) return 0;
+    return t->readTime;
+}
+
+// Set the correction gains
+bool ServoEstimator::setGains(float alpha, float beta) {
+    if (alpha <= 0.0f || alpha > 1.0f || beta < 0.0f || beta > 1.0f) {
+        LOG_ERR("Invalid estimator gains " + String(alpha, 3) + " " + String(beta, 3));
+        return false;
+    }
+    this->alpha = alpha;
+    this->beta  = beta;
+    return true;
+}
+
+// State of a servo ID, nullptr if not estimated
+ServoEstimator::ServoTrack* ServoEstimator::track(uint8_t id) {
+    if (id < 1 || id > ESTIMATOR_SERVOS) return nullptr;
+    return &tracks[id - 1];
+}
+
+const ServoEstimator::ServoTrack* ServoEstimator::track(uint8_t id) const {
+    if (id < 1 || id > ESTIMATOR_SERVOS) return nullptr;
+    return &tracks[id - 1];
+}
+
+// Position of a track at time: towards the goal at the commanded speed plus bias, stopping at the goal
+float ServoEstimator::predict(const ServoTrack& t, uint32_t time) const {
+    if (!t.torque) return t.position;                                               // Relaxed servos are only known from reads
+
+    float distance = (float)t.goal - t.position;
+    float speed    = (t.speed ? t.speed : ESTIMATOR_MAX_SPEED) * ESTIMATOR_TICKS_PER_SPEED + t.speedBias;
+    if (speed < 0.0f) speed = 0.0f;
+    float travel   = speed * (float)(int32_t)(time - t.time) * 1e-6f;
+    if (travel < 0.0f) travel = 0.0f;                                               // Time before the state: no extrapolation backwards
+    if (travel >= fabsf(distance)) return (float)t.goal;
+    return t.position + ((distance > 0.0f) ? travel : -travel);
+}
+
+// Move a track's state to time, keeping its prediction
+void ServoEstimator::rebase(ServoTrack& t, uint32_t time) {
+    t.position = predict(t, time);
+    t.time     = time;
+}
+
+// Print estimator status
+bool ServoEstimator::printStatus() {
+    PRINTLN("ServoEstimator Status: \n\r");
+    PRINTLN("Gains            : alpha " + String(alpha, 3) + " | beta " + String(beta, 3));
+    PRINTLN("Reads            : " + String(reads) + " | rms residual " + String(sqrtf(meanSquare), 2) + " ticks");
+    uint32_t now = micros();
+    for (uint8_t i = 0; i < ESTIMATOR_SERVOS; i++) {
+        const ServoTrack& t = tracks[i];
+        PRINTLN("ID " + String(i + 1) + (i < 9 ? " " : "") + "            : " + String(predict(t, now), 1)
+                + " | goal " + String(t.goal) + " | speed " + String(t.speed) + " | bias " + String(t.speedBias, 1)
+                + " | residual " + String(t.residual, 1) + " | read " + String((now - t.readTime) / 1000) + " ms ago"
+                + (t.valid ? "" : " | no read") + (t.torque ? "" : " | relaxed"));
+    }
+    return true;
+}
+
+// os: Print the estimated servo positions
+static bool showEstimates(void* estimator, const CommandArgs&) {
+    return static_cast<ServoEstimator*>(estimator)->printStatus();
+}
+
+// og [a] [b]: Set the correction gains
+static bool setEstimatorGains(void* estimator, const CommandArgs& args) {
+    if (args.count() < 2) {
+        LOG_ERR("Usage: og [alpha] [beta]");
+        return false;
+    }
+    float a = atof(args.get(0));
+    float b = atof(args.get(1));
+    if (!static_cast<ServoEstimator*>(estimator)->setGains(a, b)) return false;
+    LOG_INF("Estimator gains set to " + String(a, 3) + " " + String(b, 3));
+    return true;
+}
+
+// o?: Print the estimator help
+static bool showEstimatorHelp(void* estimator, const CommandArgs&) {
+    return static_cast<ServoEstimator*>(estimator)->printConsoleHelp();
+}
+
+// Console commands, the help is printed from this table
+static const ConsoleCommand estimatorCommands[] = {
+    { "os",     "",        "Show estimated servo positions",                        showEstimates },
+    { "og",     "[a] [b]", "Set alpha and beta correction gains (default 0.5 0.1)", setEstimatorGains },
+    { "o?",     "",        "Show this help",                                        showEstimatorHelp },
+};
+const ConsoleCommandTable ServoEstimator::commandTable = { "Servo Estimator Commands:", estimatorCommands, sizeof(estimatorCommands) / sizeof(estimatorCommands[0]) };
+
+// Print estimator help information
+bool ServoEstimator::printConsoleHelp() {
+    return CommandRegistry::printHelp(commandTable);
+}
+
+// end of ServoEstimator.cpp
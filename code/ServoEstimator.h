@@ -0,0 +1,74 @@
+#ifndef SERVOESTIMATOR_H
+#define SERVOESTIMATOR_H
+
+    #include <Arduino.h>
+    #include "Driver.h"
+    #include "CommandRegistry.h"
+
+    #define ESTIMATOR_SERVOS            uint8_t(20)         // Servo IDs 1 to 20 are estimated
+    #define ESTIMATOR_PRESENT_POSITION  uint16_t(36)        // AX-18A Present_Position address
+    #define ESTIMATOR_POSITION_LENGTH   uint16_t(2)         // AX-18A Present_Position length
+    #define ESTIMATOR_TICKS_PER_SPEED   float(2.27)         // Position ticks per second per Moving_Speed unit (0.111 rpm)
+    #define ESTIMATOR_MAX_SPEED         uint16_t(1023)      // Moving_Speed used for 0, which means no speed limit
+    #define ESTIMATOR_DEADBAND          float(2.0)          // Distance to the goal in ticks treated as arrived
+    #define ESTIMATOR_ALPHA             float(0.5)          // Position correction gain, 0 to 1
+    #define ESTIMATOR_BETA              float(0.1)          // Speed bias correction gain, 0 to 1
+
+    // Predicts servo positions between sparse reads. Every Goal_Position, Moving_Speed and Torque_Enable
+    // write through the Driver is passed here, so each servo is modelled as moving to its goal at its
+    // commanded speed plus a learned speed bias (servos under load run slower than commanded). This is an
+    // alpha-beta filter: alpha corrects the position and beta the speed bias from the residual of each read.
+    // The estimator reads the bus only in begin(); the state stage feeds it the reads it takes, so positions
+    // are available at any time without bus traffic from the caller.
+    class ServoEstimator {
+        public:
+            ServoEstimator();                                                       // Constructor
+            bool            begin(Driver* driver);                                  // Initialize and attach to the driver
+
+            // Command hooks, called by the Driver on successful writes
+            void            setGoal(uint8_t id, int32_t position);                  // Goal_Position written
+            void            setGoals(const uint8_t* ids, uint8_t id_num, const int32_t* data, uint8_t stride);   // Goal_Position sync written
+            void            setSpeed(uint8_t id, uint16_t speed);                   // Moving_Speed written
+            void            setTorque(uint8_t id, bool on);                         // Torque_Enable written, a relaxed servo only follows reads
+            void            correct(uint8_t id, uint16_t position, uint32_t time);  // Feed a position read taken at time (us)
+
+            float           getPosition(uint8_t id) const;                          // Estimated position now in ticks
+            float           getPosition(uint8_t id, uint32_t time) const;           // Estimated position at time (us)
+            bool            getPositions(const uint8_t* ids, uint8_t id_num, uint16_t* positions) const;  // Rounded estimates now
+            uint32_t        getReadTime(uint8_t id) const;                          // Time of the last correction in us, 0 if never read
+            bool            setGains(float alpha, float beta);                      // Set the correction gains
+
+            bool            printStatus();                                          // Print estimator status
+            bool            printConsoleHelp();                                     // Print estimator help information
+            static const ConsoleCommandTable commandTable;                          // Console commands and their help
+
+        private:
+            // State of one servo, rebased to the present at every command and correction
+            struct ServoTrack {
+                float       position;                                               // Position at time in ticks
+                float       speedBias;                                              // Learned speed error along the motion in ticks/s
+                float       residual;                                               // Last read minus prediction in ticks
+                uint32_t    time;                                                   // Time of position in us
+                uint32_t    readTime;                                               // Time of the last correction in us
+                int16_t     goal;                                                   // Commanded goal position
+                uint16_t    speed;                                                  // Commanded Moving_Speed
+                bool        torque;                                                 // Torque enabled, the servo follows its goal
+                bool        valid;                                                  // At least one read has been taken
+            };
+
+            Driver*         driver;                                                 // Pointer to the driver instance
+            ServoTrack      tracks[ESTIMATOR_SERVOS];                               // State per servo, index = ID - 1
+            uint8_t         ids[ESTIMATOR_SERVOS];                                  // Servo IDs 1 to 20
+            float           alpha;                                                  // Position correction gain
+            float           beta;                                                   // Speed bias correction gain
+
+            uint32_t        reads;                                                  // Corrections applied
+            float           meanSquare;                                             // Running mean of squared residuals
+
+            ServoTrack*     track(uint8_t id);                                      // State of a servo ID, nullptr if not estimated
+            const ServoTrack* track(uint8_t id) const;
+            float           predict(const ServoTrack& t, uint32_t time) const;      // Position of a track at time
+            void            rebase(ServoTrack& t, uint32_t time);                   // Move a track's state to time
+    };
+
+#endif // SERVOESTIMATOR_H
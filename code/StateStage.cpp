@@ -0,0 +1,249 @@
+#include "StateStage.h"
+#include "ServoEstimator.h"
+#include "Console.h"
+#include "Debug.h"
+
+// Constructor for StateStage class
+StateStage::StateStage() {
+    driver          = nullptr;
+    servo           = nullptr;
+    sensor          = nullptr;
+    mc              = nullptr;
+    maxUpdateTime   = 0;
+    sensorErrors    = 0;
+    loadMask        = 0;
+    loadErrors      = 0;
+    nextPosition    = 0;
+    positionErrors  = 0;
+    memset(&state, 0, sizeof(state));
+    memset(motion, 0, sizeof(motion));
+}
+
+// Initialize with the modules that own the bus data and publish the snapshot through the driver
+bool StateStage::begin(Driver* driver, Servo* servo, AXS1Sensor* sensor, Microcontroller* mc) {
+    if (driver == nullptr || servo == nullptr || mc == nullptr) {
+        LOG_ERR("StateStage dependencies are not initialized.");
+        return false;
+    }
+    this->driver    = driver;
+    this->servo     = servo;
+    this->sensor    = sensor;
+    this->mc        = mc;
+    driver->setState(&state);
+
+    LOG_INF("StateStage initialized successfully.");
+    return true;
+}
+
+// Refresh the snapshot. Outside the motion player and recorder, which drive the servos while the gait is
+// held, this is the only place the main loop reads servo state, the AX-S1 and the battery, so each is
+// read at most once per tick however many modules use it.
+bool StateStage::update() {
+    uint32_t now = micros();
+    refreshServos(now);
+    refreshSensor(now);
+    refreshBattery(now);
+    state.time = now;
+    state.sequence++;
+
+    uint32_t elapsed = micros() - now;
+    if (elapsed > maxUpdateTime) maxUpdateTime = elapsed;
+    return true;
+}
+
+// Latest snapshot
+const RobotState& StateStage::get() const {
+    return state;
+}
+
+// Longest refresh in us
+uint32_t StateStage::getMaxUpdateTime() const {
+    return maxUpdateTime;
+}
+
+// Servos whose Present_Load is read in one pass every update, foot contact sets it while walking
+void StateStage::setLoadMask(uint32_t mask) {
+    loadMask = mask & ((1UL << STATE_SERVOS) - 1);
+}
+
+// Poll servo telemetry within its budget, then take positions from the estimator when there is one
+// (estimated at the snapshot time) and from the last telemetry read otherwise
+void StateStage::refreshServos(uint32_t now) {
+    if (driver->getProtocol(1) == 2) {
+        refreshMotion();
+        return;
+    }
+    refreshEstimates();
+    refreshLoads(now);
+
+    ServoEstimator* estimator = driver->getEstimator();
+    for (uint8_t i = 0; i < STATE_SERVOS; i++) {
+        uint8_t id = i + 1;
+        servo->update(id);
+
+        const ServoTelemetry* t = servo->getTelemetry(id);
+        uint32_t bit            = 1UL << i;
+        uint32_t readTime       = t->time[SERVO_POSITION];
+        uint32_t estimateTime   = (estimator != nullptr) ? estimator->getReadTime(id) : 0;
+
+        if (estimateTime != 0) {
+            state.position[i]   = (uint16_t)constrain(lroundf(estimator->getPosition(id, now)), 0L, 1023L);
+            if ((int32_t)(estimateTime - readTime) > 0) readTime = estimateTime;
+        } else if (readTime != 0) {
+            state.position[i]   = t->position;
+        }
+        if (readTime != 0) state.positionValid |= bit;
+        state.positionTime[i]   = readTime;
+
+        if (!(loadMask & bit) && (int32_t)(t->time[SERVO_LOAD] - state.loadTime[i]) > 0) {  // Masked loads come from the load pass only
+            state.load[i]       = t->load;
+            state.loadTime[i]   = t->time[SERVO_LOAD];
+        }
+        state.voltage[i]        = t->voltage;
+        state.temperature[i]    = t->temperature;
+        state.healthTime[i]     = t->time[SERVO_VOLTAGE];
+    }
+}
+
+// Read the next STATE_POSITION_READS positions and correct the estimator with them, so estimates stay
+// close between telemetry polls. Nothing is read without an estimator.
+void StateStage::refreshEstimates() {
+    ServoEstimator* estimator = driver->getEstimator();
+    if (estimator == nullptr) return;
+    for (uint8_t n = 0; n < STATE_POSITION_READS; n++) {
+        uint8_t  id    = nextPosition + 1;
+        uint32_t value = 0;
+        uint32_t start = micros();
+        if (driver->readRegisters(&id, 1, SERVO_PRESENT_POSITION, 2, &value)) {
+            estimator->correct(id, (uint16_t)value, start + (micros() - start) / 2);  // Stamp the read at the middle of the transfer
+        } else {
+            positionErrors++;
+        }
+        nextPosition = (nextPosition + 1) % STATE_SERVOS;
+    }
+}
+
+// Read Present_Load of every servo in the load mask back to back. All loads of one pass are stamped
+// with the pass time, servos that do not answer keep their last load and time.
+void StateStage::refreshLoads(uint32_t now) {
+    if (loadMask == 0) return;
+    uint8_t  ids[STATE_SERVOS];
+    uint32_t loads[STATE_SERVOS];
+    uint8_t  count = 0;
+    for (uint8_t i = 0; i < STATE_SERVOS; i++) {
+        if (!(loadMask & (1UL << i))) continue;
+        ids[count]   = i + 1;
+        loads[count] = 0xFFFF;                                                      // Loads are 11 bits, this marks no answer
+        count++;
+    }
+    if (!driver->readRegisters(ids, count, SERVO_PRESENT_LOAD, 2, loads)) loadErrors++;
+    for (uint8_t n = 0; n < count; n++) {
+        if (loads[n] > 0x7FF) continue;
+        state.load[ids[n] - 1]      = (uint16_t)loads[n];
+        state.loadTime[ids[n] - 1]  = now;
+    }
+}
+
+// Read position, load and moving state of every servo in one sync read and copy those that answered
+void StateStage::refreshMotion() {
+    uint8_t ids[STATE_SERVOS];
+    for (uint8_t i = 0; i < STATE_SERVOS; i++) {
+        ids[i] = i + 1;
+    }
+    driver->readMotion(ids, STATE_SERVOS, motion);
+    ServoEstimator* estimator = driver->getEstimator();
+    for (uint8_t i = 0; i < STATE_SERVOS; i++) {
+        const ServoMotion& m = motion[i];
+        uint32_t bit         = 1UL << i;
+        if (m.time == 0) continue;
+        if (estimator != nullptr && m.time != state.positionTime[i]) {              // A failed read keeps its time, feed each read once
+            estimator->correct(i + 1, (uint16_t)constrain(m.position, 0L, 65535L), m.time);
+        }
+        state.position[i]       = (uint16_t)constrain(m.position, 0L, 65535L);
+        state.load[i]           = (uint16_t)m.load;
+        state.positionTime[i]   = m.time;
+        state.loadTime[i]       = m.time;
+        state.positionValid    |= bit;
+        if (m.moving) state.moving |= bit;
+        else          state.moving &= ~bit;
+    }
+}
+
+// Read the AX-S1 distance, light, detection and sound registers when due
+void StateStage::refreshSensor(uint32_t now) {
+    if (sensor == nullptr) return;
+    if (state.sensorTime != 0 && now - state.sensorTime < (uint32_t)STATE_SENSOR_PERIOD * 1000) return;
+
+    uint8_t data[AXS1_SENSOR_BLOCK];
+    if (!sensor->readSensors(data)) {
+        sensorErrors++;
+        state.sensorTime = now;                                                     // Retry after a period, not every tick
+        return;
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        state.distance[i]   = data[i];
+        state.light[i]      = data[AXS1_Light_Left_Data - AXS1_Left_Distance_Data + i];
+    }
+    state.obstacle          = data[AXS1_IR_Obstacle_Detected - AXS1_Left_Distance_Data];
+    state.lightDetected     = data[AXS1_Light_Detected - AXS1_Left_Distance_Data];
+    state.sound             = data[AXS1_Sound_Data - AXS1_Left_Distance_Data];
+    state.sensorTime        = now;
+}
+
+// Read the battery voltage when due
+void StateStage::refreshBattery(uint32_t now) {
+    if (state.batteryTime != 0 && now - state.batteryTime < (uint32_t)STATE_BATTERY_PERIOD * 1000) return;
+    state.battery       = mc->getBatteryVoltage();
+    state.batteryTime   = now;
+}
+
+// Print the snapshot
+bool StateStage::printStatus() {
+    uint32_t now = micros();
+    PRINTLN("Robot State: \n\r");
+    PRINTLN("Snapshot         : #" + String(state.sequence) + " | " + String((now - state.time) / 1000) + " ms ago | max refresh " + String(maxUpdateTime) + " us");
+    PRINTLN("Battery          : " + String(state.battery, 2) + " V");
+    PRINTLN("Bus Reads        : position errors " + String(positionErrors) + " | load mask 0x" + String(loadMask, HEX)
+            + " | load errors " + String(loadErrors));
+    if (sensor != nullptr) {
+        PRINTLN("AX-S1            : distance " + String(state.distance[0]) + " " + String(state.distance[1]) + " " + String(state.distance[2])
+                + " | light " + String(state.light[0]) + " " + String(state.light[1]) + " " + String(state.light[2])
+                + " | obstacle 0x" + String(state.obstacle, HEX) + " | light detected 0x" + String(state.lightDetected, HEX)
+                + " | sound " + String(state.sound) + " | errors " + String(sensorErrors));
+    }
+    for (uint8_t i = 0; i < STATE_SERVOS; i++) {
+        String line = "ID " + String(i + 1) + (i < 9 ? " " : "") + "            : ";
+        if (!(state.positionValid & (1UL << i))) {
+            PRINTLN(line + "no position");
+            continue;
+        }
+        PRINTLN(line + "pos " + String(state.position[i]) + " | load " + String(state.load[i] & 0x3FF)
+                + " | " + String((float)state.voltage[i] / 10, 1) + " V | " + String(state.temperature[i]) + " °C"
+                + " | read " + String((state.time - state.positionTime[i]) / 1000) + " ms before");
+    }
+    return true;
+}
+
+// ys: Print the snapshot
+static bool showState(void* stage, const CommandArgs&) {
+    return static_cast<StateStage*>(stage)->printStatus();
+}
+
+// y?: Print the state stage help
+static bool showStateHelp(void* stage, const CommandArgs&) {
+    return static_cast<StateStage*>(stage)->printConsoleHelp();
+}
+
+// Console commands, the help is printed from this table
+static const ConsoleCommand stateCommands[] = {
+    { "ys",     "", "Show the robot state snapshot",    showState },
+    { "y?",     "", "Show this help",                   showStateHelp },
+};
+const ConsoleCommandTable StateStage::commandTable = { "Robot State Commands:", stateCommands, sizeof(stateCommands) / sizeof(stateCommands[0]) };
+
+// Print state stage help information
+bool StateStage::printConsoleHelp() {
+    return CommandRegistry::printHelp(commandTable);
+}
+
+// end of StateStage.cpp
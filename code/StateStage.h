@@ -0,0 +1,87 @@
+#ifndef STATESTAGE_H
+#define STATESTAGE_H
+
+    #include <Arduino.h>
+    #include "Driver.h"
+    #include "Servo.h"
+    #include "AXS1Sensor.h"
+    #include "Microcontroller.h"
+    #include "CommandRegistry.h"
+
+    #define STATE_SERVOS                SERVO_TELEMETRY_SERVOS  // Servo IDs 1 to 20 are in the snapshot
+    #define STATE_SENSOR_PERIOD         uint16_t(100)       // AX-S1 read period in ms
+    #define STATE_BATTERY_PERIOD        uint16_t(500)       // Battery ADC read period in ms
+    #define STATE_POSITION_READS        uint8_t(4)          // Present_Position reads per update for the estimator, rotating through the servos
+
+    // Whole robot state at one instant. Servo fields are arrays indexed by ID - 1 so a reader walking
+    // one field touches consecutive memory, and the positions every reader needs come first. Times are
+    // of the last bus read behind each value in us, 0 when never read.
+    struct RobotState {
+        uint32_t    time;                                   // Snapshot time in us
+        uint32_t    sequence;                               // Incremented on every refresh
+        uint32_t    positionValid;                          // Bit per servo (bit 0 = ID 1), set when position is known
+        uint32_t    moving;                                 // Bit per servo, set while its Moving register reads 1 (Protocol 2.0 bus only)
+        uint16_t    position[STATE_SERVOS];                 // Servo positions at time in ticks
+        uint16_t    load[STATE_SERVOS];                     // Present_Load, bit 10 is the direction
+        uint8_t     voltage[STATE_SERVOS];                  // Present_Voltage in 0.1 V
+        uint8_t     temperature[STATE_SERVOS];              // Present_Temperature in °C
+
+        uint8_t     distance[3];                            // AX-S1 IR distance left, center, right
+        uint8_t     light[3];                               // AX-S1 light left, center, right
+        uint8_t     obstacle;                               // AX-S1 obstacle detected bits
+        uint8_t     lightDetected;                          // AX-S1 light detected bits
+        uint8_t     sound;                                  // AX-S1 sound level
+        float       battery;                                // Battery voltage in V
+
+        uint32_t    positionTime[STATE_SERVOS];             // Last position read per servo
+        uint32_t    loadTime[STATE_SERVOS];                 // Last load read per servo
+        uint32_t    healthTime[STATE_SERVOS];               // Last voltage and temperature read per servo
+        uint32_t    sensorTime;                             // Last AX-S1 read
+        uint32_t    batteryTime;                            // Last battery read
+    };
+
+    // The one I/O stage of the main loop. Every update polls servo telemetry within its bus budget, reads a
+    // few positions round-robin to correct the estimator, reads Present_Load of the servos in the load mask
+    // in one pass, reads the AX-S1 and the battery when due, and copies the results and the estimated
+    // positions into a RobotState. The snapshot is published through the Driver, so foot contact, the
+    // console, turret and legs read it instead of reading the bus themselves. On a Protocol 2.0 servo bus
+    // position, load and moving state of all servos come from one sync read per update instead.
+    // Not for the control tick ISR, which would see the snapshot half written.
+    class StateStage {
+        public:
+            StateStage();                                                           // Constructor
+            bool            begin(Driver* driver, Servo* servo, AXS1Sensor* sensor, Microcontroller* mc);  // Initialize and publish the snapshot
+            bool            update();                                               // Refresh the snapshot, call every STATE_TASK_PERIOD
+
+            const RobotState& get() const;                                          // Latest snapshot
+            void            setLoadMask(uint32_t mask);                             // Servos whose Present_Load is read every update, bit 0 = ID 1
+            uint32_t        getMaxUpdateTime() const;                               // Longest refresh in us
+
+            bool            printStatus();                                          // Print the snapshot
+            bool            printConsoleHelp();                                     // Print state stage help information
+            static const ConsoleCommandTable commandTable;                          // Console commands and their help
+
+        private:
+            Driver*         driver;                                                 // Pointer to the driver instance
+            Servo*          servo;                                                  // Polls servo telemetry
+            AXS1Sensor*     sensor;                                                 // AX-S1 sensor, nullptr if not fitted
+            Microcontroller* mc;                                                    // Battery ADC
+
+            RobotState      state;                                                  // Latest snapshot
+            uint32_t        maxUpdateTime;                                          // Longest refresh in us
+            uint32_t        sensorErrors;                                           // Failed AX-S1 reads
+            uint32_t        loadMask;                                               // Servos whose Present_Load is read every update
+            uint32_t        loadErrors;                                             // Load passes with a servo not answering
+            uint8_t         nextPosition;                                           // Index of the next servo read for the estimator
+            uint32_t        positionErrors;                                         // Failed estimator position reads
+            ServoMotion     motion[STATE_SERVOS];                                   // Last sync read of a Protocol 2.0 bus
+
+            void            refreshServos(uint32_t now);                            // Poll telemetry and copy servo fields
+            void            refreshEstimates();                                     // Read the next positions round-robin and correct the estimator
+            void            refreshLoads(uint32_t now);                             // Read Present_Load of the servos in the load mask
+            void            refreshMotion();                                        // Sync read all servos on a Protocol 2.0 bus
+            void            refreshSensor(uint32_t now);                            // Read the AX-S1 when due
+            void            refreshBattery(uint32_t now);                           // Read the battery when due
+    };
+
+#endif // STATESTAGE_H
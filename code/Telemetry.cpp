@@ -0,0 +1,168 @@
+#include "Telemetry.h"
+#include "Debug.h"
+
+// Constructor for Telemetry class
+Telemetry::Telemetry() {
+    stateStage  = nullptr;
+    gc          = nullptr;
+    controlTick = nullptr;
+    scheduler   = nullptr;
+    rate        = 0;
+    task        = SCHEDULER_INVALID_TASK;
+    sequence    = 0;
+    sent        = 0;
+    dropped     = 0;
+}
+
+// Initialize with the modules the frames report on. The gait, control tick and scheduler are optional
+// and their fields stay 0 without them.
+bool Telemetry::begin(StateStage* stateStage, GaitController* gc, ControlTick* controlTick, Scheduler* scheduler, uint8_t rate) {
+    if (stateStage == nullptr) {
+        LOG_ERR("Telemetry needs the state stage.");
+        return false;
+    }
+    this->stateStage    = stateStage;
+    this->gc            = gc;
+    this->controlTick   = controlTick;
+    this->scheduler     = scheduler;
+    if (!setRate(rate)) return false;
+
+    LOG_INF("Telemetry initialized successfully.");
+    return true;
+}
+
+// Queue one frame. The telemetry task is released at the set rate at its own priority, so frames
+// keep their period while the console is busy and a task that falls behind skips, not bursts.
+bool Telemetry::update() {
+    if (rate == 0) return true;                                                     // Task re-enabled by hand with 'ke'
+
+    TelemetryRecord r;
+    fill(r);
+    uint16_t length = telemetryEncode(r, frame);
+    if (log::write(frame, length)) {
+        sent++;
+    } else {
+        dropped++;
+    }
+    sequence++;                                                                     // A dropped frame leaves a gap the decoder reports
+    return true;
+}
+
+// Let a scheduler task send the frames, the current rate is applied to it
+bool Telemetry::attachTask(uint8_t task) {
+    if (scheduler == nullptr || scheduler->getTask(task) == nullptr) {
+        LOG_ERR("Telemetry task is not registered.");
+        return false;
+    }
+    this->task = task;
+    return setRate(rate);
+}
+
+// Set the frame rate as the task period, 0 disables the task
+bool Telemetry::setRate(uint8_t rate) {
+    if (rate > TELEMETRY_MAX_RATE) {
+        LOG_ERR("Telemetry rate must be 0 to " + String(TELEMETRY_MAX_RATE) + " Hz");
+        return false;
+    }
+    this->rate = rate;
+    if (task == SCHEDULER_INVALID_TASK) return true;                               // Applied by attachTask()
+    if (rate == 0) return scheduler->setTaskEnabled(task, false);
+    return scheduler->setTaskPeriod(task, 1000000UL / rate) && scheduler->setTaskEnabled(task, true);
+}
+
+// Get the frame rate
+uint8_t Telemetry::getRate() const {
+    return rate;
+}
+
+// Collect the snapshot, gait and timing fields of one record
+void Telemetry::fill(TelemetryRecord& r) {
+    memset(&r, 0, sizeof(r));
+    const RobotState& s = stateStage->get();
+
+    r.sequence      = sequence;
+    r.time          = s.time;
+    r.positionValid = s.positionValid;
+    r.moving        = s.moving;
+    for (uint8_t i = 0; i < TELEMETRY_SERVOS && i < STATE_SERVOS; i++) {
+        r.position[i]       = s.position[i];
+        r.load[i]           = s.load[i];
+        r.temperature[i]    = s.temperature[i];
+        r.voltage[i]        = s.voltage[i];
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        r.distance[i]   = s.distance[i];
+        r.light[i]      = s.light[i];
+    }
+    r.obstacle      = s.obstacle;
+    r.lightDetected = s.lightDetected;
+    r.sound         = s.sound;
+    r.battery       = (uint16_t)lroundf(s.battery * 1000.0f);
+    r.stateMax      = (uint16_t)min(stateStage->getMaxUpdateTime(), (uint32_t)0xFFFF);
+    r.dropped       = (uint16_t)dropped;
+
+    if (gc != nullptr) {
+        r.gaitType  = (uint8_t)gc->getGaitType();
+        r.gaitPhase = (uint16_t)(gc->getPhase() * 65536.0f);
+        r.duty      = (uint16_t)lroundf(gc->getDutyFactor() * 1000.0f);
+    }
+    if (controlTick != nullptr) {
+        r.tickMax       = (uint16_t)min(controlTick->getMaxTickTime(), (uint32_t)0xFFFF);
+        r.tickOverruns  = (uint16_t)controlTick->getOverruns();
+    }
+    if (scheduler != nullptr) {
+        uint32_t lateness = 0;
+        for (uint8_t i = 0; i < scheduler->getTaskCount(); i++) {
+            const SchedulerTask* t = scheduler->getTask(i);
+            if (t->period != SCHEDULER_IDLE && t->maxLateness > lateness) lateness = t->maxLateness;
+        }
+        r.latenessMax = (uint16_t)min(lateness, (uint32_t)0xFFFF);
+    }
+}
+
+// Print the stream settings and counters
+bool Telemetry::printStatus() {
+    PRINTLN("Telemetry Status:\n\r");
+    PRINTLN("Rate             : " + String(rate) + " Hz" + (rate == 0 ? " (off)" : ""));
+    PRINTLN("Frame            : " + String(TELEMETRY_FRAME_MAX) + " bytes, version " + String(TELEMETRY_VERSION)
+            + " | " + String((uint32_t)rate * TELEMETRY_FRAME_MAX) + " bytes/s");
+    PRINTLN("Frames           : " + String(sent) + " sent | " + String(dropped) + " dropped | next #" + String(sequence));
+    return true;
+}
+
+// xs: Print the stream settings and counters
+static bool showTelemetry(void* telemetry, const CommandArgs&) {
+    return static_cast<Telemetry*>(telemetry)->printStatus();
+}
+
+// xr [hz]: Set the frame rate, 0 stops the stream
+static bool setTelemetryRate(void* telemetry, const CommandArgs& args) {
+    long value = args.toInt(0, -1);
+    if (value < 0 || value > TELEMETRY_MAX_RATE) {
+        LOG_ERR("Usage: xr [0-" + String(TELEMETRY_MAX_RATE) + "]");
+        return false;
+    }
+    if (!static_cast<Telemetry*>(telemetry)->setRate((uint8_t)value)) return false;
+    LOG_INF("Telemetry rate set to " + String(value) + " Hz");
+    return true;
+}
+
+// x?: Print the telemetry help
+static bool showTelemetryHelp(void* telemetry, const CommandArgs&) {
+    return static_cast<Telemetry*>(telemetry)->printConsoleHelp();
+}
+
+// Console commands, the help is printed from this table
+static const ConsoleCommand telemetryCommands[] = {
+    { "xs",     "",     "Show telemetry status",                                                           showTelemetry },
+    { "xr",     "[hz]", "Stream binary frames at 1-100 Hz on this port, 0 stops; decode a capture with tlm/", setTelemetryRate },
+    { "x?",     "",     "Show this help",                                                                  showTelemetryHelp },
+};
+const ConsoleCommandTable Telemetry::commandTable = { "Telemetry Commands:", telemetryCommands, sizeof(telemetryCommands) / sizeof(telemetryCommands[0]) };
+
+// Print telemetry help information
+bool Telemetry::printConsoleHelp() {
+    return CommandRegistry::printHelp(commandTable);
+}
+
+// end of Telemetry.cpp
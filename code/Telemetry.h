@@ -0,0 +1,49 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+    #include <Arduino.h>
+    #include "TelemetryFormat.h"
+    #include "StateStage.h"
+    #include "GaitController.h"
+    #include "ControlTick.h"
+    #include "Scheduler.h"
+    #include "CommandRegistry.h"
+
+    #define TELEMETRY_MAX_RATE      uint8_t(100)        // Highest frame rate in Hz
+
+    // Binary telemetry on the console stream. At the set rate, the latest robot state snapshot, the gait
+    // phase and the loop timing are packed into one CRC-checked frame (see TelemetryFormat.h) and queued
+    // in the console output ring, so a frame costs about 170 bytes of copying and never waits for the
+    // link. A frame that does not fit is dropped and counted. tlm/ decodes a capture of the stream to CSV.
+    class Telemetry {
+        public:
+            Telemetry();                                                            // Constructor
+            bool            begin(StateStage* stateStage, GaitController* gc,       // Initialize with the modules it reports on
+                                  ControlTick* controlTick, Scheduler* scheduler, uint8_t rate = 0);
+            bool            update();                                               // Queue one frame, call from the task given to attachTask()
+            bool            attachTask(uint8_t task);                               // Scheduler task whose period and enable follow the rate
+
+            bool            setRate(uint8_t rate);                                  // Frames per second, 0 disables the task
+            uint8_t         getRate() const;
+
+            bool            printStatus();                                          // Print the stream settings and counters
+            bool            printConsoleHelp();                                     // Print telemetry help information
+            static const ConsoleCommandTable commandTable;                          // Console commands and their help
+
+        private:
+            StateStage*     stateStage;                                             // Robot state snapshot
+            GaitController* gc;                                                     // Gait type, phase and duty
+            ControlTick*    controlTick;                                            // Control tick timing
+            Scheduler*      scheduler;                                              // Task release latency
+
+            uint8_t         rate;                                                   // Frames per second, 0 = off
+            uint8_t         task;                                                   // Scheduler task sending the frames
+            uint16_t        sequence;                                               // Next frame number
+            uint32_t        sent;                                                   // Frames queued
+            uint32_t        dropped;                                                // Frames the output ring had no room for
+            uint8_t         frame[TELEMETRY_FRAME_MAX];                             // Frame being sent
+
+            void            fill(TelemetryRecord& r);                               // Collect one record
+    };
+
+#endif // TELEMETRY_H
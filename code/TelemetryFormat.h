@@ -0,0 +1,168 @@
+#ifndef TELEMETRYFORMAT_H
+#define TELEMETRYFORMAT_H
+
+    // Binary telemetry frame format, shared by the firmware and the host decoder in tlm/.
+    // Depends only on <stdint.h> so the host tool decodes with the same code the firmware encodes with.
+    //
+    // Frame, all fields little-endian:
+    //
+    //   0xA5 0x5A  version:8  type:8  length:16  payload[length]  crc:16
+    //
+    // The CRC-16/CCITT (polynomial 0x1021, initial 0xFFFF) covers version through the last payload
+    // byte. Frames share the console with text, so a reader hunts for the sync bytes and skips anything
+    // whose CRC does not match. A new field is appended to the payload and bumps the version; decoders
+    // accept a longer payload than they know and ignore the rest.
+    //
+    // TELEMETRY_STATE payload, version 1:
+    //
+    //   sequence:16 time:32 positionValid:32 moving:32
+    //   position:16 x 20  load:16 x 20  temperature:8 x 20  voltage:8 x 20
+    //   gaitType:8 gaitPhase:16 duty:16
+    //   distance:8 x 3  light:8 x 3  obstacle:8 lightDetected:8 sound:8  battery:16
+    //   tickMax:16 tickOverruns:16 stateMax:16 latenessMax:16 dropped:16
+    //
+    // gaitPhase is in 1/65536 cycle, duty in 1/1000, battery in mV, timing in us. Counters wrap.
+
+    #include <stdint.h>
+
+    #define TELEMETRY_SYNC0         uint8_t(0xA5)       // First sync byte
+    #define TELEMETRY_SYNC1         uint8_t(0x5A)       // Second sync byte
+    #define TELEMETRY_VERSION       uint8_t(1)          // Version of the payload layout
+    #define TELEMETRY_STATE         uint8_t(1)          // Record type: robot state snapshot
+    #define TELEMETRY_SERVOS        uint8_t(20)         // Servo IDs 1 to 20
+    #define TELEMETRY_HEADER        uint16_t(6)         // Sync, version, type and length
+    #define TELEMETRY_STATE_LENGTH  uint16_t(160)       // Payload bytes of a version 1 state record
+    #define TELEMETRY_FRAME_MAX     uint16_t(TELEMETRY_HEADER + TELEMETRY_STATE_LENGTH + 2)
+    #define TELEMETRY_PAYLOAD_MAX   uint16_t(1024)      // Longest payload any version may use, longer lengths are not a frame
+
+    // One state record, unpacked
+    struct TelemetryRecord {
+        uint16_t    sequence;                               // Frame counter, a gap means frames were lost
+        uint32_t    time;                                   // Snapshot time in us
+        uint32_t    positionValid;                          // Bit per servo (bit 0 = ID 1)
+        uint32_t    moving;                                 // Bit per servo
+        uint16_t    position[TELEMETRY_SERVOS];             // Positions in ticks
+        uint16_t    load[TELEMETRY_SERVOS];                 // Present_Load, bit 10 is the direction
+        uint8_t     temperature[TELEMETRY_SERVOS];          // °C
+        uint8_t     voltage[TELEMETRY_SERVOS];              // 0.1 V
+        uint8_t     gaitType;                               // GaitType
+        uint16_t    gaitPhase;                              // Oscillator phase in 1/65536 cycle
+        uint16_t    duty;                                   // Duty factor in 1/1000
+        uint8_t     distance[3];                            // AX-S1 IR distance left, center, right
+        uint8_t     light[3];                               // AX-S1 light left, center, right
+        uint8_t     obstacle;                               // AX-S1 obstacle detected bits
+        uint8_t     lightDetected;                          // AX-S1 light detected bits
+        uint8_t     sound;                                  // AX-S1 sound level
+        uint16_t    battery;                                // Battery voltage in mV
+        uint16_t    tickMax;                                // Longest control tick in us
+        uint16_t    tickOverruns;                           // Control ticks longer than their period
+        uint16_t    stateMax;                               // Longest state refresh in us
+        uint16_t    latenessMax;                            // Longest scheduler release-to-start delay in us
+        uint16_t    dropped;                                // Frames the firmware could not queue
+    };
+
+    // CRC-16/CCITT of a byte run, bitwise: 168 bytes at 100 Hz do not justify a table
+    inline uint16_t telemetryCrc(const uint8_t* data, uint16_t length) {
+        uint16_t crc = 0xFFFF;
+        for (uint16_t i = 0; i < length; i++) {
+            crc ^= (uint16_t)data[i] << 8;
+            for (uint8_t b = 0; b < 8; b++) {
+                crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    // Little-endian field writer and reader over a frame buffer
+    struct TelemetryCursor {
+        uint8_t*        p;
+
+        void put8(uint8_t v)    { *p++ = v; }
+        void put16(uint16_t v)  { put8((uint8_t)v); put8((uint8_t)(v >> 8)); }
+        void put32(uint32_t v)  { put16((uint16_t)v); put16((uint16_t)(v >> 16)); }
+        uint8_t  get8()         { return *p++; }
+        uint16_t get16()        { uint16_t v = get8(); return (uint16_t)(v | (uint16_t)get8() << 8); }
+        uint32_t get32()        { uint32_t v = get16(); return v | (uint32_t)get16() << 16; }
+    };
+
+    // Write a state record as a whole frame, returns the frame length (TELEMETRY_FRAME_MAX bytes needed)
+    inline uint16_t telemetryEncode(const TelemetryRecord& r, uint8_t* frame) {
+        TelemetryCursor c = { frame };
+        c.put8(TELEMETRY_SYNC0);
+        c.put8(TELEMETRY_SYNC1);
+        c.put8(TELEMETRY_VERSION);
+        c.put8(TELEMETRY_STATE);
+        c.put16(TELEMETRY_STATE_LENGTH);
+
+        c.put16(r.sequence);
+        c.put32(r.time);
+        c.put32(r.positionValid);
+        c.put32(r.moving);
+        for (uint8_t i = 0; i < TELEMETRY_SERVOS; i++) c.put16(r.position[i]);
+        for (uint8_t i = 0; i < TELEMETRY_SERVOS; i++) c.put16(r.load[i]);
+        for (uint8_t i = 0; i < TELEMETRY_SERVOS; i++) c.put8(r.temperature[i]);
+        for (uint8_t i = 0; i < TELEMETRY_SERVOS; i++) c.put8(r.voltage[i]);
+        c.put8(r.gaitType);
+        c.put16(r.gaitPhase);
+        c.put16(r.duty);
+        for (uint8_t i = 0; i < 3; i++) c.put8(r.distance[i]);
+        for (uint8_t i = 0; i < 3; i++) c.put8(r.light[i]);
+        c.put8(r.obstacle);
+        c.put8(r.lightDetected);
+        c.put8(r.sound);
+        c.put16(r.battery);
+        c.put16(r.tickMax);
+        c.put16(r.tickOverruns);
+        c.put16(r.stateMax);
+        c.put16(r.latenessMax);
+        c.put16(r.dropped);
+
+        uint16_t length = (uint16_t)(c.p - frame);
+        c.put16(telemetryCrc(frame + 2, length - 2));
+        return length + 2;
+    }
+
+    // Length of the frame starting at frame, once its header is in, 0 if the header is not a frame
+    inline uint16_t telemetryFrameLength(const uint8_t* frame) {
+        if (frame[0] != TELEMETRY_SYNC0 || frame[1] != TELEMETRY_SYNC1 || frame[2] == 0) return 0;
+        uint16_t length = (uint16_t)(frame[4] | frame[5] << 8);
+        if (length > TELEMETRY_PAYLOAD_MAX) return 0;
+        return TELEMETRY_HEADER + length + 2;
+    }
+
+    // Check a whole frame and unpack a state record. False on a CRC mismatch, an unknown type or a
+    // payload shorter than version 1.
+    inline bool telemetryDecode(const uint8_t* frame, uint16_t size, TelemetryRecord* r) {
+        uint16_t length = telemetryFrameLength(frame);
+        if (length == 0 || length > size) return false;
+        uint16_t crc = (uint16_t)(frame[length - 2] | frame[length - 1] << 8);
+        if (telemetryCrc(frame + 2, length - 4) != crc) return false;
+        if (frame[3] != TELEMETRY_STATE || length - TELEMETRY_HEADER - 2 < TELEMETRY_STATE_LENGTH) return false;
+
+        TelemetryCursor c = { (uint8_t*)frame + TELEMETRY_HEADER };
+        r->sequence      = c.get16();
+        r->time          = c.get32();
+        r->positionValid = c.get32();
+        r->moving        = c.get32();
+        for (uint8_t i = 0; i < TELEMETRY_SERVOS; i++) r->position[i]    = c.get16();
+        for (uint8_t i = 0; i < TELEMETRY_SERVOS; i++) r->load[i]        = c.get16();
+        for (uint8_t i = 0; i < TELEMETRY_SERVOS; i++) r->temperature[i] = c.get8();
+        for (uint8_t i = 0; i < TELEMETRY_SERVOS; i++) r->voltage[i]     = c.get8();
+        r->gaitType      = c.get8();
+        r->gaitPhase     = c.get16();
+        r->duty          = c.get16();
+        for (uint8_t i = 0; i < 3; i++) r->distance[i] = c.get8();
+        for (uint8_t i = 0; i < 3; i++) r->light[i]    = c.get8();
+        r->obstacle      = c.get8();
+        r->lightDetected = c.get8();
+        r->sound         = c.get8();
+        r->battery       = c.get16();
+        r->tickMax       = c.get16();
+        r->tickOverruns  = c.get16();
+        r->stateMax      = c.get16();
+        r->latenessMax   = c.get16();
+        r->dropped       = c.get16();
+        return true;
+    }
+
+#endif // TELEMETRYFORMAT_H
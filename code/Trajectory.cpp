@@ -0,0 +1,118 @@
+#include "Trajectory.h"
+
+namespace Trajectory {
+
+    // Hermite cubic from end positions and end velocities
+    Cubic cubic(float p0, float p1, float v0, float v1) {
+        float h = p1 - p0;
+        Cubic p;
+        p.c[0] = p0;
+        p.c[1] = v0;
+        p.c[2] =  3.0f * h - 2.0f * v0 - v1;
+        p.c[3] = -2.0f * h + v0 + v1;
+        return p;
+    }
+
+    // Quintic from end positions, velocities and accelerations
+    Quintic quintic(float p0, float p1, float v0, float v1, float a0, float a1) {
+        float h = p1 - p0;
+        Quintic p;
+        p.c[0] = p0;
+        p.c[1] = v0;
+        p.c[2] = 0.5f * a0;
+        p.c[3] =  10.0f * h - 6.0f * v0 - 4.0f * v1 - 0.5f * (3.0f * a0 - a1);
+        p.c[4] = -15.0f * h + 8.0f * v0 + 7.0f * v1 + 0.5f * (3.0f * a0 - 2.0f * a1);
+        p.c[5] =   6.0f * h - 3.0f * v0 - 3.0f * v1 + 0.5f * (a1 - a0);
+        return p;
+    }
+
+    // Quintic that starts and ends at rest
+    Quintic quinticRestToRest(float p0, float p1) {
+        return quintic(p0, p1, 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    // Cubic Bezier converted from Bernstein to power basis, so evaluation is three Horner steps per axis
+    Curve3 bezier(const float p0[3], const float p1[3], const float p2[3], const float p3[3]) {
+        Curve3 curve;
+        for (uint8_t a = 0; a < TRAJECTORY_AXES; a++) {
+            curve.axis[a].c[0] = p0[a];
+            curve.axis[a].c[1] = 3.0f * (p1[a] - p0[a]);
+            curve.axis[a].c[2] = 3.0f * (p0[a] - 2.0f * p1[a] + p2[a]);
+            curve.axis[a].c[3] = p3[a] - 3.0f * p2[a] + 3.0f * p1[a] - p0[a];
+        }
+        return curve;
+    }
+
+    // Straight segment in power basis
+    Curve3 line(const float p0[3], const float p1[3]) {
+        Curve3 curve;
+        for (uint8_t a = 0; a < TRAJECTORY_AXES; a++) {
+            curve.axis[a].c[0] = p0[a];
+            curve.axis[a].c[1] = p1[a] - p0[a];
+            curve.axis[a].c[2] = 0.0f;
+            curve.axis[a].c[3] = 0.0f;
+        }
+        return curve;
+    }
+
+    // Swing arc: control points are raised by 4/3 of the height so the curve peaks at exactly height mid-swing
+    Curve3 swingArc(const float liftoff[3], const float touchdown[3], float height) {
+        float lift = height * (4.0f / 3.0f);
+        float p1[3] = { liftoff[0],   liftoff[1],   liftoff[2]   + lift };
+        float p2[3] = { touchdown[0], touchdown[1], touchdown[2] + lift };
+        return bezier(liftoff, p1, p2, touchdown);
+    }
+
+    // Build a complete foot cycle
+    FootPath footPath(const float liftoff[3], const float touchdown[3], float height, float swingFraction) {
+        FootPath path;
+        path.swing         = swingArc(liftoff, touchdown, height);
+        path.stance        = line(touchdown, liftoff);
+        path.swingFraction = constrain(swingFraction, 0.01f, 0.99f);
+        return path;
+    }
+
+    // Evaluate a 3D curve
+    void evaluate(const Curve3& curve, float s, float out[3]) {
+        out[0] = evaluate(curve.axis[0], s);
+        out[1] = evaluate(curve.axis[1], s);
+        out[2] = evaluate(curve.axis[2], s);
+    }
+
+    // Foot position at cycle phase: swing follows the arc with a quintic timing law (zero velocity at liftoff
+    // and touchdown), stance moves back at constant speed
+    void evaluateFoot(const FootPath& path, float phase, float out[3]) {
+        phase -= floorf(phase);                                             // Wrap into [0, 1)
+        if (phase < path.swingFraction) {
+            evaluate(path.swing, smoothstep5(phase / path.swingFraction), out);
+        } else {
+            evaluate(path.stance, (phase - path.swingFraction) / (1.0f - path.swingFraction), out);
+        }
+    }
+
+    // Evaluate all six feet for their phases
+    void evaluateFeet(const FootPath paths[TRAJECTORY_FEET], const float phases[TRAJECTORY_FEET], float out[TRAJECTORY_FEET][TRAJECTORY_AXES]) {
+        for (uint8_t i = 0; i < TRAJECTORY_FEET; i++) {
+            evaluateFoot(paths[i], phases[i], out[i]);
+        }
+    }
+
+    // Advance a ramp one time step. The acceleration is steered towards the largest value that can still
+    // be brought back to zero within maxJerk by the time the target is reached, so the ramp lands on the
+    // target without overshoot; changing the target mid-ramp just bends the profile.
+    void rampTo(Ramp& ramp, float target, float maxAccel, float maxJerk, float dt) {
+        float error   = target - ramp.velocity;
+        float desired = sqrtf(2.0f * maxJerk * fabsf(error));
+        if (desired > maxAccel) desired = maxAccel;
+        if (error < 0.0f) desired = -desired;
+
+        float step     = maxJerk * dt;
+        ramp.accel    += constrain(desired - ramp.accel, -step, step);
+        ramp.velocity += ramp.accel * dt;
+        if ((target - ramp.velocity) * error <= 0.0f) {                     // Reached or crossed the target
+            ramp.velocity = target;
+            ramp.accel    = 0.0f;
+        }
+    }
+
+} // namespace Trajectory
@@ -0,0 +1,54 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+    #include <Arduino.h>
+
+    #define TRAJECTORY_FEET         uint8_t(6)                  // Number of feet evaluated per call
+    #define TRAJECTORY_AXES         uint8_t(3)                  // X, Y, Z
+    #define QUINTIC_PEAK_VELOCITY   float(1.875f)               // Peak of the rest-to-rest quintic velocity relative to the average velocity
+
+    namespace Trajectory {
+
+        // Polynomial in power basis over normalized time s in [0, 1]: p(s) = c[0] + c[1]*s + c[2]*s^2 + ...
+        struct Cubic   { float c[4]; };
+        struct Quintic { float c[6]; };
+
+        // Cubic polynomial per axis, used for Bezier curves converted to power basis
+        struct Curve3  { Cubic axis[TRAJECTORY_AXES]; };
+
+        // One foot cycle: swing from liftoff to touchdown along a Bezier arc, then stance back in a straight line
+        struct FootPath {
+            Curve3  swing;                                      // Swing curve, precomputed power-basis coefficients
+            Curve3  stance;                                     // Stance line, precomputed power-basis coefficients
+            float   swingFraction;                              // Fraction of the cycle spent in swing (0, 1)
+        };
+
+        // Velocity that follows a target with bounded acceleration and jerk
+        struct Ramp {
+            float   velocity;                                   // Current velocity
+            float   accel;                                      // Current acceleration
+        };
+
+        // Coefficient builders, call once per segment
+        Cubic   cubic(float p0, float p1, float v0, float v1);                              // Hermite cubic, v0/v1 are end velocities per unit s
+        Quintic quintic(float p0, float p1, float v0, float v1, float a0, float a1);        // Quintic with end velocities and accelerations per unit s
+        Quintic quinticRestToRest(float p0, float p1);                                      // Quintic with zero end velocity and acceleration
+        Curve3  bezier(const float p0[3], const float p1[3], const float p2[3], const float p3[3]);   // Cubic Bezier converted to power basis
+        Curve3  line(const float p0[3], const float p1[3]);                                 // Straight segment in power basis
+        Curve3  swingArc(const float liftoff[3], const float touchdown[3], float height);   // Bezier swing arc lifting the foot by height
+        FootPath footPath(const float liftoff[3], const float touchdown[3], float height, float swingFraction);
+
+        // Kernels, allocation-free and branch-light
+        inline float evaluate(const Cubic& p, float s)   { return p.c[0] + s * (p.c[1] + s * (p.c[2] + s * p.c[3])); }
+        inline float evaluate(const Quintic& p, float s) { return p.c[0] + s * (p.c[1] + s * (p.c[2] + s * (p.c[3] + s * (p.c[4] + s * p.c[5])))); }
+        inline float smoothstep5(float s)                { return s * s * s * (10.0f + s * (-15.0f + s * 6.0f)); }   // quinticRestToRest(0, 1)
+        void         evaluate(const Curve3& curve, float s, float out[3]);                  // Evaluate a 3D curve
+
+        void         evaluateFoot(const FootPath& path, float phase, float out[3]);         // Foot position at cycle phase [0, 1)
+        void         evaluateFeet(const FootPath paths[TRAJECTORY_FEET],                    // All six feet at their phases in one call
+                                  const float phases[TRAJECTORY_FEET],
+                                  float out[TRAJECTORY_FEET][TRAJECTORY_AXES]);
+        void         rampTo(Ramp& ramp, float target, float maxAccel, float maxJerk, float dt);  // Advance a ramp one time step towards a target
+    }
+
+#endif // TRAJECTORY_H
@@ -1,5 +1,6 @@
 #include "Turret.h"
 #include "TurretPoses.h"
+#include "StateStage.h"
 #include "Console.h"        // Add this include for logging macros
 #include "Debug.h"
 
@@ -17,8 +18,9 @@ bool Turret::begin(Driver* driver, Servo* servo) {
   this->driver = driver;  // Set the driver pointer
   this->servo = servo;    // Set the servo pointer
   this->speed = TURRET_SPEED;
-  if (!servo->init(turret_ids[0], TURRET_SPEED, TURRET_PAN_CW_LIMIT, TURRET_PAN_CCW_LIMIT)) return false;
-  if (!servo->init(turret_ids[1], TURRET_SPEED, TURRET_TILT_CW_LIMIT, TURRET_TILT_CCW_LIMIT)) return false;
+  const int32_t cwLimits[TURRET_SERVOS]  = {TURRET_PAN_CW_LIMIT,  TURRET_TILT_CW_LIMIT};
+  const int32_t ccwLimits[TURRET_SERVOS] = {TURRET_PAN_CCW_LIMIT, TURRET_TILT_CCW_LIMIT};
+  if (!servo->initServos(turret_ids, TURRET_SERVOS, TURRET_SPEED, cwLimits, ccwLimits)) return false;
   moveHome();
   LOG_INF("Turret initialized successfully. (Servo IDs: " + String(turret_ids[0]) + ", " + String(turret_ids[1]) + ")");
   return true;
@@ -26,9 +28,7 @@ bool Turret::begin(Driver* driver, Servo* servo) {
 
 // Update turret state
 bool Turret::update() {
-  for (int i = 0; i < TURRET_SERVOS; i++) {
-    servo->update(turret_ids[i]);
-  }
+  // Servo telemetry is polled by the state stage, once per tick for all servos
   return true;
 }
 
@@ -89,71 +89,83 @@ uint16_t Turret::getSpeed() const {
 // Print current turret angles to Serial
 bool Turret::printStatus() {
   uint16_t panPosition = 0, tiltPosition = 0;
-  if (!servo->getPresentPosition(turret_ids[0], &panPosition)) return false;
-  if (!servo->getPresentPosition(turret_ids[1], &tiltPosition)) return false;
+  const RobotState* state = driver->getState();
+  uint32_t mask = (1UL << (turret_ids[0] - 1)) | (1UL << (turret_ids[1] - 1));
+  if (state != nullptr && (state->positionValid & mask) == mask) {
+    panPosition  = state->position[turret_ids[0] - 1];
+    tiltPosition = state->position[turret_ids[1] - 1];
+  } else {
+    if (!servo->getPresentPosition(turret_ids[0], &panPosition)) return false;
+    if (!servo->getPresentPosition(turret_ids[1], &tiltPosition)) return false;
+  }
   PRINTLN("Turret Status: Pan: " + String(panPosition) + " | Tilt: " + String(tiltPosition) + "| Speed: " + String(speed));
   return true;
 }
 
-// Print turret-specific help information
-bool Turret::printConsoleHelp() {
-    PRINTLN("Turret Commands:\n\r");
-    PRINTLN("  ts               - Print current turret angles");
-    PRINTLN("");
-    PRINTLN("  tss [speed]      - Set turret speed 0 to 1023 (default: " + String(TURRET_SPEED) + ")");
-    PRINTLN("  tgs              - Get turret speed");
-    PRINTLN("");
-    PRINTLN("  tu               - Move turret up");
-    PRINTLN("  td               - Move turret down");
-    PRINTLN("  tl               - Move turret left");
-    PRINTLN("  tr               - Move turret right");
-    PRINTLN("  th               - Move turret to home position");
-    PRINTLN("");
-    PRINTLN("  t?               - Print this help message");
-    PRINTLN("");
+// ts: Print the turret angles
+static bool showTurret(void* turret, const CommandArgs&) {
+    return static_cast<Turret*>(turret)->printStatus();
+}
+
+// tss speed: Set the turret speed
+static bool setTurretSpeed(void* turret, const CommandArgs& args) {
+    return static_cast<Turret*>(turret)->setSpeed((int16_t)args.toInt(0, 0));
+}
+
+// tgs: Print the turret speed
+static bool showTurretSpeed(void* turret, const CommandArgs&) {
+    PRINTLN("Turret Speed: " + String(static_cast<Turret*>(turret)->getSpeed()));
     return true;
 }
 
-// Process console commands for turret control
-bool Turret::runConsoleCommands(const String& cmd, const String& args) {
-  
-      if (cmd == "ts") {
-        printStatus();
-        return true;
-
-    } else if (cmd == "tss") {
-        int16_t speed = args.toInt();
-        setSpeed(speed);
-        return true;
-
-    } else if (cmd == "tgs") {
-        PRINTLN("Turret Speed: " + String(getSpeed()));
-        return true;
-        
-    } else if (cmd == "tu") {
-        moveUp();
-        return true;
-
-    } else if (cmd == "td") {
-        moveDown();
-        return true;
-
-    } else if (cmd == "tl") {
-        moveLeft();
-        return true;
-
-    } else if (cmd == "tr") {
-        moveRight();
-        return true;
-
-    } else if (cmd == "th") {
-        moveHome();
-        return true;
-
-    } else if (cmd == "t?") {
-        printConsoleHelp();
-        return true;
-
-    }
-    return false; // Command not recognized
-}
\ No newline at end of file
+// tu: Move up
+static bool turretUp(void* turret, const CommandArgs&) {
+    return static_cast<Turret*>(turret)->moveUp();
+}
+
+// td: Move down
+static bool turretDown(void* turret, const CommandArgs&) {
+    return static_cast<Turret*>(turret)->moveDown();
+}
+
+// tl: Move left
+static bool turretLeft(void* turret, const CommandArgs&) {
+    return static_cast<Turret*>(turret)->moveLeft();
+}
+
+// tr: Move right
+static bool turretRight(void* turret, const CommandArgs&) {
+    return static_cast<Turret*>(turret)->moveRight();
+}
+
+// th: Move home
+static bool turretHome(void* turret, const CommandArgs&) {
+    return static_cast<Turret*>(turret)->moveHome();
+}
+
+// t?: Print the turret help
+static bool showTurretHelp(void* turret, const CommandArgs&) {
+    return static_cast<Turret*>(turret)->printConsoleHelp();
+}
+
+// Console commands, the help is printed from this table
+static const ConsoleCommand turretCommands[] = {
+    { "ts",     "",        "Print current turret angles",               showTurret },
+    { nullptr,  "",        "",                                          nullptr },
+    { "tss",    "[speed]", "Set turret speed 0 to 1023 (default: 100)", setTurretSpeed },
+    { "tgs",    "",        "Get turret speed",                          showTurretSpeed },
+    { nullptr,  "",        "",                                          nullptr },
+    { "tu",     "",        "Move turret up",                            turretUp },
+    { "td",     "",        "Move turret down",                          turretDown },
+    { "tl",     "",        "Move turret left",                          turretLeft },
+    { "tr",     "",        "Move turret right",                         turretRight },
+    { "th",     "",        "Move turret to home position",              turretHome },
+    { nullptr,  "",        "",                                          nullptr },
+    { "t?",     "",        "Print this help message",                   showTurretHelp },
+};
+const ConsoleCommandTable Turret::commandTable = { "Turret Commands:", turretCommands, sizeof(turretCommands) / sizeof(turretCommands[0]) };
+
+// Print turret-specific help information
+bool Turret::printConsoleHelp() {
+    return CommandRegistry::printHelp(commandTable);
+}
@@ -3,6 +3,7 @@
 
   #include "Servo.h"
   #include "Driver.h"
+  #include "CommandRegistry.h"
 
   #define handler_index  0                           // Index for sync write handler
 
@@ -39,8 +40,8 @@
       uint16_t  getSpeed() const;             // Get current turret rotation speed
 
       bool      printStatus();                // Print current turret angles to Serial
-      bool      runConsoleCommands(const String& cmd, const String& args); // Process console commands for turret control
       bool      printConsoleHelp();                                        // Print turret-specific help information
+      static const ConsoleCommandTable commandTable;                       // Console commands and their help
 
     private:
       Driver*   driver;                       // Pointer to the driver instance
@@ -15,6 +15,14 @@
 #include "AXS1Sensor.h"                 // Include AXS1Sensor class for managing the AX-S1 sensor
 #include "GaitController.h"             // Include GaitController class for managing the gait of the hexapod
 #include "Remotecontroller.h"           // Include RemoteController class for managing remote controller input
+#include "Scheduler.h"                  // Include Scheduler class for running the main loop tasks
+#include "ControlTick.h"                // Include ControlTick class for the timer-driven control stage
+#include "MotionPlayer.h"               // Include MotionPlayer class for RoboPlus motion playback
+#include "Recorder.h"                   // Include Recorder class for teach-and-replay recording
+#include "FootContact.h"                // Include FootContact class for foot contact estimation
+#include "ServoEstimator.h"             // Include ServoEstimator class for servo position estimation
+#include "StateStage.h"                 // Include StateStage class for the robot state snapshot
+#include "Telemetry.h"                  // Include Telemetry class for the binary telemetry stream
 
 
 // Global variables and instances
@@ -28,6 +36,14 @@ BodyPose            bodyPose;                   // BodyPose instance
 AXS1Sensor          axs1;                       // AX-S1 Sensor instance
 GaitController      gc;                         // Gait Controller instance
 Remotecontroller    rc;                         // Remote Controller instance
+Scheduler           scheduler;                  // Main loop task scheduler instance
+ControlTick         controlTick;                // Timer-driven control tick instance
+MotionPlayer        motion;                     // RoboPlus motion player instance
+Recorder            recorder;                   // Teach-and-replay recorder instance
+FootContact         contact;                    // Foot contact estimator instance
+ServoEstimator      estimator;                  // Servo position estimator instance
+StateStage          stateStage;                 // Robot state snapshot instance
+Telemetry           telemetry;                  // Binary telemetry stream instance
 
 // Initialize console with all necessary components
 Console             con(    &DEBUG_SERIAL,      // Initialize console with debug serial stream
@@ -40,40 +56,76 @@ Console             con(    &DEBUG_SERIAL,      // Initialize console with debug
                             &turret,            // Pass the Turret instance
                             &axs1,              // Pass the AXS1Sensor instance
                             &gc,                // Pass the GaitController instance
-                            &rc                 // Pass the RemoteController instance
+                            &rc,                // Pass the RemoteController instance
+                            &scheduler,         // Pass the Scheduler instance
+                            &motion,            // Pass the MotionPlayer instance
+                            &recorder,          // Pass the Recorder instance
+                            &contact,           // Pass the FootContact instance
+                            &estimator,         // Pass the ServoEstimator instance
+                            &stateStage,        // Pass the StateStage instance
+                            &telemetry          // Pass the Telemetry instance
                         );  
 
 // Setup function to initialize the robot components
 void setup() {
 
     bool success = true;
+    uint32_t bootStart = millis();                                              // Boot-to-walk time is reported at the end
 
     // Initialize all components
     success &= con.begin();
     success &= mc.begin();
     success &= driver.begin( DXL_SERIAL, DXL_BAUD_RATE, DXL_PROTOCOL_VERSION);
+#ifdef DXL_SERIAL_2
+    success &= driver.addPort(DXL_SERIAL_2, DXL_BAUD_RATE);                     // Before any servo is talked to
+    for (uint8_t leg = 0; leg < HEXAPOD_LEGS; leg += 2) {                       // Right legs (negative Y): 0, 2 and 4
+        for (uint8_t joint = 1; joint <= LEG_SERVOS; joint++) {
+            driver.setPort(leg * LEG_SERVOS + joint, 1);
+        }
+    }
+    driver.setPort(TURRET_PAN_ID, 1);
+    driver.setPort(TURRET_TILT_ID, 1);
+#endif
+    success &= estimator.begin(&driver);                                        // Attach before any servo is commanded
     success &= servo.begin(&driver);
     success &= hexapod.begin(&driver, &servo);
     success &= turret.begin(&driver, &servo);
     success &= axs1.begin(&driver, AXS1_SENSOR_ID);
-    success &= gc.begin(&hexapod);
+    success &= gc.begin(&hexapod, CONTROL_TICK_PERIOD);
     success &= rc.begin(RC100_SERIAL,&mc,&hexapod,&turret,&gc);
+    success &= motion.begin(&driver, &gc);
+    success &= recorder.begin(&driver, &servo, &gc, &motion);
+    success &= stateStage.begin(&driver, &servo, &axs1, &mc);
+    success &= contact.begin(&stateStage, &gc);
+    success &= telemetry.begin(&stateStage, &gc, &controlTick, &scheduler, TELEMETRY_RATE);
+
+    // Register main loop tasks: name, function, period (us), priority (0 = highest)
+    scheduler.addTask("gait",    [](){ gc.update();      }, GAIT_TASK_PERIOD,    0);   // Streams setpoints from the control tick
+    scheduler.addTask("motion",  [](){ motion.update();  }, MOTION_TASK_PERIOD,  1);   // Streams RoboPlus motion frames
+    scheduler.addTask("record",  [](){ recorder.update();}, RECORDER_PERIOD,     2);   // Samples or replays at a fixed rate
+    scheduler.addTask("state",   [](){ stateStage.update();}, STATE_TASK_PERIOD, 3);   // Telemetry, estimator corrections, contact loads, sensor and battery
+    scheduler.addTask("contact", [](){ contact.update(); }, CONTACT_TASK_PERIOD, 4);   // Filters the load pass the state stage just read
+    scheduler.addTask("rc",      [](){ rc.update();      }, RC_TASK_PERIOD,      5);
+    scheduler.addTask("hexapod", [](){ hexapod.update(); }, HEXAPOD_TASK_PERIOD, 6);
+    scheduler.addTask("turret",  [](){ turret.update();  }, TURRET_TASK_PERIOD,  7);
+    scheduler.addTask("axs1",    [](){ axs1.update();    }, AXS1_TASK_PERIOD,    8);
+    scheduler.addTask("mc",      [](){ mc.update();      }, MC_TASK_PERIOD,      9);
+    uint8_t telemetryTask = scheduler.addTask("telemetry", [](){ telemetry.update(); }, MC_TASK_PERIOD, 10);   // Period and enable follow 'xr'
+    uint8_t consoleTask = scheduler.addTask("console", [](){ con.update();   }, SCHEDULER_IDLE, 11);
+    scheduler.setTaskEssential(consoleTask);                                            // kd must not lock out the console
+    success &= telemetry.attachTask(telemetryTask);
+    success &= scheduler.begin();
+    success &= controlTick.begin(CONTROL_TICK_PERIOD, [](){ gc.controlTick(); });   // Gait setpoints are produced in the timer ISR
 
     if (!success) {
         LOG_ERR("Failed to initialize components.");
     } else {
-        LOG_INF("All components initialized successfully.");
+        LOG_INF("All components initialized successfully in " + String(millis() - bootStart) + " ms.");
         con.startShell();
     }
 }
 
 // Main loop function
 void loop() {
-    con.update();       // Update console state
-    mc.update();        // Update Microcontroller state
-    hexapod.update();   // Update Hexapod > Legs > Servos states
-    turret.update();    // Update Turret > Servos state
-    axs1.update();      // Update AX-S1 sensor state
-    gc.update();        // Update Gait Controller state
-    rc.update();        // Update Remote Controller state
+    scheduler.update(); // Run the next due task, console runs when nothing else is due
 }
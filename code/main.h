@@ -8,9 +8,21 @@
   
   #define DXL_SERIAL            ""          // OpenCR Dynamixel is on Serial1(USART1)
   #define DXL_BAUD_RATE         1000000     // Default baud rate for Dynamixel servos
-  #define DXL_PROTOCOL_VERSION  1.0f        // Protocol version for Dynamixel servos
+  #define DXL_PROTOCOL_VERSION  1.0f        // Protocol version for Dynamixel servos, 2.0 for X series (the AX-S1 stays on 1.0)
+//#define DXL_SERIAL_2          "2"         // Second Dynamixel bus for the right legs and the turret, leave undefined for one bus
   
   #define RC100_SERIAL          Serial1     // Serial port for RC100 remote controller
   #define RC100_BAUD_RATE       115200      // Baud rate for RC controller communication
 
+  #define GAIT_TASK_PERIOD      10000       // Gait controller period in us (100 Hz)
+  #define MOTION_TASK_PERIOD    20000       // Motion player frame period in us (50 Hz)
+  #define STATE_TASK_PERIOD     20000       // Robot state snapshot refresh period in us (50 Hz), all main loop servo reads
+  #define CONTACT_TASK_PERIOD   20000       // Foot contact filter period in us (50 Hz), one load pass of the state stage each
+  #define RC_TASK_PERIOD        20000       // Remote controller polling period in us (50 Hz)
+  #define HEXAPOD_TASK_PERIOD   20000       // Hexapod legs and servos update period in us (50 Hz)
+  #define TURRET_TASK_PERIOD    50000       // Turret servos update period in us (20 Hz)
+  #define AXS1_TASK_PERIOD      50000       // AX-S1 sensor update period in us (20 Hz)
+  #define MC_TASK_PERIOD        100000      // Microcontroller update period in us (10 Hz)
+  #define TELEMETRY_RATE        0           // Binary telemetry frames per second at boot, 0 = off until 'xr'
+
 #endif  // MAIN_H
\ No newline at end of file
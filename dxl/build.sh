@@ -0,0 +1,7 @@
+#!/bin/bash
+# Build script for the Dynamixel packet codec and driver routing checks
+# Usage: ./build.sh
+#        ./dxltest
+
+g++ -std=c++17 -I../host -o dxltest main.cpp ../code/Protocol1.cpp ../code/Protocol2.cpp ../code/Driver.cpp ../code/ServoEstimator.cpp \
+    ../code/CommandRegistry.cpp ../code/Debug.cpp ../host/Arduino.cpp ../host/DynamixelWorkbench.cpp
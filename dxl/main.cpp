@@ -0,0 +1,388 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+#include "../code/Protocol1.h"          // Packet codecs compiled from the firmware sources
+#include "../code/Protocol2.h"
+#include "../code/Driver.h"             // Port routing, built against the shim in host/
+#include "../code/Debug.h"
+
+
+struct Stats {
+    size_t  checks = 0;                     // Checks run
+    size_t  failed = 0;                     // Checks that failed
+};
+
+static Stats stats;
+
+// -------------------- Checks --------------------
+std::string hex(const uint8_t* data, size_t length) {
+    std::string out;
+    char buf[4];
+    for (size_t i = 0; i < length; i++) {
+        snprintf(buf, sizeof(buf), i ? " %02X" : "%02X", data[i]);
+        out += buf;
+    }
+    return out;
+}
+
+void check(const std::string& name, bool ok, const std::string& detail = "") {
+    stats.checks++;
+    if (ok) {
+        std::cout << "ok    " << name << "\n";
+        return;
+    }
+    stats.failed++;
+    std::cout << "FAIL  " << name << (detail.empty() ? "" : ": " + detail) << "\n";
+}
+
+void checkInt(const std::string& name, long got, long expected) {
+    check(name, got == expected, "got " + std::to_string(got) + ", expected " + std::to_string(expected));
+}
+
+// Compare a built packet with the bytes the e-manual gives for it
+void checkBytes(const std::string& name, const uint8_t* data, size_t length, const std::vector<uint8_t>& expected) {
+    bool ok = length == expected.size() && memcmp(data, expected.data(), length) == 0;
+    check(name, ok, "got " + hex(data, length) + ", expected " + hex(expected.data(), expected.size()));
+}
+
+// -------------------- Protocol 1.0 --------------------
+// Received bytes are copied into the receive buffer as the driver's serial read would leave them
+long parse1(Protocol1& p, const std::vector<uint8_t>& rx, uint8_t id, Protocol1Status* status) {
+    memcpy(p.rxBuffer(), rx.data(), rx.size());
+    return p.parse((uint16_t)rx.size(), id, status);
+}
+
+void testProtocol1() {
+    Protocol1 p;
+
+    p.ping(1);
+    checkBytes("p1 ping", p.txBuffer(), p.txLength(), {0xFF, 0xFF, 0x01, 0x02, 0x01, 0xFB});
+
+    p.read(1, 0x2B, 1);                                                             // Present_Temperature
+    checkBytes("p1 read", p.txBuffer(), p.txLength(), {0xFF, 0xFF, 0x01, 0x04, 0x02, 0x2B, 0x01, 0xCC});
+
+    const uint8_t goal[] = {0x00, 0x02};                                            // Goal_Position 512
+    p.write(1, 0x1E, goal, sizeof(goal));
+    checkBytes("p1 write", p.txBuffer(), p.txLength(), {0xFF, 0xFF, 0x01, 0x05, 0x03, 0x1E, 0x00, 0x02, 0xD6});
+
+    uint8_t large[PROTOCOL1_TX_MAX] = {0};
+    checkInt("p1 write too long", p.write(1, 0x1E, large, PROTOCOL1_TX_MAX - 6), 0);
+    checkInt("p1 write longest", p.write(1, 0x1E, large, PROTOCOL1_TX_MAX - 7), PROTOCOL1_TX_MAX);
+
+    p.syncBegin(0x1E, 4);                                                           // Goal_Position and Moving_Speed of IDs 0 to 3
+    p.syncAdd(0, 0x01500010);
+    p.syncAdd(1, 0x03600220);
+    p.syncAdd(2, 0x01700030);
+    p.syncAdd(3, 0x03800220);
+    p.syncEnd();
+    checkBytes("p1 sync write", p.txBuffer(), p.txLength(),
+               {0xFF, 0xFF, 0xFE, 0x18, 0x83, 0x1E, 0x04,
+                0x00, 0x10, 0x00, 0x50, 0x01, 0x01, 0x20, 0x02, 0x60, 0x03,
+                0x02, 0x30, 0x00, 0x70, 0x01, 0x03, 0x20, 0x02, 0x80, 0x03, 0x12});
+
+    p.syncBegin(0x1E, 2);
+    uint8_t added = 0;
+    while (p.syncAdd(added + 1, 512)) added++;
+    checkInt("p1 sync write full", p.syncEnd(), 7 + added * 3 + 1);
+    check("p1 sync write fits", p.txLength() <= PROTOCOL1_TX_MAX && p.txLength() + 3 > PROTOCOL1_TX_MAX);
+
+    Protocol1Status status;
+    const std::vector<uint8_t> answer = {0xFF, 0xFF, 0x01, 0x03, 0x00, 0x20, 0xDB};  // Present_Temperature 32
+    checkInt("p1 parse status", parse1(p, answer, 1, &status), PROTOCOL1_OK);
+    check("p1 parse fields", status.id == 1 && status.error == 0 && status.paramLength == 1 && status.params[0] == 0x20);
+    checkInt("p1 parse statusLength", Protocol1::statusLength(1), answer.size());
+
+    std::vector<uint8_t> error = {0xFF, 0xFF, 0x01, 0x02, 0x24, 0xD8};                // Overload and overheating bits
+    checkInt("p1 parse error status", parse1(p, error, 1, &status), PROTOCOL1_OK);
+    check("p1 parse error fields", status.error == 0x24 && status.paramLength == 0);
+
+    checkInt("p1 parse nothing", parse1(p, {}, 1, &status), PROTOCOL1_NO_STATUS);
+    checkInt("p1 parse short", parse1(p, {0xFF, 0xFF, 0x01, 0x03, 0x00}, 1, &status), PROTOCOL1_SHORT);
+    checkInt("p1 parse truncated", parse1(p, {0xFF, 0xFF, 0x01, 0x04, 0x00, 0x20, 0xDB}, 1, &status), PROTOCOL1_SHORT);
+    checkInt("p1 parse length too small", parse1(p, {0xFF, 0xFF, 0x01, 0x01, 0x00, 0xFD}, 1, &status), PROTOCOL1_SHORT);
+    checkInt("p1 parse bad header", parse1(p, {0xFF, 0xFE, 0x01, 0x03, 0x00, 0x20, 0xDB}, 1, &status), PROTOCOL1_BAD_HEADER);
+    checkInt("p1 parse bad checksum", parse1(p, {0xFF, 0xFF, 0x01, 0x03, 0x00, 0x20, 0xDC}, 1, &status), PROTOCOL1_BAD_CHECKSUM);
+    checkInt("p1 parse wrong id", parse1(p, answer, 2, &status), PROTOCOL1_WRONG_ID);
+}
+
+// -------------------- Protocol 2.0 --------------------
+long parse2(Protocol2& p, const std::vector<uint8_t>& rx, uint8_t id, Protocol2Status* status) {
+    memcpy(p.rxBuffer(), rx.data(), rx.size());
+    return p.parse((uint16_t)rx.size(), id, status);
+}
+
+void testProtocol2() {
+    Protocol2 p;
+
+    const uint8_t crcInput[] = {0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x03, 0x00, 0x01};
+    checkInt("p2 crc", Protocol2::crc(crcInput, sizeof(crcInput)), 0x4E19);
+
+    p.ping(1);
+    checkBytes("p2 ping", p.txBuffer(), p.txLength(), {0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x03, 0x00, 0x01, 0x19, 0x4E});
+
+    p.read(1, 132, 4);                                                              // Present_Position
+    checkBytes("p2 read", p.txBuffer(), p.txLength(),
+               {0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x07, 0x00, 0x02, 0x84, 0x00, 0x04, 0x00, 0x1D, 0x15});
+
+    const uint8_t goal[] = {0x00, 0x02, 0x00, 0x00};                                // Goal_Position 512
+    p.write(1, 116, goal, sizeof(goal));
+    checkBytes("p2 write", p.txBuffer(), p.txLength(),
+               {0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x09, 0x00, 0x03, 0x74, 0x00, 0x00, 0x02, 0x00, 0x00, 0xCA, 0x89});
+
+    const uint8_t ids[] = {1, 2};
+    p.syncRead(132, 4, ids, sizeof(ids), false);
+    checkBytes("p2 sync read", p.txBuffer(), p.txLength(),
+               {0xFF, 0xFF, 0xFD, 0x00, 0xFE, 0x09, 0x00, 0x82, 0x84, 0x00, 0x04, 0x00, 0x01, 0x02, 0xCE, 0xFA});
+
+    p.syncBegin(116, 4);                                                            // Goal_Position 150 and 170
+    p.syncAdd(1, 150);
+    p.syncAdd(2, 170);
+    p.syncEnd();
+    checkBytes("p2 sync write", p.txBuffer(), p.txLength(),
+               {0xFF, 0xFF, 0xFD, 0x00, 0xFE, 0x11, 0x00, 0x83, 0x74, 0x00, 0x04, 0x00,
+                0x01, 0x96, 0x00, 0x00, 0x00, 0x02, 0xAA, 0x00, 0x00, 0x00, 0x82, 0x87});
+
+    p.syncBegin(116, 4);
+    uint8_t added = 0;
+    while (p.syncAdd(added + 1, 2048)) added++;
+    checkInt("p2 sync write full", p.syncEnd(), 0);
+    p.syncBegin(116, 4);
+    for (uint8_t i = 0; i < added; i++) p.syncAdd(i + 1, 2048);
+    checkInt("p2 sync write fits", p.syncEnd(), 12 + added * 5 + 2);
+
+    const uint8_t header[] = {0xFF, 0xFF, 0xFD, 0x01};                              // Stuffed: LEN and CRC count the added 0xFD
+    p.write(1, 128, header, sizeof(header));
+    checkBytes("p2 write stuffed", p.txBuffer(), p.txLength(),
+               {0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x0A, 0x00, 0x03, 0x80, 0x00, 0xFF, 0xFF, 0xFD, 0xFD, 0x01, 0x67, 0x1C});
+
+    uint8_t large[PROTOCOL2_TX_MAX] = {0};
+    checkInt("p2 write too long", p.write(1, 116, large, PROTOCOL2_TX_MAX - 11), 0);
+    checkInt("p2 write longest", p.write(1, 116, large, PROTOCOL2_TX_MAX - 12), PROTOCOL2_TX_MAX);
+
+    Protocol2Status status;
+    const std::vector<uint8_t> answer = {0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x08, 0x00, 0x55, 0x00, 0xA6, 0x00, 0x00, 0x00, 0x8C, 0xC0};
+    checkInt("p2 parse status", parse2(p, answer, 1, &status), PROTOCOL2_OK);
+    check("p2 parse fields", status.id == 1 && status.error == 0 && status.paramLength == 4
+                             && status.params[0] == 0xA6 && status.params[1] == 0 && status.params[3] == 0);
+    checkInt("p2 parse statusLength", Protocol2::statusLength(4), answer.size());
+    checkInt("p2 parse any id", parse2(p, answer, PROTOCOL2_ANY_ID, &status), PROTOCOL2_OK);
+
+    const std::vector<uint8_t> stuffed = {0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x09, 0x00, 0x55, 0x00, 0xFF, 0xFF, 0xFD, 0xFD, 0x01, 0xDD, 0x1C};
+    checkInt("p2 parse stuffed", parse2(p, stuffed, 1, &status), PROTOCOL2_OK);
+    check("p2 parse unstuffed", status.paramLength == 4 && status.params[0] == 0xFF && status.params[1] == 0xFF
+                                && status.params[2] == 0xFD && status.params[3] == 0x01,
+          "got " + hex(status.params, status.paramLength) + ", expected FF FF FD 01");
+
+    std::vector<uint8_t> badCrc = answer;
+    badCrc[answer.size() - 1] ^= 0x01;
+    std::vector<uint8_t> notStatus = answer;                                        // A READ echoed back, CRC fixed up
+    notStatus[7] = PROTOCOL2_READ;
+    uint16_t value = Protocol2::crc(notStatus.data(), notStatus.size() - 2);
+    notStatus[notStatus.size() - 2] = (uint8_t)value;
+    notStatus[notStatus.size() - 1] = (uint8_t)(value >> 8);
+
+    checkInt("p2 parse nothing", parse2(p, {}, 1, &status), PROTOCOL2_NO_STATUS);
+    checkInt("p2 parse short", parse2(p, {0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x04, 0x00, 0x55, 0x00, 0x00}, 1, &status), PROTOCOL2_SHORT);
+    checkInt("p2 parse truncated", parse2(p, std::vector<uint8_t>(answer.begin(), answer.end() - 1), 1, &status), PROTOCOL2_SHORT);
+    checkInt("p2 parse bad header", parse2(p, {0xFF, 0xFF, 0xFD, 0x01, 0x01, 0x04, 0x00, 0x55, 0x00, 0x00, 0x00}, 1, &status), PROTOCOL2_BAD_HEADER);
+    checkInt("p2 parse bad crc", parse2(p, badCrc, 1, &status), PROTOCOL2_BAD_CRC);
+    checkInt("p2 parse not status", parse2(p, notStatus, 1, &status), PROTOCOL2_NOT_STATUS);
+    checkInt("p2 parse wrong id", parse2(p, answer, 2, &status), PROTOCOL2_WRONG_ID);
+}
+
+// -------------------- Driver routing --------------------
+// A bus on the host. It keeps every packet the driver writes and answers Protocol 1.0 READs of the
+// servos attached to it with 0x100 + ID, so a read sent to the wrong bus gets no reply.
+class FakePort : public dynamixel::PortHandler {
+    public:
+        std::vector<std::vector<uint8_t>>   packets;                // Packets written, in order
+        std::vector<uint8_t>                servos;                 // IDs on this bus
+
+        void reset(std::vector<uint8_t> ids) {
+            packets.clear();
+            servos = ids;
+            rx.clear();
+            rxRead = 0;
+        }
+
+        bool    openPort() override                         { return true; }
+        void    closePort() override                        {}
+        void    clearPort() override                        { rx.clear(); rxRead = 0; }
+        void    setPortName(const char* port_name) override { (void)port_name; }
+        char*   getPortName() override                      { return nullptr; }
+        bool    setBaudRate(const int baudrate) override    { (void)baudrate; return true; }
+        int     getBaudRate() override                      { return 1000000; }
+        int     getBytesAvailable() override                { return (int)(rx.size() - rxRead); }
+        void    setPacketTimeout(uint16_t packet_length) override { (void)packet_length; }
+        void    setPacketTimeout(double msec) override      { (void)msec; }
+        bool    isPacketTimeout() override                  { return rxRead == rx.size(); }
+
+        int readPort(uint8_t* packet, int length) override {
+            int n = 0;
+            while (n < length && rxRead < rx.size()) packet[n++] = rx[rxRead++];
+            return n;
+        }
+
+        int writePort(uint8_t* packet, int length) override;
+
+    private:
+        std::vector<uint8_t>                rx;                     // Reply waiting to be read
+        size_t                              rxRead = 0;
+};
+
+static FakePort         fakePorts[DRIVER_PORTS];
+static std::vector<int> writeOrder;                                 // Port of each packet written
+
+// The driver opens "fake0", "fake1", ...
+dynamixel::PortHandler* dynamixel::PortHandler::getPortHandler(const char* port_name) {
+    int port = port_name[strlen(port_name) - 1] - '0';
+    return (port >= 0 && port < DRIVER_PORTS) ? &fakePorts[port] : nullptr;
+}
+
+int FakePort::writePort(uint8_t* packet, int length) {
+    packets.emplace_back(packet, packet + length);
+    writeOrder.push_back((int)(this - fakePorts));
+    bool read = length == 8 && packet[2] != 0xFD && packet[4] == PROTOCOL1_READ;
+    if (!read || std::find(servos.begin(), servos.end(), packet[2]) == servos.end()) return length;
+
+    uint8_t  id    = packet[2];
+    uint8_t  count = packet[6];
+    uint32_t value = 0x100 + id;
+    uint8_t  sum   = id + count + 2;
+    rx = {0xFF, 0xFF, id, (uint8_t)(count + 2), 0x00};
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t b = i < 4 ? (uint8_t)(value >> (8 * i)) : 0;
+        rx.push_back(b);
+        sum += b;
+    }
+    rx.push_back((uint8_t)~sum);
+    rxRead = 0;
+    return length;
+}
+
+// The (ID, value) pairs of a sync write packet of either protocol
+std::vector<std::pair<uint8_t, uint32_t>> syncEntries(const std::vector<uint8_t>& packet) {
+    std::vector<std::pair<uint8_t, uint32_t>> entries;
+    bool   p2     = packet.size() > 12 && packet[2] == 0xFD;
+    size_t first  = p2 ? 12 : 7;
+    size_t end    = packet.size() - (p2 ? 2 : 1);
+    size_t length = p2 ? (packet[10] | packet[11] << 8) : packet[6];
+    for (size_t i = first; i + length < end + 1; i += length + 1) {
+        uint32_t value = 0;
+        for (size_t b = 0; b < length && b < 4; b++) value |= (uint32_t)packet[i + 1 + b] << (8 * b);
+        entries.emplace_back(packet[i], value);
+    }
+    return entries;
+}
+
+std::string describe(const std::vector<std::pair<uint8_t, uint32_t>>& entries) {
+    std::string out;
+    for (const auto& e : entries) out += (out.empty() ? "" : " ") + std::to_string(e.first) + "=" + std::to_string(e.second);
+    return out;
+}
+
+// Left legs 1, 3, 5 on port 0, right legs 2, 4, 6 on port 1
+std::unique_ptr<Driver> twoPorts(float protocol) {
+    fakePorts[0].reset({1, 3, 5});
+    fakePorts[1].reset({2, 4, 6});
+    std::unique_ptr<Driver> driver(new Driver());
+    driver->begin("fake0", 1000000, protocol);
+    driver->addPort("fake1", 1000000);
+    for (uint8_t id = 2; id <= 6; id += 2) driver->setPort(id, 1);
+    fakePorts[0].packets.clear();
+    fakePorts[1].packets.clear();
+    writeOrder.clear();
+    return driver;
+}
+
+// Each port gets a sync write holding only its own IDs
+void checkSyncSplit(const std::string& name, uint16_t address, uint8_t length) {
+    const std::vector<std::pair<uint8_t, uint32_t>> expected[DRIVER_PORTS] = {
+        {{1, 101}, {3, 103}, {5, 105}},
+        {{2, 102}, {4, 104}, {6, 106}}
+    };
+    for (uint8_t p = 0; p < DRIVER_PORTS; p++) {
+        const std::string port = name + " port " + std::to_string(p);
+        if (fakePorts[p].packets.size() != 1) {
+            checkInt(port + " packets", fakePorts[p].packets.size(), 1);
+            continue;
+        }
+        const std::vector<uint8_t>& packet = fakePorts[p].packets[0];
+        bool p2 = packet[2] == 0xFD;
+        uint16_t gotAddress = p2 ? (packet[8] | packet[9] << 8) : packet[5];
+        uint16_t gotLength  = p2 ? (packet[10] | packet[11] << 8) : packet[6];
+        check(port + " header", gotAddress == address && gotLength == length,
+              "address " + std::to_string(gotAddress) + " length " + std::to_string(gotLength));
+        auto entries = syncEntries(packet);
+        check(port + " ids", entries == expected[p], "got " + describe(entries) + ", expected " + describe(expected[p]));
+        if (p2) {
+            uint16_t crc = Protocol2::crc(packet.data(), (uint16_t)(packet.size() - 2));
+            check(port + " crc", packet[packet.size() - 2] == (uint8_t)crc && packet[packet.size() - 1] == (uint8_t)(crc >> 8));
+        }
+    }
+}
+
+void testRouting() {
+    uint8_t ids[]   = {1, 2, 3, 4, 5, 6};
+    int32_t goals[] = {101, 102, 103, 104, 105, 106};
+
+    std::unique_ptr<Driver> driver = twoPorts(1.0f);
+    checkInt("route port count", driver->getPortCount(), 2);
+    check("route p1 handler", driver->addSyncWriteHandler(30, 2));                 // AX Goal_Position
+    check("route p1 sync write", driver->syncWrite(0, ids, 6, goals, 1));
+    checkSyncSplit("route p1 sync write", 30, 2);
+
+    fakePorts[0].packets.clear();
+    fakePorts[1].packets.clear();
+    uint32_t value = 0;
+    check("route read", driver->readRegister(4, 36, 2, &value));                   // Present_Position of a right leg
+    checkInt("route read value", value, 0x104);
+    check("route read port", fakePorts[0].packets.empty() && fakePorts[1].packets.size() == 1);
+
+    uint32_t values[6] = {0};
+    writeOrder.clear();
+    check("route interleaved", driver->readRegisters(ids, 6, 36, 2, values));
+    bool all = true;
+    for (uint8_t i = 0; i < 6; i++) all &= values[i] == 0x100u + ids[i];
+    check("route interleaved values", all);
+    check("route interleaved turns", writeOrder == std::vector<int>({0, 1, 0, 1, 0, 1}));
+
+    uint8_t  uneven[] = {2, 1, 4, 6};                                               // Port 1 has three reads to port 0's one
+    uint32_t got[4]   = {0};
+    check("route interleaved uneven", driver->readRegisters(uneven, 4, 36, 2, got));
+    check("route interleaved uneven values", got[0] == 0x102 && got[1] == 0x101 && got[2] == 0x104 && got[3] == 0x106);
+
+    uint8_t  missing[] = {1, 7, 2};                                                 // No servo 7 on port 0
+    uint32_t kept[3]   = {0, 77, 0};
+    check("route interleaved missing", !driver->readRegisters(missing, 3, 36, 2, kept));
+    check("route interleaved missing values", kept[0] == 0x101 && kept[1] == 77 && kept[2] == 0x102);
+
+    driver = twoPorts(2.0f);
+    check("route p2 handler", driver->addSyncWriteHandler(1, "Goal_Position"));    // X series, address and length from the control table
+    check("route p2 sync write", driver->syncWrite(0, ids, 6, goals, 1));
+    checkSyncSplit("route p2 sync write", 116, 4);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 1) {
+        std::cerr << "Usage: dxltest\n";
+        std::cerr << "Checks the Dynamixel packet codecs of the firmware against the byte vectors of the e-manual\n";
+        std::cerr << "and their status parsing error paths, and the driver's routing over two fake ports.\n";
+        std::cerr << "Exits with 1 if any check fails.\n";
+        return 1;
+    }
+
+    testProtocol1();
+    testProtocol2();
+    log::setLogStream(nullptr);                                                     // Keep the driver's own logging out of the report
+    testRouting();
+
+    std::cout << stats.checks << " checks, " << stats.failed << " failed\n";
+    return stats.failed ? 1 : 0;
+}
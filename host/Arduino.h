@@ -0,0 +1,146 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+    // Just enough of the Arduino core to build firmware modules into the host checks. Output written
+    // to Serial goes to stdout, time runs on the host clock.
+
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <string.h>
+    #include <strings.h>
+    #include <math.h>
+    #include <string>
+    #include <algorithm>
+
+    #define DEC             10
+    #define HEX             16
+    #define BIN             2
+
+    #ifndef PI
+        #define PI          3.1415926535897932384626433832795
+    #endif
+    #define DEG_TO_RAD      0.017453292519943295769236907684886
+    #define RAD_TO_DEG      57.295779513082320876798154814105
+
+    #define F(x)            x
+    #define PROGMEM
+    #define constrain(amt, low, high)   ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+    using std::min;
+    using std::max;
+
+    inline bool isDigit(int c) { return c >= '0' && c <= '9'; }
+
+    class String {
+        public:
+            String(const char* text = "")           : s(text != nullptr ? text : "") {}
+            String(const std::string& text)         : s(text) {}
+            String(char c)                          : s(1, c) {}
+            String(int value, int base = DEC)       { s = format(value < 0 ? "-" : "", value < 0 ? -(unsigned long)value : value, base); }
+            String(unsigned value, int base = DEC)  { s = format("", value, base); }
+            String(long value, int base = DEC)      { s = format(value < 0 ? "-" : "", value < 0 ? -(unsigned long)value : value, base); }
+            String(unsigned long value, int base = DEC) { s = format("", value, base); }
+            String(float value, int decimals = 2)   { s = fixed(value, decimals); }
+            String(double value, int decimals = 2)  { s = fixed(value, decimals); }
+
+            unsigned    length() const                          { return s.size(); }
+            const char* c_str() const                           { return s.c_str(); }
+            char        charAt(unsigned i) const                { return i < s.size() ? s[i] : 0; }
+            char        operator[](unsigned i) const            { return charAt(i); }
+            void        setCharAt(unsigned i, char c)           { if (i < s.size()) s[i] = c; }
+            String      substring(unsigned from) const          { return from < s.size() ? s.substr(from) : ""; }
+            String      substring(unsigned from, unsigned to) const { return from < to && from < s.size() ? s.substr(from, to - from) : ""; }
+            int         indexOf(char c, unsigned from = 0) const { size_t p = s.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+            bool        startsWith(const String& other) const   { return s.compare(0, other.s.size(), other.s) == 0; }
+            bool        equalsIgnoreCase(const String& other) const { return strcasecmp(s.c_str(), other.c_str()) == 0; }
+            void        toLowerCase()                           { for (char& c : s) c = (char)tolower((unsigned char)c); }
+            void        trim()                                  { s.erase(0, s.find_first_not_of(" \t\r\n")); s.erase(s.find_last_not_of(" \t\r\n") + 1); }
+            void        remove(unsigned index, unsigned count = 1) { if (index < s.size()) s.erase(index, count); }
+            bool        reserve(unsigned size)                  { s.reserve(size); return true; }
+            long        toInt() const                           { return atol(s.c_str()); }
+            float       toFloat() const                         { return (float)atof(s.c_str()); }
+
+            bool        operator==(const String& other) const   { return s == other.s; }
+            bool        operator==(const char* other) const     { return s == other; }
+            bool        operator!=(const String& other) const   { return s != other.s; }
+            String&     operator+=(const String& other)         { s += other.s; return *this; }
+            String&     operator+=(const char* other)           { s += other; return *this; }
+            String&     operator+=(char c)                      { s += c; return *this; }
+
+            friend String operator+(const String& a, const String& b)   { return String(a.s + b.s); }
+            friend String operator+(const String& a, const char* b)     { return String(a.s + b); }
+            friend String operator+(const char* a, const String& b)     { return String(a + b.s); }
+            friend String operator+(const String& a, char b)            { return String(a.s + b); }
+
+        private:
+            std::string s;
+
+            static std::string format(const char* sign, unsigned long value, int base) {
+                std::string digits;
+                do {
+                    digits.insert(digits.begin(), "0123456789abcdef"[value % base]);
+                    value /= base;
+                } while (value != 0);
+                return sign + digits;
+            }
+            static std::string fixed(double value, int decimals) {
+                char text[48];
+                snprintf(text, sizeof(text), "%.*f", decimals, value);
+                return text;
+            }
+    };
+
+    class Print {
+        public:
+            virtual ~Print() {}
+            virtual size_t  write(uint8_t c) = 0;
+            virtual size_t  write(const uint8_t* data, size_t length) {
+                size_t n = 0;
+                while (n < length && write(data[n]) == 1) n++;
+                return n;
+            }
+            virtual int     availableForWrite() { return 0; }
+            virtual void    flush() {}
+
+            size_t  print(const char* text)             { return write((const uint8_t*)text, strlen(text)); }
+            size_t  print(const String& text)           { return print(text.c_str()); }
+            size_t  print(char c)                       { return write((uint8_t)c); }
+            size_t  print(int value, int base = DEC)    { return print(String(value, base)); }
+            size_t  print(long value, int base = DEC)   { return print(String(value, base)); }
+            size_t  print(unsigned long value, int base = DEC) { return print(String(value, base)); }
+            size_t  print(double value, int decimals = 2) { return print(String(value, decimals)); }
+            template <typename T>
+            size_t  println(const T& value)             { return print(value) + print("\r\n"); }
+            size_t  println()                           { return print("\r\n"); }
+    };
+
+    class Stream : public Print {
+        public:
+            virtual int     available() { return 0; }
+            virtual int     read()      { return -1; }
+            virtual int     peek()      { return -1; }
+    };
+
+    // A serial port on stdout and stdin, never short of room
+    class HardwareSerial : public Stream {
+        public:
+            void    begin(unsigned long baud)   { (void)baud; }
+            size_t  write(uint8_t c) override   { return fwrite(&c, 1, 1, stdout); }
+            size_t  write(const uint8_t* data, size_t length) override { return fwrite(data, 1, length, stdout); }
+            int     availableForWrite() override { return 4096; }
+            operator bool()                     { return true; }
+    };
+
+    extern HardwareSerial Serial;
+
+    unsigned long   millis();
+    unsigned long   micros();
+    void            delay(unsigned long ms);
+    void            delayMicroseconds(unsigned int us);
+    void            noInterrupts();
+    void            interrupts();
+
+#endif
+// ARDUINO_H
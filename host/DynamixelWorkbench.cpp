@@ -0,0 +1,146 @@
+#include "DynamixelWorkbench.h"
+
+// Control table entries the firmware adds sync write handlers for, per protocol
+static const ControlItem axItems[] = {
+    {30, "Goal_Position", 13, 2},
+    {32, "Moving_Speed",  12, 2},
+    {24, "Torque_Enable", 13, 1},
+};
+static const ControlItem xItems[] = {
+    {116, "Goal_Position",  13, 4},
+    {112, "Profile_Velocity", 16, 4},
+    {64,  "Torque_Enable",  13, 1},
+};
+
+static const char* noBus = "[Host] The workbench has no bus on the host";
+
+// Keep the settings, there is nothing to open
+bool DynamixelWorkbench::setPortHandler(const char* device_name, const char** log) {
+    (void)device_name;
+    (void)log;
+    return true;
+}
+
+bool DynamixelWorkbench::setBaudrate(uint32_t baud_rate, const char** log) {
+    (void)log;
+    baudrate = baud_rate;
+    return true;
+}
+
+bool DynamixelWorkbench::setPacketHandler(float protocol_version, const char** log) {
+    (void)log;
+    protocol = protocol_version;
+    return true;
+}
+
+float DynamixelWorkbench::getProtocolVersion() {
+    return protocol;
+}
+
+uint32_t DynamixelWorkbench::getBaudrate() {
+    return baudrate;
+}
+
+const char* DynamixelWorkbench::getModelName(uint8_t id, const char** log) {
+    (void)id;
+    (void)log;
+    return protocol >= 2.0f ? "XM430-W350" : "AX-18A";
+}
+
+// Every ID is taken to be an AX on a Protocol 1.0 bus and an X series on a Protocol 2.0 bus
+const ControlItem* DynamixelWorkbench::getItemInfo(uint8_t id, const char* item_name, const char** log) {
+    (void)id;
+    const ControlItem* items = protocol >= 2.0f ? xItems : axItems;
+    uint8_t            count = protocol >= 2.0f ? sizeof(xItems) / sizeof(xItems[0]) : sizeof(axItems) / sizeof(axItems[0]);
+    for (uint8_t i = 0; i < count; i++) {
+        if (strcmp(items[i].item_name, item_name) == 0) return &items[i];
+    }
+    if (log != NULL) *log = "[Host] Unknown control table item";
+    return NULL;
+}
+
+uint8_t DynamixelWorkbench::getTheNumberOfSyncWriteHandler() {
+    return handlers;
+}
+
+uint8_t DynamixelWorkbench::getTheNumberOfSyncReadHandler() {
+    return 0;
+}
+
+uint8_t DynamixelWorkbench::getTheNumberOfBulkReadParam() {
+    return 0;
+}
+
+bool DynamixelWorkbench::ping(uint8_t id, const char** log) {
+    (void)id;
+    if (log != NULL) *log = noBus;
+    return false;
+}
+
+bool DynamixelWorkbench::readRegister(uint8_t id, uint16_t address, uint16_t length, uint32_t* data, const char** log) {
+    (void)id; (void)address; (void)length; (void)data;
+    if (log != NULL) *log = noBus;
+    return false;
+}
+
+bool DynamixelWorkbench::readRegister(uint8_t id, const char* item_name, int32_t* data, const char** log) {
+    (void)id; (void)item_name; (void)data;
+    if (log != NULL) *log = noBus;
+    return false;
+}
+
+bool DynamixelWorkbench::writeRegister(uint8_t id, uint16_t address, uint16_t length, uint8_t* data, const char** log) {
+    (void)id; (void)address; (void)length; (void)data;
+    if (log != NULL) *log = noBus;
+    return false;
+}
+
+bool DynamixelWorkbench::writeRegister(uint8_t id, const char* item_name, int32_t data, const char** log) {
+    (void)id; (void)item_name; (void)data;
+    if (log != NULL) *log = noBus;
+    return false;
+}
+
+bool DynamixelWorkbench::writeOnlyRegister(uint8_t id, uint16_t address, uint16_t length, uint8_t* data, const char** log) {
+    (void)id; (void)address; (void)length; (void)data;
+    if (log != NULL) *log = noBus;
+    return false;
+}
+
+bool DynamixelWorkbench::writeOnlyRegister(uint8_t id, const char* item_name, int32_t data, const char** log) {
+    (void)id; (void)item_name; (void)data;
+    if (log != NULL) *log = noBus;
+    return false;
+}
+
+// Handlers are only counted, the driver's codecs build the packets
+bool DynamixelWorkbench::addSyncWriteHandler(uint16_t address, uint16_t length, const char** log) {
+    (void)address;
+    (void)length;
+    if (handlers >= HOST_SYNC_WRITE_HANDLERS) {
+        if (log != NULL) *log = "[Host] Too many sync write handlers";
+        return false;
+    }
+    handlers++;
+    return true;
+}
+
+bool DynamixelWorkbench::addSyncWriteHandler(uint8_t id, const char* item_name, const char** log) {
+    const ControlItem* item = getItemInfo(id, item_name, log);
+    if (item == NULL) return false;
+    return addSyncWriteHandler(item->address, item->data_length, log);
+}
+
+bool DynamixelWorkbench::syncWrite(uint8_t index, int32_t* data, const char** log) {
+    (void)index; (void)data;
+    if (log != NULL) *log = noBus;
+    return false;
+}
+
+bool DynamixelWorkbench::syncWrite(uint8_t index, uint8_t* id, uint8_t id_num, int32_t* data, uint8_t data_num_for_each_id, const char** log) {
+    (void)index; (void)id; (void)id_num; (void)data; (void)data_num_for_each_id;
+    if (log != NULL) *log = noBus;
+    return false;
+}
+
+// end of DynamixelWorkbench.cpp
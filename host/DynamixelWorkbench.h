@@ -0,0 +1,79 @@
+#ifndef DYNAMIXEL_WORKBENCH_H
+#define DYNAMIXEL_WORKBENCH_H
+
+    // The parts of DynamixelWorkbench the driver uses, for the host checks. The port handler interface
+    // matches the Dynamixel SDK, and getPortHandler is left to the check, which returns its own fake
+    // ports. The workbench itself has no bus: it keeps its settings and sync write handlers, knows the
+    // control table items the firmware adds handlers for, and fails every transfer, so only the
+    // driver's codecs reach the fake ports.
+
+    #include <Arduino.h>
+
+    namespace dynamixel {
+        class PortHandler {
+            public:
+                static PortHandler* getPortHandler(const char* port_name);     // Defined by the check
+
+                virtual ~PortHandler() {}
+                virtual bool    openPort() = 0;
+                virtual void    closePort() = 0;
+                virtual void    clearPort() = 0;
+                virtual void    setPortName(const char* port_name) = 0;
+                virtual char*   getPortName() = 0;
+                virtual bool    setBaudRate(const int baudrate) = 0;
+                virtual int     getBaudRate() = 0;
+                virtual int     getBytesAvailable() = 0;
+                virtual int     readPort(uint8_t* packet, int length) = 0;
+                virtual int     writePort(uint8_t* packet, int length) = 0;
+                virtual void    setPacketTimeout(uint16_t packet_length) = 0;
+                virtual void    setPacketTimeout(double msec) = 0;
+                virtual bool    isPacketTimeout() = 0;
+
+                bool            is_using_ = false;
+        };
+    }
+
+    typedef struct {
+        uint16_t        address;
+        const char*     item_name;
+        uint8_t         item_name_length;
+        uint8_t         data_length;
+    } ControlItem;
+
+    #define HOST_SYNC_WRITE_HANDLERS    5                   // As MAX_HANDLER_NUM of the workbench
+
+    class DynamixelWorkbench {
+        public:
+            bool                setPortHandler(const char* device_name, const char** log = NULL);
+            bool                setBaudrate(uint32_t baud_rate, const char** log = NULL);
+            bool                setPacketHandler(float protocol_version, const char** log = NULL);
+            float               getProtocolVersion();
+            uint32_t            getBaudrate();
+            const char*         getModelName(uint8_t id, const char** log = NULL);
+            const ControlItem*  getItemInfo(uint8_t id, const char* item_name, const char** log = NULL);
+
+            uint8_t             getTheNumberOfSyncWriteHandler();
+            uint8_t             getTheNumberOfSyncReadHandler();
+            uint8_t             getTheNumberOfBulkReadParam();
+
+            bool                ping(uint8_t id, const char** log = NULL);
+            bool                readRegister(uint8_t id, uint16_t address, uint16_t length, uint32_t* data, const char** log = NULL);
+            bool                readRegister(uint8_t id, const char* item_name, int32_t* data, const char** log = NULL);
+            bool                writeRegister(uint8_t id, uint16_t address, uint16_t length, uint8_t* data, const char** log = NULL);
+            bool                writeRegister(uint8_t id, const char* item_name, int32_t data, const char** log = NULL);
+            bool                writeOnlyRegister(uint8_t id, uint16_t address, uint16_t length, uint8_t* data, const char** log = NULL);
+            bool                writeOnlyRegister(uint8_t id, const char* item_name, int32_t data, const char** log = NULL);
+
+            bool                addSyncWriteHandler(uint16_t address, uint16_t length, const char** log = NULL);
+            bool                addSyncWriteHandler(uint8_t id, const char* item_name, const char** log = NULL);
+            bool                syncWrite(uint8_t index, int32_t* data, const char** log = NULL);
+            bool                syncWrite(uint8_t index, uint8_t* id, uint8_t id_num, int32_t* data, uint8_t data_num_for_each_id, const char** log = NULL);
+
+        private:
+            float               protocol = 1.0f;
+            uint32_t            baudrate = 0;
+            uint8_t             handlers = 0;
+    };
+
+#endif
+// DYNAMIXEL_WORKBENCH_H
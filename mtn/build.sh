@@ -0,0 +1,6 @@
+#!/bin/bash
+# Build script for the RoboPlus motion compiler
+# Usage: ./build.sh
+#        ./mtnc ../roboplus_files/Basic_Motions.mtn ../code/MotionPages.h
+
+g++ -std=c++17 -o mtnc main.cpp
@@ -0,0 +1,250 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include "../code/MotionFormat.h"   // Packed format and decoder shared with the firmware
+
+
+#define MTN_IDS          int(26)       // Values per step= line before pause and time (IDs 0 to 25)
+#define MTN_FIRST_ID     int(1)        // First servo ID stored in the packed format
+
+struct Page {
+    int                     number = 0;
+    std::string             name;
+    int                     next = 0, exit = 0, repeat = 1;
+    float                   speedRate = 1.0f;
+    std::vector<MotionStep> steps;
+    std::vector<uint8_t>    data;
+};
+
+// -------------------- Bit writer --------------------
+class BitWriter {
+    public:
+        std::vector<uint8_t> bytes;
+        uint32_t             bitPos = 0;
+
+        void write(uint32_t value, uint8_t n) {     // write n bits, least significant bit first
+            for (uint8_t i = 0; i < n; i++, bitPos++) {
+                if ((bitPos >> 3) >= bytes.size()) bytes.push_back(0);
+                if (value & (1UL << i)) bytes[bitPos >> 3] |= 1 << (bitPos & 7);
+            }
+        }
+};
+
+inline uint32_t zigzag(int32_t v) {             // 0, -1, 1, -2, 2 ... -> 0, 1, 2, 3, 4 ...
+    return (uint32_t)((v << 1) ^ (v >> 31));
+}
+
+uint8_t bitWidth(uint32_t v) {
+    uint8_t n = 0;
+    while (v) { n++; v >>= 1; }
+    return n;
+}
+
+// -------------------- Parser --------------------
+bool parseMtn(const std::string& path, std::vector<Page>& pages) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Cannot open " << path << "\n";
+        return false;
+    }
+
+    Page page;
+    int  number = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) line.pop_back();
+        if (line.size() >= 3 && (uint8_t)line[0] == 0xEF) line.erase(0, 3);   // UTF-8 byte order mark
+
+        if (line == "page_begin") {
+            page = Page();
+            page.number = ++number;
+
+        } else if (line.rfind("name=", 0) == 0) {
+            page.name = line.substr(5);
+
+        } else if (line.rfind("play_param=", 0) == 0) {
+            std::istringstream ss(line.substr(11));
+            ss >> page.next >> page.exit >> page.repeat >> page.speedRate;
+
+        } else if (line.rfind("step=", 0) == 0) {
+            std::istringstream ss(line.substr(5));
+            float values[MTN_IDS + 2];
+            for (int i = 0; i < MTN_IDS + 2; i++) {
+                if (!(ss >> values[i])) {
+                    std::cerr << "Page " << page.number << ": short step line\n";
+                    return false;
+                }
+            }
+            MotionStep step;
+            for (int i = 0; i < MOTION_SERVOS; i++) {
+                int position = (int)values[MTN_FIRST_ID + i];
+                if (position < 0 || position > 1023) {
+                    std::cerr << "Page " << page.number << ": position " << position << " out of range\n";
+                    return false;
+                }
+                step.positions[i] = (uint16_t)position;
+            }
+            step.pause = (uint16_t)lroundf(values[MTN_IDS]     * 1000.0f);
+            step.time  = (uint16_t)lroundf(values[MTN_IDS + 1] * 1000.0f);
+            page.steps.push_back(step);
+
+        } else if (line == "page_end") {
+            if (!page.steps.empty()) pages.push_back(page);         // Empty pages are not compiled
+        }
+    }
+    return true;
+}
+
+// -------------------- Encoder --------------------
+void encodePage(Page& page) {
+    BitWriter bits;
+    for (size_t s = 0; s < page.steps.size(); s++) {
+        const MotionStep& step = page.steps[s];
+
+        if (s == 0) {
+            bits.write(step.pause, MOTION_TIME_BITS);
+            bits.write(step.time,  MOTION_TIME_BITS);
+            for (int i = 0; i < MOTION_SERVOS; i++) bits.write(step.positions[i], MOTION_POSITION_BITS);
+            continue;
+        }
+
+        const MotionStep& prev = page.steps[s - 1];
+        bool timed = step.pause != prev.pause || step.time != prev.time;
+        bits.write(timed, 1);
+        if (timed) {
+            bits.write(step.pause, MOTION_TIME_BITS);
+            bits.write(step.time,  MOTION_TIME_BITS);
+        }
+
+        uint32_t mask  = 0;
+        uint8_t  width = 0;
+        for (int i = 0; i < MOTION_SERVOS; i++) {
+            int32_t delta = (int32_t)step.positions[i] - (int32_t)prev.positions[i];
+            if (delta == 0) continue;
+            mask |= 1UL << i;
+            uint8_t w = bitWidth(zigzag(delta));
+            if (w > width) width = w;
+        }
+        bits.write(mask,  MOTION_SERVOS);
+        bits.write(width, MOTION_WIDTH_BITS);
+        for (int i = 0; i < MOTION_SERVOS; i++) {
+            if (mask & (1UL << i)) bits.write(zigzag((int32_t)step.positions[i] - (int32_t)prev.positions[i]), width);
+        }
+    }
+    page.data = bits.bytes;
+}
+
+// Decode the packed page with the firmware decoder and compare against the source steps
+bool verifyPage(const Page& page) {
+    MotionPage index = { page.name.c_str(), (uint8_t)page.number, (uint8_t)page.next, (uint8_t)page.exit,
+                         (uint8_t)page.repeat, page.speedRate, (uint8_t)page.steps.size(),
+                         page.data.data(), (uint16_t)page.data.size() };
+    MotionDecoder decoder;
+    decoder.begin(&index);
+    for (size_t s = 0; s < page.steps.size(); s++) {
+        MotionStep step;
+        if (!decoder.next(step)) return false;
+        if (step.pause != page.steps[s].pause || step.time != page.steps[s].time) return false;
+        for (int i = 0; i < MOTION_SERVOS; i++) {
+            if (step.positions[i] != page.steps[s].positions[i]) return false;
+        }
+    }
+    MotionStep extra;
+    return !decoder.next(extra);
+}
+
+// -------------------- Header writer --------------------
+void writeHeader(std::ostream& out, const std::string& source, const std::vector<Page>& pages) {
+    size_t packed = 0, steps = 0;
+    for (const Page& p : pages) { packed += p.data.size(); steps += p.steps.size(); }
+
+    char buf[160];
+    out << "#ifndef __MOTIONPAGES_H__\n#define __MOTIONPAGES_H__\n\n";
+    out << "    // Generated by mtn/mtnc from " << source << ", do not edit.\n";
+    out << "    // " << pages.size() << " pages, " << steps << " steps, " << packed << " bytes of packed keyframes ("
+        << steps * sizeof(MotionStep) << " bytes unpacked). See MotionFormat.h for the format.\n\n";
+
+    out << "    const uint8_t motionData[] = {\n";
+    for (size_t p = 0; p < pages.size(); p++) {
+        out << "        // " << pages[p].number << " " << pages[p].name << "\n";
+        const std::vector<uint8_t>& d = pages[p].data;
+        for (size_t i = 0; i < d.size(); i += 16) {
+            out << "        ";
+            for (size_t j = i; j < i + 16 && j < d.size(); j++) {
+                bool last = (p + 1 == pages.size()) && (j + 1 == d.size());
+                bool eol  = (j + 1 == i + 16) || (j + 1 == d.size());
+                snprintf(buf, sizeof(buf), "0x%02X%s", d[j], last ? "" : (eol ? "," : ", "));
+                out << buf;
+            }
+            out << "\n";
+        }
+    }
+    out << "    };\n\n";
+
+    out << "    const MotionPage motionPages[] = {\n";
+    out << "        //  name            page  next  exit  repeat  speed  steps  data                size\n";
+    size_t offset = 0;
+    for (size_t p = 0; p < pages.size(); p++) {
+        const Page& page = pages[p];
+        std::string name = "\"" + page.name + "\",";
+        snprintf(buf, sizeof(buf), "        {   %-16s%4d, %4d, %4d, %6d,   %.1ff, %4d,  motionData + %4zu, %4zu }%s\n",
+                 name.c_str(), page.number, page.next, page.exit, page.repeat, page.speedRate,
+                 (int)page.steps.size(), offset, page.data.size(), p + 1 == pages.size() ? "" : ",");
+        out << buf;
+        offset += page.data.size();
+    }
+    out << "    };\n\n";
+    out << "    #define MOTION_PAGES    uint8_t(sizeof(motionPages) / sizeof(motionPages[0]))     // Number of compiled motion pages\n\n";
+    out << "#endif // __MOTIONPAGES_H__\n";
+}
+
+// -------------------- Main --------------------
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: mtnc <motion.mtn> [MotionPages.h]\n";
+        std::cerr << "Compiles RoboPlus motion pages into a packed C header, written to stdout if no output is given.\n";
+        return 1;
+    }
+
+    std::vector<Page> pages;
+    if (!parseMtn(argv[1], pages)) return 1;
+
+    for (Page& page : pages) {
+        if (page.number > 255 || page.steps.size() > 255 || page.name.empty()) {
+            std::cerr << "Page " << page.number << ": unsupported page\n";
+            return 1;
+        }
+        encodePage(page);
+        if (!verifyPage(page)) {
+            std::cerr << "Page " << page.number << " " << page.name << ": decode check failed\n";
+            return 1;
+        }
+    }
+
+    std::string source = argv[1];
+    size_t slash = source.find_last_of("/\\");
+    if (slash != std::string::npos) source = source.substr(slash + 1);
+
+    if (argc == 3) {
+        std::ofstream out(argv[2]);
+        if (!out) {
+            std::cerr << "Cannot write " << argv[2] << "\n";
+            return 1;
+        }
+        writeHeader(out, source, pages);
+    } else {
+        writeHeader(std::cout, source, pages);
+    }
+
+    for (const Page& page : pages) {
+        std::cerr << page.number << "\t" << page.name << "\t" << page.steps.size() << " steps\t"
+                  << page.data.size() << " bytes (" << page.steps.size() * sizeof(MotionStep) << " unpacked)\n";
+    }
+    return 0;
+}
@@ -0,0 +1,6 @@
+#!/bin/bash
+# Build script for the scheduler checks
+# Usage: ./build.sh
+#        ./schtest
+
+g++ -std=c++17 -I../host -o schtest main.cpp ../code/Scheduler.cpp ../code/CommandRegistry.cpp ../code/Debug.cpp ../host/Arduino.cpp
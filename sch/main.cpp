@@ -0,0 +1,156 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../code/Scheduler.h"          // Scheduler compiled from the firmware sources, built against the shim in host/
+#include "../code/Debug.h"
+
+
+struct Stats {
+    size_t  checks = 0;                     // Checks run
+    size_t  failed = 0;                     // Checks that failed
+};
+
+static Stats stats;
+
+// -------------------- Checks --------------------
+void check(const std::string& name, bool ok, const std::string& detail = "") {
+    stats.checks++;
+    if (ok) {
+        std::cout << "ok    " << name << "\n";
+        return;
+    }
+    stats.failed++;
+    std::cout << "FAIL  " << name << (detail.empty() ? "" : ": " + detail) << "\n";
+}
+
+void checkInt(const std::string& name, long got, long expected) {
+    check(name, got == expected, "got " + std::to_string(got) + ", expected " + std::to_string(expected));
+}
+
+// -------------------- Simulated time --------------------
+// The scheduler reads this clock instead of micros(). Time only moves when a task runs, by the cost
+// set for it, or when a check advances it, so every run is repeatable.
+static uint32_t     now = 0;
+static std::string  trace;                  // One letter per task run, in order
+static uint32_t     cost[4] = {0};          // Execution time per task letter A to D in us
+
+unsigned long simulatedClock() {
+    return now;
+}
+
+void run(char letter) {
+    trace += letter;
+    now   += cost[letter - 'A'];
+}
+
+void taskA() { run('A'); }
+void taskB() { run('B'); }
+void taskC() { run('C'); }
+void taskD() { run('D'); }
+void taskIdle() { trace += 'i'; }
+
+void reset() {
+    now   = 0;
+    trace = "";
+    for (uint32_t& c : cost) c = 0;
+}
+
+// Call update n times
+void step(Scheduler& scheduler, int n) {
+    for (int i = 0; i < n; i++) scheduler.update();
+}
+
+// -------------------- Order --------------------
+// Higher priority first, the earliest release among equal priorities, idle tasks only when nothing
+// periodic is due
+void testOrder() {
+    reset();
+    Scheduler scheduler(simulatedClock);
+    scheduler.addTask("idle", taskIdle, SCHEDULER_IDLE, 0);
+    uint8_t b = scheduler.addTask("b", taskB, 1000, 1);
+    scheduler.addTask("c", taskC, 1000, 1);
+    scheduler.addTask("a", taskA, 1000, 0);
+    scheduler.begin();                                                              // All released at 0
+
+    now = 100;
+    scheduler.setTaskPeriod(b, 1000);                                               // B released again at 100, after C
+    now = 200;
+    step(scheduler, 3);
+    check("priority then earliest release", trace == "ACB", "got " + trace + ", expected ACB");
+
+    step(scheduler, 2);
+    check("idle when nothing is due", trace == "ACBii", "got " + trace + ", expected ACBii");
+
+    now   = 1000;                                                                   // A and C due at 1000, B at 1100
+    trace = "";
+    step(scheduler, 3);
+    check("idle waits for due tasks", trace == "ACi", "got " + trace + ", expected ACi");
+
+    now   = 1100;
+    trace = "";
+    step(scheduler, 2);
+    check("released task preempts idle", trace == "Bi", "got " + trace + ", expected Bi");
+
+    now   = 2000;
+    trace = "";
+    scheduler.setTaskEnabled(b, false);
+    step(scheduler, 3);
+    check("disabled task is not released", trace == "ACi", "got " + trace + ", expected ACi");
+    checkInt("idle runs counted", scheduler.getTask(0)->runs, 5);
+}
+
+// -------------------- Overruns --------------------
+// A run past its deadline counts as an overrun; a run that ends a whole period late drops the missed
+// releases instead of bursting to catch up
+void testOverruns() {
+    reset();
+    Scheduler scheduler(simulatedClock);
+    uint8_t d = scheduler.addTask("d", taskD, 1000, 0, 300);                        // Deadline 300 us
+    scheduler.begin();
+    const SchedulerTask* task = scheduler.getTask(d);
+
+    cost['D' - 'A'] = 200;
+    step(scheduler, 1);
+    checkInt("within deadline", task->overruns, 0);
+    checkInt("next release one period on", task->nextRelease, 1000);
+
+    now = 1000;
+    cost['D' - 'A'] = 500;
+    step(scheduler, 1);
+    checkInt("past deadline", task->overruns, 1);
+    checkInt("late run skips nothing", task->skipped, 0);
+
+    now = 2000;
+    cost['D' - 'A'] = 2500;                                                         // Ends at 4500: the release at 3000 is missed, 4000 is late
+    step(scheduler, 1);
+    checkInt("overrun counted", task->overruns, 2);
+    checkInt("missed release skipped", task->skipped, 1);
+    checkInt("next release within a period", task->nextRelease, 4000);
+
+    cost['D' - 'A'] = 0;
+    trace = "";
+    step(scheduler, 2);
+    check("no catch-up burst", trace == "D", "got " + trace + ", expected D");
+    checkInt("lateness recorded", task->maxLateness, 500);
+    checkInt("longest run recorded", task->maxExec, 2500);
+    checkInt("back on schedule", task->nextRelease, 5000);
+    checkInt("runs", task->runs, 4);
+}
+
+int main(int argc, char** argv) {
+    (void)argv;
+    if (argc != 1) {
+        std::cerr << "Usage: schtest\n";
+        std::cerr << "Checks the firmware scheduler on a simulated clock: task order by priority and release time,\n";
+        std::cerr << "idle tasks, overrun and skipped release counts. Exits with 1 if any check fails.\n";
+        return 1;
+    }
+
+    log::setLogStream(nullptr);                                                     // Keep the scheduler's own logging out of the report
+    testOrder();
+    testOverruns();
+
+    std::cout << stats.checks << " checks, " << stats.failed << " failed\n";
+    return stats.failed ? 1 : 0;
+}
@@ -0,0 +1,6 @@
+#!/bin/bash
+# Build script for the telemetry decoder
+# Usage: ./build.sh
+#        ./tlmdec capture.bin telemetry.csv
+
+g++ -std=c++17 -o tlmdec main.cpp
@@ -0,0 +1,134 @@
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+
+#include "../code/TelemetryFormat.h"    // Frame format and decoder shared with the firmware
+
+
+struct Stats {
+    size_t  frames = 0;                     // Frames decoded
+    size_t  badFrames = 0;                  // Frames with a bad CRC, unknown type or short payload
+    size_t  skipped = 0;                    // Bytes outside frames, console text included
+    size_t  lost = 0;                       // Frames missing from the sequence
+};
+
+// -------------------- CSV --------------------
+// One row per frame, one column per value, so the file loads straight into a data frame or converts
+// to Parquet without reshaping. Positions of servos not read yet are left empty. Load is signed,
+// negative when bit 10 (clockwise) is set.
+void writeCsvHeader(std::ostream& out) {
+    out << "sequence,time_us,gait_type,gait_phase,duty,battery_v"
+        << ",distance_left,distance_center,distance_right,light_left,light_center,light_right"
+        << ",obstacle,light_detected,sound,tick_max_us,tick_overruns,state_max_us,lateness_max_us,dropped";
+    for (int i = 1; i <= TELEMETRY_SERVOS; i++) out << ",position_" << i;
+    for (int i = 1; i <= TELEMETRY_SERVOS; i++) out << ",load_" << i;
+    for (int i = 1; i <= TELEMETRY_SERVOS; i++) out << ",temperature_" << i;
+    for (int i = 1; i <= TELEMETRY_SERVOS; i++) out << ",voltage_" << i;
+    for (int i = 1; i <= TELEMETRY_SERVOS; i++) out << ",moving_" << i;
+    out << "\n";
+}
+
+void writeCsvRow(std::ostream& out, const TelemetryRecord& r) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%u,%u,%u,%.5f,%.3f,%.3f", r.sequence, r.time, r.gaitType,
+             r.gaitPhase / 65536.0, r.duty / 1000.0, r.battery / 1000.0);
+    out << buf;
+    for (int i = 0; i < 3; i++) out << "," << (int)r.distance[i];
+    for (int i = 0; i < 3; i++) out << "," << (int)r.light[i];
+    out << "," << (int)r.obstacle << "," << (int)r.lightDetected << "," << (int)r.sound
+        << "," << r.tickMax << "," << r.tickOverruns << "," << r.stateMax << "," << r.latenessMax << "," << r.dropped;
+
+    for (int i = 0; i < TELEMETRY_SERVOS; i++) {
+        out << ",";
+        if (r.positionValid & (1UL << i)) out << r.position[i];
+    }
+    for (int i = 0; i < TELEMETRY_SERVOS; i++) {
+        int load = r.load[i] & 0x3FF;
+        out << "," << ((r.load[i] & 0x400) ? -load : load);
+    }
+    for (int i = 0; i < TELEMETRY_SERVOS; i++) out << "," << (int)r.temperature[i];
+    for (int i = 0; i < TELEMETRY_SERVOS; i++) {
+        snprintf(buf, sizeof(buf), ",%.1f", r.voltage[i] / 10.0);
+        out << buf;
+    }
+    for (int i = 0; i < TELEMETRY_SERVOS; i++) out << "," << ((r.moving >> i) & 1);
+    out << "\n";
+}
+
+// -------------------- Frame scanner --------------------
+// Walk the capture looking for sync bytes. A frame that fails its check only costs its first byte,
+// so a sync pair inside text or inside a broken frame cannot hide the frame after it.
+void decode(const std::vector<uint8_t>& data, std::ostream& out, Stats& stats) {
+    bool     first = true;
+    uint16_t expected = 0;
+    size_t   i = 0;
+    while (i + TELEMETRY_HEADER <= data.size()) {
+        uint16_t length = telemetryFrameLength(&data[i]);
+        if (length == 0) {
+            i++;
+            stats.skipped++;
+            continue;
+        }
+        TelemetryRecord r;
+        if (i + length > data.size() || !telemetryDecode(&data[i], length, &r)) {   // Broken, or the capture ends inside it
+            stats.badFrames++;
+            stats.skipped++;
+            i++;
+            continue;
+        }
+        if (!first && r.sequence != expected) stats.lost += (uint16_t)(r.sequence - expected);
+        first    = false;
+        expected = r.sequence + 1;
+
+        writeCsvRow(out, r);
+        stats.frames++;
+        i += length;
+    }
+    stats.skipped += data.size() - i;
+}
+
+// -------------------- Main --------------------
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: tlmdec <capture.bin|-> [telemetry.csv]\n";
+        std::cerr << "Decodes binary telemetry frames from a capture of the debug serial port (xr command) into CSV,\n";
+        std::cerr << "written to stdout if no output is given. Console text in the capture is skipped.\n";
+        return 1;
+    }
+
+    std::vector<uint8_t> data;
+    std::string source = argv[1];
+    if (source == "-") {
+        std::cin >> std::noskipws;
+        data.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    } else {
+        std::ifstream in(source, std::ios::binary);
+        if (!in) {
+            std::cerr << "Cannot open " << source << "\n";
+            return 1;
+        }
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    Stats stats;
+    if (argc == 3) {
+        std::ofstream out(argv[2]);
+        if (!out) {
+            std::cerr << "Cannot write " << argv[2] << "\n";
+            return 1;
+        }
+        writeCsvHeader(out);
+        decode(data, out, stats);
+    } else {
+        writeCsvHeader(std::cout);
+        decode(data, std::cout, stats);
+    }
+
+    std::cerr << stats.frames << " frames, " << stats.lost << " lost, " << stats.badFrames << " bad, "
+              << stats.skipped << " bytes skipped\n";
+    return 0;
+}
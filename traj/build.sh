@@ -0,0 +1,6 @@
+#!/bin/bash
+# Build script for the trajectory checks
+# Usage: ./build.sh
+#        ./trajtest
+
+g++ -std=c++17 -I../host -o trajtest main.cpp ../code/Trajectory.cpp
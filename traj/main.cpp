@@ -0,0 +1,173 @@
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <cstdio>
+
+#include "../code/Trajectory.h"         // Trajectory builders and kernels compiled from the firmware sources
+
+using namespace Trajectory;
+
+
+struct Stats {
+    size_t  checks = 0;                     // Checks run
+    size_t  failed = 0;                     // Checks that failed
+};
+
+static Stats stats;
+
+static const float TOLERANCE = 1e-4f;       // Float error allowed relative to the size of the values compared
+
+// -------------------- Checks --------------------
+void check(const std::string& name, bool ok, const std::string& detail = "") {
+    stats.checks++;
+    if (ok) {
+        std::cout << "ok    " << name << "\n";
+        return;
+    }
+    stats.failed++;
+    std::cout << "FAIL  " << name << (detail.empty() ? "" : ": " + detail) << "\n";
+}
+
+void checkNear(const std::string& name, float got, float expected) {
+    char detail[64];
+    snprintf(detail, sizeof(detail), "got %.6f, expected %.6f", got, expected);
+    check(name, fabsf(got - expected) <= TOLERANCE * (1.0f + fabsf(expected)), detail);
+}
+
+// -------------------- Power basis --------------------
+// Derivative of the given order (0 for the value) at s of a polynomial with n power-basis coefficients
+float derivative(const float* c, int n, int order, float s) {
+    float sum = 0.0f;
+    for (int k = order; k < n; k++) {
+        float factor = 1.0f;
+        for (int j = 0; j < order; j++) factor *= (float)(k - j);
+        sum += factor * c[k] * powf(s, (float)(k - order));
+    }
+    return sum;
+}
+
+// The end conditions a segment was built from hold at s = 0 and s = 1
+void checkEnds(const std::string& name, const float* c, int n, const float start[3], const float end[3], int orders) {
+    static const char* what[] = { "position", "velocity", "acceleration" };
+    for (int order = 0; order < orders; order++) {
+        checkNear(name + " start " + what[order], derivative(c, n, order, 0.0f), start[order]);
+        checkNear(name + " end " + what[order],   derivative(c, n, order, 1.0f), end[order]);
+    }
+}
+
+void testPolynomials() {
+    const float start[3] = { -12.5f, 3.0f, -40.0f };                                // Position, velocity, acceleration per unit s
+    const float end[3]   = {  30.0f, -7.5f, 25.0f };
+
+    Cubic c = cubic(start[0], end[0], start[1], end[1]);
+    checkEnds("cubic", c.c, 4, start, end, 2);
+
+    Quintic q = quintic(start[0], end[0], start[1], end[1], start[2], end[2]);
+    checkEnds("quintic", q.c, 6, start, end, 3);
+
+    const float restStart[3] = { 1.0f, 0.0f, 0.0f };
+    const float restEnd[3]   = { 5.0f, 0.0f, 0.0f };
+    Quintic r = quinticRestToRest(restStart[0], restEnd[0]);
+    checkEnds("quintic rest to rest", r.c, 6, restStart, restEnd, 3);
+    checkNear("quintic rest to rest peak velocity", derivative(r.c, 6, 1, 0.5f) / (restEnd[0] - restStart[0]), QUINTIC_PEAK_VELOCITY);
+
+    Quintic unit = quinticRestToRest(0.0f, 1.0f);
+    bool same = true;
+    for (int i = 0; i <= 20; i++) {
+        float s = i / 20.0f;
+        same &= fabsf(smoothstep5(s) - evaluate(unit, s)) <= TOLERANCE;
+    }
+    check("smoothstep5 is the unit quintic", same);
+    checkNear("evaluate cubic", evaluate(c, 0.3f), derivative(c.c, 4, 0, 0.3f));
+    checkNear("evaluate quintic", evaluate(q, 0.7f), derivative(q.c, 6, 0, 0.7f));
+}
+
+// -------------------- Curves --------------------
+// Cubic Bezier in Bernstein form
+float bernstein(float p0, float p1, float p2, float p3, float s) {
+    float t = 1.0f - s;
+    return t * t * t * p0 + 3.0f * t * t * s * p1 + 3.0f * t * s * s * p2 + s * s * s * p3;
+}
+
+void testCurves() {
+    const float p0[3] = { 10.0f, -20.0f,  0.0f };
+    const float p1[3] = { 35.0f,  15.0f, 40.0f };
+    const float p2[3] = { -5.0f,  60.0f, 55.0f };
+    const float p3[3] = { 50.0f,  45.0f, -5.0f };
+
+    Curve3 curve = bezier(p0, p1, p2, p3);
+    bool same = true;
+    for (int i = 0; i <= 20; i++) {
+        float s = i / 20.0f;
+        float out[3];
+        evaluate(curve, s, out);
+        for (int a = 0; a < 3; a++) {
+            float expected = bernstein(p0[a], p1[a], p2[a], p3[a], s);
+            same &= fabsf(out[a] - expected) <= TOLERANCE * (1.0f + fabsf(expected));
+        }
+    }
+    check("bezier power basis matches Bernstein", same);
+
+    Curve3 straight = line(p0, p3);
+    float  middle[3];
+    evaluate(straight, 0.5f, middle);
+    check("line midpoint", fabsf(middle[0] - 30.0f) <= TOLERANCE && fabsf(middle[1] - 12.5f) <= TOLERANCE
+                           && fabsf(middle[2] + 2.5f) <= TOLERANCE);
+
+    const float liftoff[3]   = { 60.0f, -30.0f, -80.0f };
+    const float touchdown[3] = { 60.0f,  30.0f, -80.0f };
+    Curve3 arc = swingArc(liftoff, touchdown, 25.0f);
+    float  top[3];
+    evaluate(arc, 0.5f, top);
+    checkNear("swing arc peak height", top[2] - liftoff[2], 25.0f);
+}
+
+// -------------------- Feet --------------------
+void testFeet() {
+    FootPath paths[TRAJECTORY_FEET];
+    float    phases[TRAJECTORY_FEET];
+    for (uint8_t i = 0; i < TRAJECTORY_FEET; i++) {
+        const float liftoff[3]   = { 50.0f + i, -25.0f - 2.0f * i, -70.0f };
+        const float touchdown[3] = { 55.0f - i,  25.0f + i,        -72.0f };
+        paths[i]  = footPath(liftoff, touchdown, 20.0f + i, 0.3f + 0.05f * i);
+        phases[i] = -0.4f + 0.37f * i;                                              // Negative and above 1 wrap
+    }
+
+    float feet[TRAJECTORY_FEET][TRAJECTORY_AXES];
+    evaluateFeet(paths, phases, feet);
+    bool same = true;
+    for (uint8_t i = 0; i < TRAJECTORY_FEET; i++) {
+        float foot[3];
+        evaluateFoot(paths[i], phases[i], foot);
+        for (uint8_t a = 0; a < TRAJECTORY_AXES; a++) same &= feet[i][a] == foot[a];
+    }
+    check("evaluateFeet is six evaluateFoot", same);
+
+    float at[3];
+    float end[3];
+    evaluateFoot(paths[0], 0.0f, at);
+    evaluate(paths[0].swing, 0.0f, end);
+    check("foot starts at liftoff", at[0] == end[0] && at[1] == end[1] && at[2] == end[2]);
+    evaluateFoot(paths[0], paths[0].swingFraction, at);
+    evaluate(paths[0].swing, 1.0f, end);
+    check("foot touches down at the swing fraction", fabsf(at[0] - end[0]) <= TOLERANCE && fabsf(at[1] - end[1]) <= TOLERANCE
+                                                     && fabsf(at[2] - end[2]) <= TOLERANCE);
+}
+
+int main(int argc, char** argv) {
+    (void)argv;
+    if (argc != 1) {
+        std::cerr << "Usage: trajtest\n";
+        std::cerr << "Checks the trajectory builders of the firmware: end conditions of the cubic and quintic segments,\n";
+        std::cerr << "Bezier curves in power basis against the Bernstein form, and the batched foot evaluation.\n";
+        std::cerr << "Exits with 1 if any check fails.\n";
+        return 1;
+    }
+
+    testPolynomials();
+    testCurves();
+    testFeet();
+
+    std::cout << stats.checks << " checks, " << stats.failed << " failed\n";
+    return stats.failed ? 1 : 0;
+}